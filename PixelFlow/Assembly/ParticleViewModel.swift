@@ -259,6 +259,7 @@ final class ParticleViewModel {
     private func finalizeSystemSetup(system: ParticleSystemControlling) {
         particleSystem = system
         isConfigured = true
+        system.applyThermalState(ProcessInfo.processInfo.thermalState)
         
         logger.info("Particle system created – ready for interaction")
         logger.info("=== INITIALIZATION SEQUENCE: 3. PARTICLE GENERATION ===")
@@ -289,6 +290,18 @@ final class ParticleViewModel {
         particleSystem?.startLightningStorm()
     }
 
+    func startSwarm() {
+        particleSystem?.startSwarm()
+    }
+
+    func setTouchAttractor(id: Int, location: CGPoint, repels: Bool) {
+        particleSystem?.setTouchAttractor(id: id, location: location, repels: repels)
+    }
+
+    func removeTouchAttractor(id: Int) {
+        particleSystem?.removeTouchAttractor(id: id)
+    }
+
     func startSimulation() {
         particleSystem?.startSimulation()
     }
@@ -317,6 +330,11 @@ final class ParticleViewModel {
         particleSystem?.handleDidBecomeActive()
     }
     
+    /// При перегреве рисуется префикс частиц — без повторной генерации
+    func handleThermalStateChange(_ state: ProcessInfo.ThermalState) {
+        particleSystem?.applyThermalState(state)
+    }
+    
     // MARK: - Render View Management
     
     func makeRenderView(frame: CGRect) -> RenderView {
@@ -21,6 +21,10 @@ final class ViewController: UIViewController, ParticleSystemLifecycleHandling {
         static let qualityScaleTransform: CGFloat = 1.1
         static let qualityLabelDismissDelay: TimeInterval = 3.0
         static let qualityFadeDuration: TimeInterval = 0.5
+        // Касание становится точкой притяжения, только когда это точно не тап:
+        // сдвиг дальше допуска или удержание дольше задержки
+        static let attractorActivationDistance: CGFloat = 12
+        static let attractorActivationDelay: TimeInterval = 0.3
     }
     
     private enum Messages {
@@ -37,6 +41,11 @@ final class ViewController: UIViewController, ParticleSystemLifecycleHandling {
     private var restartMessageLabel: UILabel?
     private var isFirstLayout = true
     private var memoryWarningObserver: NSObjectProtocol?
+    private var thermalStateObserver: NSObjectProtocol?
+    /// Активные касания → отталкивают ли они (первое касание притягивает)
+    private var attractorTouches: [ObjectIdentifier: Bool] = [:]
+    /// Касания, которые еще могут оказаться тапом для распознавателей
+    private var pendingAttractorTouches: [ObjectIdentifier: PendingAttractorTouch] = [:]
     
     // MARK: - Initialization
     
@@ -59,6 +68,7 @@ final class ViewController: UIViewController, ParticleSystemLifecycleHandling {
         setupGestures()
         setupViewModelCallbacks()
         setupMemoryWarningObserver()
+        setupThermalStateObserver()
         setNeedsStatusBarAppearanceUpdate()
     }
     
@@ -202,10 +212,25 @@ final class ViewController: UIViewController, ParticleSystemLifecycleHandling {
         }
     }
     
+    private func setupThermalStateObserver() {
+        thermalStateObserver = NotificationCenter.default.addObserver(
+            forName: ProcessInfo.thermalStateDidChangeNotification,
+            object: nil,
+            queue: .main
+        ) { [weak self] _ in
+            Task { @MainActor [weak self] in
+                self?.viewModel.handleThermalStateChange(ProcessInfo.processInfo.thermalState)
+            }
+        }
+    }
+    
     private func cleanupObservers() {
         if let observer = memoryWarningObserver {
             NotificationCenter.default.removeObserver(observer)
         }
+        if let observer = thermalStateObserver {
+            NotificationCenter.default.removeObserver(observer)
+        }
     }
     
     // MARK: - Layout
@@ -276,6 +301,7 @@ final class ViewController: UIViewController, ParticleSystemLifecycleHandling {
             tripleTap: tripleTap
         )
 
+        view.addGestureRecognizer(createTwoFingerTapGesture())
     }
     
     private func createTapGesture() -> UITapGestureRecognizer {
@@ -298,6 +324,13 @@ final class ViewController: UIViewController, ParticleSystemLifecycleHandling {
         return gesture
     }
     
+    private func createTwoFingerTapGesture() -> UITapGestureRecognizer {
+        let gesture = UITapGestureRecognizer(target: self, action: #selector(handleTwoFingerTap))
+        gesture.numberOfTouchesRequired = 2
+        gesture.delegate = self
+        return gesture
+    }
+    
     private func configureGestureRecognizers(
         tap: UITapGestureRecognizer,
         doubleTap: UITapGestureRecognizer,
@@ -340,6 +373,101 @@ final class ViewController: UIViewController, ParticleSystemLifecycleHandling {
         startRendering()
     }
     
+    @objc private func handleTwoFingerTap(_ gesture: UITapGestureRecognizer) {
+        guard gesture.state == .ended else { return }
+        
+        viewModel.startSwarm()
+        startRendering()
+    }
+    
+    // MARK: - Touch Attractors
+
+    override func touchesBegan(_ touches: Set<UITouch>, with event: UIEvent?) {
+        super.touchesBegan(touches, with: event)
+
+        // Тапы, двойные тапы и тап двумя пальцами забирают распознаватели — точка появляется
+        // только после сдвига или удержания, иначе каждый тап дергал бы частицы
+        for touch in touches where !isQualityControlTouch(touch) {
+            let key = ObjectIdentifier(touch)
+            let activation = DispatchWorkItem { [weak self] in
+                self?.activatePendingAttractor(key)
+            }
+            pendingAttractorTouches[key] = PendingAttractorTouch(
+                touch: touch,
+                startLocation: touch.location(in: view),
+                activation: activation
+            )
+            DispatchQueue.main.asyncAfter(deadline: .now() + Constants.attractorActivationDelay, execute: activation)
+        }
+    }
+
+    override func touchesMoved(_ touches: Set<UITouch>, with event: UIEvent?) {
+        super.touchesMoved(touches, with: event)
+
+        for touch in touches {
+            let key = ObjectIdentifier(touch)
+            if let pending = pendingAttractorTouches[key] {
+                let location = touch.location(in: view)
+                let distance = hypot(location.x - pending.startLocation.x, location.y - pending.startLocation.y)
+                if distance >= Constants.attractorActivationDistance {
+                    activatePendingAttractor(key)
+                }
+                continue
+            }
+            guard let repels = attractorTouches[key] else { continue }
+            updateTouchAttractor(touch, repels: repels)
+        }
+    }
+
+    override func touchesEnded(_ touches: Set<UITouch>, with event: UIEvent?) {
+        super.touchesEnded(touches, with: event)
+        removeTouchAttractors(touches)
+    }
+
+    override func touchesCancelled(_ touches: Set<UITouch>, with event: UIEvent?) {
+        super.touchesCancelled(touches, with: event)
+        // Сюда приходят и касания, которые забрал распознаватель (cancelsTouchesInView)
+        removeTouchAttractors(touches)
+    }
+
+    private func activatePendingAttractor(_ key: ObjectIdentifier) {
+        guard let pending = pendingAttractorTouches.removeValue(forKey: key) else { return }
+        pending.activation.cancel()
+
+        // Распознаватель уже признал касание своим — точку не создаем
+        let isClaimed = pending.touch.gestureRecognizers?.contains { recognizer in
+            recognizer.state == .began || recognizer.state == .changed || recognizer.state == .ended
+        } ?? false
+        guard !isClaimed, pending.touch.phase != .ended, pending.touch.phase != .cancelled else { return }
+
+        let repels = !attractorTouches.isEmpty
+        attractorTouches[key] = repels
+        updateTouchAttractor(pending.touch, repels: repels)
+    }
+
+    private func updateTouchAttractor(_ touch: UITouch, repels: Bool) {
+        let targetView = (renderView as? UIView) ?? view
+        viewModel.setTouchAttractor(
+            id: ObjectIdentifier(touch).hashValue,
+            location: touch.location(in: targetView),
+            repels: repels
+        )
+    }
+
+    private func removeTouchAttractors(_ touches: Set<UITouch>) {
+        for touch in touches {
+            let key = ObjectIdentifier(touch)
+            pendingAttractorTouches.removeValue(forKey: key)?.activation.cancel()
+            guard attractorTouches.removeValue(forKey: key) != nil else { continue }
+            viewModel.removeTouchAttractor(id: key.hashValue)
+        }
+    }
+
+    private func isQualityControlTouch(_ touch: UITouch) -> Bool {
+        guard let control = qualityControl, let touchedView = touch.view else { return false }
+        return touchedView.isDescendant(of: control)
+    }
+    
     private func performSystemReset() {
         viewModel.pauseRendering()
         viewModel.resetParticleSystem()
@@ -514,6 +642,15 @@ final class ViewController: UIViewController, ParticleSystemLifecycleHandling {
     }
 }
 
+// MARK: - PendingAttractorTouch
+
+/// Касание до решения «тап или точка притяжения»
+private struct PendingAttractorTouch {
+    let touch: UITouch
+    let startLocation: CGPoint
+    let activation: DispatchWorkItem
+}
+
 // MARK: - UIGestureRecognizerDelegate
 
 extension ViewController: UIGestureRecognizerDelegate {
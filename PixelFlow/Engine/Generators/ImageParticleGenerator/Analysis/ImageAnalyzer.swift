@@ -63,9 +63,21 @@ private struct AnalysisResult {
 
 final class DefaultImageAnalyzer: ImageAnalyzer, ImageAnalyzerProtocol {
 
+    private enum Constants {
+        // Результат — сотни байт, стоимость записи — удерживаемое изображение
+        static let analysisCacheCapacity = 128 * 1024 * 1024
+        static let analysisCacheShards = 2
+    }
+
     // Параметры производительности (для будущего расширения)
     private let config: PerformanceParams
 
+    /// Анализ зависит только от изображения: повторная генерация из того же CGImage его не повторяет
+    private let analysisCache = MemoryCache<ImageIdentityKey, ImageAnalysis>(
+        capacityBytes: Constants.analysisCacheCapacity,
+        shardCount: Constants.analysisCacheShards
+    )
+
     // MARK: - ImageAnalyzerProtocol
 
     var supportsSIMD: Bool { true }
@@ -83,6 +95,11 @@ final class DefaultImageAnalyzer: ImageAnalyzer, ImageAnalyzerProtocol {
             throw GeneratorError.invalidImage
         }
         
+        let key = ImageIdentityKey(image: image)
+        if let analysis = analysisCache.get(for: key) {
+            return analysis
+        }
+        
         // Даун‑сэмплинг (если изображение слишком велико)
         let downsampled = downsampleIfNeeded(image, maxDimension: 2048)
         
@@ -90,7 +107,7 @@ final class DefaultImageAnalyzer: ImageAnalyzer, ImageAnalyzerProtocol {
         let result = try performSinglePassAnalysis(downsampled)
         
         // Формируем финальный `ImageAnalysis`
-        return ImageAnalysis(
+        let analysis = ImageAnalysis(
             width: downsampled.width,
             height: downsampled.height,
             averageColor: result.averageColor,
@@ -103,6 +120,14 @@ final class DefaultImageAnalyzer: ImageAnalyzer, ImageAnalyzerProtocol {
             edgeDensity: result.edgeDensity,
             saturation: result.saturation
         )
+        analysisCache.set(
+            analysis,
+            for: key,
+            cost: MemoryLayout<ImageAnalysis>.stride
+                + analysis.dominantColors.count * MemoryLayout<SIMD3<Float>>.stride
+                + key.retainedBytes
+        )
+        return analysis
     }
     
     // MARK: Private helpers
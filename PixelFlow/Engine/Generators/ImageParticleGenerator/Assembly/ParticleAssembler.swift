@@ -107,6 +107,37 @@ final class DefaultParticleAssembler: ParticleAssembler, ParticleAssemblerProtoc
         }
     }
     
+    func assembleParticleChunk(
+        from samples: [Sample],
+        range: Range<Int>,
+        config: ParticleGenerationConfig,
+        screenSize: CGSize,
+        imageSize: CGSize,
+        originalImageSize: CGSize
+    ) -> [Particle] {
+        do {
+            try validateInputs(
+                samples: samples,
+                imageSize: imageSize,
+                screenSize: screenSize
+            )
+            let assemblyContext = makeAssemblyContext(
+                config: config,
+                screenSize: screenSize,
+                imageSize: imageSize,
+                originalImageSize: originalImageSize
+            )
+            let clamped = range.clamped(to: 0..<samples.count)
+            var particles: [Particle] = []
+            particles.reserveCapacity(clamped.count)
+            appendParticles(from: samples, range: clamped, context: assemblyContext, to: &particles)
+            return particles
+        } catch {
+            Logger.shared.error("Particle chunk assembly failed: \(error)")
+            return []
+        }
+    }
+    
     // MARK: - Internal Assembly
     
     private func assembleParticlesInternal(
@@ -123,6 +154,28 @@ final class DefaultParticleAssembler: ParticleAssembler, ParticleAssemblerProtoc
             screenSize: screenSize
         )
         
+        let assemblyContext = makeAssemblyContext(
+            config: config,
+            screenSize: screenSize,
+            imageSize: imageSize,
+            originalImageSize: originalImageSize
+        )
+        
+        let particles = generateParticles(
+            from: samples,
+            context: assemblyContext
+        )
+        
+        return particles
+    }
+    
+    /// Раскладка не зависит от порции: порции одного изображения собираются с одним контекстом
+    private func makeAssemblyContext(
+        config: ParticleGenerationConfig,
+        screenSize: CGSize,
+        imageSize: CGSize,
+        originalImageSize: CGSize
+    ) -> AssemblyContext {
         let displayMode = config.imageDisplayMode
         let isFullRes = isFullResolution(config: config, imageSize: imageSize)
         
@@ -133,20 +186,13 @@ final class DefaultParticleAssembler: ParticleAssembler, ParticleAssemblerProtoc
             snapToIntScale: isFullRes
         )
         
-        let assemblyContext = createAssemblyContext(
+        return createAssemblyContext(
             config: config,
             transformation: transformation,
             imageSize: imageSize,
             originalImageSize: originalImageSize,
             screenSize: screenSize
         )
-        
-        let particles = generateParticles(
-            from: samples,
-            context: assemblyContext
-        )
-        
-        return particles
     }
     
     // MARK: - Validation
@@ -405,6 +451,7 @@ final class DefaultParticleAssembler: ParticleAssembler, ParticleAssemblerProtoc
     
     // MARK: - Particle Generation
     
+    /// Собирает все сэмплы одним проходом; порции собирает assembleParticleChunk
     private func generateParticles(
         from samples: [Sample],
         context: AssemblyContext
@@ -412,17 +459,34 @@ final class DefaultParticleAssembler: ParticleAssembler, ParticleAssemblerProtoc
         
         var particles: [Particle] = []
         particles.reserveCapacity(samples.count)
-        
-        for (index, sample) in samples.enumerated() {
+        appendParticles(from: samples, range: 0..<samples.count, context: context, to: &particles)
+        return particles
+    }
+    
+    /// Частицы сэмплов range (индексы — глобальные) в конец particles
+    private func appendParticles(
+        from samples: [Sample],
+        range: Range<Int>,
+        context: AssemblyContext,
+        to particles: inout [Particle]
+    ) {
+        let firstIndex = particles.count
+        for index in range {
             let particle = createParticle(
-                from: sample,
+                from: samples[index],
                 index: index,
                 context: context
             )
             particles.append(particle)
         }
         
-        return particles
+        // Сэмплы хранят sRGB из PixelCache; фрагментный шейдер ждет linear
+        // (params.colorsLinear) — переводим один раз здесь, а не на каждый фрагмент
+        particles.withUnsafeMutableBytes { raw in
+            guard let base = raw.baseAddress else { return }
+            let chunk = base.assumingMemoryBound(to: ParticleC.self) + firstIndex
+            linearizeParticleColorsC(chunk, Int32(range.count))
+        }
     }
     
     @inline(__always)
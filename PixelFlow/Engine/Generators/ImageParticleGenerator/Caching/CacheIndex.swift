@@ -0,0 +1,113 @@
+//
+//  CacheIndex.swift
+//  PixelFlow
+//
+//  Индекс дискового кэша поверх журнала CacheIndexC.h: изменение — одна
+//  дозапись вместо перезаписи всего индекса, касание и вытеснение — O(1).
+//  Не потокобезопасен: DefaultCacheManager обращается к нему через свою очередь.
+//
+
+import Foundation
+
+final class CacheIndex {
+
+    typealias Entry = DefaultCacheManager.CacheEntry
+
+    // MARK: - Properties
+
+    private let index: OpaquePointer
+
+    var count: Int { Int(cacheIndexCountC(index)) }
+    var totalSize: Int { Int(cacheIndexTotalSizeC(index)) }
+
+    /// Самая давно использованная запись — первая на вытеснение
+    var oldest: Entry? {
+        var entry = CacheIndexEntryC()
+        guard cacheIndexOldestC(index, &entry) != 0 else { return nil }
+        return Self.makeEntry(entry)
+    }
+
+    /// Все записи от самой старой к самой свежей
+    var entries: [Entry] {
+        var result: [Entry] = []
+        withUnsafeMutablePointer(to: &result) { pointer in
+            cacheIndexForEachC(index, { entry, context in
+                guard let entry, let context else { return 0 }
+                context.assumingMemoryBound(to: [Entry].self).pointee.append(CacheIndex.makeEntry(entry.pointee))
+                return 1
+            }, pointer)
+        }
+        return result
+    }
+
+    // MARK: - Initialization
+
+    init?(url: URL) {
+        guard let index = url.withUnsafeFileSystemRepresentation({ path -> OpaquePointer? in
+            guard let path else { return nil }
+            return cacheIndexOpenC(path)
+        }) else {
+            return nil
+        }
+        self.index = index
+    }
+
+    deinit {
+        cacheIndexCloseC(index)
+    }
+
+    // MARK: - Access
+
+    func entry(for key: String) -> Entry? {
+        var entry = CacheIndexEntryC()
+        guard cacheIndexGetC(index, key, &entry) != 0 else { return nil }
+        return Self.makeEntry(entry)
+    }
+
+    func contains(_ key: String) -> Bool {
+        cacheIndexGetC(index, key, nil) != 0
+    }
+
+    /// Добавляет или заменяет запись; она становится самой свежей
+    @discardableResult
+    func put(_ entry: Entry) -> Bool {
+        cacheIndexPutC(
+            index,
+            entry.key,
+            entry.fileName,
+            Int64(entry.size),
+            entry.createdAt.timeIntervalSinceReferenceDate,
+            entry.lastAccessed.timeIntervalSinceReferenceDate
+        ) != 0
+    }
+
+    /// Обновляет время доступа; в журнал касания уходят пачками (CACHE_INDEX_TOUCH_BATCH)
+    func touch(_ key: String, at date: Date = Date()) {
+        cacheIndexTouchC(index, key, date.timeIntervalSinceReferenceDate)
+    }
+
+    func remove(_ key: String) {
+        cacheIndexRemoveC(index, key)
+    }
+
+    func clear() {
+        cacheIndexClearC(index)
+    }
+
+    /// Дописывает отложенные касания
+    func flush() {
+        cacheIndexFlushC(index)
+    }
+
+    // MARK: - Private Methods
+
+    private static func makeEntry(_ entry: CacheIndexEntryC) -> Entry {
+        Entry(
+            key: String(cString: entry.key),
+            fileName: String(cString: entry.fileName),
+            size: Int(entry.size),
+            createdAt: Date(timeIntervalSinceReferenceDate: entry.createdAt),
+            lastAccessed: Date(timeIntervalSinceReferenceDate: entry.lastAccessed)
+        )
+    }
+}
@@ -0,0 +1,580 @@
+//
+//  CacheIndexC.c
+//  PixelFlow
+//
+
+// strdup, fileno, ftruncate — POSIX: под -std=c11 без макроса не объявлены
+#define _POSIX_C_SOURCE 200809L
+
+#include "CacheIndexC.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+_Static_assert(sizeof(CacheIndexFileHeaderC) == 16, "Journal header layout is part of the file format");
+_Static_assert(sizeof(CacheIndexRecordHeaderC) == 12, "Record header layout is part of the file format");
+
+#define INDEX_INITIAL_BUCKETS   64u
+// Запись длиннее — заведомо мусор (ключ и имя файла — сотни байт)
+#define INDEX_MAX_PAYLOAD       (1u << 20)
+
+typedef struct CacheIndexEntry {
+    struct CacheIndexEntry* hashNext;
+    struct CacheIndexEntry* older;    // к началу LRU (вытесняется первой)
+    struct CacheIndexEntry* newer;
+    uint64_t hash;
+    int64_t size;
+    double createdAt;
+    double lastAccessed;
+    uint32_t keyLength;
+    uint32_t fileNameLength;
+    int touchPending;
+    char strings[];                   // key '\0' fileName '\0'
+} CacheIndexEntry;
+
+struct CacheIndexC {
+    FILE* journal;
+    char* path;
+
+    CacheIndexEntry** buckets;
+    uint64_t bucketCount;             // степень двойки
+    uint64_t count;
+    int64_t totalSize;
+
+    CacheIndexEntry* oldest;
+    CacheIndexEntry* newest;
+
+    uint32_t pendingTouches;          // столько самых свежих записей ждут TOUCH в журнале
+    uint64_t journalRecords;
+    int replaying;
+
+    uint8_t* scratch;                 // payload собираемой записи
+    size_t scratchCapacity;
+};
+
+static uint64_t hashBytes(const char* bytes, size_t length) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+static uint32_t checksumBytes(const uint8_t* bytes, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static inline const char* entryFileName(const CacheIndexEntry* entry) {
+    return entry->strings + entry->keyLength + 1;
+}
+
+static void fillEntry(const CacheIndexEntry* source, CacheIndexEntryC* entry) {
+    entry->key = source->strings;
+    entry->fileName = entryFileName(source);
+    entry->size = source->size;
+    entry->createdAt = source->createdAt;
+    entry->lastAccessed = source->lastAccessed;
+}
+
+// MARK: - LRU List
+
+static void unlinkEntry(CacheIndexC* index, CacheIndexEntry* entry) {
+    if (entry->older) entry->older->newer = entry->newer; else index->oldest = entry->newer;
+    if (entry->newer) entry->newer->older = entry->older; else index->newest = entry->older;
+    entry->older = entry->newer = NULL;
+}
+
+static void linkNewest(CacheIndexC* index, CacheIndexEntry* entry) {
+    entry->older = index->newest;
+    entry->newer = NULL;
+    if (index->newest) index->newest->newer = entry; else index->oldest = entry;
+    index->newest = entry;
+}
+
+// MARK: - Hash Table
+
+static CacheIndexEntry** findSlot(const CacheIndexC* index, const char* key, size_t keyLength, uint64_t hash) {
+    CacheIndexEntry** slot = &index->buckets[hash & (index->bucketCount - 1)];
+    while (*slot) {
+        const CacheIndexEntry* entry = *slot;
+        if (entry->hash == hash && entry->keyLength == keyLength && memcmp(entry->strings, key, keyLength) == 0) {
+            return slot;
+        }
+        slot = &(*slot)->hashNext;
+    }
+    return slot;
+}
+
+static CacheIndexEntry* findEntry(const CacheIndexC* index, const char* key, size_t keyLength) {
+    return *findSlot(index, key, keyLength, hashBytes(key, keyLength));
+}
+
+static int growBuckets(CacheIndexC* index) {
+    const uint64_t bucketCount = index->bucketCount * 2;
+    CacheIndexEntry** buckets = (CacheIndexEntry**)calloc((size_t)bucketCount, sizeof(CacheIndexEntry*));
+    if (!buckets) return 0;
+
+    for (uint64_t b = 0; b < index->bucketCount; b++) {
+        CacheIndexEntry* entry = index->buckets[b];
+        while (entry) {
+            CacheIndexEntry* next = entry->hashNext;
+            CacheIndexEntry** slot = &buckets[entry->hash & (bucketCount - 1)];
+            entry->hashNext = *slot;
+            *slot = entry;
+            entry = next;
+        }
+    }
+    free(index->buckets);
+    index->buckets = buckets;
+    index->bucketCount = bucketCount;
+    return 1;
+}
+
+static void detachEntry(CacheIndexC* index, CacheIndexEntry** slot) {
+    CacheIndexEntry* entry = *slot;
+    *slot = entry->hashNext;
+    unlinkEntry(index, entry);
+    if (entry->touchPending) index->pendingTouches--;
+    index->count--;
+    index->totalSize -= entry->size;
+    free(entry);
+}
+
+static void removeAllEntries(CacheIndexC* index) {
+    CacheIndexEntry* entry = index->oldest;
+    while (entry) {
+        CacheIndexEntry* next = entry->newer;
+        free(entry);
+        entry = next;
+    }
+    memset(index->buckets, 0, (size_t)index->bucketCount * sizeof(CacheIndexEntry*));
+    index->oldest = index->newest = NULL;
+    index->count = 0;
+    index->totalSize = 0;
+    index->pendingTouches = 0;
+}
+
+static int insertEntry(CacheIndexC* index, const char* key, size_t keyLength,
+                       const char* fileName, size_t fileNameLength,
+                       int64_t size, double createdAt, double lastAccessed) {
+    const uint64_t hash = hashBytes(key, keyLength);
+    CacheIndexEntry** slot = findSlot(index, key, keyLength, hash);
+    if (*slot) detachEntry(index, slot);
+
+    if (index->count + 1 > index->bucketCount) {
+        if (!growBuckets(index)) return 0;
+    }
+
+    CacheIndexEntry* entry = (CacheIndexEntry*)malloc(sizeof(CacheIndexEntry) + keyLength + fileNameLength + 2);
+    if (!entry) return 0;
+    memset(entry, 0, sizeof(*entry));
+    entry->hash = hash;
+    entry->size = size;
+    entry->createdAt = createdAt;
+    entry->lastAccessed = lastAccessed;
+    entry->keyLength = (uint32_t)keyLength;
+    entry->fileNameLength = (uint32_t)fileNameLength;
+    memcpy(entry->strings, key, keyLength);
+    entry->strings[keyLength] = '\0';
+    memcpy(entry->strings + keyLength + 1, fileName, fileNameLength);
+    entry->strings[keyLength + 1 + fileNameLength] = '\0';
+
+    slot = &index->buckets[hash & (index->bucketCount - 1)];
+    entry->hashNext = *slot;
+    *slot = entry;
+    linkNewest(index, entry);
+    index->count++;
+    index->totalSize += size;
+    return 1;
+}
+
+static void touchEntry(CacheIndexC* index, CacheIndexEntry* entry, double lastAccessed) {
+    entry->lastAccessed = lastAccessed;
+    if (index->newest != entry) {
+        unlinkEntry(index, entry);
+        linkNewest(index, entry);
+    }
+}
+
+// MARK: - Journal Records
+
+static uint8_t* reserveScratch(CacheIndexC* index, size_t length) {
+    if (length > index->scratchCapacity) {
+        uint8_t* scratch = (uint8_t*)realloc(index->scratch, length);
+        if (!scratch) return NULL;
+        index->scratch = scratch;
+        index->scratchCapacity = length;
+    }
+    return index->scratch;
+}
+
+static int writeRecord(FILE* file, uint32_t type, const uint8_t* payload, uint32_t payloadLength) {
+    const CacheIndexRecordHeaderC header = {
+        .type = type,
+        .payloadLength = payloadLength,
+        .checksum = checksumBytes(payload, payloadLength),
+    };
+    if (fwrite(&header, sizeof(header), 1, file) != 1) return 0;
+    return payloadLength == 0 || fwrite(payload, 1, payloadLength, file) == payloadLength;
+}
+
+/// Payload PUT в scratch; возвращает длину, 0 — нет памяти
+static uint32_t encodePut(CacheIndexC* index, const CacheIndexEntry* entry) {
+    const size_t length = sizeof(int64_t) + 2 * sizeof(double) + 2 * sizeof(uint32_t) +
+                          entry->keyLength + entry->fileNameLength;
+    uint8_t* p = reserveScratch(index, length);
+    if (!p) return 0;
+
+    memcpy(p, &entry->size, sizeof(int64_t)); p += sizeof(int64_t);
+    memcpy(p, &entry->createdAt, sizeof(double)); p += sizeof(double);
+    memcpy(p, &entry->lastAccessed, sizeof(double)); p += sizeof(double);
+    memcpy(p, &entry->keyLength, sizeof(uint32_t)); p += sizeof(uint32_t);
+    memcpy(p, &entry->fileNameLength, sizeof(uint32_t)); p += sizeof(uint32_t);
+    memcpy(p, entry->strings, entry->keyLength); p += entry->keyLength;
+    memcpy(p, entryFileName(entry), entry->fileNameLength);
+    return (uint32_t)length;
+}
+
+/// Payload TOUCH или REMOVE (withTime = 0) в scratch
+static uint32_t encodeKeyRecord(CacheIndexC* index, const char* key, uint32_t keyLength,
+                                int withTime, double lastAccessed) {
+    const size_t length = (withTime ? sizeof(double) : 0) + sizeof(uint32_t) + keyLength;
+    uint8_t* p = reserveScratch(index, length);
+    if (!p) return 0;
+
+    if (withTime) {
+        memcpy(p, &lastAccessed, sizeof(double));
+        p += sizeof(double);
+    }
+    memcpy(p, &keyLength, sizeof(uint32_t)); p += sizeof(uint32_t);
+    memcpy(p, key, keyLength);
+    return (uint32_t)length;
+}
+
+static int appendRecord(CacheIndexC* index, uint32_t type, uint32_t payloadLength) {
+    if (!writeRecord(index->journal, type, index->scratch, payloadLength)) return 0;
+    index->journalRecords++;
+    return 1;
+}
+
+static int flushPendingTouches(CacheIndexC* index) {
+    if (index->pendingTouches == 0) return 1;
+
+    // Ожидающие касания — ровно pendingTouches самых свежих записей:
+    // PUT/REMOVE/CLEAR сначала сбрасывают пачку. Пишем от старой к свежей
+    CacheIndexEntry* entry = index->newest;
+    for (uint32_t i = 1; i < index->pendingTouches && entry; i++) entry = entry->older;
+
+    int ok = 1;
+    for (; entry; entry = entry->newer) {
+        entry->touchPending = 0;
+        const uint32_t length = encodeKeyRecord(index, entry->strings, entry->keyLength, 1, entry->lastAccessed);
+        ok = ok && length > 0 && appendRecord(index, CACHE_INDEX_RECORD_TOUCH, length);
+    }
+    index->pendingTouches = 0;
+    return ok && fflush(index->journal) == 0;
+}
+
+static int writeJournalHeader(FILE* file) {
+    const CacheIndexFileHeaderC header = { .magic = CACHE_INDEX_MAGIC, .version = CACHE_INDEX_VERSION };
+    return fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+static void compactIfNeeded(CacheIndexC* index) {
+    if (index->journalRecords > CACHE_INDEX_COMPACT_FACTOR * index->count + CACHE_INDEX_COMPACT_MIN) {
+        cacheIndexCompactC(index);
+    }
+}
+
+// MARK: - Replay
+
+static int readU32(const uint8_t** p, const uint8_t* end, uint32_t* value) {
+    if ((size_t)(end - *p) < sizeof(*value)) return 0;
+    memcpy(value, *p, sizeof(*value));
+    *p += sizeof(*value);
+    return 1;
+}
+
+static int readF64(const uint8_t** p, const uint8_t* end, double* value) {
+    if ((size_t)(end - *p) < sizeof(*value)) return 0;
+    memcpy(value, *p, sizeof(*value));
+    *p += sizeof(*value);
+    return 1;
+}
+
+/// Применяет запись журнала к памяти. 0 — payload не разбирается
+static int applyRecord(CacheIndexC* index, uint32_t type, const uint8_t* payload, uint32_t length) {
+    const uint8_t* p = payload;
+    const uint8_t* end = payload + length;
+    uint32_t keyLength = 0;
+
+    switch (type) {
+    case CACHE_INDEX_RECORD_PUT: {
+        int64_t size;
+        double createdAt, lastAccessed;
+        uint32_t fileNameLength;
+        if ((size_t)(end - p) < sizeof(size)) return 0;
+        memcpy(&size, p, sizeof(size));
+        p += sizeof(size);
+        if (!readF64(&p, end, &createdAt) || !readF64(&p, end, &lastAccessed) ||
+            !readU32(&p, end, &keyLength) || !readU32(&p, end, &fileNameLength) ||
+            (uint64_t)keyLength + fileNameLength != (uint64_t)(end - p)) {
+            return 0;
+        }
+        return insertEntry(index, (const char*)p, keyLength, (const char*)p + keyLength, fileNameLength,
+                           size, createdAt, lastAccessed);
+    }
+    case CACHE_INDEX_RECORD_TOUCH: {
+        double lastAccessed;
+        if (!readF64(&p, end, &lastAccessed) || !readU32(&p, end, &keyLength) ||
+            keyLength != (uint64_t)(end - p)) {
+            return 0;
+        }
+        CacheIndexEntry* entry = findEntry(index, (const char*)p, keyLength);
+        if (entry) touchEntry(index, entry, lastAccessed);
+        return 1;
+    }
+    case CACHE_INDEX_RECORD_REMOVE: {
+        if (!readU32(&p, end, &keyLength) || keyLength != (uint64_t)(end - p)) return 0;
+        const char* key = (const char*)p;
+        CacheIndexEntry** slot = findSlot(index, key, keyLength, hashBytes(key, keyLength));
+        if (*slot) detachEntry(index, slot);
+        return 1;
+    }
+    case CACHE_INDEX_RECORD_CLEAR:
+        removeAllEntries(index);
+        return length == 0;
+    default:
+        return 0;
+    }
+}
+
+/// Воспроизводит журнал; возвращает смещение конца последней целой записи
+static long replayJournal(CacheIndexC* index) {
+    FILE* file = index->journal;
+    CacheIndexFileHeaderC fileHeader;
+    if (fseek(file, 0, SEEK_SET) != 0 ||
+        fread(&fileHeader, sizeof(fileHeader), 1, file) != 1 ||
+        fileHeader.magic != CACHE_INDEX_MAGIC ||
+        fileHeader.version != CACHE_INDEX_VERSION) {
+        return 0;
+    }
+
+    long goodOffset = (long)sizeof(fileHeader);
+    CacheIndexRecordHeaderC header;
+    while (fread(&header, sizeof(header), 1, file) == 1) {
+        if (header.payloadLength > INDEX_MAX_PAYLOAD) break;
+        uint8_t* payload = reserveScratch(index, header.payloadLength > 0 ? header.payloadLength : 1);
+        if (!payload) break;
+        if (header.payloadLength > 0 && fread(payload, 1, header.payloadLength, file) != header.payloadLength) break;
+        if (checksumBytes(payload, header.payloadLength) != header.checksum) break;
+        if (!applyRecord(index, header.type, payload, header.payloadLength)) break;
+
+        index->journalRecords++;
+        goodOffset += (long)(sizeof(header) + header.payloadLength);
+    }
+    return goodOffset;
+}
+
+// MARK: - Public Interface
+
+CacheIndexC* cacheIndexOpenC(const char* journalPath) {
+    if (!journalPath) return NULL;
+
+    CacheIndexC* index = (CacheIndexC*)calloc(1, sizeof(CacheIndexC));
+    if (!index) return NULL;
+    index->bucketCount = INDEX_INITIAL_BUCKETS;
+    index->buckets = (CacheIndexEntry**)calloc(INDEX_INITIAL_BUCKETS, sizeof(CacheIndexEntry*));
+    index->path = strdup(journalPath);
+    if (!index->buckets || !index->path) {
+        cacheIndexCloseC(index);
+        return NULL;
+    }
+
+    index->journal = fopen(journalPath, "r+b");
+    if (!index->journal) index->journal = fopen(journalPath, "w+b");
+    if (!index->journal) {
+        cacheIndexCloseC(index);
+        return NULL;
+    }
+
+    long goodOffset = replayJournal(index);
+    if (goodOffset == 0) {
+        // Пустой, чужой или другой версии — начинаем журнал заново
+        removeAllEntries(index);
+        index->journalRecords = 0;
+        if (fseek(index->journal, 0, SEEK_SET) != 0 || !writeJournalHeader(index->journal)) {
+            cacheIndexCloseC(index);
+            return NULL;
+        }
+        goodOffset = (long)sizeof(CacheIndexFileHeaderC);
+    }
+
+    // Оборванный хвост отрезаем: дозапись продолжится с последней целой записи
+    fflush(index->journal);
+    if (ftruncate(fileno(index->journal), goodOffset) != 0 ||
+        fseek(index->journal, goodOffset, SEEK_SET) != 0) {
+        cacheIndexCloseC(index);
+        return NULL;
+    }
+
+    compactIfNeeded(index);
+    return index;
+}
+
+void cacheIndexCloseC(CacheIndexC* index) {
+    if (!index) return;
+    if (index->journal) {
+        flushPendingTouches(index);
+        fclose(index->journal);
+    }
+    if (index->buckets) removeAllEntries(index);
+    free(index->buckets);
+    free(index->path);
+    free(index->scratch);
+    free(index);
+}
+
+int cacheIndexPutC(CacheIndexC* index, const char* key, const char* fileName,
+                   int64_t size, double createdAt, double lastAccessed) {
+    if (!index || !key || !fileName) return 0;
+    if (!flushPendingTouches(index)) return 0;
+
+    if (!insertEntry(index, key, strlen(key), fileName, strlen(fileName), size, createdAt, lastAccessed)) return 0;
+
+    const uint32_t length = encodePut(index, index->newest);
+    if (length == 0 || !appendRecord(index, CACHE_INDEX_RECORD_PUT, length) || fflush(index->journal) != 0) return 0;
+
+    compactIfNeeded(index);
+    return 1;
+}
+
+int cacheIndexGetC(const CacheIndexC* index, const char* key, CacheIndexEntryC* entry) {
+    if (!index || !key) return 0;
+    const CacheIndexEntry* found = findEntry(index, key, strlen(key));
+    if (!found) return 0;
+    if (entry) fillEntry(found, entry);
+    return 1;
+}
+
+int cacheIndexTouchC(CacheIndexC* index, const char* key, double lastAccessed) {
+    if (!index || !key) return 0;
+    CacheIndexEntry* entry = findEntry(index, key, strlen(key));
+    if (!entry) return 0;
+
+    // Повторное касание той же записи в пачке — без новой записи журнала
+    touchEntry(index, entry, lastAccessed);
+    if (!entry->touchPending) {
+        entry->touchPending = 1;
+        index->pendingTouches++;
+    }
+    if (index->pendingTouches >= CACHE_INDEX_TOUCH_BATCH) flushPendingTouches(index);
+    return 1;
+}
+
+int cacheIndexRemoveC(CacheIndexC* index, const char* key) {
+    if (!index || !key) return 0;
+    const size_t keyLength = strlen(key);
+    CacheIndexEntry** slot = findSlot(index, key, keyLength, hashBytes(key, keyLength));
+    if (!*slot) return 0;
+
+    flushPendingTouches(index);
+    // flush не меняет таблицу: slot все еще указывает на запись
+    detachEntry(index, slot);
+
+    const uint32_t length = encodeKeyRecord(index, key, (uint32_t)keyLength, 0, 0.0);
+    if (length > 0 && appendRecord(index, CACHE_INDEX_RECORD_REMOVE, length)) fflush(index->journal);
+
+    compactIfNeeded(index);
+    return 1;
+}
+
+void cacheIndexClearC(CacheIndexC* index) {
+    if (!index) return;
+    removeAllEntries(index);
+    // Журнал из одного заголовка: прежние записи не нужны.
+    // Не вышло переписать — хотя бы CLEAR в конец
+    if (!cacheIndexCompactC(index) && appendRecord(index, CACHE_INDEX_RECORD_CLEAR, 0)) {
+        fflush(index->journal);
+    }
+}
+
+int cacheIndexOldestC(const CacheIndexC* index, CacheIndexEntryC* entry) {
+    if (!index || !index->oldest) return 0;
+    if (entry) fillEntry(index->oldest, entry);
+    return 1;
+}
+
+void cacheIndexForEachC(const CacheIndexC* index,
+                        int (*visitor)(const CacheIndexEntryC* entry, void* context), void* context) {
+    if (!index || !visitor) return;
+    for (const CacheIndexEntry* entry = index->oldest; entry; entry = entry->newer) {
+        CacheIndexEntryC value;
+        fillEntry(entry, &value);
+        if (!visitor(&value, context)) return;
+    }
+}
+
+uint64_t cacheIndexCountC(const CacheIndexC* index) {
+    return index ? index->count : 0;
+}
+
+int64_t cacheIndexTotalSizeC(const CacheIndexC* index) {
+    return index ? index->totalSize : 0;
+}
+
+int cacheIndexFlushC(CacheIndexC* index) {
+    return index ? flushPendingTouches(index) : 0;
+}
+
+int cacheIndexCompactC(CacheIndexC* index) {
+    if (!index || !index->journal) return 0;
+
+    size_t pathLength = strlen(index->path);
+    char* temporaryPath = (char*)malloc(pathLength + 5);
+    if (!temporaryPath) return 0;
+    memcpy(temporaryPath, index->path, pathLength);
+    memcpy(temporaryPath + pathLength, ".tmp", 5);
+
+    // Снимок от старой записи к свежей: воспроизведение восстановит порядок LRU
+    FILE* file = fopen(temporaryPath, "w+b");
+    int ok = file != NULL && writeJournalHeader(file);
+    uint64_t records = 0;
+    for (CacheIndexEntry* entry = index->oldest; ok && entry; entry = entry->newer) {
+        const uint32_t length = encodePut(index, entry);
+        ok = length > 0 && writeRecord(file, CACHE_INDEX_RECORD_PUT, index->scratch, length);
+        records++;
+    }
+    ok = ok && fflush(file) == 0 && rename(temporaryPath, index->path) == 0;
+
+    if (!ok) {
+        if (file) fclose(file);
+        remove(temporaryPath);
+        free(temporaryPath);
+        return 0;
+    }
+    free(temporaryPath);
+
+    // Снимок уже содержит текущее время доступа — отложенные касания не нужны
+    for (CacheIndexEntry* entry = index->newest; entry && entry->touchPending; entry = entry->older) {
+        entry->touchPending = 0;
+    }
+    index->pendingTouches = 0;
+
+    fclose(index->journal);
+    index->journal = file;
+    index->journalRecords = records;
+    return 1;
+}
+
+uint64_t cacheIndexJournalRecordsC(const CacheIndexC* index) {
+    return index ? index->journalRecords : 0;
+}
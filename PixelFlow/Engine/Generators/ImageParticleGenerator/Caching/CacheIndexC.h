@@ -0,0 +1,115 @@
+//
+//  CacheIndexC.h
+//  PixelFlow
+//
+//  Индекс дискового кэша (DefaultCacheManager): записи в хеш-таблице,
+//  порядок LRU — двусвязный список (касание и вытеснение за O(1)).
+//  На диске — журнал только на дозапись: каждое изменение — одна запись
+//  в конце файла вместо перезаписи всего индекса. Касания (время доступа)
+//  копятся и пишутся пачкой; журнал периодически сжимается до снимка.
+//
+//  Журнал (little-endian, порядок байт устройства):
+//  - CacheIndexFileHeaderC
+//  - записи: CacheIndexRecordHeaderC + payload
+//    PUT:    int64 size, double createdAt, double lastAccessed,
+//            uint32 keyLength, uint32 fileNameLength, key, fileName
+//    TOUCH:  double lastAccessed, uint32 keyLength, key
+//    REMOVE: uint32 keyLength, key
+//    CLEAR:  пусто
+//  Порядок записей PUT/TOUCH — порядок LRU при воспроизведении.
+//  Хвост с неверной контрольной суммой (оборванная запись) отбрасывается.
+//
+
+#ifndef CacheIndexC_h
+#define CacheIndexC_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CACHE_INDEX_MAGIC          0x49434650u  // "PFCI"
+#define CACHE_INDEX_VERSION        1u
+
+#define CACHE_INDEX_RECORD_PUT     1u
+#define CACHE_INDEX_RECORD_TOUCH   2u
+#define CACHE_INDEX_RECORD_REMOVE  3u
+#define CACHE_INDEX_RECORD_CLEAR   4u
+
+/// Касаний в пачке: до стольких обновлений времени доступа может потеряться при падении
+#define CACHE_INDEX_TOUCH_BATCH    64
+/// Сжатие, когда записей журнала больше COMPACT_FACTOR × записей индекса + COMPACT_MIN
+#define CACHE_INDEX_COMPACT_FACTOR 4
+#define CACHE_INDEX_COMPACT_MIN    256
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t reserved[2];
+} CacheIndexFileHeaderC;
+
+typedef struct {
+    uint32_t type;            // CACHE_INDEX_RECORD_*
+    uint32_t payloadLength;
+    uint32_t checksum;        // FNV-1a payload
+} CacheIndexRecordHeaderC;
+
+/// Запись индекса. Строки принадлежат индексу и живут до следующего изменения
+typedef struct {
+    const char* key;
+    const char* fileName;
+    int64_t size;
+    double createdAt;         // секунды (Date.timeIntervalSinceReferenceDate)
+    double lastAccessed;
+} CacheIndexEntryC;
+
+typedef struct CacheIndexC CacheIndexC;
+
+/// Открывает журнал (создает, если нет) и воспроизводит его.
+/// NULL — файл недоступен или нет памяти
+CacheIndexC* cacheIndexOpenC(const char* journalPath);
+
+/// Дописывает отложенные касания и закрывает журнал
+void cacheIndexCloseC(CacheIndexC* index);
+
+/// Добавляет или заменяет запись (самая свежая в LRU). 0 — ошибка записи журнала
+int cacheIndexPutC(CacheIndexC* index, const char* key, const char* fileName,
+                   int64_t size, double createdAt, double lastAccessed);
+
+/// Запись по ключу без касания. 0 — нет записи
+int cacheIndexGetC(const CacheIndexC* index, const char* key, CacheIndexEntryC* entry);
+
+/// Делает запись самой свежей; в журнал — пачкой. 0 — нет записи
+int cacheIndexTouchC(CacheIndexC* index, const char* key, double lastAccessed);
+
+/// Удаляет запись. 0 — нет записи
+int cacheIndexRemoveC(CacheIndexC* index, const char* key);
+
+void cacheIndexClearC(CacheIndexC* index);
+
+/// Самая давно использованная запись (кандидат на вытеснение). 0 — индекс пуст
+int cacheIndexOldestC(const CacheIndexC* index, CacheIndexEntryC* entry);
+
+/// Записи от самой старой к самой свежей: visitor возвращает 0, чтобы остановить обход
+void cacheIndexForEachC(const CacheIndexC* index,
+                        int (*visitor)(const CacheIndexEntryC* entry, void* context), void* context);
+
+uint64_t cacheIndexCountC(const CacheIndexC* index);
+int64_t cacheIndexTotalSizeC(const CacheIndexC* index);
+
+/// Дописывает отложенные касания. 0 — ошибка записи журнала
+int cacheIndexFlushC(CacheIndexC* index);
+
+/// Переписывает журнал снимком текущих записей (временный файл + rename).
+/// Вызывается и сам, когда журнал разрастается. 0 — ошибка
+int cacheIndexCompactC(CacheIndexC* index);
+
+/// Записей в журнале (для замеров и решения о сжатии)
+uint64_t cacheIndexJournalRecordsC(const CacheIndexC* index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CacheIndexC_h */
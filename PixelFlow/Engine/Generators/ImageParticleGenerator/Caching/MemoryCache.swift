@@ -0,0 +1,138 @@
+//
+//  MemoryCache.swift
+//  PixelFlow
+//
+//  Кэш в памяти поверх ShardedLRUCacheC.h: шарды со своими блокировками,
+//  емкость в байтах (стоимость задает вызывающий), get/set — O(1).
+//  Потокобезопасен.
+//
+
+import CoreGraphics
+import Foundation
+
+/// Значения кэша — Swift-объекты (Entry); C-часть владеет ими через retain/release
+private let memoryCacheCallbacks = ShardedLRUCallbacksC(
+    retain: { value in
+        guard let value else { return }
+        _ = Unmanaged<AnyObject>.fromOpaque(value).retain()
+    },
+    release: { value in
+        guard let value else { return }
+        Unmanaged<AnyObject>.fromOpaque(value).release()
+    }
+)
+
+final class MemoryCache<Key: Hashable, Value> {
+
+    struct Statistics {
+        let hits: Int
+        let misses: Int
+        let insertions: Int
+        let evictions: Int
+        let rejections: Int
+        let count: Int
+        let bytes: Int
+        let capacityBytes: Int
+
+        var hitRate: Double {
+            hits + misses > 0 ? Double(hits) / Double(hits + misses) : 0
+        }
+    }
+
+    /// Ключ хранится целиком: в C-часть уходит только 64-битный хеш,
+    /// при совпадении хешей разных ключей get вернет промах, а не чужое значение
+    private final class Entry {
+        let key: Key
+        let value: Value
+
+        init(key: Key, value: Value) {
+            self.key = key
+            self.value = value
+        }
+    }
+
+    // MARK: - Properties
+
+    /// nil — не хватило памяти на шарды: кэш ничего не хранит
+    private let cache: OpaquePointer?
+
+    var statistics: Statistics {
+        var stats = ShardedLRUStatsC()
+        if let cache { shardedLRUStatsC(cache, &stats) }
+        return Statistics(
+            hits: Int(stats.hits),
+            misses: Int(stats.misses),
+            insertions: Int(stats.insertions),
+            evictions: Int(stats.evictions),
+            rejections: Int(stats.rejections),
+            count: Int(stats.count),
+            bytes: Int(stats.bytes),
+            capacityBytes: Int(stats.capacityBytes)
+        )
+    }
+
+    // MARK: - Initialization
+
+    /// Емкость делится между шардами поровну: значение дороже capacityBytes / shardCount
+    /// не сохраняется. Для немногих крупных значений шардов нужно меньше
+    init(capacityBytes: Int, shardCount: Int = Int(SHARDED_LRU_DEFAULT_SHARDS)) {
+        cache = shardedLRUCreateC(UInt32(clamping: max(shardCount, 1)), Int64(capacityBytes), memoryCacheCallbacks)
+        if cache == nil {
+            Logger.shared.warning("MemoryCache: failed to allocate \(shardCount) shards, caching disabled")
+        }
+    }
+
+    deinit {
+        shardedLRUDestroyC(cache)
+    }
+
+    // MARK: - Access
+
+    /// cost — байты, которые удерживает значение. false — значение дороже емкости шарда
+    @discardableResult
+    func set(_ value: Value, for key: Key, cost: Int) -> Bool {
+        guard let cache else { return false }
+        let entry = Unmanaged.passRetained(Entry(key: key, value: value))
+        return shardedLRUPutC(cache, Self.hash(key), entry.toOpaque(), Int64(cost)) != 0
+    }
+
+    func get(for key: Key) -> Value? {
+        guard let cache, let pointer = shardedLRUGetC(cache, Self.hash(key)) else { return nil }
+        let entry = Unmanaged<Entry>.fromOpaque(pointer).takeRetainedValue()
+        return entry.key == key ? entry.value : nil
+    }
+
+    func remove(for key: Key) {
+        guard let cache else { return }
+        shardedLRURemoveC(cache, Self.hash(key))
+    }
+
+    func clear() {
+        guard let cache else { return }
+        shardedLRUClearC(cache)
+    }
+
+    // MARK: - Private Methods
+
+    private static func hash(_ key: Key) -> UInt64 {
+        UInt64(bitPattern: Int64(key.hashValue))
+    }
+}
+
+/// Ключ по идентичности изображения: одно и то же CGImage дает попадание без
+/// хеширования пикселей. Ключ удерживает изображение, поэтому адрес не может
+/// достаться другому изображению, пока запись в кэше
+struct ImageIdentityKey: Hashable {
+    let image: CGImage
+
+    /// Байты, которые удерживает ключ (изображение) — входят в стоимость записи
+    var retainedBytes: Int { image.bytesPerRow * image.height }
+
+    static func == (lhs: ImageIdentityKey, rhs: ImageIdentityKey) -> Bool {
+        lhs.image === rhs.image
+    }
+
+    func hash(into hasher: inout Hasher) {
+        hasher.combine(ObjectIdentifier(image))
+    }
+}
@@ -0,0 +1,136 @@
+//
+//  ParticleCacheFile.swift
+//  PixelFlow
+//
+//  Бинарный кэш частиц (ParticleCacheFileC.h): запись массива частиц
+//  как есть или квантованными столбцами и чтение через mmap — без
+//  JSON-кодирования SIMD-полей.
+//
+
+import Foundation
+import Metal
+
+enum ParticleCacheFileError: Error {
+    case io
+    case format
+    case checksum
+
+    init(status: Int32) {
+        switch status {
+        case PARTICLE_CACHE_ERROR_FORMAT: self = .format
+        case PARTICLE_CACHE_ERROR_CHECKSUM: self = .checksum
+        default: self = .io
+        }
+    }
+}
+
+/// Кодировка payload файла кэша
+enum ParticleCacheEncoding {
+    /// Частицы как есть: отображение отдается GPU без копии
+    case raw
+    /// 12–24 байта на частицу вместо 96: позиции и скорости квантованы
+    /// (ошибка позиции — сотые доли пикселя), цвета 8-битные без потерь.
+    /// Частицы не из генератора пишутся как raw
+    case quantized
+
+    var fileValue: UInt32 {
+        switch self {
+        case .raw: return PARTICLE_CACHE_ENCODING_RAW
+        case .quantized: return PARTICLE_CACHE_ENCODING_QUANTIZED
+        }
+    }
+}
+
+enum ParticleCacheFile {
+
+    /// Пишет частицы в url (атомарно); возвращает размер файла в байтах
+    static func write(_ particles: [Particle], to url: URL, encoding: ParticleCacheEncoding) throws -> Int {
+        guard MemoryLayout<Particle>.stride == MemoryLayout<ParticleC>.stride else {
+            throw ParticleCacheFileError.format
+        }
+
+        var fileSize: UInt64 = 0
+        let status = particles.withUnsafeBytes { bytes in
+            url.withUnsafeFileSystemRepresentation { path -> Int32 in
+                guard let path else { return PARTICLE_CACHE_ERROR_IO }
+                return particleCacheWriteC(path, bytes.baseAddress, UInt64(particles.count), encoding.fileValue, &fileSize)
+            }
+        }
+        guard status == PARTICLE_CACHE_OK else { throw ParticleCacheFileError(status: status) }
+        return Int(fileSize)
+    }
+}
+
+/// Отображенный файл кэша. Память копируется только при записи (MAP_PRIVATE),
+/// файл на диске не меняется; отображение живет, пока жив объект
+final class ParticleCacheMapping {
+
+    // MARK: - Properties
+
+    let url: URL
+    private var mapping = ParticleCacheMappingC()
+
+    var count: Int { Int(mapping.particleCount) }
+
+    /// Payload — частицы как есть (их можно отдать GPU без копии)
+    var isRaw: Bool { mapping.particles != nil }
+
+    // MARK: - Initialization
+
+    /// verifyChecksum — проверить payload целиком (читает весь файл)
+    init(url: URL, verifyChecksum: Bool) throws {
+        guard MemoryLayout<Particle>.stride == MemoryLayout<ParticleC>.stride else {
+            throw ParticleCacheFileError.format
+        }
+
+        self.url = url
+        var result = ParticleCacheMappingC()
+        let status = url.withUnsafeFileSystemRepresentation { path -> Int32 in
+            guard let path else { return PARTICLE_CACHE_ERROR_IO }
+            return particleCacheMapC(path, verifyChecksum ? 1 : 0, &result)
+        }
+        guard status == PARTICLE_CACHE_OK else { throw ParticleCacheFileError(status: status) }
+        mapping = result
+    }
+
+    deinit {
+        particleCacheUnmapC(&mapping)
+    }
+
+    // MARK: - Access
+
+    /// Первые prefix частиц массивом (прогрессивный порядок: префикс — уровень детализации).
+    /// Квантованный payload декодируется только блоками префикса; пустой массив — блоки повреждены
+    func copyParticles(prefix: Int) -> [Particle] {
+        let copyCount = min(max(prefix, 0), count)
+        guard copyCount > 0 else { return [] }
+
+        return [Particle](unsafeUninitializedCapacity: copyCount) { buffer, initializedCount in
+            let status = particleCacheDecodeC(&mapping, UInt64(copyCount), buffer.baseAddress)
+            initializedCount = status == PARTICLE_CACHE_OK ? copyCount : 0
+        }
+    }
+
+    /// Shared-буфер со всеми частицами. Raw — поверх отображения без копии
+    /// (payload выровнен по странице), буфер удерживает отображение до своего
+    /// освобождения; квантованный payload декодируется в новый буфер
+    func makeBuffer(device: MTLDevice) -> MTLBuffer? {
+        guard count > 0 else { return nil }
+
+        guard let base = mapping.particles else {
+            guard let buffer = device.makeBuffer(length: count * MemoryLayout<Particle>.stride,
+                                                 options: .storageModeShared) else { return nil }
+            let status = particleCacheDecodeC(&mapping, UInt64(count), buffer.contents())
+            return status == PARTICLE_CACHE_OK ? buffer : nil
+        }
+
+        return device.makeBuffer(
+            bytesNoCopy: base,
+            length: Int(mapping.payloadLength),
+            options: .storageModeShared,
+            deallocator: { _, _ in
+                withExtendedLifetime(self) {}
+            }
+        )
+    }
+}
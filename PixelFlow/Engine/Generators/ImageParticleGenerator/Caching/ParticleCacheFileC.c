@@ -0,0 +1,584 @@
+//
+//  ParticleCacheFileC.c
+//  PixelFlow
+//
+
+#include "ParticleCacheFileC.h"
+
+#include <fcntl.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../../../ParticleSystem/Particles/ColorSpaceC.h"
+#include "../../../ParticleSystem/Particles/SimulationStepC.h"
+
+_Static_assert(sizeof(ParticleCacheHeaderC) <= PARTICLE_CACHE_PAGE_SIZE,
+               "Header must fit before the first payload page");
+_Static_assert(sizeof(ParticleCacheHeaderC) == 80, "Header layout is part of the file format");
+
+typedef float CacheVec4 __attribute__((vector_size(16)));
+
+// Допуск проверки 8-битного цвета: значения сборщика — запись таблицы sRGB→linear
+// с точностью до интерполяции srgbToLinearLUTC (порядка 1e-7)
+#define QUANTIZED_COLOR_TOLERANCE  1e-5f
+#define QUANTIZED_POSITION_LEVELS  65535.0f
+#define QUANTIZED_VELOCITY_LEVELS  32767.0f
+
+// Константы раунда контрольной суммы (простые числа xxHash64)
+#define CHECKSUM_PRIME_1  0x9E3779B185EBCA87ull
+#define CHECKSUM_PRIME_2  0xC2B2AE3D27D4EB4Full
+#define CHECKSUM_PRIME_3  0x165667B19E3779F9ull
+#define CHECKSUM_PRIME_4  0x85EBCA77C2B2AE63ull
+
+static inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint64_t checksumRound(uint64_t accumulator, uint64_t word) {
+    accumulator += word * CHECKSUM_PRIME_2;
+    accumulator = rotateLeft(accumulator, 31);
+    return accumulator * CHECKSUM_PRIME_1;
+}
+
+static inline uint64_t loadWord(const uint8_t* p) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+static inline uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+uint32_t particleCacheLayoutHashC(void) {
+    const uint32_t layout[] = {
+        (uint32_t)sizeof(ParticleC),
+        (uint32_t)offsetof(ParticleC, position),
+        (uint32_t)offsetof(ParticleC, velocity),
+        (uint32_t)offsetof(ParticleC, targetPosition),
+        (uint32_t)offsetof(ParticleC, color),
+        (uint32_t)offsetof(ParticleC, originalColor),
+        (uint32_t)offsetof(ParticleC, size),
+        (uint32_t)offsetof(ParticleC, baseSize),
+        (uint32_t)offsetof(ParticleC, life),
+        (uint32_t)offsetof(ParticleC, idleChaoticMotion),
+    };
+
+    // FNV-1a по байтам описания раскладки
+    uint32_t hash = 2166136261u;
+    const uint8_t* bytes = (const uint8_t*)layout;
+    for (size_t i = 0; i < sizeof(layout); i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+uint64_t particleCacheChecksumC(const void* data, uint64_t size) {
+    if (!data && size > 0) return 0;
+
+    const uint8_t* p = (const uint8_t*)data;
+    const uint8_t* end = p + size;
+    uint64_t hash;
+
+    if (size >= 32) {
+        uint64_t lane0 = CHECKSUM_PRIME_1 + CHECKSUM_PRIME_2;
+        uint64_t lane1 = CHECKSUM_PRIME_2;
+        uint64_t lane2 = 0;
+        uint64_t lane3 = 0 - CHECKSUM_PRIME_1;
+        const uint8_t* limit = end - 32;
+        do {
+            lane0 = checksumRound(lane0, loadWord(p));
+            lane1 = checksumRound(lane1, loadWord(p + 8));
+            lane2 = checksumRound(lane2, loadWord(p + 16));
+            lane3 = checksumRound(lane3, loadWord(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        hash = rotateLeft(lane0, 1) + rotateLeft(lane1, 7) + rotateLeft(lane2, 12) + rotateLeft(lane3, 18);
+        const uint64_t lanes[4] = { lane0, lane1, lane2, lane3 };
+        for (int i = 0; i < 4; i++) {
+            hash ^= checksumRound(0, lanes[i]);
+            hash = hash * CHECKSUM_PRIME_1 + CHECKSUM_PRIME_4;
+        }
+    } else {
+        hash = CHECKSUM_PRIME_3;
+    }
+
+    hash += size;
+    for (; p + 8 <= end; p += 8) {
+        hash ^= checksumRound(0, loadWord(p));
+        hash = rotateLeft(hash, 27) * CHECKSUM_PRIME_1 + CHECKSUM_PRIME_4;
+    }
+    for (; p < end; p++) {
+        hash ^= (uint64_t)(*p) * CHECKSUM_PRIME_3;
+        hash = rotateLeft(hash, 11) * CHECKSUM_PRIME_1;
+    }
+
+    // Перемешивание хвоста
+    hash ^= hash >> 33;
+    hash *= CHECKSUM_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= CHECKSUM_PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+// MARK: - Quantized Encoding
+
+static const uint32_t columnSizes[PARTICLE_CACHE_COLUMN_COUNT] = { 2, 2, 2, 2, 4, 4, 4, 4 };
+
+typedef struct {
+    float positionMin[2];
+    float positionMax[2];
+    float velocityMaxAbs;
+} QuantizedBounds;
+
+/// Частицы генератора: производные поля совпадают с исходными, z = 0.
+/// Заодно границы позиций и скоростей для сетки квантования
+static int collectQuantizedBounds(const ParticleC* particles, uint64_t count, QuantizedBounds* bounds) {
+    bounds->positionMin[0] = bounds->positionMin[1] = INFINITY;
+    bounds->positionMax[0] = bounds->positionMax[1] = -INFINITY;
+    bounds->velocityMaxAbs = 0.0f;
+
+    for (uint64_t i = 0; i < count; i++) {
+        const ParticleC* p = &particles[i];
+        if (!isfinite(p->position[0]) || !isfinite(p->position[1]) || p->position[2] != 0.0f) return 0;
+        if (!isfinite(p->velocity[0]) || !isfinite(p->velocity[1]) || p->velocity[2] != 0.0f) return 0;
+        if (memcmp(p->targetPosition, p->position, 3 * sizeof(float)) != 0) return 0;
+        if (memcmp(p->originalColor, p->color, sizeof(p->color)) != 0) return 0;
+        if (p->baseSize != p->size) return 0;
+
+        for (int axis = 0; axis < 2; axis++) {
+            bounds->positionMin[axis] = fminf(bounds->positionMin[axis], p->position[axis]);
+            bounds->positionMax[axis] = fmaxf(bounds->positionMax[axis], p->position[axis]);
+            bounds->velocityMaxAbs = fmaxf(bounds->velocityMaxAbs, fabsf(p->velocity[axis]));
+        }
+    }
+    return 1;
+}
+
+/// RGBA8 цвета: rgb — sRGB-коды, a — a·255. 0 — цвет не 8-битный
+static int packColor(const float* color, uint32_t* packed) {
+    uint32_t value = 0;
+    for (int c = 0; c < 3; c++) {
+        const uint8_t code = linearToSrgb8C(color[c]);
+        if (!(fabsf(srgb8ToLinearC(code) - color[c]) <= QUANTIZED_COLOR_TOLERANCE)) return 0;
+        value |= (uint32_t)code << (8 * c);
+    }
+    if (!(color[3] >= 0.0f && color[3] <= 1.0f)) return 0;
+    const uint32_t alpha = (uint32_t)lrintf(color[3] * 255.0f);
+    if (!(fabsf((float)alpha / 255.0f - color[3]) <= QUANTIZED_COLOR_TOLERANCE)) return 0;
+    *packed = value | (alpha << 24);
+    return 1;
+}
+
+static inline uint16_t quantizeUnsigned(float value, float origin, float step) {
+    if (step <= 0.0f) return 0;
+    const float q = rintf((value - origin) / step);
+    return (uint16_t)(q < 0.0f ? 0.0f : (q > QUANTIZED_POSITION_LEVELS ? QUANTIZED_POSITION_LEVELS : q));
+}
+
+static inline int16_t quantizeSigned(float value, float step) {
+    if (step <= 0.0f) return 0;
+    const float q = rintf(value / step);
+    return (int16_t)(q < -QUANTIZED_VELOCITY_LEVELS ? -QUANTIZED_VELOCITY_LEVELS
+                                                    : (q > QUANTIZED_VELOCITY_LEVELS ? QUANTIZED_VELOCITY_LEVELS : q));
+}
+
+/// Столбец в out: одно значение, если все равны (бит в constantMask), иначе все.
+/// Возвращает записанные байты с выравниванием до 4
+static uint64_t emitColumn(uint8_t* out, const void* values, uint32_t count, int column, uint32_t* constantMask) {
+    const uint32_t size = columnSizes[column];
+    const uint8_t* bytes = (const uint8_t*)values;
+
+    uint32_t i = 1;
+    while (i < count && memcmp(bytes + (size_t)i * size, bytes, size) == 0) i++;
+    const uint32_t written = i == count ? 1 : count;
+    if (written == 1) *constantMask |= 1u << column;
+
+    const uint64_t length = (uint64_t)written * size;
+    memcpy(out, bytes, (size_t)length);
+    const uint64_t padded = alignUp(length, 4);
+    memset(out + length, 0, (size_t)(padded - length));
+    return padded;
+}
+
+/// Собирает payload QUANTIZED и поля сетки в header;
+/// 0 — частицы не подходят под кодировку (или нет памяти), header не тронут
+static int encodeQuantized(const ParticleC* particles, uint64_t count, ParticleCacheHeaderC* output,
+                           uint8_t** payload, uint64_t* payloadSize) {
+    QuantizedBounds bounds;
+    if (!collectQuantizedBounds(particles, count, &bounds)) return 0;
+
+    const uint64_t blockCount = (count + PARTICLE_CACHE_BLOCK_PARTICLES - 1) / PARTICLE_CACHE_BLOCK_PARTICLES;
+    const uint64_t tableSize = (blockCount + 1) * sizeof(uint64_t);
+    uint64_t columnsSize = 0;
+    for (int column = 0; column < PARTICLE_CACHE_COLUMN_COUNT; column++) {
+        columnsSize += alignUp((uint64_t)PARTICLE_CACHE_BLOCK_PARTICLES * columnSizes[column], 4);
+    }
+    const uint64_t capacity = tableSize + blockCount * (2 * sizeof(uint32_t) + columnsSize);
+
+    uint8_t* buffer = (uint8_t*)malloc((size_t)capacity);
+    uint8_t* scratch = (uint8_t*)malloc((size_t)PARTICLE_CACHE_BLOCK_PARTICLES * 4);
+    if (!buffer || !scratch) {
+        free(buffer);
+        free(scratch);
+        return 0;
+    }
+
+    ParticleCacheHeaderC quantized = *output;
+    ParticleCacheHeaderC* header = &quantized;
+    float positionStep[2];
+    for (int axis = 0; axis < 2; axis++) {
+        positionStep[axis] = count > 0 ? (bounds.positionMax[axis] - bounds.positionMin[axis]) / QUANTIZED_POSITION_LEVELS : 0.0f;
+        header->positionOrigin[axis] = count > 0 ? bounds.positionMin[axis] : 0.0f;
+        header->positionStep[axis] = positionStep[axis];
+    }
+    header->velocityStep = bounds.velocityMaxAbs / QUANTIZED_VELOCITY_LEVELS;
+    header->blockParticles = PARTICLE_CACHE_BLOCK_PARTICLES;
+
+    uint64_t* offsets = (uint64_t*)buffer;
+    uint64_t cursor = tableSize;
+    int ok = 1;
+
+    for (uint64_t block = 0; block < blockCount && ok; block++) {
+        const uint64_t first = block * PARTICLE_CACHE_BLOCK_PARTICLES;
+        const uint32_t n = (uint32_t)(count - first < PARTICLE_CACHE_BLOCK_PARTICLES ? count - first : PARTICLE_CACHE_BLOCK_PARTICLES);
+        const ParticleC* p = particles + first;
+
+        offsets[block] = cursor;
+        uint8_t* blockStart = buffer + cursor;
+        uint32_t constantMask = 0;
+        cursor += 2 * sizeof(uint32_t);
+
+        for (int column = 0; column < PARTICLE_CACHE_COLUMN_COUNT && ok; column++) {
+            for (uint32_t i = 0; i < n; i++) {
+                switch (column) {
+                case PARTICLE_CACHE_COLUMN_POSITION_X:
+                case PARTICLE_CACHE_COLUMN_POSITION_Y: {
+                    const int axis = column - PARTICLE_CACHE_COLUMN_POSITION_X;
+                    ((uint16_t*)scratch)[i] = quantizeUnsigned(p[i].position[axis], header->positionOrigin[axis], positionStep[axis]);
+                    break;
+                }
+                case PARTICLE_CACHE_COLUMN_VELOCITY_X:
+                case PARTICLE_CACHE_COLUMN_VELOCITY_Y:
+                    ((int16_t*)scratch)[i] = quantizeSigned(p[i].velocity[column - PARTICLE_CACHE_COLUMN_VELOCITY_X], header->velocityStep);
+                    break;
+                case PARTICLE_CACHE_COLUMN_COLOR:
+                    ok = ok && packColor(p[i].color, &((uint32_t*)scratch)[i]);
+                    break;
+                case PARTICLE_CACHE_COLUMN_SIZE:
+                    memcpy(scratch + 4 * i, &p[i].size, 4);
+                    break;
+                case PARTICLE_CACHE_COLUMN_LIFE:
+                    memcpy(scratch + 4 * i, &p[i].life, 4);
+                    break;
+                default:
+                    memcpy(scratch + 4 * i, &p[i].idleChaoticMotion, 4);
+                    break;
+                }
+            }
+            if (ok) cursor += emitColumn(buffer + cursor, scratch, n, column, &constantMask);
+        }
+
+        memcpy(blockStart, &n, sizeof(n));
+        memcpy(blockStart + sizeof(n), &constantMask, sizeof(constantMask));
+    }
+    offsets[blockCount] = cursor;
+    free(scratch);
+
+    if (!ok) {
+        free(buffer);
+        return 0;
+    }
+    header->encoding = PARTICLE_CACHE_ENCODING_QUANTIZED;
+    *output = quantized;
+    *payload = buffer;
+    *payloadSize = cursor;
+    return 1;
+}
+
+// MARK: - Write
+
+static int writeZeros(FILE* file, uint64_t count) {
+    static const uint8_t zeros[PARTICLE_CACHE_PAGE_SIZE];
+    while (count > 0) {
+        size_t chunk = count < sizeof(zeros) ? (size_t)count : sizeof(zeros);
+        if (fwrite(zeros, 1, chunk, file) != chunk) return 0;
+        count -= chunk;
+    }
+    return 1;
+}
+
+int particleCacheWriteC(const char* path, const void* particles, uint64_t count,
+                        uint32_t encoding, uint64_t* fileSize) {
+    if (!path || (!particles && count > 0)) return PARTICLE_CACHE_ERROR_IO;
+    if (count > UINT64_MAX / sizeof(ParticleC)) return PARTICLE_CACHE_ERROR_IO;
+
+    ParticleCacheHeaderC header = {
+        .magic = PARTICLE_CACHE_MAGIC,
+        .version = PARTICLE_CACHE_VERSION,
+        .headerSize = (uint32_t)sizeof(ParticleCacheHeaderC),
+        .layoutHash = particleCacheLayoutHashC(),
+        .particleStride = (uint32_t)sizeof(ParticleC),
+        .encoding = PARTICLE_CACHE_ENCODING_RAW,
+        .particleCount = count,
+        .payloadOffset = alignUp(sizeof(ParticleCacheHeaderC), PARTICLE_CACHE_PAGE_SIZE),
+    };
+
+    // Частицы не из генератора (encodeQuantized отказал) пишутся без потерь
+    const void* payload = particles;
+    uint64_t payloadSize = count * sizeof(ParticleC);
+    uint8_t* encoded = NULL;
+    if (encoding == PARTICLE_CACHE_ENCODING_QUANTIZED &&
+        encodeQuantized((const ParticleC*)particles, count, &header, &encoded, &payloadSize)) {
+        payload = encoded;
+    }
+
+    const uint64_t payloadOffset = header.payloadOffset;
+    const uint64_t totalSize = payloadOffset + alignUp(payloadSize, PARTICLE_CACHE_PAGE_SIZE);
+    header.payloadSize = payloadSize;
+    header.checksum = particleCacheChecksumC(payload, payloadSize);
+
+    // Пишем рядом и переименовываем: читатель не увидит недописанный файл
+    size_t pathLength = strlen(path);
+    char* temporaryPath = malloc(pathLength + 5);
+    if (!temporaryPath) {
+        free(encoded);
+        return PARTICLE_CACHE_ERROR_IO;
+    }
+    memcpy(temporaryPath, path, pathLength);
+    memcpy(temporaryPath + pathLength, ".tmp", 5);
+
+    FILE* file = fopen(temporaryPath, "wb");
+    int ok = file != NULL;
+    ok = ok && fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && writeZeros(file, payloadOffset - sizeof(header));
+    ok = ok && (payloadSize == 0 || fwrite(payload, 1, (size_t)payloadSize, file) == (size_t)payloadSize);
+    ok = ok && writeZeros(file, totalSize - payloadOffset - payloadSize);
+    if (file && fclose(file) != 0) ok = 0;
+    ok = ok && rename(temporaryPath, path) == 0;
+
+    if (!ok) remove(temporaryPath);
+    free(temporaryPath);
+    free(encoded);
+    if (!ok) return PARTICLE_CACHE_ERROR_IO;
+
+    if (fileSize) *fileSize = totalSize;
+    return PARTICLE_CACHE_OK;
+}
+
+// MARK: - Map
+
+static int validateHeader(const ParticleCacheHeaderC* header, uint64_t fileSize) {
+    if (header->magic != PARTICLE_CACHE_MAGIC ||
+        header->version != PARTICLE_CACHE_VERSION ||
+        header->headerSize != sizeof(ParticleCacheHeaderC) ||
+        header->layoutHash != particleCacheLayoutHashC() ||
+        header->particleStride != sizeof(ParticleC)) {
+        return PARTICLE_CACHE_ERROR_FORMAT;
+    }
+    if (header->encoding == PARTICLE_CACHE_ENCODING_RAW) {
+        if (header->particleCount > UINT64_MAX / sizeof(ParticleC) ||
+            header->payloadSize != header->particleCount * sizeof(ParticleC)) {
+            return PARTICLE_CACHE_ERROR_FORMAT;
+        }
+    } else if (header->encoding == PARTICLE_CACHE_ENCODING_QUANTIZED) {
+        // Блоки проверяются при декодировании; здесь — что таблица смещений в payload
+        if (header->blockParticles == 0) return PARTICLE_CACHE_ERROR_FORMAT;
+        const uint64_t blockCount = header->particleCount / header->blockParticles +
+                                    (header->particleCount % header->blockParticles != 0);
+        if (blockCount >= header->payloadSize / sizeof(uint64_t)) {
+            return PARTICLE_CACHE_ERROR_FORMAT;
+        }
+    } else {
+        return PARTICLE_CACHE_ERROR_FORMAT;
+    }
+    if (header->payloadOffset % PARTICLE_CACHE_PAGE_SIZE != 0 ||
+        header->payloadOffset < sizeof(ParticleCacheHeaderC) ||
+        header->payloadOffset > fileSize ||
+        alignUp(header->payloadSize, PARTICLE_CACHE_PAGE_SIZE) > fileSize - header->payloadOffset) {
+        return PARTICLE_CACHE_ERROR_FORMAT;
+    }
+    return PARTICLE_CACHE_OK;
+}
+
+int particleCacheMapC(const char* path, int verifyChecksum, ParticleCacheMappingC* mapping) {
+    if (!path || !mapping) return PARTICLE_CACHE_ERROR_IO;
+    memset(mapping, 0, sizeof(*mapping));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return PARTICLE_CACHE_ERROR_IO;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return PARTICLE_CACHE_ERROR_IO;
+    }
+    if (info.st_size < (off_t)sizeof(ParticleCacheHeaderC)) {
+        close(fd);
+        return PARTICLE_CACHE_ERROR_FORMAT;
+    }
+
+    const uint64_t fileSize = (uint64_t)info.st_size;
+    void* base = mmap(NULL, (size_t)fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return PARTICLE_CACHE_ERROR_IO;
+
+    ParticleCacheHeaderC header;
+    memcpy(&header, base, sizeof(header));
+    int status = validateHeader(&header, fileSize);
+
+    uint8_t* payload = (uint8_t*)base + (status == PARTICLE_CACHE_OK ? header.payloadOffset : 0);
+    if (status == PARTICLE_CACHE_OK && verifyChecksum &&
+        particleCacheChecksumC(payload, header.payloadSize) != header.checksum) {
+        status = PARTICLE_CACHE_ERROR_CHECKSUM;
+    }
+    if (status != PARTICLE_CACHE_OK) {
+        munmap(base, (size_t)fileSize);
+        return status;
+    }
+
+    mapping->base = base;
+    mapping->length = fileSize;
+    mapping->header = header;
+    mapping->payload = payload;
+    mapping->particles = header.encoding == PARTICLE_CACHE_ENCODING_RAW ? payload : NULL;
+    mapping->particleCount = header.particleCount;
+    mapping->payloadLength = alignUp(header.payloadSize, PARTICLE_CACHE_PAGE_SIZE);
+    return PARTICLE_CACHE_OK;
+}
+
+void particleCacheUnmapC(ParticleCacheMappingC* mapping) {
+    if (!mapping) return;
+    if (mapping->base) munmap(mapping->base, (size_t)mapping->length);
+    memset(mapping, 0, sizeof(*mapping));
+}
+
+// MARK: - Decode
+
+/// Блок QUANTIZED → n частиц в out. 0 — блок поврежден
+static int decodeBlock(const ParticleCacheHeaderC* header, const uint8_t* block, uint64_t blockSize,
+                       uint32_t expected, uint32_t n, const float* colorTable, ParticleC* out) {
+    uint32_t stored;
+    uint32_t constantMask;
+    if (blockSize < 2 * sizeof(uint32_t)) return 0;
+    memcpy(&stored, block, sizeof(stored));
+    memcpy(&constantMask, block + sizeof(stored), sizeof(constantMask));
+    if (stored != expected) return 0;
+
+    // Начало каждого столбца и маска индекса: у постоянного столбца всегда элемент 0
+    const uint8_t* columns[PARTICLE_CACHE_COLUMN_COUNT];
+    uint32_t indexMasks[PARTICLE_CACHE_COLUMN_COUNT];
+    uint64_t cursor = 2 * sizeof(uint32_t);
+    for (int column = 0; column < PARTICLE_CACHE_COLUMN_COUNT; column++) {
+        const int constant = (constantMask >> column) & 1u;
+        const uint64_t length = alignUp((uint64_t)(constant ? 1 : stored) * columnSizes[column], 4);
+        if (length > blockSize - cursor) return 0;
+        columns[column] = block + cursor;
+        indexMasks[column] = constant ? 0u : UINT32_MAX;
+        cursor += length;
+    }
+
+    const uint16_t* positionX = (const uint16_t*)columns[PARTICLE_CACHE_COLUMN_POSITION_X];
+    const uint16_t* positionY = (const uint16_t*)columns[PARTICLE_CACHE_COLUMN_POSITION_Y];
+    const int16_t* velocityX = (const int16_t*)columns[PARTICLE_CACHE_COLUMN_VELOCITY_X];
+    const int16_t* velocityY = (const int16_t*)columns[PARTICLE_CACHE_COLUMN_VELOCITY_Y];
+    const uint32_t* colors = (const uint32_t*)columns[PARTICLE_CACHE_COLUMN_COLOR];
+    const float* sizes = (const float*)columns[PARTICLE_CACHE_COLUMN_SIZE];
+    const float* lives = (const float*)columns[PARTICLE_CACHE_COLUMN_LIFE];
+    const float* idles = (const float*)columns[PARTICLE_CACHE_COLUMN_IDLE];
+
+    const CacheVec4 origin = { header->positionOrigin[0], header->positionOrigin[1], 0.0f, 0.0f };
+    const CacheVec4 step = { header->positionStep[0], header->positionStep[1], 0.0f, 0.0f };
+    const CacheVec4 velocityStep = { header->velocityStep, header->velocityStep, 0.0f, 0.0f };
+
+    for (uint32_t i = 0; i < n; i++) {
+        const CacheVec4 grid = {
+            (float)positionX[i & indexMasks[PARTICLE_CACHE_COLUMN_POSITION_X]],
+            (float)positionY[i & indexMasks[PARTICLE_CACHE_COLUMN_POSITION_Y]],
+            0.0f, 0.0f
+        };
+        const CacheVec4 velocityGrid = {
+            (float)velocityX[i & indexMasks[PARTICLE_CACHE_COLUMN_VELOCITY_X]],
+            (float)velocityY[i & indexMasks[PARTICLE_CACHE_COLUMN_VELOCITY_Y]],
+            0.0f, 0.0f
+        };
+        const uint32_t rgba = colors[i & indexMasks[PARTICLE_CACHE_COLUMN_COLOR]];
+        const CacheVec4 color = {
+            colorTable[rgba & 0xFFu],
+            colorTable[(rgba >> 8) & 0xFFu],
+            colorTable[(rgba >> 16) & 0xFFu],
+            colorTable[256 + (rgba >> 24)]
+        };
+        const float size = sizes[i & indexMasks[PARTICLE_CACHE_COLUMN_SIZE]];
+        // idleChaoticMotion переносится битами через float-дорожку
+        const CacheVec4 scalars = {
+            size, size,
+            lives[i & indexMasks[PARTICLE_CACHE_COLUMN_LIFE]],
+            idles[i & indexMasks[PARTICLE_CACHE_COLUMN_IDLE]]
+        };
+        const CacheVec4 position = origin + grid * step;
+        const CacheVec4 velocity = velocityGrid * velocityStep;
+
+        ParticleC* p = &out[i];
+        memcpy(p->position, &position, sizeof(position));
+        memcpy(p->velocity, &velocity, sizeof(velocity));
+        memcpy(p->targetPosition, &position, sizeof(position));
+        memcpy(p->color, &color, sizeof(color));
+        memcpy(p->originalColor, &color, sizeof(color));
+        memcpy(&p->size, &scalars, sizeof(scalars));
+    }
+    return 1;
+}
+
+int particleCacheDecodeC(const ParticleCacheMappingC* mapping, uint64_t count, void* out) {
+    if (!mapping || !mapping->base || (!out && count > 0)) return PARTICLE_CACHE_ERROR_IO;
+    if (count > mapping->particleCount) return PARTICLE_CACHE_ERROR_FORMAT;
+    if (count == 0) return PARTICLE_CACHE_OK;
+
+    const ParticleCacheHeaderC* header = &mapping->header;
+    if (header->encoding == PARTICLE_CACHE_ENCODING_RAW) {
+        memcpy(out, mapping->particles, (size_t)(count * sizeof(ParticleC)));
+        return PARTICLE_CACHE_OK;
+    }
+
+    // sRGB-коды rgb и коды альфы → float одной таблицей на вызов
+    float colorTable[512];
+    for (int code = 0; code < 256; code++) {
+        colorTable[code] = srgb8ToLinearC((uint8_t)code);
+        colorTable[256 + code] = (float)code / 255.0f;
+    }
+
+    const uint8_t* payload = (const uint8_t*)mapping->payload;
+    const uint64_t payloadSize = header->payloadSize;
+    const uint64_t blockParticles = header->blockParticles;
+    const uint64_t blockCount = (mapping->particleCount + blockParticles - 1) / blockParticles;
+    const uint64_t tableSize = (blockCount + 1) * sizeof(uint64_t);
+    ParticleC* particles = (ParticleC*)out;
+
+    for (uint64_t first = 0, block = 0; first < count; first += blockParticles, block++) {
+        uint64_t start;
+        uint64_t end;
+        memcpy(&start, payload + block * sizeof(uint64_t), sizeof(start));
+        memcpy(&end, payload + (block + 1) * sizeof(uint64_t), sizeof(end));
+        if (start < tableSize || start > end || end > payloadSize || start % 4 != 0) {
+            return PARTICLE_CACHE_ERROR_FORMAT;
+        }
+
+        const uint64_t remaining = mapping->particleCount - first;
+        const uint32_t expected = (uint32_t)(remaining < blockParticles ? remaining : blockParticles);
+        const uint32_t n = (uint32_t)(count - first < expected ? count - first : expected);
+        if (!decodeBlock(header, payload + start, end - start, expected, n, colorTable, particles + first)) {
+            return PARTICLE_CACHE_ERROR_FORMAT;
+        }
+    }
+    return PARTICLE_CACHE_OK;
+}
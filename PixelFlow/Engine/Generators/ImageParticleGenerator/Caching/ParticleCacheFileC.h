@@ -0,0 +1,126 @@
+//
+//  ParticleCacheFileC.h
+//  PixelFlow
+//
+//  Бинарный файл кэша частиц (DefaultCacheManager): частицы лежат в файле
+//  в раскладке GPU и читаются через mmap без декодирования — отображение
+//  можно отдать Metal как shared-буфер без копии (bytesNoCopy).
+//
+//  Формат (little-endian, порядок байт устройства):
+//  - заголовок ParticleCacheHeaderC
+//  - нули до payloadOffset (кратно PARTICLE_CACHE_PAGE_SIZE)
+//  - payload в кодировке encoding
+//  - нули до конца страницы: отображение payload целыми страницами
+//    не выходит за конец файла
+//
+//  RAW: particleCount * particleStride байт частиц как есть.
+//
+//  QUANTIZED: только независимые поля частицы из генератора
+//  (targetPosition = position, originalColor = color, baseSize = size),
+//  по столбцам блоками по blockParticles частиц:
+//  - uint64 смещения блоков от начала payload, blockCount + 1 штук
+//  - блок: uint32 число частиц, uint32 маска постоянных столбцов, затем
+//    столбцы по порядку PARTICLE_CACHE_COLUMN_*; постоянный столбец —
+//    одно значение, остальные — по значению на частицу; каждый столбец
+//    дополнен нулями до 4 байт
+//  Позиции — uint16 в сетке [positionOrigin, positionOrigin + 65535·positionStep],
+//  скорости — int16 с шагом velocityStep, цвета — sRGB-коды RGBA8.
+//  Префикс декодируется только своими блоками.
+//
+
+#ifndef ParticleCacheFileC_h
+#define ParticleCacheFileC_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PARTICLE_CACHE_MAGIC          0x43504650u  // "PFPC"
+#define PARTICLE_CACHE_VERSION        1u
+/// Страница VM Apple Silicon (кратна и 4 КБ x86): payload выровнен под mmap и bytesNoCopy
+#define PARTICLE_CACHE_PAGE_SIZE      16384u
+
+/// Кодировка payload: частицы как есть
+#define PARTICLE_CACHE_ENCODING_RAW        0u
+/// Кодировка payload: квантованные столбцы без производных полей
+#define PARTICLE_CACHE_ENCODING_QUANTIZED  1u
+
+/// Частиц в блоке QUANTIZED
+#define PARTICLE_CACHE_BLOCK_PARTICLES  4096u
+
+// Столбцы блока QUANTIZED (бит маски постоянных столбцов — 1 << номер)
+#define PARTICLE_CACHE_COLUMN_POSITION_X  0   // uint16
+#define PARTICLE_CACHE_COLUMN_POSITION_Y  1   // uint16
+#define PARTICLE_CACHE_COLUMN_VELOCITY_X  2   // int16
+#define PARTICLE_CACHE_COLUMN_VELOCITY_Y  3   // int16
+#define PARTICLE_CACHE_COLUMN_COLOR       4   // RGBA8, rgb — sRGB-коды
+#define PARTICLE_CACHE_COLUMN_SIZE        5   // float
+#define PARTICLE_CACHE_COLUMN_LIFE        6   // float
+#define PARTICLE_CACHE_COLUMN_IDLE        7   // uint32
+#define PARTICLE_CACHE_COLUMN_COUNT       8
+
+// Результаты
+#define PARTICLE_CACHE_OK              0
+#define PARTICLE_CACHE_ERROR_IO       -1   // ввод-вывод, память, аргументы
+#define PARTICLE_CACHE_ERROR_FORMAT   -2   // не кэш частиц, другая версия или раскладка
+#define PARTICLE_CACHE_ERROR_CHECKSUM -3   // payload поврежден
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;      // sizeof(ParticleCacheHeaderC)
+    uint32_t layoutHash;      // particleCacheLayoutHashC() при записи
+    uint32_t particleStride;
+    uint32_t encoding;        // PARTICLE_CACHE_ENCODING_*
+    uint64_t particleCount;
+    uint64_t payloadOffset;   // от начала файла, кратно PARTICLE_CACHE_PAGE_SIZE
+    uint64_t payloadSize;     // байт частиц, без выравнивания в конце
+    uint64_t checksum;        // particleCacheChecksumC(payload)
+    // QUANTIZED (в RAW — нули)
+    float positionOrigin[2];  // NDC узла сетки 0
+    float positionStep[2];    // шаг сетки по осям
+    float velocityStep;
+    uint32_t blockParticles;
+} ParticleCacheHeaderC;
+
+/// Отображение файла кэша
+typedef struct {
+    void* base;               // начало отображения (файл целиком)
+    uint64_t length;          // длина отображения
+    ParticleCacheHeaderC header;
+    const void* payload;      // base + payloadOffset — выровнено по странице
+    void* particles;          // payload частицами в RAW; NULL — нужен particleCacheDecodeC
+    uint64_t particleCount;
+    uint64_t payloadLength;   // payloadSize, округленный до страницы (длина для bytesNoCopy)
+} ParticleCacheMappingC;
+
+/// Хеш раскладки ParticleC (размер и смещения полей): файл другой раскладки не читается
+uint32_t particleCacheLayoutHashC(void);
+
+/// 64-битная контрольная сумма (4 независимые полосы по 8 байт — на скорости чтения памяти)
+uint64_t particleCacheChecksumC(const void* data, uint64_t size);
+
+/// Пишет particles (count * sizeof(ParticleC) байт) во временный файл рядом
+/// и атомарно переименовывает в path. fileSize — итоговый размер файла (может быть NULL).
+/// encoding QUANTIZED применяется, только если поля частиц выводятся друг из друга,
+/// а цвета 8-битные (как у частиц генератора); иначе файл пишется в RAW
+int particleCacheWriteC(const char* path, const void* particles, uint64_t count,
+                        uint32_t encoding, uint64_t* fileSize);
+
+/// Отображает файл (MAP_PRIVATE, чтение и запись — копия при записи, файл не меняется)
+/// и проверяет заголовок; verifyChecksum != 0 — еще и контрольную сумму payload
+int particleCacheMapC(const char* path, int verifyChecksum, ParticleCacheMappingC* mapping);
+
+void particleCacheUnmapC(ParticleCacheMappingC* mapping);
+
+/// Первые count частиц отображения в out (ParticleC, count штук) в любой кодировке.
+/// PARTICLE_CACHE_ERROR_FORMAT — count больше particleCount или блоки повреждены
+int particleCacheDecodeC(const ParticleCacheMappingC* mapping, uint64_t count, void* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ParticleCacheFileC_h */
@@ -0,0 +1,336 @@
+//
+//  ShardedLRUCacheC.c
+//  PixelFlow
+//
+
+// posix_memalign — POSIX: под -std=c11 без макроса не объявлена
+#define _POSIX_C_SOURCE 200809L
+
+#include "ShardedLRUCacheC.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__APPLE__)
+#include <os/lock.h>
+typedef os_unfair_lock ShardLock;
+#define SHARD_LOCK_INIT(lock)    (*(lock) = OS_UNFAIR_LOCK_INIT)
+#define SHARD_LOCK(lock)         os_unfair_lock_lock(lock)
+#define SHARD_UNLOCK(lock)       os_unfair_lock_unlock(lock)
+#define SHARD_LOCK_DESTROY(lock) ((void)(lock))
+#else
+#include <pthread.h>
+typedef pthread_mutex_t ShardLock;
+#define SHARD_LOCK_INIT(lock)    pthread_mutex_init(lock, NULL)
+#define SHARD_LOCK(lock)         pthread_mutex_lock(lock)
+#define SHARD_UNLOCK(lock)       pthread_mutex_unlock(lock)
+#define SHARD_LOCK_DESTROY(lock) pthread_mutex_destroy(lock)
+#endif
+
+#define SHARD_INITIAL_BUCKETS 16u
+#define CACHE_LINE_SIZE       64u
+
+typedef struct LRUNode {
+    struct LRUNode* hashNext;         // цепочка бакета; у вытесненных — список на освобождение
+    struct LRUNode* older;            // к началу LRU (вытесняется первым)
+    struct LRUNode* newer;
+    uint64_t key;
+    void* value;
+    int64_t cost;
+} LRUNode;
+
+// Шард на своих кэш-линиях: блокировки соседних шардов не делят линию
+typedef struct {
+    ShardLock lock;
+
+    LRUNode** buckets;
+    uint64_t bucketCount;             // степень двойки
+    uint64_t count;
+    int64_t bytes;
+    int64_t capacity;
+
+    LRUNode* oldest;
+    LRUNode* newest;
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t insertions;
+    uint64_t evictions;
+    uint64_t rejections;
+} __attribute__((aligned(CACHE_LINE_SIZE))) LRUShard;
+
+struct ShardedLRUCacheC {
+    LRUShard* shards;
+    uint32_t shardCount;
+    uint32_t shardShift;              // шард — старшие биты перемешанного ключа
+    int64_t capacityBytes;
+    ShardedLRUCallbacksC callbacks;
+};
+
+// Финализатор splitmix64: ключи-хеши Swift уже перемешаны, но шард и бакет
+// берутся из разных битов — перемешивание защищает от слабых хешей
+static inline uint64_t mixKey(uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xBF58476D1CE4E5B9ull;
+    key ^= key >> 27;
+    key *= 0x94D049BB133111EBull;
+    key ^= key >> 31;
+    return key;
+}
+
+static inline LRUShard* shardFor(const ShardedLRUCacheC* cache, uint64_t mixed) {
+    return cache->shardCount == 1 ? cache->shards : &cache->shards[mixed >> cache->shardShift];
+}
+
+// MARK: - LRU List
+
+static void unlinkNode(LRUShard* shard, LRUNode* node) {
+    if (node->older) node->older->newer = node->newer; else shard->oldest = node->newer;
+    if (node->newer) node->newer->older = node->older; else shard->newest = node->older;
+    node->older = node->newer = NULL;
+}
+
+static void linkNewest(LRUShard* shard, LRUNode* node) {
+    node->older = shard->newest;
+    node->newer = NULL;
+    if (shard->newest) shard->newest->newer = node; else shard->oldest = node;
+    shard->newest = node;
+}
+
+// MARK: - Hash Table
+
+static LRUNode** findSlot(const LRUShard* shard, uint64_t key, uint64_t mixed) {
+    LRUNode** slot = &shard->buckets[mixed & (shard->bucketCount - 1)];
+    while (*slot && (*slot)->key != key) {
+        slot = &(*slot)->hashNext;
+    }
+    return slot;
+}
+
+static void growBuckets(LRUShard* shard) {
+    const uint64_t bucketCount = shard->bucketCount * 2;
+    LRUNode** buckets = (LRUNode**)calloc((size_t)bucketCount, sizeof(LRUNode*));
+    // Без памяти остаемся с длинными цепочками — кэш работает, только медленнее
+    if (!buckets) return;
+
+    for (LRUNode* node = shard->oldest; node; node = node->newer) {
+        LRUNode** slot = &buckets[mixKey(node->key) & (bucketCount - 1)];
+        node->hashNext = *slot;
+        *slot = node;
+    }
+    free(shard->buckets);
+    shard->buckets = buckets;
+    shard->bucketCount = bucketCount;
+}
+
+/// Убирает узел из таблицы и списка; узел добавляется в released
+static void detachNode(LRUShard* shard, LRUNode** slot, LRUNode** released) {
+    LRUNode* node = *slot;
+    *slot = node->hashNext;
+    unlinkNode(shard, node);
+    shard->count--;
+    shard->bytes -= node->cost;
+    node->hashNext = *released;
+    *released = node;
+}
+
+static void evictOldest(LRUShard* shard, LRUNode** released) {
+    LRUNode* node = shard->oldest;
+    detachNode(shard, findSlot(shard, node->key, mixKey(node->key)), released);
+    shard->evictions++;
+}
+
+/// Освобождает значения и узлы вне блокировки: release может запускать
+/// деинициализацию Swift-объектов произвольной длительности
+static void releaseNodes(const ShardedLRUCacheC* cache, LRUNode* node) {
+    while (node) {
+        LRUNode* next = node->hashNext;
+        if (cache->callbacks.release) cache->callbacks.release(node->value);
+        free(node);
+        node = next;
+    }
+}
+
+// MARK: - Public API
+
+ShardedLRUCacheC* shardedLRUCreateC(uint32_t shardCount, int64_t capacityBytes, ShardedLRUCallbacksC callbacks) {
+    if (shardCount == 0) shardCount = SHARDED_LRU_DEFAULT_SHARDS;
+    if (shardCount > SHARDED_LRU_MAX_SHARDS) shardCount = SHARDED_LRU_MAX_SHARDS;
+    uint32_t shardBits = 0;
+    while ((1u << shardBits) < shardCount) shardBits++;
+    shardCount = 1u << shardBits;
+
+    ShardedLRUCacheC* cache = (ShardedLRUCacheC*)calloc(1, sizeof(ShardedLRUCacheC));
+    if (!cache) return NULL;
+
+    void* shards = NULL;
+    if (posix_memalign(&shards, CACHE_LINE_SIZE, sizeof(LRUShard) * shardCount) != 0) {
+        free(cache);
+        return NULL;
+    }
+    memset(shards, 0, sizeof(LRUShard) * shardCount);
+
+    cache->shards = (LRUShard*)shards;
+    cache->shardCount = shardCount;
+    cache->shardShift = 64u - shardBits;
+    cache->capacityBytes = capacityBytes > 0 ? capacityBytes : 0;
+    cache->callbacks = callbacks;
+
+    for (uint32_t i = 0; i < shardCount; i++) {
+        LRUShard* shard = &cache->shards[i];
+        shard->buckets = (LRUNode**)calloc(SHARD_INITIAL_BUCKETS, sizeof(LRUNode*));
+        if (!shard->buckets) {
+            for (uint32_t j = 0; j < i; j++) {
+                free(cache->shards[j].buckets);
+                SHARD_LOCK_DESTROY(&cache->shards[j].lock);
+            }
+            free(cache->shards);
+            free(cache);
+            return NULL;
+        }
+        shard->bucketCount = SHARD_INITIAL_BUCKETS;
+        shard->capacity = cache->capacityBytes / shardCount;
+        SHARD_LOCK_INIT(&shard->lock);
+    }
+    return cache;
+}
+
+void shardedLRUDestroyC(ShardedLRUCacheC* cache) {
+    if (!cache) return;
+
+    for (uint32_t i = 0; i < cache->shardCount; i++) {
+        LRUShard* shard = &cache->shards[i];
+        LRUNode* node = shard->oldest;
+        while (node) {
+            LRUNode* next = node->newer;
+            if (cache->callbacks.release) cache->callbacks.release(node->value);
+            free(node);
+            node = next;
+        }
+        free(shard->buckets);
+        SHARD_LOCK_DESTROY(&shard->lock);
+    }
+    free(cache->shards);
+    free(cache);
+}
+
+int shardedLRUPutC(ShardedLRUCacheC* cache, uint64_t key, void* value, int64_t cost) {
+    if (cost < 0) cost = 0;
+    const uint64_t mixed = mixKey(key);
+    LRUShard* shard = shardFor(cache, mixed);
+
+    // Узел выделяется до блокировки: malloc под ней удлинил бы ожидание других потоков
+    LRUNode* node = cost <= shard->capacity ? (LRUNode*)malloc(sizeof(LRUNode)) : NULL;
+    LRUNode* released = NULL;
+
+    SHARD_LOCK(&shard->lock);
+
+    // Старое значение заменяется в любом случае: иначе get вернул бы устаревшее
+    LRUNode** slot = findSlot(shard, key, mixed);
+    if (*slot) detachNode(shard, slot, &released);
+
+    if (!node) {
+        shard->rejections++;
+        SHARD_UNLOCK(&shard->lock);
+        releaseNodes(cache, released);
+        if (cache->callbacks.release) cache->callbacks.release(value);
+        return 0;
+    }
+
+    while (shard->bytes + cost > shard->capacity && shard->oldest) {
+        evictOldest(shard, &released);
+    }
+
+    node->key = key;
+    node->value = value;
+    node->cost = cost;
+    slot = &shard->buckets[mixed & (shard->bucketCount - 1)];
+    node->hashNext = *slot;
+    *slot = node;
+    linkNewest(shard, node);
+    shard->count++;
+    shard->bytes += cost;
+    shard->insertions++;
+    if (shard->count > shard->bucketCount) growBuckets(shard);
+
+    SHARD_UNLOCK(&shard->lock);
+
+    releaseNodes(cache, released);
+    return 1;
+}
+
+void* shardedLRUGetC(ShardedLRUCacheC* cache, uint64_t key) {
+    const uint64_t mixed = mixKey(key);
+    LRUShard* shard = shardFor(cache, mixed);
+    void* value = NULL;
+
+    SHARD_LOCK(&shard->lock);
+    LRUNode* node = *findSlot(shard, key, mixed);
+    if (node) {
+        if (node != shard->newest) {
+            unlinkNode(shard, node);
+            linkNewest(shard, node);
+        }
+        value = node->value;
+        // Под блокировкой: иначе другой поток успел бы вытеснить и освободить значение
+        if (cache->callbacks.retain) cache->callbacks.retain(value);
+        shard->hits++;
+    } else {
+        shard->misses++;
+    }
+    SHARD_UNLOCK(&shard->lock);
+
+    return value;
+}
+
+int shardedLRURemoveC(ShardedLRUCacheC* cache, uint64_t key) {
+    const uint64_t mixed = mixKey(key);
+    LRUShard* shard = shardFor(cache, mixed);
+    LRUNode* released = NULL;
+
+    SHARD_LOCK(&shard->lock);
+    LRUNode** slot = findSlot(shard, key, mixed);
+    if (*slot) detachNode(shard, slot, &released);
+    SHARD_UNLOCK(&shard->lock);
+
+    releaseNodes(cache, released);
+    return released != NULL;
+}
+
+void shardedLRUClearC(ShardedLRUCacheC* cache) {
+    for (uint32_t i = 0; i < cache->shardCount; i++) {
+        LRUShard* shard = &cache->shards[i];
+        LRUNode* released = NULL;
+
+        SHARD_LOCK(&shard->lock);
+        for (LRUNode* node = shard->oldest; node; node = node->newer) {
+            node->hashNext = released;
+            released = node;
+        }
+        memset(shard->buckets, 0, (size_t)shard->bucketCount * sizeof(LRUNode*));
+        shard->oldest = shard->newest = NULL;
+        shard->count = 0;
+        shard->bytes = 0;
+        SHARD_UNLOCK(&shard->lock);
+
+        releaseNodes(cache, released);
+    }
+}
+
+void shardedLRUStatsC(ShardedLRUCacheC* cache, ShardedLRUStatsC* stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->capacityBytes = cache->capacityBytes;
+
+    for (uint32_t i = 0; i < cache->shardCount; i++) {
+        LRUShard* shard = &cache->shards[i];
+        SHARD_LOCK(&shard->lock);
+        stats->hits += shard->hits;
+        stats->misses += shard->misses;
+        stats->insertions += shard->insertions;
+        stats->evictions += shard->evictions;
+        stats->rejections += shard->rejections;
+        stats->count += shard->count;
+        stats->bytes += shard->bytes;
+        SHARD_UNLOCK(&shard->lock);
+    }
+}
@@ -0,0 +1,73 @@
+//
+//  ShardedLRUCacheC.h
+//  PixelFlow
+//
+//  Кэш в памяти (MemoryCache): ключи — 64-битные хеши, значения —
+//  непрозрачные указатели со стоимостью в байтах. Ключи распределяются
+//  по шардам; у шарда своя блокировка, хеш-таблица и LRU-список, поэтому
+//  потоки с разными ключами почти не ждут друг друга. get/put — O(1).
+//
+//  Владение значениями — через callbacks: put забирает ссылку вызывающего,
+//  get возвращает новую ссылку (retain под блокировкой шарда), вытесненные
+//  и замененные значения освобождаются после снятия блокировки.
+//
+
+#ifndef ShardedLRUCacheC_h
+#define ShardedLRUCacheC_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Шардов по умолчанию (степень двойки)
+#define SHARDED_LRU_DEFAULT_SHARDS  16u
+#define SHARDED_LRU_MAX_SHARDS      256u
+
+typedef struct {
+    void (*retain)(void* value);
+    void (*release)(void* value);
+} ShardedLRUCallbacksC;
+
+/// Счетчики, суммированные по шардам
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t insertions;
+    uint64_t evictions;       // вытеснены по емкости (remove/clear не считаются)
+    uint64_t rejections;      // стоимость больше емкости шарда — не сохранены
+    uint64_t count;
+    int64_t  bytes;           // сумма стоимостей
+    int64_t  capacityBytes;
+} ShardedLRUStatsC;
+
+typedef struct ShardedLRUCacheC ShardedLRUCacheC;
+
+/// shardCount округляется вверх до степени двойки (1…SHARDED_LRU_MAX_SHARDS, 0 — по умолчанию).
+/// Емкость делится между шардами поровну. NULL — нет памяти
+ShardedLRUCacheC* shardedLRUCreateC(uint32_t shardCount, int64_t capacityBytes, ShardedLRUCallbacksC callbacks);
+
+/// Освобождает все значения и сам кэш. Вызывать, когда другие потоки кэш уже не используют
+void shardedLRUDestroyC(ShardedLRUCacheC* cache);
+
+/// Сохраняет значение (самое свежее в шарде), вытесняя старые до емкости шарда.
+/// Ссылка на value переходит кэшу: при отказе она освобождается. 0 — отказ
+int shardedLRUPutC(ShardedLRUCacheC* cache, uint64_t key, void* value, int64_t cost);
+
+/// Значение с новой ссылкой (освобождает вызывающий) или NULL. Попадание делает запись самой свежей
+void* shardedLRUGetC(ShardedLRUCacheC* cache, uint64_t key);
+
+/// 0 — нет записи
+int shardedLRURemoveC(ShardedLRUCacheC* cache, uint64_t key);
+
+void shardedLRUClearC(ShardedLRUCacheC* cache);
+
+/// Снимок счетчиков: шарды читаются по очереди, а не атомарно вместе
+void shardedLRUStatsC(ShardedLRUCacheC* cache, ShardedLRUStatsC* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ShardedLRUCacheC_h */
@@ -11,12 +11,19 @@ import CryptoKit
 /// Менеджер кэширования результатов генерации частиц
 final class DefaultCacheManager: CacheManager, CacheManagerProtocol {
 
+    private enum Constants {
+        static let journalFileName = "cache_index.journal"
+        // Индекс до журнала: переносится при первом запуске и удаляется
+        static let legacyIndexFileName = "cache_index.json"
+    }
+
     private let cacheDirectory: URL
     private var maxCacheSize: Int // в байтах
+    private let particleEncoding: ParticleCacheEncoding
     private let queue = DispatchQueue(label: "com.particlegen.cachemanager", attributes: .concurrent)
 
-    private var cacheIndex: [String: CacheEntry] = [:]
-    private var currentCacheSize: Int = 0
+    /// Журнал индекса (CacheIndexC.h); nil — журнал недоступен, кэш не работает
+    private let cacheIndex: CacheIndex?
 
     struct CacheEntry: Codable {
         let key: String
@@ -26,8 +33,10 @@ final class DefaultCacheManager: CacheManager, CacheManagerProtocol {
         var lastAccessed: Date
     }
 
-    init(cacheSizeLimit: Int = 100 * 1024 * 1024) { // 100MB по умолчанию
+    init(cacheSizeLimit: Int = 100 * 1024 * 1024, // 100MB по умолчанию
+         particleEncoding: ParticleCacheEncoding = .raw) {
         self.maxCacheSize = cacheSizeLimit
+        self.particleEncoding = particleEncoding
 
         // Создаем директорию кэша
         guard let cachesDir = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first else {
@@ -37,12 +46,15 @@ final class DefaultCacheManager: CacheManager, CacheManagerProtocol {
 
         try? FileManager.default.createDirectory(at: cacheDirectory, withIntermediateDirectories: true)
 
-        // Загружаем индекс кэша
-        loadCacheIndex()
+        // Открываем журнал индекса (воспроизводится в память)
+        cacheIndex = CacheIndex(url: cacheDirectory.appendingPathComponent(Constants.journalFileName))
+        migrateLegacyIndex()
     }
 
     func cache<T: Codable>(_ value: T, for key: String) throws {
         try queue.sync(flags: .barrier) {
+            guard let cacheIndex else { return }
+
             let fileName = self.generateFileName(for: key)
             let fileURL = cacheDirectory.appendingPathComponent(fileName)
 
@@ -55,70 +67,104 @@ final class DefaultCacheManager: CacheManager, CacheManagerProtocol {
             }
 
             // Удаляем старый файл если существует
-            if let oldEntry = cacheIndex[key] {
+            if let oldEntry = cacheIndex.entry(for: key) {
                 try? FileManager.default.removeItem(at: cacheDirectory.appendingPathComponent(oldEntry.fileName))
-                currentCacheSize -= oldEntry.size
+                cacheIndex.remove(key)
             }
 
             // Очищаем кэш если необходимо
-            try cleanupIfNeeded(additionalSize: data.count)
+            cleanupIfNeeded(additionalSize: data.count)
 
             // Записываем файл
             try data.write(to: fileURL, options: .atomic)
 
-            // Обновляем индекс
-            let entry = CacheEntry(
+            // Обновляем индекс (одна запись в журнал)
+            cacheIndex.put(CacheEntry(
                 key: key,
                 fileName: fileName,
                 size: data.count,
                 createdAt: Date(),
                 lastAccessed: Date()
-            )
-
-            cacheIndex[key] = entry
-            currentCacheSize += data.count
-
-            // Сохраняем индекс
-            try saveCacheIndex()
+            ))
         }
     }
 
     func retrieve<T: Codable>(_ type: T.Type, for key: String) throws -> T? {
         // Используем barrier для записи, чтобы избежать race condition при обновлении индекса
         return queue.sync(flags: .barrier) {
-            guard let entry = cacheIndex[key] else { return nil }
+            guard let cacheIndex, let entry = cacheIndex.entry(for: key) else { return nil }
 
             let fileURL = cacheDirectory.appendingPathComponent(entry.fileName)
 
-            // Проверяем существование файла
-            guard FileManager.default.fileExists(atPath: fileURL.path) else {
-                // Удаляем поврежденную запись из индекса
-                cacheIndex.removeValue(forKey: key)
-                currentCacheSize -= entry.size
-                try? saveCacheIndex()
-                return nil
-            }
-
             do {
                 // Читаем данные
                 let data = try Data(contentsOf: fileURL)
 
-                // Обновляем время последнего доступа (защищено barrier)
-                var updatedEntry = entry
-                updatedEntry.lastAccessed = Date()
-                cacheIndex[key] = updatedEntry
-
-                // Пытаемся сохранить индекс, но не прерываем выполнение при ошибке
-                try? saveCacheIndex()
+                // Время доступа уходит в журнал пачкой с другими касаниями
+                cacheIndex.touch(key)
 
                 // Десериализуем
                 return try JSONDecoder().decode(type, from: data)
             } catch {
-                // Если файл поврежден, удаляем запись
-                cacheIndex.removeValue(forKey: key)
-                currentCacheSize -= entry.size
+                // Файла нет или он поврежден — удаляем запись
+                cacheIndex.remove(key)
+                try? FileManager.default.removeItem(at: fileURL)
+                return nil
+            }
+        }
+    }
+
+    // MARK: - Particles
+
+    /// Частицы пишутся бинарно (particleEncoding) — лимит четверти кэша,
+    /// рассчитанный на JSON, к ним не применяется: файл ограничен всем кэшем
+    func cacheParticles(_ particles: [Particle], for key: String) throws {
+        try queue.sync(flags: .barrier) {
+            guard let cacheIndex else { return }
+
+            let fileName = self.generateFileName(for: key, pathExtension: "particles")
+            let fileURL = cacheDirectory.appendingPathComponent(fileName)
+
+            if let oldEntry = cacheIndex.entry(for: key) {
+                try? FileManager.default.removeItem(at: cacheDirectory.appendingPathComponent(oldEntry.fileName))
+                cacheIndex.remove(key)
+            }
+
+            // Размер сжатого файла известен только после записи: пишем, затем освобождаем место
+            let fileSize = try ParticleCacheFile.write(particles, to: fileURL, encoding: particleEncoding)
+            guard fileSize <= maxCacheSize else {
+                try? FileManager.default.removeItem(at: fileURL)
+                return
+            }
+            cleanupIfNeeded(additionalSize: fileSize)
+
+            cacheIndex.put(CacheEntry(
+                key: key,
+                fileName: fileName,
+                size: fileSize,
+                createdAt: Date(),
+                lastAccessed: Date()
+            ))
+        }
+    }
+
+    /// Контрольная сумма проверяется при каждом отображении: чтение файла целиком
+    /// (1M частиц: ~3 мс квантованных, ~20 мс raw) несопоставимо дешевле генерации,
+    /// а битый кэш удаляется
+    func mapParticles(for key: String) -> ParticleCacheMapping? {
+        queue.sync(flags: .barrier) {
+            guard let cacheIndex, let entry = cacheIndex.entry(for: key) else { return nil }
+
+            let fileURL = cacheDirectory.appendingPathComponent(entry.fileName)
+
+            do {
+                let mapping = try ParticleCacheMapping(url: fileURL, verifyChecksum: true)
+                cacheIndex.touch(key)
+                return mapping
+            } catch {
+                // Нет файла, другая раскладка частиц или поврежденный payload
+                cacheIndex.remove(key)
                 try? FileManager.default.removeItem(at: fileURL)
-                try? saveCacheIndex()
                 return nil
             }
         }
@@ -126,25 +172,23 @@ final class DefaultCacheManager: CacheManager, CacheManagerProtocol {
 
     func clear() {
         queue.sync(flags: .barrier) {
+            guard let cacheIndex else { return }
+
             // Удаляем все файлы кэша
-            for entry in cacheIndex.values {
+            for entry in cacheIndex.entries {
                 let fileURL = cacheDirectory.appendingPathComponent(entry.fileName)
                 try? FileManager.default.removeItem(at: fileURL)
             }
 
-            // Очищаем индекс
-            cacheIndex.removeAll()
-            currentCacheSize = 0
-
-            // Сохраняем пустой индекс
-            try? saveCacheIndex()
+            // Журнал переписывается пустым
+            cacheIndex.clear()
         }
     }
 
     // MARK: - CacheManagerProtocol
 
     var size: Int64 {
-        queue.sync { Int64(currentCacheSize) }
+        queue.sync { Int64(cacheIndex?.totalSize ?? 0) }
     }
 
     var sizeLimit: Int64 {
@@ -153,113 +197,43 @@ final class DefaultCacheManager: CacheManager, CacheManagerProtocol {
     }
 
     var count: Int {
-        queue.sync { cacheIndex.count }
+        queue.sync { cacheIndex?.count ?? 0 }
     }
 
     func contains(key: String) -> Bool {
-        queue.sync { cacheIndex[key] != nil }
+        queue.sync { cacheIndex?.contains(key) ?? false }
     }
 
     // MARK: - Private Methods
 
-    private func generateFileName(for key: String) -> String {
+    private func generateFileName(for key: String, pathExtension: String = "cache") -> String {
         let hash = SHA256.hash(data: Data(key.utf8))
-        return hash.compactMap { String(format: "%02x", $0) }.joined() + ".cache"
+        return hash.compactMap { String(format: "%02x", $0) }.joined() + "." + pathExtension
     }
 
-    private func loadCacheIndex() {
-        let indexURL = cacheDirectory.appendingPathComponent("cache_index.json")
+    /// Переносит записи из cache_index.json в журнал (от старых к свежим — порядок LRU)
+    private func migrateLegacyIndex() {
+        let legacyURL = cacheDirectory.appendingPathComponent(Constants.legacyIndexFileName)
+        guard let cacheIndex, FileManager.default.fileExists(atPath: legacyURL.path) else { return }
 
-        guard let data = try? Data(contentsOf: indexURL),
-              let entries = try? JSONDecoder().decode([String: CacheEntry].self, from: data) else {
-            return
+        if cacheIndex.count == 0,
+           let data = try? Data(contentsOf: legacyURL),
+           let entries = try? JSONDecoder().decode([String: CacheEntry].self, from: data) {
+            for entry in entries.values.sorted(by: { $0.lastAccessed < $1.lastAccessed }) {
+                cacheIndex.put(entry)
+            }
         }
-
-        cacheIndex = entries
-        currentCacheSize = entries.values.reduce(0) { $0 + $1.size }
+        try? FileManager.default.removeItem(at: legacyURL)
     }
 
-    private func saveCacheIndex() throws {
-        let indexURL = cacheDirectory.appendingPathComponent("cache_index.json")
-        let data = try JSONEncoder().encode(cacheIndex)
-        try data.write(to: indexURL, options: .atomic)
-    }
-
-    private func cleanupIfNeeded(additionalSize: Int) throws {
-        guard currentCacheSize + additionalSize > maxCacheSize else { return }
-
-        // Сортируем по времени последнего доступа (старые сначала)
-        let sortedEntries = cacheIndex.values.sorted { $0.lastAccessed < $1.lastAccessed }
+    /// Вытесняет самые давно использованные записи: каждая — O(1), без сортировки индекса
+    private func cleanupIfNeeded(additionalSize: Int) {
+        guard let cacheIndex else { return }
 
-        var sizeToFree = currentCacheSize + additionalSize - maxCacheSize
-        var entriesToRemove: [String] = []
-
-        for entry in sortedEntries {
-            guard sizeToFree > 0 else { break }
-
-            // Удаляем файл
+        while cacheIndex.totalSize + additionalSize > maxCacheSize, let entry = cacheIndex.oldest {
             let fileURL = cacheDirectory.appendingPathComponent(entry.fileName)
             try? FileManager.default.removeItem(at: fileURL)
-
-            // Запоминаем ключи для удаления
-            entriesToRemove.append(entry.key)
-            currentCacheSize -= entry.size
-            sizeToFree -= entry.size
-        }
-
-        // Удаляем из индекса все записи разом
-        for key in entriesToRemove {
-            cacheIndex.removeValue(forKey: key)
-        }
-    }
-}
-
-// MARK: - Memory Cache
-
-/// Памятный кэш для часто используемых данных
-final class MemoryCache<Key: Hashable, Value> {
-    private let cache = NSCache<NSString, CacheWrapper>()
-    private let keyFormatter = NumberFormatter()
-    private let queue = DispatchQueue(label: "com.particlegen.memorycache", attributes: .concurrent)
-
-    private class CacheWrapper {
-        let value: Value
-        let timestamp: Date
-
-        init(_ value: Value) {
-            self.value = value
-            self.timestamp = Date()
-        }
-    }
-
-    func set(_ value: Value, for key: Key) {
-        queue.async(flags: .barrier) {
-            let wrapper = CacheWrapper(value)
-            let keyString = String(describing: key)
-            self.cache.setObject(wrapper, forKey: NSString(string: keyString))
-        }
-    }
-
-    func get(for key: Key) -> Value? {
-        queue.sync {
-            let keyString = String(describing: key)
-            guard let wrapper = cache.object(forKey: NSString(string: keyString)) else {
-                return nil
-            }
-            return wrapper.value
-        }
-    }
-
-    func remove(for key: Key) {
-        queue.async(flags: .barrier) {
-            let keyString = String(describing: key)
-            self.cache.removeObject(forKey: NSString(string: keyString))
-        }
-    }
-
-    func clear() {
-        queue.async(flags: .barrier) {
-            self.cache.removeAllObjects()
+            cacheIndex.remove(entry.key)
         }
     }
 }
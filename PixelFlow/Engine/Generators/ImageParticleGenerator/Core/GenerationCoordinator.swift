@@ -23,9 +23,29 @@ enum GenerationCoordinatorFactory {
               let errorHandler = container.resolve(ErrorHandlerProtocol.self) else {
             fatalError("Failed to resolve GenerationCoordinator dependencies")
         }
-        
+        guard let analyzer = container.resolve(ImageAnalyzerProtocol.self),
+              let sampler = container.resolve(PixelSamplerProtocol.self),
+              let assembler = container.resolve(ParticleAssemblerProtocol.self),
+              let strategy = container.resolve(GenerationStrategyProtocol.self, name: "adaptive") else {
+            fatalError("Failed to resolve batch pipeline dependencies")
+        }
+
+        // Пакетные задания идут одновременно — у каждого свой конвейер и контекст;
+        // анализатор, сэмплер и сборщик общие (их кэши потокобезопасны)
+        let makePipeline: () -> GenerationPipelineProtocol = {
+            GenerationPipeline(
+                analyzer: analyzer,
+                sampler: sampler,
+                assembler: assembler,
+                strategy: strategy,
+                context: GenerationContext(logger: logger),
+                logger: logger
+            )
+        }
+
         return GenerationCoordinator(
             pipeline: pipeline,
+            makePipeline: makePipeline,
             operationManager: operationManager,
             memoryManager: memoryManager,
             cacheManager: cacheManager,
@@ -35,11 +55,33 @@ enum GenerationCoordinatorFactory {
     }
 }
 
+/// Ключ кэша частиц в памяти: идентичность изображения (без хеширования пикселей)
+/// и ключ генерации — размеры, экран, отпечаток конфигурации
+private struct ParticleMemoryKey: Hashable {
+    let image: ImageIdentityKey
+    let generationKey: String
+}
+
 final class GenerationCoordinator: NSObject, @unchecked Sendable, GenerationCoordinatorProtocol {
 
+    private enum Constants {
+        // ~2.8M частиц; массив делит память с результатом, отданным вызывающему (copy-on-write)
+        static let particleMemoryCacheCapacity = 256 * 1024 * 1024
+        // Обращение одно на генерацию — конкуренции за блокировку нет
+        static let particleMemoryCacheShards = 1
+        // Пакет: заданий в работе сверх числа потоков пула — пока одно пишет файл
+        // или ждет, у пула есть готовые этапы других
+        static let batchExtraJobsInFlight = 1
+        // Ниже этапов генерации (veryLow = 0 у стратегий): запись не задерживает их
+        static let batchCacheWritePriority = -1
+        // Строк пикселей в отпечатке содержимого: 4K-кадр — ~4 МБ SHA-256 (единицы мс)
+        static let contentFingerprintRows = 256
+    }
+
     // MARK: - Dependencies
 
     private let pipeline: GenerationPipelineProtocol
+    private let makePipeline: () -> GenerationPipelineProtocol
     private let operationManager: OperationManagerProtocol
     private let memoryManager: MemoryManagerProtocol
     private let cacheManager: CacheManagerProtocol
@@ -55,9 +97,22 @@ final class GenerationCoordinator: NSObject, @unchecked Sendable, GenerationCoor
 
     private var currentTask: Task<[Particle], Error>?
 
+    /// Свободные конвейеры пакетной генерации: переиспользуются между заданиями
+    private let batchPipelinesLock = NSLock()
+    private var idleBatchPipelines: [GenerationPipelineProtocol] = []
+    private let taskPool: TaskPool = .shared
+
+    /// Уровень перед дисковым кэшем: попадание не отображает и не декодирует файл.
+    /// Ключ — то же CGImage и ключ генерации: одинаковые размеры разных изображений не совпадают
+    private let particleMemoryCache = MemoryCache<ParticleMemoryKey, [Particle]>(
+        capacityBytes: Constants.particleMemoryCacheCapacity,
+        shardCount: Constants.particleMemoryCacheShards
+    )
+
     // MARK: - Initialization
 
     init(pipeline: GenerationPipelineProtocol,
+         makePipeline: @escaping () -> GenerationPipelineProtocol,
          operationManager: OperationManagerProtocol,
          memoryManager: MemoryManagerProtocol,
          cacheManager: CacheManagerProtocol,
@@ -65,6 +120,7 @@ final class GenerationCoordinator: NSObject, @unchecked Sendable, GenerationCoor
          errorHandler: ErrorHandlerProtocol) {
 
         self.pipeline = pipeline
+        self.makePipeline = makePipeline
         self.operationManager = operationManager
         self.memoryManager = memoryManager
         self.cacheManager = cacheManager
@@ -94,7 +150,8 @@ final class GenerationCoordinator: NSObject, @unchecked Sendable, GenerationCoor
         from image: CGImage,
         config: ParticleGenerationConfig,
         screenSize: CGSize,
-        progress: @escaping (Float, String) -> Void
+        progress: @escaping (Float, String) -> Void,
+        onChunk: ((ParticleChunk) -> Void)?
     ) async throws -> [Particle] {
 
         let canStart = stateQueue.sync(flags: .barrier) { () -> Bool in
@@ -121,39 +178,37 @@ final class GenerationCoordinator: NSObject, @unchecked Sendable, GenerationCoor
                 // Проверка кэша
                 let cacheKey = self.cacheKey(for: image, config: config, screenSize: screenSize)
                 if config.enableCaching,
-                   let cachedParticles: [Particle] = try self.cacheManager.retrieve([Particle].self, for: cacheKey) {
-
-                    // Проверяем, что количество частиц в кэше соответствует целевому
-                    if cachedParticles.count == config.targetParticleCount {
-                        await MainActor.run {
-                            progress(1.0, "Loaded from cache")
-                        }
-
-                        self.logger.info("Loaded \(cachedParticles.count) particles from cache")
-                        return cachedParticles
-                    } else {
+                   let particles = self.loadCachedParticles(for: cacheKey, image: image, targetCount: config.targetParticleCount) {
+                    // Из кэша — одной порцией: массив уже готов целиком
+                    onChunk?(ParticleChunk(startIndex: 0, particles: particles))
+                    await MainActor.run {
+                        progress(1.0, "Loaded from cache")
                     }
+                    return particles
                 }
 
                 // Выполнение генерации через pipeline
                 let particles = try await self.pipeline.execute(
                     image: image,
                     config: config,
-                    screenSize: screenSize
-                ) { progressValue, stage in
-                    self.stateQueue.async(flags: .barrier) {
-                        self._currentProgress = progressValue
-                        self._currentStage = stage
-                    }
+                    screenSize: screenSize,
+                    progress: { progressValue, stage in
+                        self.stateQueue.async(flags: .barrier) {
+                            self._currentProgress = progressValue
+                            self._currentStage = stage
+                        }
 
-                    DispatchQueue.main.async {
-                        progress(progressValue, stage)
-                    }
-                }
+                        DispatchQueue.main.async {
+                            progress(progressValue, stage)
+                        }
+                    },
+                    onChunk: onChunk
+                )
 
-                // Кэширование результата
+                // Кэширование результата: запись файла не задерживает возврат частиц
                 if config.enableCaching {
-                    try self.cacheManager.cache(particles, for: cacheKey)
+                    self.storeInMemoryCache(particles, for: cacheKey, image: image)
+                    self.writeToDiskCache(particles, for: cacheKey, image: image)
                 }
 
                 // Отслеживание памяти
@@ -200,6 +255,84 @@ final class GenerationCoordinator: NSObject, @unchecked Sendable, GenerationCoor
         }
     }
 
+    func generateParticles(
+        batch jobs: [GenerationJob],
+        memoryBudgetBytes: Int,
+        onResult: @escaping (Int, Result<[Particle], Error>) -> Void
+    ) async -> BatchGenerationReport {
+
+        logger.info("Starting batch generation of \(jobs.count) images, budget \(memoryBudgetBytes / (1024 * 1024)) MB")
+
+        let startTime = DispatchTime.now().uptimeNanoseconds
+        let budget = GenerationMemoryBudget(capacityBytes: memoryBudgetBytes)
+        let maxJobsInFlight = taskPool.workerCount + Constants.batchExtraJobsInFlight
+        var generated = 0
+        var cached = 0
+        var failed = 0
+
+        // Задания стартуют по порядку: попадание в кэш отдается сразу, без бюджета
+        // и слота; промах ждет места в бюджете и слота, этапы запущенных идут
+        // на общем пуле (TaskGraph) вперемешку
+        await withTaskGroup(of: BatchJobOutcome.self) { group in
+            var inFlight = 0
+            let record: (BatchJobOutcome) -> Void = { outcome in
+                switch outcome {
+                case .generated: generated += 1
+                case .cached: cached += 1
+                case .failed: failed += 1
+                }
+            }
+
+            for (index, job) in jobs.enumerated() {
+                if Task.isCancelled { break }
+
+                let cacheKey = self.cacheKey(for: job.image, config: job.config, screenSize: job.screenSize)
+                if job.config.enableCaching,
+                   let particles = loadCachedParticles(for: cacheKey, image: job.image, targetCount: job.config.targetParticleCount) {
+                    onResult(index, .success(particles))
+                    record(.cached)
+                    continue
+                }
+
+                if inFlight >= maxJobsInFlight, let outcome = await group.next() {
+                    record(outcome)
+                    inFlight -= 1
+                }
+
+                // nil — пакет отменили, пока задание ждало бюджет
+                guard let reserved = await budget.reserve(estimatedBatchJobBytes(job)) else { break }
+                group.addTask { [self] in
+                    defer { budget.release(reserved) }
+                    do {
+                        let particles = try await runBatchJob(job, cacheKey: cacheKey)
+                        onResult(index, .success(particles))
+                        return .generated
+                    } catch {
+                        logger.warning("Batch job \(index) failed: \(error)")
+                        onResult(index, .failure(error))
+                        return .failed
+                    }
+                }
+                inFlight += 1
+            }
+
+            for await outcome in group {
+                record(outcome)
+            }
+        }
+
+        let report = BatchGenerationReport(
+            generated: generated,
+            cached: cached,
+            failed: failed,
+            seconds: Double(DispatchTime.now().uptimeNanoseconds &- startTime) / 1_000_000_000,
+            peakReservedBytes: budget.peakReservedBytes
+        )
+        let rate = String(format: "%.2f", report.imagesPerSecond)
+        logger.info("Batch generation finished: \(generated) generated, \(cached) cached, \(failed) failed, \(rate) images/s")
+        return report
+    }
+
     func cancelGeneration() {
         logger.info("Cancelling particle generation")
 
@@ -224,10 +357,131 @@ final class GenerationCoordinator: NSObject, @unchecked Sendable, GenerationCoor
         }
     }
 
+    /// Память, затем диск. Частицы в прогрессивном порядке: набор не меньше целевого
+    /// обслуживает бюджет своим префиксом без повторного сэмплинга.
+    /// Из отображения копируется только префикс
+    private func loadCachedParticles(for key: String, image: CGImage, targetCount: Int) -> [Particle]? {
+        let memoryKey = ParticleMemoryKey(image: ImageIdentityKey(image: image), generationKey: key)
+        if let cachedParticles = particleMemoryCache.get(for: memoryKey),
+           cachedParticles.count >= targetCount {
+            let particles = cachedParticles.count == targetCount
+                ? cachedParticles
+                : Array(cachedParticles.prefix(targetCount))
+            logger.info("Loaded \(particles.count) of \(cachedParticles.count) particles from memory cache")
+            return particles
+        }
+
+        guard let diskKey = diskCacheKey(for: key, image: image),
+              let cachedParticles = cacheManager.mapParticles(for: diskKey),
+              cachedParticles.count >= targetCount else {
+            return nil
+        }
+        let particles = cachedParticles.copyParticles(prefix: targetCount)
+        storeInMemoryCache(particles, for: key, image: image)
+        logger.info("Loaded \(particles.count) of \(cachedParticles.count) cached particles")
+        return particles
+    }
+
+    /// Набор меньше уже закэшированного не вытесняет его: больший обслуживает оба бюджета.
+    /// Ключ удерживает изображение — его байты входят в стоимость записи
+    private func storeInMemoryCache(_ particles: [Particle], for key: String, image: CGImage) {
+        let memoryKey = ParticleMemoryKey(image: ImageIdentityKey(image: image), generationKey: key)
+        if let cached = particleMemoryCache.get(for: memoryKey), cached.count >= particles.count {
+            return
+        }
+        let cost = particles.count * MemoryLayout<Particle>.stride + memoryKey.image.retainedBytes
+        particleMemoryCache.set(particles, for: memoryKey, cost: cost)
+    }
+
+    /// Запись файла (1M квантованных частиц — ~240 мс) идет в фоне, после возврата
+    /// результата; повторный запрос до ее окончания обслуживает кэш в памяти.
+    /// Ошибка записи не роняет генерацию — частицы уже готовы. Отпечаток
+    /// содержимого для ключа файла тоже считается в фоне
+    private func writeToDiskCache(_ particles: [Particle], for key: String, image: CGImage) {
+        let cacheManager = self.cacheManager
+        let logger = self.logger
+        Task.detached(priority: .utility) { [weak self] in
+            guard let self = self, let diskKey = self.diskCacheKey(for: key, image: image) else { return }
+            do {
+                try cacheManager.cacheParticles(particles, for: diskKey)
+            } catch {
+                logger.warning("Failed to write particles to disk cache: \(error)")
+            }
+        }
+    }
+
+    // MARK: - Batch Generation
+
+    private enum BatchJobOutcome {
+        case generated
+        case cached
+        case failed
+    }
+
+    /// Кэш → конвейер → запись файла. Запись идет внутри задания (на пуле, ниже
+    /// приоритетом этапов): частицы держатся в бюджете, пока файл не записан
+    /// Промах кэша (проверен до резервирования бюджета): генерация и запись в кэш
+    private func runBatchJob(_ job: GenerationJob, cacheKey: String) async throws -> [Particle] {
+        let jobPipeline = acquireBatchPipeline()
+        defer { releaseBatchPipeline(jobPipeline) }
+
+        let particles = try await jobPipeline.execute(
+            image: job.image,
+            config: job.config,
+            screenSize: job.screenSize,
+            progress: { _, _ in },
+            onChunk: nil
+        )
+
+        if job.config.enableCaching {
+            storeInMemoryCache(particles, for: cacheKey, image: job.image)
+            await writeToDiskCacheOnPool(particles, for: cacheKey, image: job.image)
+        }
+        return particles
+    }
+
+    private func writeToDiskCacheOnPool(_ particles: [Particle], for key: String, image: CGImage) async {
+        let cacheManager = self.cacheManager
+        let graph = TaskGraph()
+        graph.addNode(priority: Constants.batchCacheWritePriority, cost: Double(particles.count)) { [weak self] _ in
+            guard let self = self, let diskKey = self.diskCacheKey(for: key, image: image) else { return }
+            try cacheManager.cacheParticles(particles, for: diskKey)
+        }
+        do {
+            try await graph.run(on: taskPool)
+        } catch {
+            logger.warning("Failed to write particles to disk cache: \(error)")
+        }
+    }
+
+    /// Пиксели (PixelCache, 4 байта), сэмплы и частицы задания
+    private func estimatedBatchJobBytes(_ job: GenerationJob) -> Int {
+        let pixelBytes = job.image.width * job.image.height * 4
+        let particleBytes = job.config.targetParticleCount * (MemoryLayout<Sample>.stride + MemoryLayout<Particle>.stride)
+        return pixelBytes + particleBytes
+    }
+
+    private func acquireBatchPipeline() -> GenerationPipelineProtocol {
+        batchPipelinesLock.lock()
+        defer { batchPipelinesLock.unlock() }
+        return idleBatchPipelines.popLast() ?? makePipeline()
+    }
+
+    private func releaseBatchPipeline(_ pipeline: GenerationPipelineProtocol) {
+        batchPipelinesLock.lock()
+        idleBatchPipelines.append(pipeline)
+        batchPipelinesLock.unlock()
+    }
+
+    /// Ключ генерации: размеры, экран, конфигурация. Содержимого в нем нет — в памяти
+    /// его дополняет идентичность изображения, на диске — отпечаток пикселей.
+    /// targetParticleCount не входит в ключ: меньший бюджет берет префикс кэшированного набора
     private func cacheKey(for image: CGImage, config: ParticleGenerationConfig, screenSize: CGSize) -> String {
-        let configFingerprint = hashConfig(config)
+        var lodConfig = config
+        lodConfig.targetParticleCount = 0
+        let configFingerprint = hashConfig(lodConfig)
         let components = [
-            "v3-fullres-2026-02-07",
+            "v6-content-2026-10-17",
             "\(image.width)x\(image.height)",
             "\(Int(screenSize.width))x\(Int(screenSize.height))",
             configFingerprint
@@ -235,6 +489,46 @@ final class GenerationCoordinator: NSObject, @unchecked Sendable, GenerationCoor
         return "generation_" + components.joined(separator: "_")
     }
 
+    /// Ключ файла: файл переживает CGImage, поэтому к ключу генерации добавляется
+    /// отпечаток содержимого. Считается только при промахе кэша в памяти и при записи;
+    /// nil — байты изображения недоступны, диск не используется
+    private func diskCacheKey(for key: String, image: CGImage) -> String? {
+        guard let fingerprint = contentFingerprint(of: image) else {
+            logger.warning("Image bytes unavailable, skipping disk cache")
+            return nil
+        }
+        return key + "_" + fingerprint
+    }
+
+    /// SHA-256 по строкам пикселей с шагом (не больше contentFingerprintRows строк
+    /// на всю высоту, последняя строка всегда) и формату пикселей. Другое изображение
+    /// тех же размеров дает другой ключ; правка только в пропущенных строках — нет
+    private func contentFingerprint(of image: CGImage) -> String? {
+        guard let data = image.dataProvider?.data,
+              let bytes = CFDataGetBytePtr(data) else {
+            return nil
+        }
+        let length = CFDataGetLength(data)
+        let bytesPerRow = image.bytesPerRow
+        let height = image.height
+        let rowStride = max(1, height / Constants.contentFingerprintRows)
+
+        var hasher = SHA256()
+        let format = "\(image.bitsPerPixel)_\(image.bitmapInfo.rawValue)_\(bytesPerRow)"
+        hasher.update(data: Data(format.utf8))
+        var rows = Array(stride(from: 0, to: height, by: rowStride))
+        if let last = rows.last, last != height - 1 {
+            rows.append(height - 1)
+        }
+        for row in rows {
+            let start = row * bytesPerRow
+            let count = min(bytesPerRow, length - start)
+            guard count > 0 else { break }
+            hasher.update(bufferPointer: UnsafeRawBufferPointer(start: bytes + start, count: count))
+        }
+        return hasher.finalize().compactMap { String(format: "%02x", $0) }.joined()
+    }
+
     private func hashConfig(_ config: ParticleGenerationConfig) -> String {
         do {
             let data = try JSONEncoder().encode(config)
@@ -248,6 +542,7 @@ final class GenerationCoordinator: NSObject, @unchecked Sendable, GenerationCoor
 
     func clearCache() {
         logger.info("Clearing generation cache")
+        particleMemoryCache.clear()
         cacheManager.clear()
     }
 }
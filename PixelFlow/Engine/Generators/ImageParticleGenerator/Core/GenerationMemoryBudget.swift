@@ -0,0 +1,120 @@
+//
+//  GenerationMemoryBudget.swift
+//  PixelFlow
+//
+//  Бюджет памяти пакетной генерации: задание резервирует оценку своих
+//  промежуточных данных (пиксели, сэмплы, частицы) до старта и возвращает
+//  после. Ожидающие обслуживаются по очереди — крупное задание не голодает
+//  за мелкими.
+//
+
+import Foundation
+
+final class GenerationMemoryBudget {
+
+    private struct Waiter {
+        let id: UInt64
+        let bytes: Int
+        let continuation: CheckedContinuation<Bool, Never>
+    }
+
+    // MARK: - Properties
+
+    let capacityBytes: Int
+
+    private let lock = NSLock()
+    private var reservedBytes = 0
+    private var peakBytes = 0
+    private var waiters: [Waiter] = []
+    private var nextWaiterID: UInt64 = 0
+
+    /// Наибольшая одновременно зарезервированная сумма
+    var peakReservedBytes: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return peakBytes
+    }
+
+    // MARK: - Initialization
+
+    init(capacityBytes: Int) {
+        self.capacityBytes = max(capacityBytes, 1)
+    }
+
+    // MARK: - Reservation
+
+    /// Ждет, пока оценка поместится в бюджет. Оценка больше емкости урезается
+    /// до нее — такое задание идет одно. Возвращает зарезервированные байты;
+    /// nil — задачу отменили до выдачи (ожидающий снимается с очереди)
+    func reserve(_ bytes: Int) async -> Int? {
+        let bytes = min(max(bytes, 0), capacityBytes)
+        lock.lock()
+        let id = nextWaiterID
+        nextWaiterID &+= 1
+        lock.unlock()
+
+        let granted = await withTaskCancellationHandler {
+            await withCheckedContinuation { (continuation: CheckedContinuation<Bool, Never>) in
+                lock.lock()
+                // Флаг отмены ставится до onCancel: если обработчик уже прошел
+                // и никого не нашел, здесь видна отмена — ожидающий не повиснет
+                if Task.isCancelled {
+                    lock.unlock()
+                    continuation.resume(returning: false)
+                } else if waiters.isEmpty && reservedBytes + bytes <= capacityBytes {
+                    grant(bytes)
+                    lock.unlock()
+                    continuation.resume(returning: true)
+                } else {
+                    waiters.append(Waiter(id: id, bytes: bytes, continuation: continuation))
+                    lock.unlock()
+                }
+            }
+        } onCancel: {
+            cancelWaiter(id: id)
+        }
+        return granted ? bytes : nil
+    }
+
+    /// bytes — значение, которое вернул reserve
+    func release(_ bytes: Int) {
+        lock.lock()
+        reservedBytes -= bytes
+        let ready = takeReadyWaiters()
+        lock.unlock()
+        // Вне блокировки: продолжение может сразу вызвать reserve
+        ready.forEach { $0.resume(returning: true) }
+    }
+
+    // MARK: - Private Methods
+
+    private func cancelWaiter(id: UInt64) {
+        lock.lock()
+        guard let index = waiters.firstIndex(where: { $0.id == id }) else {
+            lock.unlock()
+            return
+        }
+        let cancelled = waiters.remove(at: index)
+        // Снятый из головы ожидающий мог держать очередь за собой
+        let ready = takeReadyWaiters()
+        lock.unlock()
+        cancelled.continuation.resume(returning: false)
+        ready.forEach { $0.resume(returning: true) }
+    }
+
+    /// Под lock: выдает бюджет ожидающим по порядку, пока помещаются
+    private func takeReadyWaiters() -> [CheckedContinuation<Bool, Never>] {
+        var ready: [CheckedContinuation<Bool, Never>] = []
+        while let first = waiters.first, reservedBytes + first.bytes <= capacityBytes {
+            waiters.removeFirst()
+            grant(first.bytes)
+            ready.append(first.continuation)
+        }
+        return ready
+    }
+
+    private func grant(_ bytes: Int) {
+        reservedBytes += bytes
+        peakBytes = max(peakBytes, reservedBytes)
+    }
+}
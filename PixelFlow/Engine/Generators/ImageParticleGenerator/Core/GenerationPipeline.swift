@@ -12,6 +12,18 @@ import Foundation
 /// Конвейер выполнения этапов генерации частиц
 final class GenerationPipeline: GenerationPipelineProtocol {
 
+    // MARK: - Constants
+
+    private enum Constants {
+        // Частиц в порции потоковой сборки: первая порция видна через ~1 мс сборки
+        static let particleChunkSize = 16_384
+        // Порций в очереди между сборкой и получателем: сборка уходит вперед
+        // не больше чем на столько порций (~6 МБ), дальше ждет получателя
+        static let particleChunkQueueCapacity = 4
+        // Анализ работает по копии не больше 2048 px — его стоимость ограничена
+        static let analysisMaxPixels = 2048.0 * 2048.0
+    }
+
     // MARK: - Dependencies
 
     private let analyzer: ImageAnalyzerProtocol
@@ -20,6 +32,7 @@ final class GenerationPipeline: GenerationPipelineProtocol {
     private let strategy: GenerationStrategyProtocol
     private var context: GenerationContextProtocol
     private let logger: LoggerProtocol
+    private let taskPool: TaskPool
 
     // MARK: - Initialization
 
@@ -28,13 +41,15 @@ final class GenerationPipeline: GenerationPipelineProtocol {
          assembler: ParticleAssemblerProtocol,
          strategy: GenerationStrategyProtocol? = nil,
          context: GenerationContextProtocol,
-         logger: LoggerProtocol) {
+         logger: LoggerProtocol,
+         taskPool: TaskPool = .shared) {
 
         self.analyzer = analyzer
         self.sampler = sampler
         self.assembler = assembler
         self.context = context
         self.logger = logger
+        self.taskPool = taskPool
         let resolvedStrategy = strategy ?? SequentialStrategy(logger: logger)
         self.strategy = resolvedStrategy
 
@@ -47,7 +62,8 @@ final class GenerationPipeline: GenerationPipelineProtocol {
         image: CGImage,
         config: ParticleGenerationConfig,
         screenSize: CGSize,
-        progress: @escaping (Float, String) -> Void
+        progress: @escaping (Float, String) -> Void,
+        onChunk: ((ParticleChunk) -> Void)?
     ) async throws -> [Particle] {
 
         logger.info("Starting generation pipeline for image \(image.width)x\(image.height)")
@@ -59,55 +75,47 @@ final class GenerationPipeline: GenerationPipelineProtocol {
         context.reset()
         context.image = image
         context.config = config
-
-        // Выполнение этапов согласно стратегии (с учётом зависимостей и параллелизма)
+        // Контекст не держит изображение и результат до следующей генерации (и после ошибки):
+        // после возврата массив живет, только пока нужен вызывающему
+        defer { cleanupIntermediateData() }
+
+        // Этапы — узлы графа: каждый стартует, как только готовы его зависимости,
+        // без барьеров между группами. Потоковая сборка (и кэширование после нее)
+        // идет после графа порциями: ожидание получателя — приостановка задачи,
+        // а не поток пула, стоящий на семафоре
         let stages = effectiveStages(for: config)
-        let executionPlan = try buildExecutionPlan(stages: stages, strategy: strategy)
-        let totalStages = stages.count
-        var completedStages = 0
+        let reportProgress = makeProgressReporter(stageCount: stages.count, progress: progress)
+        let streamedStages: Set<GenerationStage> = onChunk == nil ? [] : [.assembly, .caching]
+        let graph = buildStageGraph(
+            stages: stages.filter { !streamedStages.contains($0) },
+            image: image,
+            config: config,
+            screenSize: screenSize,
+            reportProgress: reportProgress
+        )
 
-        let reportProgress: (GenerationStage) -> Void = { stage in
-            completedStages += 1
-            let currentProgress = Float(completedStages) / Float(max(1, totalStages))
-            self.context.updateProgress(currentProgress, stage: stage.description)
-            progress(currentProgress, stage.description)
-        }
-
-        for group in executionPlan {
-            try Task.checkCancellation()
-            let maxParallel = max(1, min(config.maxConcurrentOperations, group.count))
-            if group.count == 1 || maxParallel == 1 {
-                for stage in group {
-                    try await executeStageAndReport(
-                        stage,
-                        config: config,
-                        screenSize: screenSize,
-                        reportProgress: reportProgress
-                    )
-                }
-            } else {
-                var startIndex = 0
-                while startIndex < group.count {
-                    let endIndex = min(startIndex + maxParallel, group.count)
-                    let chunk = Array(group[startIndex..<endIndex])
-                    try await executeStageGroup(
-                        chunk,
-                        config: config,
-                        screenSize: screenSize,
-                        reportProgress: reportProgress
-                    )
-                    startIndex = endIndex
+        do {
+            try await graph.run(on: taskPool)
+            if let sink = onChunk {
+                try await assembleStreaming(screenSize: screenSize, sink: sink, reportProgress: reportProgress)
+                if stages.contains(.caching) {
+                    try performStageAndReport(.caching, config: config, screenSize: screenSize,
+                                              reportProgress: reportProgress)
                 }
             }
+        } catch is CancellationError {
+            throw GeneratorError.cancelled
+        } catch TaskGraphError.cycle {
+            logger.error("Stage graph has a dependency cycle: \(stages)")
+            throw GenerationPipelineError.pipelineInvalidConfiguration
         }
 
         // Финализация
-        guard !context.particles.isEmpty else {
+        let particles = context.particles
+        guard !particles.isEmpty else {
             throw GeneratorError.stageFailed(stage: "Assembly", error: GenerationPipelineError.emptyResult)
         }
 
-        let particles = context.particles
-
         logger.info("Generation pipeline completed successfully with \(particles.count) particles")
         return particles
     }
@@ -118,6 +126,26 @@ final class GenerationPipeline: GenerationPipelineProtocol {
         config: ParticleGenerationConfig,
         screenSize: CGSize
     ) async throws -> GenerationStageOutput {
+        try performStage(stage, input: input, config: config, screenSize: screenSize)
+    }
+
+    func validatePrerequisites(for config: ParticleGenerationConfig) throws {
+        try strategy.validate(config: config)
+    }
+
+    func cleanupIntermediateData() {
+        context.reset()
+    }
+
+    // MARK: - Stage Work
+
+    /// Тело этапа: синхронно, на потоке пула графа
+    private func performStage(
+        _ stage: GenerationStage,
+        input: GenerationStageInput,
+        config: ParticleGenerationConfig,
+        screenSize: CGSize
+    ) throws -> GenerationStageOutput {
 
         switch stage {
         case .analysis:
@@ -144,7 +172,13 @@ final class GenerationPipeline: GenerationPipelineProtocol {
                 image: image,
                 screenSize: screenSize
             )
-            return .samples(samples)
+            // Любой префикс — равномерная выборка: набор служит и меньшим бюджетам частиц
+            let orderedSamples = ProgressiveSampleOrder.reorder(
+                samples,
+                imageWidth: image.width,
+                imageHeight: image.height
+            )
+            return .samples(orderedSamples)
 
         case .assembly:
             guard case .samples(let samples) = input else {
@@ -173,14 +207,6 @@ final class GenerationPipeline: GenerationPipelineProtocol {
         }
     }
 
-    func validatePrerequisites(for config: ParticleGenerationConfig) throws {
-        try strategy.validate(config: config)
-    }
-
-    func cleanupIntermediateData() {
-        context.reset()
-    }
-
     // MARK: - Private Methods
 
     private func prepareInput(for stage: GenerationStage) throws -> GenerationStageInput {
@@ -227,6 +253,8 @@ final class GenerationPipeline: GenerationPipelineProtocol {
 
         case (.assembly, .particles(let particles)):
             context.particles = particles
+            // Сэмплы больше не нужны: не держим их рядом с частицами до конца генерации
+            context.samples = []
             if particles.first != nil {
             } else {
                 logger.warning("Assembly produced 0 particles")
@@ -241,6 +269,15 @@ final class GenerationPipeline: GenerationPipelineProtocol {
         }
     }
 
+    /// Ошибку декодирования покажет сам сэмплинг
+    private func prefetchPixelCache(for image: CGImage) {
+        do {
+            try sampler.preparePixelCache(for: image)
+        } catch {
+            logger.warning("Pixel cache prefetch failed: \(error)")
+        }
+    }
+
     // MARK: - Execution Planning
 
     private func effectiveStages(for config: ParticleGenerationConfig) -> [GenerationStage] {
@@ -251,55 +288,106 @@ final class GenerationPipeline: GenerationPipelineProtocol {
         return stages
     }
 
-    private func buildExecutionPlan(
+    /// Граф этапов: зависимости и приоритеты стратегии, стоимость — оценка по размеру
+    /// изображения и бюджету частиц (ранг узла — критический путь). Декодирование
+    /// пикселей — отдельный узел рядом с анализом: тот работает по уменьшенной копии.
+    /// Несвязанные этапы, которые стратегия не параллелит (или при
+    /// maxConcurrentOperations == 1), упорядочиваются ребрами по executionOrder
+    private func buildStageGraph(
         stages: [GenerationStage],
-        strategy: GenerationStrategyProtocol
-    ) throws -> [[GenerationStage]] {
+        image: CGImage,
+        config: ParticleGenerationConfig,
+        screenSize: CGSize,
+        reportProgress: @escaping (GenerationStage) -> Void
+    ) -> TaskGraph {
+        let graph = TaskGraph()
+        let serial = config.maxConcurrentOperations <= 1
+
+        var nodes: [GenerationStage: TaskGraph.Node] = [:]
+        for stage in stages {
+            nodes[stage] = graph.addNode(
+                priority: priorityValue(strategy.priority(for: stage)),
+                cost: estimatedCost(of: stage, image: image, config: config)
+            ) { [self] _ in
+                try performStageAndReport(stage, config: config, screenSize: screenSize, reportProgress: reportProgress)
+            }
+        }
+
         let stageSet = Set(stages)
-        let stageOrderIndex = Dictionary(uniqueKeysWithValues: stages.enumerated().map { ($0.element, $0.offset) })
-        var remaining = stages
-        var completed = Set<GenerationStage>()
-        var plan: [[GenerationStage]] = []
-
-        while !remaining.isEmpty {
-            let ready = stages.filter { stage in
-                guard remaining.contains(stage) else { return false }
-                let deps = strategy.dependencies(for: stage).filter { stageSet.contains($0) }
-                return deps.allSatisfy { completed.contains($0) }
+        var dependencies: [GenerationStage: Set<GenerationStage>] = [:]
+        for stage in stages {
+            dependencies[stage] = Set(strategy.dependencies(for: stage).filter { stageSet.contains($0) })
+        }
+
+        func reaches(_ stage: GenerationStage, _ target: GenerationStage) -> Bool {
+            var pending = [stage]
+            var visited = Set<GenerationStage>()
+            while let current = pending.popLast() {
+                if current == target { return true }
+                guard visited.insert(current).inserted else { continue }
+                pending.append(contentsOf: dependencies[current] ?? [])
             }
+            return false
+        }
 
-            let sortedReady = ready.sorted { lhs, rhs in
-                let lhsPriority = priorityValue(strategy.priority(for: lhs))
-                let rhsPriority = priorityValue(strategy.priority(for: rhs))
-                if lhsPriority != rhsPriority {
-                    return lhsPriority > rhsPriority
+        for (laterIndex, later) in stages.enumerated() {
+            for earlier in stages[..<laterIndex] where !reaches(later, earlier) && !reaches(earlier, later) {
+                if serial || !strategy.canParallelize(earlier) || !strategy.canParallelize(later) {
+                    dependencies[later, default: []].insert(earlier)
                 }
-                let lhsIndex = stageOrderIndex[lhs] ?? 0
-                let rhsIndex = stageOrderIndex[rhs] ?? 0
-                return lhsIndex < rhsIndex
             }
+        }
 
-            guard let firstReady = sortedReady.first else {
-                logger.error("Execution plan unresolved dependencies. Remaining: \(remaining)")
-                throw GenerationPipelineError.pipelineInvalidConfiguration
+        for stage in stages {
+            guard let node = nodes[stage] else { continue }
+            for dependency in dependencies[stage] ?? [] {
+                guard let dependencyNode = nodes[dependency] else { continue }
+                graph.addDependency(node, dependsOn: dependencyNode)
             }
+        }
 
-            if !strategy.canParallelize(firstReady) {
-                plan.append([firstReady])
-                completed.insert(firstReady)
-                remaining.removeAll { $0 == firstReady }
-                continue
+        if let analysisNode = nodes[.analysis], let samplingNode = nodes[.sampling] {
+            let decodeNode = graph.addNode(
+                priority: priorityValue(strategy.priority(for: .sampling)),
+                cost: Double(image.width * image.height)
+            ) { [self] _ in
+                prefetchPixelCache(for: image)
             }
-
-            let parallelStages = sortedReady.filter { strategy.canParallelize($0) }
-            plan.append(parallelStages)
-            for stage in parallelStages {
-                completed.insert(stage)
+            graph.addDependency(samplingNode, dependsOn: decodeNode)
+            if serial {
+                graph.addDependency(decodeNode, dependsOn: analysisNode)
             }
-            remaining.removeAll { parallelStages.contains($0) }
         }
 
-        return plan
+        return graph
+    }
+
+    /// Прогресс — доля завершенных этапов из stageCount (в графе и после него)
+    private func makeProgressReporter(
+        stageCount: Int,
+        progress: @escaping (Float, String) -> Void
+    ) -> (GenerationStage) -> Void {
+        let progressLock = NSLock()
+        var completedStages = 0
+        return { stage in
+            progressLock.lock()
+            defer { progressLock.unlock() }
+            completedStages += 1
+            let currentProgress = Float(completedStages) / Float(max(1, stageCount))
+            self.context.updateProgress(currentProgress, stage: stage.description)
+            progress(currentProgress, stage.description)
+        }
+    }
+
+    /// Оценка времени этапа для ранга узла; единица — проход по пикселю или частице
+    private func estimatedCost(of stage: GenerationStage, image: CGImage, config: ParticleGenerationConfig) -> Double {
+        let pixels = Double(image.width * image.height)
+        switch stage {
+        case .analysis: return min(pixels, Constants.analysisMaxPixels)
+        case .sampling: return pixels
+        case .assembly: return Double(config.targetParticleCount)
+        case .caching: return 0
+        }
     }
 
     private func priorityValue(_ priority: Operation.QueuePriority) -> Int {
@@ -313,57 +401,102 @@ final class GenerationPipeline: GenerationPipelineProtocol {
         }
     }
 
-    // MARK: - Stage Execution
+    // MARK: - Streaming Assembly
 
-    private func executeStageAndReport(
-        _ stage: GenerationStage,
-        config: ParticleGenerationConfig,
+    /// Сборка порциями: каждая порция — узел пула, между порциями задача
+    /// приостанавливается до свободного места у получателя. Получатель
+    /// обрабатывает порцию k, пока собирается k + 1; поток пула не ждет
+    private func assembleStreaming(
         screenSize: CGSize,
-        reportProgress: @escaping (GenerationStage) -> Void
+        sink: @escaping (ParticleChunk) -> Void,
+        reportProgress: (GenerationStage) -> Void
     ) async throws {
+        let stage = GenerationStage.assembly
+        let relay = ParticleChunkRelay(capacity: Constants.particleChunkQueueCapacity, sink: sink)
+        let particles: [Particle]
         do {
-            try Task.checkCancellation()
-            let input = try prepareInput(for: stage)
-            let output = try await executeStage(stage, input: input, config: config, screenSize: screenSize)
-            try processOutput(output, for: stage)
-            reportProgress(stage)
+            particles = try await assembleChunks(screenSize: screenSize, relay: relay)
+        } catch {
+            // Отправленные порции дорабатывают до возврата — получатель не переживет execute
+            await relay.drain()
+            if error is CancellationError { throw error }
+            logger.error("Failed to execute stage \(stage): \(error)")
+            throw GeneratorError.stageFailed(stage: stage.description, error: error)
+        }
+        await relay.drain()
+
+        do {
+            try processOutput(.particles(particles), for: stage)
         } catch {
-            if Task.isCancelled || error is CancellationError {
-                throw GeneratorError.cancelled
-            }
             logger.error("Failed to execute stage \(stage): \(error)")
             throw GeneratorError.stageFailed(stage: stage.description, error: error)
         }
+        reportProgress(stage)
     }
 
-    private func executeStageGroup(
-        _ stages: [GenerationStage],
-        config: ParticleGenerationConfig,
+    private func assembleChunks(
         screenSize: CGSize,
-        reportProgress: @escaping (GenerationStage) -> Void
-    ) async throws {
-        try await withThrowingTaskGroup(of: GenerationStage.self) { group in
-            for stage in stages {
-                group.addTask { [self] in
-                    do {
-                        try Task.checkCancellation()
-                        let input = try prepareInput(for: stage)
-                        let output = try await executeStage(stage, input: input, config: config, screenSize: screenSize)
-                        try processOutput(output, for: stage)
-                        return stage
-                    } catch {
-                        if Task.isCancelled || error is CancellationError {
-                            throw GeneratorError.cancelled
-                        }
-                        logger.error("Failed to execute stage \(stage): \(error)")
-                        throw GeneratorError.stageFailed(stage: stage.description, error: error)
-                    }
-                }
-            }
+        relay: ParticleChunkRelay
+    ) async throws -> [Particle] {
+        guard case .samples(let samples) = try prepareInput(for: .assembly) else {
+            throw GenerationPipelineError.invalidInput
+        }
+        guard let image = context.image, let config = context.config else {
+            throw GenerationPipelineError.invalidContext
+        }
 
-            for try await stage in group {
-                reportProgress(stage)
+        let imageSize = CGSize(width: image.width, height: image.height)
+        let assembler = self.assembler
+        let priority = priorityValue(strategy.priority(for: .assembly))
+        var particles: [Particle] = []
+        particles.reserveCapacity(samples.count)
+
+        var chunkStart = 0
+        while chunkStart < samples.count {
+            try Task.checkCancellation()
+            let range = chunkStart..<min(chunkStart + Constants.particleChunkSize, samples.count)
+
+            var chunk: [Particle] = []
+            let graph = TaskGraph()
+            graph.addNode(priority: priority, cost: Double(range.count)) { _ in
+                chunk = assembler.assembleParticleChunk(
+                    from: samples,
+                    range: range,
+                    config: config,
+                    screenSize: screenSize,
+                    imageSize: imageSize,
+                    originalImageSize: imageSize
+                )
             }
+            try await graph.run(on: taskPool)
+            // Пустая порция — сборщик отверг вход (ошибка в логе); дальше то же
+            guard !chunk.isEmpty else { break }
+
+            particles.append(contentsOf: chunk)
+            // Порция собрана заранее: места у получателя ждет задача, а не поток пула
+            await relay.waitForSlot()
+            relay.push(ParticleChunk(startIndex: range.lowerBound, particles: chunk))
+            chunkStart = range.upperBound
+        }
+        return particles
+    }
+
+    // MARK: - Stage Execution
+
+    private func performStageAndReport(
+        _ stage: GenerationStage,
+        config: ParticleGenerationConfig,
+        screenSize: CGSize,
+        reportProgress: (GenerationStage) -> Void
+    ) throws {
+        do {
+            let input = try prepareInput(for: stage)
+            let output = try performStage(stage, input: input, config: config, screenSize: screenSize)
+            try processOutput(output, for: stage)
+            reportProgress(stage)
+        } catch {
+            logger.error("Failed to execute stage \(stage): \(error)")
+            throw GeneratorError.stageFailed(stage: stage.description, error: error)
         }
     }
 }
@@ -378,3 +511,69 @@ extension GenerationStage {
         }
     }
 }
+
+// MARK: - Chunk Relay
+
+/// Ограниченная очередь между сборкой и получателем порций: получатель
+/// (копия в кольцо буферов) работает на своей очереди, сборка продолжается.
+/// Заполненная очередь приостанавливает задачу сборки (waitForSlot) —
+/// порции не копятся в памяти, а поток пула не ждет получателя
+private final class ParticleChunkRelay {
+
+    private let sink: (ParticleChunk) -> Void
+    private let queue = DispatchQueue(label: "com.generation.pipeline.chunks", qos: .userInitiated)
+    private let lock = NSLock()
+    private var freeSlots: Int
+    /// Производитель один — ждет не больше одного
+    private var slotWaiter: CheckedContinuation<Void, Never>?
+
+    init(capacity: Int, sink: @escaping (ParticleChunk) -> Void) {
+        self.sink = sink
+        self.freeSlots = max(1, capacity)
+    }
+
+    /// Занимает место под следующую порцию; при полной очереди — приостановка
+    /// до обработки порции получателем
+    func waitForSlot() async {
+        await withCheckedContinuation { (continuation: CheckedContinuation<Void, Never>) in
+            lock.lock()
+            if freeSlots > 0 {
+                freeSlots -= 1
+                lock.unlock()
+                continuation.resume()
+            } else {
+                slotWaiter = continuation
+                lock.unlock()
+            }
+        }
+    }
+
+    /// Место занято waitForSlot
+    func push(_ chunk: ParticleChunk) {
+        queue.async { [self] in
+            sink(chunk)
+            releaseSlot()
+        }
+    }
+
+    /// Ждет, пока получатель обработает все отправленные порции
+    func drain() async {
+        await withCheckedContinuation { (continuation: CheckedContinuation<Void, Never>) in
+            queue.async {
+                continuation.resume()
+            }
+        }
+    }
+
+    private func releaseSlot() {
+        lock.lock()
+        if let waiter = slotWaiter {
+            slotWaiter = nil
+            lock.unlock()
+            waiter.resume()
+        } else {
+            freeSlots += 1
+            lock.unlock()
+        }
+    }
+}
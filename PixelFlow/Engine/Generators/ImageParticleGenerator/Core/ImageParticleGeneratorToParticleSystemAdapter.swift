@@ -30,6 +30,43 @@ final class ImageParticleGeneratorToParticleSystemAdapter: ParticleGeneratorProt
     // MARK: - ParticleGeneratorProtocol
 
     func generateParticles(from image: CGImage, config: ParticleGenerationConfig, screenSize: CGSize) async throws -> [Particle] {
+        try await generateParticles(from: image, config: config, screenSize: screenSize, chunkHandler: nil)
+    }
+
+    func generateParticles(
+        from image: CGImage,
+        config: ParticleGenerationConfig,
+        screenSize: CGSize,
+        onChunk: @escaping (ParticleChunk) -> Void
+    ) async throws -> [Particle] {
+        try await generateParticles(from: image, config: config, screenSize: screenSize, chunkHandler: onChunk)
+    }
+
+    func prewarmCache(jobs: [GenerationJob], memoryBudgetBytes: Int) async -> BatchGenerationReport {
+        // Результаты остаются в кэше координатора; ошибки заданий он логирует сам
+        let report = await coordinator.generateParticles(
+            batch: jobs,
+            memoryBudgetBytes: memoryBudgetBytes,
+            onResult: { _, _ in }
+        )
+        logger.info("Cache prewarm: \(report.generated) generated, \(report.cached) cached, \(report.failed) failed")
+        return report
+    }
+
+    func clearCache() {
+        coordinator.cancelGeneration()
+        // Очистка кэша генератора
+        coordinator.clearCache()
+    }
+
+    // MARK: - Private Methods
+
+    private func generateParticles(
+        from image: CGImage,
+        config: ParticleGenerationConfig,
+        screenSize: CGSize,
+        chunkHandler: ((ParticleChunk) -> Void)?
+    ) async throws -> [Particle] {
         logger.info("Generating particles from image \(image.width)x\(image.height) with config: \(config.qualityPreset)")
 
         do {
@@ -37,7 +74,8 @@ final class ImageParticleGeneratorToParticleSystemAdapter: ParticleGeneratorProt
                 from: image,
                 config: config,
                 screenSize: screenSize,
-                progress: { _, _ in }
+                progress: { _, _ in },
+                onChunk: chunkHandler
             )
 
             logger.info("Successfully generated \(particles.count) particles")
@@ -47,10 +85,4 @@ final class ImageParticleGeneratorToParticleSystemAdapter: ParticleGeneratorProt
             throw error
         }
     }
-
-    func clearCache() {
-        coordinator.cancelGeneration()
-        // Очистка кэша генератора
-        coordinator.clearCache()
-    }
 }
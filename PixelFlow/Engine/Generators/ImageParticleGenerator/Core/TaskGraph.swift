@@ -0,0 +1,193 @@
+//
+//  TaskGraph.swift
+//  PixelFlow
+//
+//  Граф задач поверх TaskGraphC.h: узлы-замыкания с зависимостями,
+//  приоритетом и оценкой стоимости (критический путь первым), parallel_for
+//  порциями и отменой через Task. Узлы выполняются на потоках TaskPool,
+//  а не на кооперативном пуле Swift — блокирующая работа его не занимает.
+//
+
+import Foundation
+
+enum TaskGraphError: Error {
+    case cycle
+    case outOfMemory
+    case failed
+}
+
+/// Общий пул потоков исполнителя графов
+final class TaskPool {
+
+    static let shared = TaskPool(workerCount: ProcessInfo.processInfo.activeProcessorCount)
+
+    fileprivate let pool: OpaquePointer
+
+    var workerCount: Int { Int(taskPoolWorkerCountC(pool)) }
+
+    init(workerCount: Int) {
+        guard let pool = taskPoolCreateC(UInt32(clamping: max(workerCount, 1))) else {
+            fatalError("Unable to start task pool threads")
+        }
+        self.pool = pool
+    }
+
+    deinit {
+        taskPoolDestroyC(pool)
+    }
+}
+
+/// Одноразовый граф: узлы и зависимости добавляются до run
+final class TaskGraph {
+
+    struct Node {
+        fileprivate let index: Int32
+    }
+
+    /// Порция узла: диапазон итераций (для узла без iterations — 0..<1)
+    typealias Work = (Range<Int>) throws -> Void
+
+    // MARK: - Properties
+
+    private let graph: OpaquePointer
+    /// Замыкания узлов: C-часть получает их без удержания, граф держит до конца
+    private var works: [NodeWork] = []
+    private let failure = Failure()
+
+    /// Граф отменен: длинная работа узла может проверять и выходить раньше
+    var isCancelled: Bool { taskGraphIsCancelledC(graph) != 0 }
+
+    // MARK: - Initialization
+
+    init() {
+        guard let graph = taskGraphCreateC() else {
+            fatalError("Unable to allocate task graph")
+        }
+        self.graph = graph
+    }
+
+    deinit {
+        taskGraphDestroyC(graph)
+    }
+
+    // MARK: - Building
+
+    /// priority — больше раньше (между узлами всех графов пула); cost — оценка времени
+    /// в единицах, общих для графа: ранг узла — стоимость самого длинного пути от него.
+    /// iterations > 1 — parallel_for порциями по grain (0 — одна порция)
+    @discardableResult
+    func addNode(priority: Int = 0, cost: Double = 1, iterations: Int = 1, grain: Int = 0,
+                 work: @escaping Work) -> Node {
+        let nodeWork = NodeWork(work: work, failure: failure)
+        works.append(nodeWork)
+        let index = taskGraphAddNodeC(
+            graph,
+            taskGraphWork,
+            Unmanaged.passUnretained(nodeWork).toOpaque(),
+            UInt64(max(iterations, 0)),
+            UInt64(max(grain, 0)),
+            Int32(clamping: priority),
+            cost
+        )
+        if index < 0 {
+            failure.record(TaskGraphError.outOfMemory)
+        }
+        return Node(index: index)
+    }
+
+    /// node запустится только после dependsOn
+    func addDependency(_ node: Node, dependsOn: Node) {
+        guard node.index >= 0, dependsOn.index >= 0 else { return }
+        if taskGraphAddDependencyC(graph, node.index, dependsOn.index) == 0 {
+            failure.record(TaskGraphError.outOfMemory)
+        }
+    }
+
+    // MARK: - Execution
+
+    /// Выполняет граф на пуле. Первая ошибка узла отменяет остальные и пробрасывается;
+    /// отмена Task — CancellationError (начатые порции дорабатывают)
+    func run(on pool: TaskPool = .shared) async throws {
+        if let error = failure.error { throw error }
+
+        let graph = self.graph
+        let status: Int32 = await withTaskCancellationHandler {
+            await withCheckedContinuation { (continuation: CheckedContinuation<Int32, Never>) in
+                let completion = Unmanaged.passRetained(Completion(continuation))
+                let started = taskGraphStartC(graph, pool.pool, nil, { status, context in
+                    guard let context else { return }
+                    Unmanaged<Completion>.fromOpaque(context).takeRetainedValue().continuation.resume(returning: status)
+                }, completion.toOpaque())
+                if started != TASK_GRAPH_OK {
+                    completion.release()
+                    continuation.resume(returning: started)
+                }
+            }
+        } onCancel: {
+            taskGraphCancelC(graph)
+        }
+
+        switch status {
+        case TASK_GRAPH_OK:
+            return
+        case TASK_GRAPH_FAILED:
+            throw failure.error ?? TaskGraphError.failed
+        case TASK_GRAPH_CANCELLED:
+            throw CancellationError()
+        case TASK_GRAPH_ERROR_CYCLE:
+            throw TaskGraphError.cycle
+        default:
+            throw TaskGraphError.outOfMemory
+        }
+    }
+}
+
+// MARK: - C Bridging
+
+private final class NodeWork {
+    let work: TaskGraph.Work
+    let failure: Failure
+
+    init(work: @escaping TaskGraph.Work, failure: Failure) {
+        self.work = work
+        self.failure = failure
+    }
+}
+
+/// Первая ошибка узлов графа
+private final class Failure {
+    private let lock = NSLock()
+    private var firstError: Error?
+
+    var error: Error? {
+        lock.lock()
+        defer { lock.unlock() }
+        return firstError
+    }
+
+    func record(_ error: Error) {
+        lock.lock()
+        if firstError == nil { firstError = error }
+        lock.unlock()
+    }
+}
+
+private final class Completion {
+    let continuation: CheckedContinuation<Int32, Never>
+
+    init(_ continuation: CheckedContinuation<Int32, Never>) {
+        self.continuation = continuation
+    }
+}
+
+private let taskGraphWork: TaskWorkC = { context, begin, end in
+    guard let context else { return 0 }
+    let node = Unmanaged<NodeWork>.fromOpaque(context).takeUnretainedValue()
+    do {
+        try node.work(Int(begin)..<Int(end))
+        return 1
+    } catch {
+        node.failure.record(error)
+        return 0
+    }
+}
@@ -0,0 +1,468 @@
+//
+//  TaskGraphC.c
+//  PixelFlow
+//
+
+#include "TaskGraphC.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define POOL_INITIAL_HEAP 64u
+
+typedef struct {
+    TaskGraphC* graph;
+    int32_t node;
+    int32_t priority;
+    double rank;
+    uint64_t sequence;
+    uint64_t begin;
+    uint64_t end;
+} TaskItem;
+
+typedef struct {
+    TaskWorkC work;
+    void* context;
+    uint64_t iterations;
+    uint64_t grain;
+    int32_t priority;
+    double cost;
+    double rank;
+
+    int32_t* dependents;
+    uint32_t dependentCount;
+    uint32_t dependentCapacity;
+
+    uint32_t waitingFor;          // незавершенных предшественников
+    uint64_t chunksLeft;          // незавершенных порций
+    int scheduled;
+} TaskNode;
+
+struct TaskCancelTokenC {
+    atomic_int cancelled;
+};
+
+struct TaskGraphC {
+    TaskNode* nodes;
+    uint32_t nodeCount;
+    uint32_t nodeCapacity;
+
+    TaskPoolC* pool;
+    TaskCancelTokenC* token;
+    atomic_int cancelled;
+    TaskGraphCompletionC completion;
+    void* completionContext;
+
+    // Под блокировкой пула
+    uint32_t nodesLeft;
+    int32_t status;
+    int started;
+    int done;
+};
+
+struct TaskPoolC {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;       // новая работа или завершенный граф
+    pthread_t* threads;
+    uint32_t workerCount;
+    int stopping;
+
+    TaskItem* heap;
+    uint32_t heapCount;
+    uint32_t heapCapacity;
+    uint64_t sequence;
+};
+
+// MARK: - Ready Heap
+
+static int itemBefore(const TaskItem* lhs, const TaskItem* rhs) {
+    if (lhs->priority != rhs->priority) return lhs->priority > rhs->priority;
+    if (lhs->rank != rhs->rank) return lhs->rank > rhs->rank;
+    return lhs->sequence < rhs->sequence;
+}
+
+static int heapPush(TaskPoolC* pool, TaskItem item) {
+    if (pool->heapCount == pool->heapCapacity) {
+        const uint32_t capacity = pool->heapCapacity ? pool->heapCapacity * 2 : POOL_INITIAL_HEAP;
+        TaskItem* heap = (TaskItem*)realloc(pool->heap, sizeof(TaskItem) * capacity);
+        if (!heap) return 0;
+        pool->heap = heap;
+        pool->heapCapacity = capacity;
+    }
+    item.sequence = pool->sequence++;
+
+    uint32_t index = pool->heapCount++;
+    while (index > 0) {
+        const uint32_t parent = (index - 1) / 2;
+        if (!itemBefore(&item, &pool->heap[parent])) break;
+        pool->heap[index] = pool->heap[parent];
+        index = parent;
+    }
+    pool->heap[index] = item;
+    return 1;
+}
+
+static TaskItem heapPop(TaskPoolC* pool) {
+    const TaskItem top = pool->heap[0];
+    const TaskItem last = pool->heap[--pool->heapCount];
+
+    uint32_t index = 0;
+    for (;;) {
+        uint32_t child = index * 2 + 1;
+        if (child >= pool->heapCount) break;
+        if (child + 1 < pool->heapCount && itemBefore(&pool->heap[child + 1], &pool->heap[child])) child++;
+        if (!itemBefore(&pool->heap[child], &last)) break;
+        pool->heap[index] = pool->heap[child];
+        index = child;
+    }
+    if (pool->heapCount > 0) pool->heap[index] = last;
+    return top;
+}
+
+// MARK: - Scheduling (под блокировкой пула)
+
+static int graphCancelled(const TaskGraphC* graph) {
+    return atomic_load_explicit(&graph->cancelled, memory_order_relaxed)
+        || (graph->token && atomic_load_explicit(&graph->token->cancelled, memory_order_relaxed));
+}
+
+static void failGraph(TaskGraphC* graph, int32_t status) {
+    if (graph->status == TASK_GRAPH_OK) graph->status = status;
+    atomic_store_explicit(&graph->cancelled, 1, memory_order_relaxed);
+}
+
+static void completeNode(TaskGraphC* graph, int32_t nodeIndex);
+
+/// Ставит порции готового узла в кучу. Без порций узел сразу завершен
+static void scheduleNode(TaskGraphC* graph, int32_t nodeIndex) {
+    TaskPoolC* pool = graph->pool;
+    TaskNode* node = &graph->nodes[nodeIndex];
+    node->scheduled = 1;
+
+    const uint64_t grain = node->grain ? node->grain : (node->iterations ? node->iterations : 1);
+    node->chunksLeft = node->iterations ? (node->iterations + grain - 1) / grain : 0;
+    if (node->chunksLeft == 0) {
+        completeNode(graph, nodeIndex);
+        return;
+    }
+
+    uint64_t begin = 0;
+    const uint64_t chunks = node->chunksLeft;
+    for (uint64_t chunk = 0; chunk < chunks; chunk++) {
+        const uint64_t end = begin + grain < node->iterations ? begin + grain : node->iterations;
+        TaskItem item = { graph, nodeIndex, node->priority, node->rank, 0, begin, end };
+        if (!heapPush(pool, item)) {
+            // Нет памяти на кучу: непоставленные порции считаем выполненными, граф — упавшим
+            failGraph(graph, TASK_GRAPH_ERROR_NOMEM);
+            node->chunksLeft -= chunks - chunk;
+            if (node->chunksLeft == 0) completeNode(graph, nodeIndex);
+            break;
+        }
+        begin = end;
+    }
+    pthread_cond_broadcast(&pool->changed);
+}
+
+static void completeNode(TaskGraphC* graph, int32_t nodeIndex) {
+    TaskNode* node = &graph->nodes[nodeIndex];
+    graph->nodesLeft--;
+    for (uint32_t i = 0; i < node->dependentCount; i++) {
+        TaskNode* dependent = &graph->nodes[node->dependents[i]];
+        if (--dependent->waitingFor == 0) scheduleNode(graph, node->dependents[i]);
+    }
+}
+
+/// Снимает completion с графа, если он закончился. Вызов — после снятия блокировки
+static int takeCompletion(TaskGraphC* graph, TaskGraphCompletionC* completion, void** context, int32_t* status) {
+    if (graph->nodesLeft != 0 || graph->done) return 0;
+    if (graph->status == TASK_GRAPH_OK && graphCancelled(graph)) graph->status = TASK_GRAPH_CANCELLED;
+    *completion = graph->completion;
+    *context = graph->completionContext;
+    *status = graph->status;
+    graph->done = 1;
+    pthread_cond_broadcast(&graph->pool->changed);
+    return 1;
+}
+
+/// Выполняет порцию без блокировки и учитывает ее под блокировкой (держит ее на выходе)
+static void runItem(TaskPoolC* pool, TaskItem item) {
+    TaskGraphC* graph = item.graph;
+    TaskNode* node = &graph->nodes[item.node];
+
+    int ok = 1;
+    int ran = 0;
+    if (!graphCancelled(graph)) {
+        pthread_mutex_unlock(&pool->lock);
+        ok = node->work(node->context, item.begin, item.end);
+        ran = 1;
+        pthread_mutex_lock(&pool->lock);
+    }
+    if (ran && !ok) failGraph(graph, TASK_GRAPH_FAILED);
+
+    if (--node->chunksLeft == 0) completeNode(graph, item.node);
+
+    TaskGraphCompletionC completion = NULL;
+    void* context = NULL;
+    int32_t status = TASK_GRAPH_OK;
+    if (takeCompletion(graph, &completion, &context, &status)) {
+        // После done граф может быть освобожден ждущим потоком — дальше его не трогаем
+        pthread_mutex_unlock(&pool->lock);
+        if (completion) completion(status, context);
+        pthread_mutex_lock(&pool->lock);
+    }
+}
+
+static void* workerMain(void* argument) {
+    TaskPoolC* pool = (TaskPoolC*)argument;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->heapCount == 0 && !pool->stopping) {
+            pthread_cond_wait(&pool->changed, &pool->lock);
+        }
+        if (pool->heapCount == 0) break;
+        runItem(pool, heapPop(pool));
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// MARK: - Pool
+
+TaskPoolC* taskPoolCreateC(uint32_t workerCount) {
+    if (workerCount == 0) {
+        const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        workerCount = cores > 0 ? (uint32_t)cores : 1;
+    }
+    if (workerCount > TASK_POOL_MAX_WORKERS) workerCount = TASK_POOL_MAX_WORKERS;
+
+    TaskPoolC* pool = (TaskPoolC*)calloc(1, sizeof(TaskPoolC));
+    if (!pool) return NULL;
+    pool->threads = (pthread_t*)calloc(workerCount, sizeof(pthread_t));
+    if (!pool->threads) {
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->changed, NULL);
+
+    for (uint32_t i = 0; i < workerCount; i++) {
+        if (pthread_create(&pool->threads[i], NULL, workerMain, pool) != 0) {
+            pool->workerCount = i;
+            taskPoolDestroyC(pool);
+            return NULL;
+        }
+    }
+    pool->workerCount = workerCount;
+    return pool;
+}
+
+void taskPoolDestroyC(TaskPoolC* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = 1;
+    pthread_cond_broadcast(&pool->changed);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (uint32_t i = 0; i < pool->workerCount; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_cond_destroy(&pool->changed);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->heap);
+    free(pool->threads);
+    free(pool);
+}
+
+uint32_t taskPoolWorkerCountC(const TaskPoolC* pool) {
+    return pool->workerCount;
+}
+
+// MARK: - Cancellation
+
+TaskCancelTokenC* taskCancelTokenCreateC(void) {
+    TaskCancelTokenC* token = (TaskCancelTokenC*)malloc(sizeof(TaskCancelTokenC));
+    if (token) atomic_init(&token->cancelled, 0);
+    return token;
+}
+
+void taskCancelTokenDestroyC(TaskCancelTokenC* token) {
+    free(token);
+}
+
+void taskCancelTokenCancelC(TaskCancelTokenC* token) {
+    atomic_store(&token->cancelled, 1);
+}
+
+int taskCancelTokenIsCancelledC(const TaskCancelTokenC* token) {
+    return atomic_load(&token->cancelled);
+}
+
+// MARK: - Graph
+
+TaskGraphC* taskGraphCreateC(void) {
+    TaskGraphC* graph = (TaskGraphC*)calloc(1, sizeof(TaskGraphC));
+    if (graph) atomic_init(&graph->cancelled, 0);
+    return graph;
+}
+
+void taskGraphDestroyC(TaskGraphC* graph) {
+    if (!graph) return;
+    for (uint32_t i = 0; i < graph->nodeCount; i++) {
+        free(graph->nodes[i].dependents);
+    }
+    free(graph->nodes);
+    free(graph);
+}
+
+int32_t taskGraphAddNodeC(TaskGraphC* graph, TaskWorkC work, void* context,
+                          uint64_t iterations, uint64_t grain, int32_t priority, double cost) {
+    if (graph->started || !work || graph->nodeCount >= INT32_MAX) return -1;
+
+    if (graph->nodeCount == graph->nodeCapacity) {
+        const uint32_t capacity = graph->nodeCapacity ? graph->nodeCapacity * 2 : 8;
+        TaskNode* nodes = (TaskNode*)realloc(graph->nodes, sizeof(TaskNode) * capacity);
+        if (!nodes) return -1;
+        graph->nodes = nodes;
+        graph->nodeCapacity = capacity;
+    }
+
+    TaskNode* node = &graph->nodes[graph->nodeCount];
+    memset(node, 0, sizeof(*node));
+    node->work = work;
+    node->context = context;
+    node->iterations = iterations;
+    node->grain = grain;
+    node->priority = priority;
+    node->cost = cost > 0 ? cost : 0;
+    return (int32_t)graph->nodeCount++;
+}
+
+int taskGraphAddDependencyC(TaskGraphC* graph, int32_t node, int32_t dependsOn) {
+    if (graph->started || node < 0 || dependsOn < 0 || node == dependsOn
+        || (uint32_t)node >= graph->nodeCount || (uint32_t)dependsOn >= graph->nodeCount) {
+        return 0;
+    }
+
+    TaskNode* before = &graph->nodes[dependsOn];
+    if (before->dependentCount == before->dependentCapacity) {
+        const uint32_t capacity = before->dependentCapacity ? before->dependentCapacity * 2 : 4;
+        int32_t* dependents = (int32_t*)realloc(before->dependents, sizeof(int32_t) * capacity);
+        if (!dependents) return 0;
+        before->dependents = dependents;
+        before->dependentCapacity = capacity;
+    }
+    before->dependents[before->dependentCount++] = node;
+    graph->nodes[node].waitingFor++;
+    return 1;
+}
+
+/// Ранги в обратном топологическом порядке (Кан). 0 — цикл или нет памяти
+static int32_t computeRanks(TaskGraphC* graph) {
+    const uint32_t count = graph->nodeCount;
+    if (count == 0) return TASK_GRAPH_OK;
+
+    int32_t* order = (int32_t*)malloc(sizeof(int32_t) * count);
+    uint32_t* waiting = (uint32_t*)malloc(sizeof(uint32_t) * count);
+    if (!order || !waiting) {
+        free(order);
+        free(waiting);
+        return TASK_GRAPH_ERROR_NOMEM;
+    }
+
+    uint32_t head = 0, tail = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        waiting[i] = graph->nodes[i].waitingFor;
+        if (waiting[i] == 0) order[tail++] = (int32_t)i;
+    }
+    while (head < tail) {
+        const TaskNode* node = &graph->nodes[order[head++]];
+        for (uint32_t i = 0; i < node->dependentCount; i++) {
+            if (--waiting[node->dependents[i]] == 0) order[tail++] = node->dependents[i];
+        }
+    }
+    free(waiting);
+
+    if (tail != count) {
+        free(order);
+        return TASK_GRAPH_ERROR_CYCLE;
+    }
+
+    for (uint32_t i = count; i-- > 0;) {
+        TaskNode* node = &graph->nodes[order[i]];
+        double longest = 0;
+        for (uint32_t j = 0; j < node->dependentCount; j++) {
+            const double rank = graph->nodes[node->dependents[j]].rank;
+            if (rank > longest) longest = rank;
+        }
+        node->rank = node->cost + longest;
+    }
+    free(order);
+    return TASK_GRAPH_OK;
+}
+
+int32_t taskGraphStartC(TaskGraphC* graph, TaskPoolC* pool, TaskCancelTokenC* token,
+                        TaskGraphCompletionC completion, void* completionContext) {
+    if (graph->started) return TASK_GRAPH_ERROR_STATE;
+
+    const int32_t status = computeRanks(graph);
+    if (status != TASK_GRAPH_OK) return status;
+
+    graph->pool = pool;
+    graph->token = token;
+    graph->completion = completion;
+    graph->completionContext = completionContext;
+    graph->status = TASK_GRAPH_OK;
+
+    pthread_mutex_lock(&pool->lock);
+    graph->started = 1;
+    graph->nodesLeft = graph->nodeCount;
+    for (uint32_t i = 0; i < graph->nodeCount; i++) {
+        // Узел без порций завершается сразу и может поставить зависимых раньше обхода
+        if (graph->nodes[i].waitingFor == 0 && !graph->nodes[i].scheduled) {
+            scheduleNode(graph, (int32_t)i);
+        }
+    }
+
+    TaskGraphCompletionC finished = NULL;
+    void* context = NULL;
+    int32_t finalStatus = TASK_GRAPH_OK;
+    const int completedNow = takeCompletion(graph, &finished, &context, &finalStatus);
+    pthread_mutex_unlock(&pool->lock);
+
+    if (completedNow && finished) finished(finalStatus, context);
+    return TASK_GRAPH_OK;
+}
+
+int32_t taskGraphWaitC(TaskGraphC* graph) {
+    TaskPoolC* pool = graph->pool;
+    if (!pool) return TASK_GRAPH_ERROR_STATE;
+
+    pthread_mutex_lock(&pool->lock);
+    while (!graph->done) {
+        if (pool->heapCount > 0) {
+            runItem(pool, heapPop(pool));
+        } else {
+            pthread_cond_wait(&pool->changed, &pool->lock);
+        }
+    }
+    const int32_t status = graph->status;
+    pthread_mutex_unlock(&pool->lock);
+    return status;
+}
+
+void taskGraphCancelC(TaskGraphC* graph) {
+    atomic_store(&graph->cancelled, 1);
+}
+
+int taskGraphIsCancelledC(const TaskGraphC* graph) {
+    return graphCancelled(graph);
+}
+
+double taskGraphNodeRankC(const TaskGraphC* graph, int32_t node) {
+    if (node < 0 || (uint32_t)node >= graph->nodeCount) return 0;
+    return graph->nodes[node].rank;
+}
@@ -0,0 +1,100 @@
+//
+//  TaskGraphC.h
+//  PixelFlow
+//
+//  Исполнитель графа задач для этапов генерации: узлы с зависимостями
+//  запускаются, как только готовы их предшественники — без барьеров между
+//  группами. Узел с iterations > 1 — parallel_for: диапазон режется на порции
+//  по grain, порции выполняют разные потоки пула.
+//
+//  Пул общий для всех графов. Очередь готовых порций — куча: сначала больший
+//  priority, затем больший ранг (стоимость самого длинного пути от узла до
+//  конца графа — критический путь первым), затем порядок постановки.
+//
+
+#ifndef TaskGraphC_h
+#define TaskGraphC_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TASK_GRAPH_OK              0
+#define TASK_GRAPH_FAILED          1   // работа узла вернула 0; остальные узлы пропущены
+#define TASK_GRAPH_CANCELLED       2
+#define TASK_GRAPH_ERROR_CYCLE     3
+#define TASK_GRAPH_ERROR_NOMEM     4
+#define TASK_GRAPH_ERROR_STATE     5   // граф уже запущен
+
+#define TASK_POOL_MAX_WORKERS      64u
+
+/// Порция узла [begin, end). 0 — ошибка: граф завершается со статусом FAILED
+typedef int (*TaskWorkC)(void* context, uint64_t begin, uint64_t end);
+
+/// Вызывается один раз, на потоке, завершившем последнюю порцию (или на
+/// запустившем, если порций нет). После вызова исполнитель граф не трогает
+typedef void (*TaskGraphCompletionC)(int32_t status, void* context);
+
+typedef struct TaskPoolC TaskPoolC;
+typedef struct TaskGraphC TaskGraphC;
+typedef struct TaskCancelTokenC TaskCancelTokenC;
+
+// MARK: - Pool
+
+/// workerCount: 0 — по числу ядер (не больше TASK_POOL_MAX_WORKERS). NULL — нет памяти или потоков
+TaskPoolC* taskPoolCreateC(uint32_t workerCount);
+
+/// Останавливает потоки. Вызывать, когда запущенные графы завершены
+void taskPoolDestroyC(TaskPoolC* pool);
+
+uint32_t taskPoolWorkerCountC(const TaskPoolC* pool);
+
+// MARK: - Cancellation
+
+/// Токен отмены: один токен может отменять несколько графов
+TaskCancelTokenC* taskCancelTokenCreateC(void);
+void taskCancelTokenDestroyC(TaskCancelTokenC* token);
+void taskCancelTokenCancelC(TaskCancelTokenC* token);
+int taskCancelTokenIsCancelledC(const TaskCancelTokenC* token);
+
+// MARK: - Graph
+
+TaskGraphC* taskGraphCreateC(void);
+
+/// Граф освобождается после завершения (completion вызван или wait вернулся)
+void taskGraphDestroyC(TaskGraphC* graph);
+
+/// Узел из iterations итераций, порциями по grain (0 — одна порция на весь диапазон).
+/// cost — оценка времени узла для ранга (единицы любые, но общие для графа).
+/// Номер узла или -1 — нет памяти
+int32_t taskGraphAddNodeC(TaskGraphC* graph, TaskWorkC work, void* context,
+                          uint64_t iterations, uint64_t grain, int32_t priority, double cost);
+
+/// node запустится только после dependsOn. 0 — неверный номер
+int taskGraphAddDependencyC(TaskGraphC* graph, int32_t node, int32_t dependsOn);
+
+/// Считает ранги и ставит готовые узлы в пул. token может быть NULL.
+/// TASK_GRAPH_OK — запущен (completion будет вызван), иначе ошибка и completion не вызывается
+int32_t taskGraphStartC(TaskGraphC* graph, TaskPoolC* pool, TaskCancelTokenC* token,
+                        TaskGraphCompletionC completion, void* completionContext);
+
+/// Ждет завершения, выполняя готовые порции пула сам, — можно звать и из потока пула.
+/// Статус графа
+int32_t taskGraphWaitC(TaskGraphC* graph);
+
+/// Порции, еще не начатые, пропускаются; начатые доработают
+void taskGraphCancelC(TaskGraphC* graph);
+
+/// Граф отменен (сам или токеном): длинная работа узла может проверять и выходить раньше
+int taskGraphIsCancelledC(const TaskGraphC* graph);
+
+/// Ранг узла после запуска: стоимость самого длинного пути от него до конца графа
+double taskGraphNodeRankC(const TaskGraphC* graph, int32_t node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TaskGraphC_h */
@@ -3,3 +3,22 @@
 //
 
 #include "PixelSampler.h"
+#include "ProgressiveOrderC.h"
+#include "../../Caching/ParticleCacheFileC.h"
+#include "../../Caching/CacheIndexC.h"
+#include "../../Caching/ShardedLRUCacheC.h"
+#include "../../Core/TaskGraphC.h"
+#include "../../../../ParticleSystem/Particles/ParticleSeeds.h"
+#include "../../../../ParticleSystem/Utils/FastMathC.h"
+#include "../../../../ParticleSystem/Particles/CollectedCounter.h"
+#include "../../../../ParticleSystem/Particles/NeighborGridC.h"
+#include "../../../../ParticleSystem/Particles/AttractorFieldC.h"
+#include "../../../../ParticleSystem/Particles/SimulationTraceC.h"
+#include "../../../../ParticleSystem/Rendering/PointSpriteRasterC.h"
+#include "../../../../ParticleSystem/Particles/ColorSpaceC.h"
+#include "../../../../ParticleSystem/Rendering/RadialProfileC.h"
+#include "../../../../ParticleSystem/Utils/BufferRingC.h"
+#include "../../../../ParticleSystem/Particles/SimulationCommandRingC.h"
+#include "../../../../ParticleSystem/Particles/PreviewIntegratorC.h"
+#include "../../../../ParticleSystem/Particles/TransitionBlendC.h"
+#include "../../../../ParticleSystem/Utils/DirtyRangeC.h"
@@ -0,0 +1,157 @@
+//
+//  ProgressiveOrderC.c
+//  PixelFlow
+//
+
+#include "ProgressiveOrderC.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Поразрядная сортировка по старшим 22 битам ключа: 2 прохода по 11 бит.
+// Ключи, различные только в младших 10 битах, остаются в порядке сэмплера —
+// префикс точен до 1/4M доли набора
+#define ORDER_RADIX_BITS     11
+#define ORDER_RADIX_BUCKETS  (1u << ORDER_RADIX_BITS)
+#define ORDER_RADIX_PASSES   2
+#define ORDER_RADIX_LOW_BITS (32 - ORDER_RADIX_BITS * ORDER_RADIX_PASSES)
+
+// 4^15 порогов Байера еще помещаются в uint32
+#define ORDER_MAX_BAYER_BITS 15
+
+static inline uint32_t orderHash(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+/// Порог матрицы Байера 2^bits × 2^bits в ячейке (x, y): 0 ..< 4^bits.
+/// Биты (x ^ y, y) перемежаются и разворачиваются — младшие биты координат
+/// дают старшие биты порога
+static inline uint32_t bayerIndex(uint32_t x, uint32_t y, int bits) {
+    uint32_t xy = x ^ y;
+    uint32_t value = 0;
+    for (int i = 0; i < bits; i++) {
+        value = (value << 2) | (((xy >> i) & 1u) << 1) | ((y >> i) & 1u);
+    }
+    return value;
+}
+
+/// Ячейка точки i; координаты вне изображения прижимаются к краю
+static inline size_t cellOf(const int32_t* coordinates, int i, int side, int gridWidth, int gridHeight) {
+    int cx = coordinates[2 * i] / side;
+    int cy = coordinates[2 * i + 1] / side;
+    cx = cx < 0 ? 0 : (cx >= gridWidth ? gridWidth - 1 : cx);
+    cy = cy < 0 ? 0 : (cy >= gridHeight ? gridHeight - 1 : cy);
+    return (size_t)cy * (size_t)gridWidth + (size_t)cx;
+}
+
+int progressiveOrderC(const int32_t* coordinates, int count, int width, int height,
+                      int pointsPerCell, uint32_t seed, uint32_t* order) {
+    if (!coordinates || !order || count <= 0 || width <= 0 || height <= 0) return -1;
+    if (pointsPerCell <= 0) pointsPerCell = PROGRESSIVE_ORDER_POINTS_PER_CELL_C;
+
+    // Сторона ячейки — так, чтобы в среднем выходило pointsPerCell точек
+    double area = (double)width * (double)height;
+    double cellsWanted = fmax(1.0, (double)count / (double)pointsPerCell);
+    int side = (int)ceil(sqrt(area / cellsWanted));
+    if (side < 1) side = 1;
+
+    const int gridWidth = (width + side - 1) / side;
+    const int gridHeight = (height + side - 1) / side;
+    const size_t cellCount = (size_t)gridWidth * (size_t)gridHeight;
+
+    int bits = 0;
+    while (bits < ORDER_MAX_BAYER_BITS && ((1 << bits) < gridWidth || (1 << bits) < gridHeight)) bits++;
+
+    uint32_t* cellCounts = (uint32_t*)calloc(cellCount, sizeof(uint32_t));
+    uint32_t* cellThresholds = (uint32_t*)malloc(cellCount * sizeof(uint32_t));
+    uint32_t* cellRanks = (uint32_t*)malloc(cellCount * sizeof(uint32_t));
+    uint64_t* items = (uint64_t*)malloc((size_t)count * sizeof(uint64_t));
+    uint64_t* itemsSwap = (uint64_t*)malloc((size_t)count * sizeof(uint64_t));
+    if (!cellCounts || !cellThresholds || !cellRanks || !items || !itemsSwap) {
+        free(cellCounts);
+        free(cellThresholds);
+        free(cellRanks);
+        free(items);
+        free(itemsSwap);
+        return -1;
+    }
+
+    // Ячейка точки хранится в items до расчета ключа
+    for (int i = 0; i < count; i++) {
+        const size_t cell = cellOf(coordinates, i, side, gridWidth, gridHeight);
+        cellCounts[cell]++;
+        items[i] = cell;
+    }
+
+    // Порог ячейки u — 32-битная фиксированная точка: уровень Байера в старших битах,
+    // дрожание внутри уровня в младших (у соседних ячеек нет равных ключей).
+    // Номер точки в ячейке стартует со случайного сдвига: первой идет не всегда
+    // левая верхняя точка построчного порядка сэмплера
+    const int thresholdShift = 32 - 2 * bits;
+    for (int cy = 0; cy < gridHeight; cy++) {
+        for (int cx = 0; cx < gridWidth; cx++) {
+            const size_t cell = (size_t)cy * (size_t)gridWidth + (size_t)cx;
+            const uint32_t hash = orderHash((uint32_t)cell ^ seed);
+            const uint32_t bayer = bayerIndex((uint32_t)cx, (uint32_t)cy, bits);
+            const uint32_t jitter = bits > 0 ? hash >> (2 * bits) : hash;
+            cellThresholds[cell] = bits > 0 ? (bayer << thresholdShift) | jitter : jitter;
+            cellRanks[cell] = cellCounts[cell] > 0 ? orderHash(hash) % cellCounts[cell] : 0;
+        }
+    }
+
+    // Ключ k-й точки ячейки из n: (k + u) / n в старших 32 битах, индекс — в младших
+    for (int i = 0; i < count; i++) {
+        const size_t cell = (size_t)items[i];
+        const uint32_t points = cellCounts[cell];
+        uint32_t rank = cellRanks[cell]++;
+        if (rank >= points) rank -= points;
+
+        const uint64_t key = (((uint64_t)rank << 32) | cellThresholds[cell]) / points;
+        items[i] = (key << 32) | (uint32_t)i;
+    }
+
+    // Поразрядная сортировка по ключу; равные ключи сохраняют порядок сэмплера
+    uint32_t histogram[ORDER_RADIX_BUCKETS];
+    for (int pass = 0; pass < ORDER_RADIX_PASSES; pass++) {
+        const int shift = 32 + ORDER_RADIX_LOW_BITS + pass * ORDER_RADIX_BITS;
+        memset(histogram, 0, sizeof(histogram));
+        for (int i = 0; i < count; i++) {
+            histogram[(items[i] >> shift) & (ORDER_RADIX_BUCKETS - 1)]++;
+        }
+
+        // Все ключи в одном разряде — проход ничего не переставит
+        const uint64_t first = (items[0] >> shift) & (ORDER_RADIX_BUCKETS - 1);
+        if (histogram[first] == (uint32_t)count) continue;
+
+        uint32_t offset = 0;
+        for (uint32_t b = 0; b < ORDER_RADIX_BUCKETS; b++) {
+            const uint32_t size = histogram[b];
+            histogram[b] = offset;
+            offset += size;
+        }
+        for (int i = 0; i < count; i++) {
+            itemsSwap[histogram[(items[i] >> shift) & (ORDER_RADIX_BUCKETS - 1)]++] = items[i];
+        }
+
+        uint64_t* swap = items;
+        items = itemsSwap;
+        itemsSwap = swap;
+    }
+
+    for (int i = 0; i < count; i++) {
+        order[i] = (uint32_t)items[i];
+    }
+
+    free(cellCounts);
+    free(cellThresholds);
+    free(cellRanks);
+    free(items);
+    free(itemsSwap);
+    return 0;
+}
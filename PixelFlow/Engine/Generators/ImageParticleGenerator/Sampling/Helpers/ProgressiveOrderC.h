@@ -0,0 +1,40 @@
+//
+//  ProgressiveOrderC.h
+//  PixelFlow
+//
+//  Прогрессивный порядок сэмплов: любой префикс из N точек — сам по себе
+//  равномерно разнесенная выборка с той же плотностью, что у полного набора.
+//  Кадр делится на ячейки по ~pointsPerCell точек; k-я точка ячейки из n
+//  получает ключ (k + u) / n, где u — порог упорядоченного дизеринга
+//  (матрица Байера) ячейки. Префикс доли f берет из каждой ячейки f·n ± 1
+//  точек (плотность сэмплера сохраняется), а ячейки, где f·n < 1, отбираются
+//  по матрице Байера — стратифицированно на всех масштабах сразу.
+//
+
+#ifndef ProgressiveOrderC_h
+#define ProgressiveOrderC_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Средняя заполненность ячейки по умолчанию
+#define PROGRESSIVE_ORDER_POINTS_PER_CELL_C 4
+
+/// Порядок сэмплов по возрастанию ранга: order[rank] — индекс сэмпла
+/// coordinates    — пары (x, y) в пикселях изображения, count пар
+/// width, height  — размер изображения
+/// pointsPerCell  — средняя заполненность ячейки (<= 0 — PROGRESSIVE_ORDER_POINTS_PER_CELL_C)
+/// seed           — сид порядка внутри ячеек
+/// order          — выходной массив (должен быть count)
+/// 0 — успех, -1 — неверные аргументы или нет памяти (order не тронут)
+int progressiveOrderC(const int32_t* coordinates, int count, int width, int height,
+                      int pointsPerCell, uint32_t seed, uint32_t* order);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ProgressiveOrderC_h */
@@ -0,0 +1,52 @@
+//
+//  ProgressiveSampleOrder.swift
+//  PixelFlow
+//
+//  Прогрессивный порядок сэмплов (ProgressiveOrderC.h): любой префикс —
+//  равномерно разнесенная выборка с плотностью полного набора. Один набор
+//  частиц обслуживает любой меньший бюджет своим префиксом.
+//
+
+import Foundation
+
+enum ProgressiveSampleOrder {
+
+    // MARK: - Constants
+
+    private enum Constants {
+        // Постоянный сид: порядок воспроизводим между генерациями и в кэше
+        static let seed: UInt32 = 0x9E37_79B9
+    }
+
+    // MARK: - Public Interface
+
+    /// Сэмплы в прогрессивном порядке; при ошибке C-части — в исходном
+    static func reorder(_ samples: [Sample], imageWidth: Int, imageHeight: Int) -> [Sample] {
+        guard samples.count > 1,
+              samples.count <= Int(Int32.max),
+              imageWidth > 0, imageHeight > 0 else { return samples }
+
+        var coordinates = [Int32](repeating: 0, count: samples.count * 2)
+        for (index, sample) in samples.enumerated() {
+            coordinates[2 * index] = Int32(clamping: sample.x)
+            coordinates[2 * index + 1] = Int32(clamping: sample.y)
+        }
+
+        var order = [UInt32](repeating: 0, count: samples.count)
+        let status = progressiveOrderC(
+            coordinates,
+            Int32(samples.count),
+            Int32(clamping: imageWidth),
+            Int32(clamping: imageHeight),
+            0,
+            Constants.seed,
+            &order
+        )
+        guard status == 0 else {
+            Logger.shared.warning("Progressive ordering failed for \(samples.count) samples, keeping sampler order")
+            return samples
+        }
+
+        return order.map { samples[Int($0)] }
+    }
+}
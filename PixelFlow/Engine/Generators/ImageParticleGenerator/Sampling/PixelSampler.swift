@@ -14,10 +14,26 @@ import simd
 
 final class DefaultPixelSampler: PixelSampler, PixelSamplerProtocol {
 
+    private enum Constants {
+        // Фото 12 Мп — ~48 МБ декодированных пикселей плюс само изображение
+        static let pixelCacheCapacity = 256 * 1024 * 1024
+        // Вся емкость — одному изображению (до ~32 Мп): пиксели, декодированные
+        // параллельно анализу, не теряются из-за отказа шарда. Обращений — единицы
+        // на генерацию, конкуренции за блокировку нет
+        static let pixelCacheShards = 1
+    }
+
     // MARK: - Properties
 
     private let config: ParticleGenerationConfig
 
+    /// Декодированные пиксели по изображению: повторная генерация из того же
+    /// CGImage (другой бюджет, стратегия, экран) не рисует его заново
+    private let pixelCaches = MemoryCache<ImageIdentityKey, PixelCache>(
+        capacityBytes: Constants.pixelCacheCapacity,
+        shardCount: Constants.pixelCacheShards
+    )
+
     // MARK: - PixelSamplerProtocol
 
     var samplingStrategy: SamplingStrategy {
@@ -72,11 +88,22 @@ final class DefaultPixelSampler: PixelSampler, PixelSamplerProtocol {
         )
     }
     
+    func preparePixelCache(for image: CGImage) throws {
+        _ = try createPixelCache(from: image)
+    }
+    
     // MARK: - Pixel Cache Creation
     
     private func createPixelCache(from image: CGImage) throws -> PixelCache {
+        let key = ImageIdentityKey(image: image)
+        if let cache = pixelCaches.get(for: key) {
+            return cache
+        }
+
         do {
-            return try PixelCacheHelper.createPixelCache(from: image)
+            let cache = try PixelCacheHelper.createPixelCache(from: image)
+            pixelCaches.set(cache, for: key, cost: cache.dataCount + key.retainedBytes)
+            return cache
         } catch {
             Logger.shared.error("Failed to create pixel cache: \(error)")
             throw SamplingError.cacheCreationFailed(underlying: error)
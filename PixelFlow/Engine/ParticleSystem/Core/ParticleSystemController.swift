@@ -34,6 +34,9 @@ protocol ParticleSystemControlling {
     func updateConfiguration(_ config: ParticleGenerationConfig)
     func collectHighQualityImage()
     func startLightningStorm()
+    func startSwarm()
+    func setTouchAttractor(id: Int, location: CGPoint, repels: Bool)
+    func removeTouchAttractor(id: Int)
     func replaceWithHighQualityParticles(completion: @escaping (Bool) -> Void)
     func updateSimulation(deltaTime: Float)
     func checkCollectionCompletion()
@@ -42,12 +45,19 @@ protocol ParticleSystemControlling {
     func handleDidBecomeActive()
     func updateRenderViewLayout(frame: CGRect, scale: CGFloat)
     func setRenderPaused(_ paused: Bool)
+    func setParticleBudget(_ budget: Int?)
+    func applyThermalState(_ state: ProcessInfo.ThermalState)
 }
 
 // MARK: - Main Implementation
 
 @MainActor
 final class ParticleSystemController: ParticleSystemControlling {
+
+    private enum Constants {
+        // Прогрев — одно задание; дороже бюджета задание идет одно
+        static let cachePrewarmBudgetBytes = 256 * 1024 * 1024
+    }
    
     // MARK: - Dependencies
     
@@ -63,11 +73,17 @@ final class ParticleSystemController: ParticleSystemControlling {
     
     internal var sourceImage: CGImage?
     internal var particleCount: Int = 0
+    /// Предел рисуемых частиц (префикс буфера); nil — все
+    private var particleBudget: Int?
+    /// Доля рисуемых частиц по температуре устройства; nil — все
+    private var thermalFraction: Double?
     private var isHighQualityMode: Bool = false
     private weak var mtkView: MTKView?
     
     // Task management
     private var generationTask: Task<Void, Never>?
+    /// Фоновый прогрев кэша генерации для повернутого экрана
+    private var cachePrewarmTask: Task<Void, Never>?
 
     // State flags
     private var isCollectingHQ: Bool = false
@@ -105,7 +121,7 @@ final class ParticleSystemController: ParticleSystemControlling {
     
     private func setupComponentConnections() {
         renderer.setSimulationEngine(simulationEngine)
-        renderer.setParticleBuffer(storage.particleBuffer)
+        renderer.setParticleRing(storage.particleRing)
         setupCallbacks()
     }
 
@@ -145,7 +161,7 @@ extension ParticleSystemController {
 
         do {
             try renderer.setupBuffers(particleCount: particleCount)
-            renderer.updateParticleCount(particleCount)
+            renderer.updateParticleCount(visibleParticleCount(of: particleCount))
         } catch {
             logger.error("Failed to setup renderer: \(error)")
         }
@@ -167,7 +183,7 @@ extension ParticleSystemController {
 
         // Быстрый предпросмотр: заполняем буфер, чтобы сразу что-то было видно
         storage.createFastPreviewParticles()
-        renderer.setParticleBuffer(storage.particleBuffer)
+        renderer.setParticleRing(storage.particleRing)
         
         // Первый кадр, чтобы частицы были видны сразу
         if let view = mtkView,
@@ -396,39 +412,55 @@ extension ParticleSystemController {
             hqConfig.samplingStrategy = .hybrid
             hqConfig.targetParticleCount = particleCount
 
-            // Генерация частиц
+            // Генерация частиц: готовые порции сразу пишутся в буфер и в HQ-цели,
+            // первые настоящие частицы видны до конца сборки всего массива
+            let storage = self.storage
+            storage.beginHighQualityStream()
             let particles = try await generator.generateParticles(
                 from: image,
                 config: hqConfig,
-                screenSize: viewSize
+                screenSize: viewSize,
+                onChunk: { chunk in
+                    // Частицы уже в NDC [-1, 1]
+                    let prepared = chunk.particles.map { particle -> Particle in
+                        var p = particle
+                        p.color[3] = 1.0 // полностью видимая альфа
+                        return p
+                    }
+                    storage.installHighQualityChunk(ParticleChunk(startIndex: chunk.startIndex, particles: prepared))
+                }
             )
             
+            let streamedCount = storage.finishHighQualityStream()
             if Task.isCancelled { return }
 
-            logger.info("Generated \(particles.count) particles from image")
+            logger.info("Generated \(particles.count) particles from image (streamed: \(streamedCount))")
 
-            // Частицы уже в NDC [-1, 1]
-            let preparedParticles = particles.map { particle -> Particle in
-                var p = particle
-                p.color[3] = 1.0 // полностью видимая альфа
-                return p
-            }
+            // Генератор не отдал порций — ставим массив целиком
+            if streamedCount == 0 {
+                let preparedParticles = particles.map { particle -> Particle in
+                    var p = particle
+                    p.color[3] = 1.0 // полностью видимая альфа
+                    return p
+                }
+
+                if preparedParticles.isEmpty {
+                    logger.warning("Prepared particles array is empty")
+                }
 
-            if preparedParticles.isEmpty {
-                logger.warning("Prepared particles array is empty")
+                storage.updateParticles(preparedParticles)
+                storage.setHighQualityTargets(preparedParticles)
             }
 
-            // Обновляем storage и рендерер
-            storage.updateParticles(preparedParticles)
-            renderer.setParticleBuffer(storage.particleBuffer)
-            renderer.updateParticleCount(preparedParticles.count)
+            // Обновляем рендерер
+            renderer.setParticleRing(storage.particleRing)
+            renderer.updateParticleCount(visibleParticleCount(of: particles.count))
             
             if Task.isCancelled { return }
 
-            logger.info("Updated storage and renderer with \(preparedParticles.count) particles")
+            logger.info("Updated storage and renderer with \(particles.count) particles")
 
-            // Готовим HQ цели для сборки
-            storage.setHighQualityTargets(preparedParticles)
+            // HQ цели для сборки готовы
             simulationEngine.setHighQualityReady(true)
             hasHighQualityTargets = true
             isHighQualityMode = true
@@ -440,11 +472,13 @@ extension ParticleSystemController {
             // Запуск симуляции только если еще не активна
             if !simulationEngine.isActive {
                 startSimulation()
-                logger.info("Simulation started with \(preparedParticles.count) visible particles")
+                logger.info("Simulation started with \(particles.count) visible particles")
             } else {
                 logger.info("Simulation already active - skipping start")
             }
 
+            startCachePrewarm(image: image, config: hqConfig, viewSize: viewSize)
+
         } catch {
             if !Task.isCancelled {
                 logger.error("Particle generation failed: \(error)")
@@ -493,6 +527,33 @@ extension ParticleSystemController {
         logger.info("Starting lightning storm")
         simulationEngine.startLightningStorm()
     }
+
+    func startSwarm() {
+        logger.info("Starting swarm")
+        simulationEngine.startSwarm()
+    }
+
+    /// location — точки в координатах render view
+    func setTouchAttractor(id: Int, location: CGPoint, repels: Bool) {
+        guard let view = mtkView, view.bounds.width > 0, view.bounds.height > 0 else { return }
+
+        let position = SIMD2<Float>(
+            Float(location.x / view.bounds.width) * 2 - 1,
+            1 - Float(location.y / view.bounds.height) * 2
+        )
+        // Радиус в пикселях drawable — тот же масштаб, что и screenSize в SimulationParams
+        let pixelScale = Float(view.drawableSize.width / view.bounds.width)
+        simulationEngine.setAttractor(
+            id: id,
+            position: position,
+            radius: AttractorField.touchRadiusPoints * max(pixelScale, 1),
+            strength: repels ? AttractorField.repelStrength : AttractorField.attractStrength
+        )
+    }
+
+    func removeTouchAttractor(id: Int) {
+        simulationEngine.removeAttractor(id: id)
+    }
     
     func updateSimulation(deltaTime: Float) {
         simulationEngine.update(deltaTime: deltaTime)
@@ -540,6 +601,62 @@ extension ParticleSystemController {
     }
 }
 
+// MARK: - Level of Detail
+
+extension ParticleSystemController {
+
+    private enum ThermalBudget {
+        // Доля рисуемых частиц при перегреве
+        static let seriousFraction = 0.5
+        static let criticalFraction = 0.25
+    }
+
+    /// HQ-частицы идут в прогрессивном порядке (ProgressiveOrderC.h): рисуется префикс
+    /// буфера — равномерная выборка изображения без повторной генерации
+    func setParticleBudget(_ budget: Int?) {
+        let clamped = budget.map { max(1, $0) }
+        guard clamped != particleBudget else { return }
+        particleBudget = clamped
+        refreshVisibleParticleCount()
+    }
+
+    func applyThermalState(_ state: ProcessInfo.ThermalState) {
+        let fraction: Double?
+        switch state {
+        case .serious:
+            fraction = ThermalBudget.seriousFraction
+        case .critical:
+            fraction = ThermalBudget.criticalFraction
+        default:
+            fraction = nil
+        }
+        guard fraction != thermalFraction else { return }
+        thermalFraction = fraction
+        logger.info("Thermal state \(state.rawValue): particle fraction \(fraction ?? 1)")
+        refreshVisibleParticleCount()
+    }
+
+    /// Буферы рендерера уже размещены под particleCount; рендер не останавливается,
+    /// поэтому количество уходит запросом и меняется в начале следующего кадра
+    private func refreshVisibleParticleCount() {
+        guard particleCount > 0 else { return }
+        let visible = visibleParticleCount(of: particleCount)
+        renderer.requestParticleCount(visible)
+        logger.info("Visible particles requested: \(visible) of \(particleCount)")
+    }
+
+    private func visibleParticleCount(of count: Int) -> Int {
+        var visible = count
+        if let budget = particleBudget {
+            visible = min(visible, budget)
+        }
+        if let fraction = thermalFraction {
+            visible = min(visible, max(1, Int(Double(count) * fraction)))
+        }
+        return visible
+    }
+}
+
 // MARK: - Particle Generation
 
 extension ParticleSystemController {
@@ -652,14 +769,14 @@ extension ParticleSystemController {
 
             do {
                 try renderer.setupBuffers(particleCount: desiredCount)
-                renderer.updateParticleCount(desiredCount)
+                renderer.updateParticleCount(visibleParticleCount(of: desiredCount))
             } catch {
                 logger.error("Failed to setup renderer for HQ collect: \(error)")
                 return
             }
 
             storage.createFastPreviewParticles()
-            renderer.setParticleBuffer(storage.particleBuffer)
+            renderer.setParticleRing(storage.particleRing)
         }
 
         logger.info("Generating HQ particles for collection: \(desiredCount)")
@@ -700,6 +817,25 @@ extension ParticleSystemController {
         }
     }
 
+    /// Поворот меняет оси drawable местами — ключ кэша генерации другой. Частицы
+    /// для повернутого экрана генерируются пакетом в фоне: сборка после поворота
+    /// (generateHighQualityTargetsAndCollect) берет их из кэша
+    private func startCachePrewarm(image: CGImage, config: ParticleGenerationConfig, viewSize: CGSize) {
+        guard config.enableCaching, viewSize.width != viewSize.height, cachePrewarmTask == nil else { return }
+
+        let rotatedSize = CGSize(width: viewSize.height, height: viewSize.width)
+        let job = GenerationJob(image: image, config: config, screenSize: rotatedSize)
+        let generator = self.generator
+        cachePrewarmTask = Task(priority: .utility) { [weak self] in
+            let report = await generator.prewarmCache(
+                jobs: [job],
+                memoryBudgetBytes: Constants.cachePrewarmBudgetBytes
+            )
+            guard let self = self, !Task.isCancelled else { return }
+            self.logger.info("Prewarmed cache for \(Int(rotatedSize.width))x\(Int(rotatedSize.height)) in \(String(format: "%.2f", report.seconds)) s")
+        }
+    }
+
     private func syncCollectionFlags(with state: SimulationState) {
         switch state {
         case .collecting:
@@ -746,6 +882,8 @@ extension ParticleSystemController {
     private func cancelAllTasks() {
         generationTask?.cancel()
         generationTask = nil
+        cachePrewarmTask?.cancel()
+        cachePrewarmTask = nil
     }
     
     func cleanup() {
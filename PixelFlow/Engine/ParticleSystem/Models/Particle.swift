@@ -13,7 +13,7 @@ struct Particle: Codable {
     var velocity: SIMD3<Float>        // float3 - 12 bytes + 4 padding = 16
     var targetPosition: SIMD3<Float>  // float3 - 12 bytes + 4 padding = 16
 
-    // Данные цвета (выровнены до 16 байт)
+    // Данные цвета (выровнены до 16 байт); RGB в linear — см. ColorSpaceC.h
     var color: SIMD4<Float>           // float4 - 16 bytes
     var originalColor: SIMD4<Float>   // float4 - 16 bytes
 
@@ -109,7 +109,7 @@ struct SimulationParams {
     var state: UInt32 = 0                    // 4
     var pixelSizeMode: UInt32 = 0            // 4
     var colorsLocked: UInt32 = 0             // 4 - предотвращает изменение цветов шейдером
-    var _pad1: UInt32 = 0                    // 4
+    var fastEffectsMath: UInt32 = 0          // 4 - 1 = быстрые аппроксимации sin/cos/exp/pow в эффектах
 
     // ---- 16 .. 31 (float)
     var deltaTime: Float = 0                  // 4
@@ -128,29 +128,38 @@ struct SimulationParams {
     var particleCount: UInt32 = 0             // 4 - USED by shader
     var idleChaoticMotion: UInt32 = 0         // 4 - флаг для хаотичного движения в idle
     var threadsPerThreadgroup: UInt32 = 256   // 4 - размер threadgroup для compute shader
-    var padding: UInt32 = 0                   // 4 - padding для выравнивания
+    var colorsLinear: UInt32 = 0              // 4 - 1 = цвета частиц уже в linear (переведены при сборке)
+
+    // ---- 80 .. 111 (равномерная сетка соседей для режима swarm, см. NeighborInteraction)
+    var neighborGrid: SIMD4<Float> = .zero    // 16 - cellSize, invCellSize, gridDim, cellCount
+    var neighborForces: SIMD4<Float> = .zero  // 16 - radius, separation, cohesion, maxNeighbors
 
-    // ---- 68 .. 255 (reserved array для достижения 272 bytes stride)
     // Разбивка структуры:
     // - uint fields (0-15): 4*4 = 16 bytes
     // - float fields (16-31): 4*4 = 16 bytes  
     // - float2 fields (32-47): 2*8 = 16 bytes
     // - particle params (48-67): 7 fields = 28 bytes (4 float + 3 uint)
-    // - reserved array (68-243): 11*16 = 176 bytes
+    // - neighbor grid (80-111): 2*16 = 32 bytes
+    // - attractors (112-255): 16*8 + 16 = 144 bytes
     // - compiler stride padding: +16 bytes to reach 272
-    // Total actual fields: 16+16+16+28+176 = 252 bytes
+    // Total actual fields: 16+16+16+28+32+144 = 252 bytes
     // Stride: 272 bytes (compiler rounds up for alignment)
-    var _reserved: (
-        SIMD4<Float>, SIMD4<Float>, SIMD4<Float>,
-        SIMD4<Float>, SIMD4<Float>, SIMD4<Float>,
-        SIMD4<Float>, SIMD4<Float>, SIMD4<Float>,
-        SIMD4<Float>, SIMD4<Float>
+    // ---- 112 .. 255 (точки касаний, см. AttractorField / AttractorFieldC.h)
+    // x, y — NDC в unorm16, z — радиус в пикселях, w — strength в snorm16
+    var attractors: (
+        SIMD4<UInt16>, SIMD4<UInt16>, SIMD4<UInt16>, SIMD4<UInt16>,
+        SIMD4<UInt16>, SIMD4<UInt16>, SIMD4<UInt16>, SIMD4<UInt16>,
+        SIMD4<UInt16>, SIMD4<UInt16>, SIMD4<UInt16>, SIMD4<UInt16>,
+        SIMD4<UInt16>, SIMD4<UInt16>, SIMD4<UInt16>, SIMD4<UInt16>
     ) = (
-        .zero, .zero, .zero,
-        .zero, .zero, .zero,
-        .zero, .zero, .zero,
-        .zero, .zero
-    )
+        .zero, .zero, .zero, .zero,
+        .zero, .zero, .zero, .zero,
+        .zero, .zero, .zero, .zero,
+        .zero, .zero, .zero, .zero
+    )                                         // 128
+    var attractorCount: UInt32 = 0            // 4
+    var _attractorPad0: UInt32 = 0            // 4
+    var _attractorPad1: SIMD2<Float> = .zero  // 8
     var _stridePadding: UInt32 = 0  // Padding to reach 272-byte stride for Metal alignment
     var _pad4: UInt32 = 0
     var _pad5: UInt32 = 0
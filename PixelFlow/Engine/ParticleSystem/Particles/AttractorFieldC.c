@@ -0,0 +1,151 @@
+//
+//  AttractorFieldC.c
+//  PixelFlow
+//
+
+#include "AttractorFieldC.h"
+#include <math.h>
+#include <string.h>
+
+#define ATTRACTOR_MIN_DIST_PX  1.0f
+
+static inline float clampUnit(float v) {
+    return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+}
+
+AttractorPackedC packAttractorC(AttractorC attractor) {
+    AttractorPackedC packed;
+    float strength = attractor.strength / ATTRACTOR_MAX_STRENGTH_C;
+    if (strength < -1.0f) strength = -1.0f;
+    if (strength > 1.0f) strength = 1.0f;
+    float radius = attractor.radius < 0.0f ? 0.0f : (attractor.radius > 65535.0f ? 65535.0f : attractor.radius);
+
+    packed.x = (uint16_t)lrintf(clampUnit(attractor.x * 0.5f + 0.5f) * 65535.0f);
+    packed.y = (uint16_t)lrintf(clampUnit(attractor.y * 0.5f + 0.5f) * 65535.0f);
+    packed.radius = (uint16_t)lrintf(radius);
+    packed.strength = (uint16_t)(int16_t)lrintf(strength * 32767.0f);
+    return packed;
+}
+
+AttractorC unpackAttractorC(AttractorPackedC packed) {
+    AttractorC attractor;
+    attractor.x = (float)packed.x / 65535.0f * 2.0f - 1.0f;
+    attractor.y = (float)packed.y / 65535.0f * 2.0f - 1.0f;
+    attractor.radius = (float)packed.radius;
+    attractor.strength = (float)(int16_t)packed.strength / 32767.0f * ATTRACTOR_MAX_STRENGTH_C;
+    return attractor;
+}
+
+void buildAttractorTileMasksC(const AttractorPackedC* attractors, int count,
+                              float screenWidth, float screenHeight,
+                              uint16_t* masks) {
+    if (!masks) return;
+    memset(masks, 0, sizeof(uint16_t) * ATTRACTOR_TILE_DIM_C * ATTRACTOR_TILE_DIM_C);
+    if (!attractors || count <= 0) return;
+    if (count > ATTRACTOR_MAX_COUNT_C) count = ATTRACTOR_MAX_COUNT_C;
+
+    float tilePxX = screenWidth / (float)ATTRACTOR_TILE_DIM_C;
+    float tilePxY = screenHeight / (float)ATTRACTOR_TILE_DIM_C;
+
+    for (int i = 0; i < count; i++) {
+        AttractorC a = unpackAttractorC(attractors[i]);
+        if (a.radius <= 0.0f || a.strength == 0.0f) continue;
+
+        // Центр в пикселях, отсчет от угла NDC (-1, -1) — как и тайлы
+        float cx = (a.x * 0.5f + 0.5f) * screenWidth;
+        float cy = (a.y * 0.5f + 0.5f) * screenHeight;
+        float radiusSq = a.radius * a.radius;
+
+        // Только тайлы внутри bounding box круга, затем точная проверка круг/прямоугольник
+        int tx0 = (int)floorf((cx - a.radius) / tilePxX);
+        int tx1 = (int)floorf((cx + a.radius) / tilePxX);
+        int ty0 = (int)floorf((cy - a.radius) / tilePxY);
+        int ty1 = (int)floorf((cy + a.radius) / tilePxY);
+        if (tx0 < 0) tx0 = 0;
+        if (ty0 < 0) ty0 = 0;
+        if (tx1 >= ATTRACTOR_TILE_DIM_C) tx1 = ATTRACTOR_TILE_DIM_C - 1;
+        if (ty1 >= ATTRACTOR_TILE_DIM_C) ty1 = ATTRACTOR_TILE_DIM_C - 1;
+
+        for (int ty = ty0; ty <= ty1; ty++) {
+            float minY = (float)ty * tilePxY;
+            float nearY = cy < minY ? minY : (cy > minY + tilePxY ? minY + tilePxY : cy);
+            for (int tx = tx0; tx <= tx1; tx++) {
+                float minX = (float)tx * tilePxX;
+                float nearX = cx < minX ? minX : (cx > minX + tilePxX ? minX + tilePxX : cx);
+                float dx = cx - nearX;
+                float dy = cy - nearY;
+                if (dx * dx + dy * dy < radiusSq) {
+                    masks[ty * ATTRACTOR_TILE_DIM_C + tx] |= (uint16_t)(1u << i);
+                }
+            }
+        }
+    }
+}
+
+static inline int attractorTileAxis(float ndc) {
+    int t = (int)floorf((ndc * 0.5f + 0.5f) * (float)ATTRACTOR_TILE_DIM_C);
+    if (t < 0) t = 0;
+    if (t >= ATTRACTOR_TILE_DIM_C) t = ATTRACTOR_TILE_DIM_C - 1;
+    return t;
+}
+
+int attractorAccelerationC(float x, float y,
+                           const AttractorPackedC* attractors, const uint16_t* masks,
+                           float screenWidth, float screenHeight,
+                           float* ax, float* ay) {
+    uint32_t mask = masks[attractorTileAxis(y) * ATTRACTOR_TILE_DIM_C + attractorTileAxis(x)];
+    if (mask == 0) return 0;
+
+    float halfW = screenWidth * 0.5f;
+    float halfH = screenHeight * 0.5f;
+    float minSide = screenWidth < screenHeight ? screenWidth : screenHeight;
+    // Направление считается в пикселях (круг не вытягивается по длинной стороне),
+    // ускорение переводится обратно в NDC относительно короткой стороны
+    float scaleX = minSide / screenWidth;
+    float scaleY = minSide / screenHeight;
+
+    float sumX = 0.0f, sumY = 0.0f;
+    while (mask) {
+        int bit = __builtin_ctz(mask);
+        mask &= mask - 1;
+
+        AttractorC a = unpackAttractorC(attractors[bit]);
+        float dxPx = (a.x - x) * halfW;
+        float dyPx = (a.y - y) * halfH;
+        float distSq = dxPx * dxPx + dyPx * dyPx;
+        if (distSq >= a.radius * a.radius) continue;
+
+        float dist = sqrtf(distSq);
+        if (dist < ATTRACTOR_MIN_DIST_PX) continue;
+
+        float falloff = 1.0f - dist / a.radius;
+        float k = a.strength * falloff * falloff / dist;
+        sumX += dxPx * k * scaleX;
+        sumY += dyPx * k * scaleY;
+    }
+
+    *ax = sumX;
+    *ay = sumY;
+    return 1;
+}
+
+int applyAttractorForcesC(const float* positions, float* velocities, int strideFloats,
+                          int particleCount, float dt,
+                          const AttractorPackedC* attractors, const uint16_t* masks,
+                          float screenWidth, float screenHeight) {
+    if (!positions || !velocities || !attractors || !masks || particleCount <= 0) return 0;
+
+    int touched = 0;
+    for (int i = 0; i < particleCount; i++) {
+        const float* p = positions + (size_t)i * (size_t)strideFloats;
+        float ax, ay;
+        if (!attractorAccelerationC(p[0], p[1], attractors, masks, screenWidth, screenHeight, &ax, &ay)) continue;
+        touched++;
+
+        float* v = velocities + (size_t)i * (size_t)strideFloats;
+        v[0] += ax * dt;
+        v[1] += ay * dt;
+    }
+
+    return touched;
+}
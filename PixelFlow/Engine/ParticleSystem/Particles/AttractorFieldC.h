@@ -0,0 +1,71 @@
+//
+//  AttractorFieldC.h
+//  PixelFlow
+//
+//  CPU-бэкенд поля притягивающих/отталкивающих точек (касания).
+//  Та же схема, что и в Physics.h (applyAttractorForces):
+//  раз в кадр строится маска тайлов экрана — для каждого тайла биты точек,
+//  чей радиус его задевает. Частица вне всех радиусов делает одну загрузку маски.
+//
+//  Упакованный формат совпадает с SimulationParams.attractors (ushort4):
+//  x, y — NDC в unorm16, radius — пиксели, strength — snorm16 * ATTRACTOR_MAX_STRENGTH_C.
+//
+
+#ifndef AttractorFieldC_h
+#define AttractorFieldC_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ATTRACTOR_MAX_COUNT_C     16
+#define ATTRACTOR_TILE_DIM_C      16      // Тайлов по стороне (маска на тайл — uint16)
+#define ATTRACTOR_MAX_STRENGTH_C  8.0f    // Модуль strength в NDC/с² при snorm16 = 1
+
+/// Точка поля в распакованном виде
+typedef struct {
+    float x;         // NDC
+    float y;         // NDC
+    float radius;    // Радиус влияния в пикселях drawable
+    float strength;  // > 0 притягивает, < 0 отталкивает (NDC/с² в центре)
+} AttractorC;
+
+/// Упакованная точка (8 байт) — элемент SimulationParams.attractors
+typedef struct {
+    uint16_t x;
+    uint16_t y;
+    uint16_t radius;
+    uint16_t strength;
+} AttractorPackedC;
+
+AttractorPackedC packAttractorC(AttractorC attractor);
+AttractorC unpackAttractorC(AttractorPackedC packed);
+
+/// Маска тайлов: masks[ATTRACTOR_TILE_DIM_C²], бит i — точка i задевает тайл
+/// screenWidth/screenHeight — размер drawable в пикселях (радиус круглый в пикселях)
+void buildAttractorTileMasksC(const AttractorPackedC* attractors, int count,
+                              float screenWidth, float screenHeight,
+                              uint16_t* masks);
+
+/// Ускорение одной частицы (x, y — NDC); 0, если маска ее тайла пуста
+/// Та же формула, что и applyAttractorForces в Physics.h
+int attractorAccelerationC(float x, float y,
+                           const AttractorPackedC* attractors, const uint16_t* masks,
+                           float screenWidth, float screenHeight,
+                           float* ax, float* ay);
+
+/// Стадия сил: velocity += a * dt для частиц [0, particleCount)
+/// positions/velocities — xy первой частицы, шаг strideFloats между частицами
+/// Возвращает количество частиц, для которых маска тайла была ненулевой
+int applyAttractorForcesC(const float* positions, float* velocities, int strideFloats,
+                          int particleCount, float dt,
+                          const AttractorPackedC* attractors, const uint16_t* masks,
+                          float screenWidth, float screenHeight);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AttractorFieldC_h */
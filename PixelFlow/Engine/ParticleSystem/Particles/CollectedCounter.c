@@ -0,0 +1,32 @@
+//
+//  CollectedCounter.c
+//  PixelFlow
+//
+
+#include "CollectedCounter.h"
+
+int reduceCollectedCountC(const uint8_t* snapped, int startIndex, int count, int groupSize, uint32_t* counter) {
+    if (!snapped || !counter || count <= 0 || startIndex < 0) return 0;
+    if (groupSize <= 0) groupSize = 1;
+
+    int atomics = 0;
+    int end = startIndex + count;
+
+    for (int groupStart = startIndex; groupStart < end; groupStart += groupSize) {
+        int groupEnd = groupStart + groupSize < end ? groupStart + groupSize : end;
+
+        // Частичная сумма группы (аналог simd_sum)
+        uint32_t partial = 0;
+        for (int i = groupStart; i < groupEnd; i++) {
+            partial += snapped[i] ? 1u : 0u;
+        }
+
+        // Одна атомарная операция на группу, пустые группы не трогают счетчик
+        if (partial > 0) {
+            __atomic_fetch_add(counter, partial, __ATOMIC_RELAXED);
+            atomics++;
+        }
+    }
+
+    return atomics;
+}
@@ -0,0 +1,32 @@
+//
+//  CollectedCounter.h
+//  PixelFlow
+//
+//  CPU-эталон иерархической редукции счетчика собранных частиц.
+//  Повторяет схему updateParticles (Physics.h): частичная сумма по группе,
+//  затем одна атомарная операция на группу вместо одной на частицу.
+//
+
+#ifndef CollectedCounter_h
+#define CollectedCounter_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Редукция флагов собранных частиц в глобальный счетчик
+/// snapped     — флаги 0/1 на частицу (собрана в этом кадре)
+/// startIndex  — первый индекс диапазона воркера
+/// count       — длина диапазона
+/// groupSize   — размер группы (SIMD-группа на GPU, чанк на CPU)
+/// counter     — глобальный счетчик (общий для всех воркеров)
+/// Возвращает количество выполненных атомарных операций
+int reduceCollectedCountC(const uint8_t* snapped, int startIndex, int count, int groupSize, uint32_t* counter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CollectedCounter_h */
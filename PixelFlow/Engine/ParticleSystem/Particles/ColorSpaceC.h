@@ -0,0 +1,39 @@
+//
+//  ColorSpaceC.h
+//  PixelFlow
+//
+//  Перевод цветов частиц в linear один раз при сборке, а не srgbToLinear
+//  на каждый фрагмент (Basic.h). Источники 8-битные (PixelCache), поэтому
+//  достаточно таблицы на 256 значений.
+//
+
+#ifndef ColorSpaceC_h
+#define ColorSpaceC_h
+
+#include <stdint.h>
+
+#include "SimulationStepC.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// sRGB-код 0…255 → linear (та же формула, что srgbToLinear в Basic.h)
+float srgb8ToLinearC(uint8_t code);
+
+/// sRGB [0, 1] → linear: точное значение таблицы для кодов c * 255,
+/// между кодами — линейная интерполяция соседних записей
+float srgbToLinearLUTC(float c);
+
+/// linear → ближайший sRGB-код; обратное к srgb8ToLinearC без потерь
+uint8_t linearToSrgb8C(float linear);
+
+/// Переводит color.rgb и originalColor.rgb частиц [0, count) из sRGB в linear.
+/// Альфа не меняется (она и на GPU линейная)
+void linearizeParticleColorsC(ParticleC* particles, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ColorSpaceC_h */
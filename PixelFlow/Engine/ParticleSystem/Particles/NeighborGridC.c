@@ -0,0 +1,212 @@
+//
+//  NeighborGridC.c
+//  PixelFlow
+//
+
+#include "NeighborGridC.h"
+#include <math.h>
+#include <string.h>
+
+#define NEIGHBOR_NDC_MIN     -1.0f
+#define NEIGHBOR_NDC_EXTENT   2.0f
+#define NEIGHBOR_MIN_DIST     1e-6f
+#define NEIGHBOR_SCAN_PER_QUOTA 4   // Кандидатов на одно место квоты ячейки
+
+NeighborGridDimsC neighborGridDimsC(float radius, int maxGridDim) {
+    NeighborGridDimsC dims;
+    if (maxGridDim < 1) maxGridDim = 1;
+
+    int gridDim = radius > 0.0f ? (int)floorf(NEIGHBOR_NDC_EXTENT / radius) : maxGridDim;
+    if (gridDim < 1) gridDim = 1;
+    if (gridDim > maxGridDim) gridDim = maxGridDim;
+
+    // Ячейка не меньше радиуса, иначе соседи выйдут за пределы 3×3
+    dims.gridDim = gridDim;
+    dims.cellCount = gridDim * gridDim;
+    dims.cellSize = NEIGHBOR_NDC_EXTENT / (float)gridDim;
+    dims.invCellSize = (float)gridDim / NEIGHBOR_NDC_EXTENT;
+    return dims;
+}
+
+static inline int neighborGridAxis(float v, NeighborGridDimsC dims) {
+    int c = (int)floorf((v - NEIGHBOR_NDC_MIN) * dims.invCellSize);
+    if (c < 0) c = 0;
+    if (c >= dims.gridDim) c = dims.gridDim - 1;
+    return c;
+}
+
+int neighborGridCellC(float x, float y, NeighborGridDimsC dims) {
+    return neighborGridAxis(y, dims) * dims.gridDim + neighborGridAxis(x, dims);
+}
+
+static int neighborGridBuildIsValid(const NeighborGridBuildC* build) {
+    return build && build->positions && build->cellStarts && build->workerCursors &&
+        build->particleCells && build->sortedIndices && build->sortedPositions &&
+        build->count >= 0 && build->workerCount > 0 && build->dims.cellCount > 0;
+}
+
+/// Диапазон частиц воркера: равные куски, последний короче
+static void neighborGridWorkerRange(const NeighborGridBuildC* build, int worker, int* begin, int* end) {
+    int chunk = (build->count + build->workerCount - 1) / build->workerCount;
+    *begin = worker * chunk < build->count ? worker * chunk : build->count;
+    *end = *begin + chunk < build->count ? *begin + chunk : build->count;
+}
+
+void neighborGridCountC(const NeighborGridBuildC* build, int worker) {
+    if (!neighborGridBuildIsValid(build) || worker < 0 || worker >= build->workerCount) return;
+
+    int begin, end;
+    neighborGridWorkerRange(build, worker, &begin, &end);
+    uint32_t* counts = build->workerCursors + (size_t)worker * (size_t)build->dims.cellCount;
+    memset(counts, 0, sizeof(uint32_t) * (size_t)build->dims.cellCount);
+
+    for (int i = begin; i < end; i++) {
+        const float* p = build->positions + (size_t)i * (size_t)build->strideFloats;
+        uint32_t cell = (uint32_t)neighborGridCellC(p[0], p[1], build->dims);
+        build->particleCells[i] = cell;
+        counts[cell]++;
+    }
+}
+
+void neighborGridScanC(const NeighborGridBuildC* build) {
+    if (!neighborGridBuildIsValid(build)) return;
+
+    // Внутри ячейки воркеры идут по порядку — как и их диапазоны частиц
+    size_t cellCount = (size_t)build->dims.cellCount;
+    uint32_t running = 0;
+    for (size_t c = 0; c < cellCount; c++) {
+        build->cellStarts[c] = running;
+        for (int w = 0; w < build->workerCount; w++) {
+            uint32_t* cursor = build->workerCursors + (size_t)w * cellCount + c;
+            uint32_t workerTotal = *cursor;
+            *cursor = running;
+            running += workerTotal;
+        }
+    }
+    build->cellStarts[cellCount] = running;
+}
+
+void neighborGridScatterC(const NeighborGridBuildC* build, int worker) {
+    if (!neighborGridBuildIsValid(build) || worker < 0 || worker >= build->workerCount) return;
+
+    int begin, end;
+    neighborGridWorkerRange(build, worker, &begin, &end);
+    uint32_t* cursors = build->workerCursors + (size_t)worker * (size_t)build->dims.cellCount;
+
+    for (int i = begin; i < end; i++) {
+        uint32_t slot = cursors[build->particleCells[i]]++;
+        const float* p = build->positions + (size_t)i * (size_t)build->strideFloats;
+        build->sortedIndices[slot] = (uint32_t)i;
+        build->sortedPositions[2 * slot] = p[0];
+        build->sortedPositions[2 * slot + 1] = p[1];
+    }
+}
+
+void buildNeighborGridC(const float* positions, int strideFloats, int count,
+                        NeighborGridDimsC dims,
+                        uint32_t* cellStarts, uint32_t* cellCursors,
+                        uint32_t* particleCells, uint32_t* sortedIndices,
+                        float* sortedPositions) {
+    NeighborGridBuildC build = {
+        .positions = positions,
+        .strideFloats = strideFloats,
+        .count = count,
+        .dims = dims,
+        .workerCount = 1,
+        .cellStarts = cellStarts,
+        .workerCursors = cellCursors,
+        .particleCells = particleCells,
+        .sortedIndices = sortedIndices,
+        .sortedPositions = sortedPositions,
+    };
+    if (!neighborGridBuildIsValid(&build)) return;
+
+    neighborGridCountC(&build, 0);
+    neighborGridScanC(&build);
+    neighborGridScatterC(&build, 0);
+}
+
+long applyNeighborForcesC(NeighborGridDimsC dims, NeighborForceParamsC params,
+                          const uint32_t* cellStarts, const uint32_t* sortedIndices,
+                          const float* sortedPositions,
+                          int startIndex, int count, float* forces) {
+    if (!cellStarts || !sortedIndices || !sortedPositions || !forces ||
+        count <= 0 || startIndex < 0 || params.radius <= 0.0f) return 0;
+
+    float radiusSq = params.radius * params.radius;
+    float invRadius = 1.0f / params.radius;
+    // Лимит делится поровну между 9 ячейками: ранний выход после первых
+    // maxNeighbors кандидатов давал бы смещение отталкивания в сторону обхода
+    int maxNeighbors = params.maxNeighbors > 0 ? params.maxNeighbors : 1;
+    uint32_t cellQuota = (uint32_t)((maxNeighbors + 8) / 9);
+    uint32_t cellScanLimit = cellQuota * NEIGHBOR_SCAN_PER_QUOTA;
+    long pairs = 0;
+
+    for (int k = startIndex; k < startIndex + count; k++) {
+        float px = sortedPositions[2 * k];
+        float py = sortedPositions[2 * k + 1];
+        uint32_t self = sortedIndices[k];
+        int cx = neighborGridAxis(px, dims);
+        int cy = neighborGridAxis(py, dims);
+
+        float sepX = 0.0f, sepY = 0.0f;
+        float sumX = 0.0f, sumY = 0.0f;
+        int neighbors = 0;
+
+        for (int oy = -1; oy <= 1; oy++) {
+            int ny = cy + oy;
+            if (ny < 0 || ny >= dims.gridDim) continue;
+
+            for (int ox = -1; ox <= 1; ox++) {
+                int nx = cx + ox;
+                if (nx < 0 || nx >= dims.gridDim) continue;
+
+                int cell = ny * dims.gridDim + nx;
+                uint32_t begin = cellStarts[cell];
+                uint32_t end = cellStarts[cell + 1];
+                if (end - begin > cellScanLimit) end = begin + cellScanLimit;
+
+                uint32_t accepted = 0;
+                for (uint32_t j = begin; j < end && accepted < cellQuota; j++) {
+                    uint32_t other = sortedIndices[j];
+                    if (other == self) continue;
+
+                    float dx = px - sortedPositions[2 * j];
+                    float dy = py - sortedPositions[2 * j + 1];
+                    float distSq = dx * dx + dy * dy;
+                    if (distSq >= radiusSq) continue;
+
+                    float dist = sqrtf(distSq);
+                    float weight = 1.0f - dist * invRadius;
+                    if (dist < NEIGHBOR_MIN_DIST) {
+                        // Совпадающие точки расталкиваем по детерминированной оси
+                        dx = self < other ? -1.0f : 1.0f;
+                        dy = 0.0f;
+                        dist = 1.0f;
+                    }
+
+                    sepX += dx / dist * weight;
+                    sepY += dy / dist * weight;
+                    sumX += sortedPositions[2 * j];
+                    sumY += sortedPositions[2 * j + 1];
+                    accepted++;
+                }
+                neighbors += (int)accepted;
+            }
+        }
+
+        float fx = sepX * params.separationStrength;
+        float fy = sepY * params.separationStrength;
+        if (neighbors > 0 && params.cohesionStrength != 0.0f) {
+            float inv = 1.0f / (float)neighbors;
+            fx += (sumX * inv - px) * invRadius * params.cohesionStrength;
+            fy += (sumY * inv - py) * invRadius * params.cohesionStrength;
+        }
+
+        forces[2 * self] = fx;
+        forces[2 * self + 1] = fy;
+        pairs += neighbors;
+    }
+
+    return pairs;
+}
@@ -0,0 +1,101 @@
+//
+//  NeighborGridC.h
+//  PixelFlow
+//
+//  CPU-бэкенд равномерной сетки соседей для режима swarm.
+//  Та же схема, что и в ядрах Shaders/Compute/NeighborGrid.h:
+//  подсчет частиц по ячейкам → префиксная сумма → раскладка (counting sort)
+//  → обход соседей в 3×3 ячейках.
+//
+//  Сетка покрывает NDC [-1, 1] × [-1, 1], сторона ячейки не меньше радиуса взаимодействия,
+//  поэтому все соседи в радиусе лежат в 3×3 ячейках вокруг частицы.
+//
+
+#ifndef NeighborGridC_h
+#define NeighborGridC_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Размеры сетки (совпадают с SimulationParams.neighborGrid в шейдерах)
+typedef struct {
+    float cellSize;     // Сторона ячейки в NDC
+    float invCellSize;  // 1 / cellSize
+    int gridDim;        // Ячеек по стороне
+    int cellCount;      // gridDim * gridDim
+} NeighborGridDimsC;
+
+/// Параметры сил (совпадают с SimulationParams.neighborForces в шейдерах)
+typedef struct {
+    float radius;              // Радиус взаимодействия в NDC
+    float separationStrength;  // Отталкивание от соседей
+    float cohesionStrength;    // Притяжение к центру соседей (0 = выключено)
+    int maxNeighbors;          // Лимит соседей на частицу (квота делится на 9 ячеек) — держит стоимость
+                               // линейной при любой плотности
+} NeighborForceParamsC;
+
+/// Размеры сетки для радиуса radius (NDC); сторона ограничена maxGridDim
+NeighborGridDimsC neighborGridDimsC(float radius, int maxGridDim);
+
+/// Индекс ячейки для точки в NDC (точки вне [-1, 1] прижимаются к краю)
+int neighborGridCellC(float x, float y, NeighborGridDimsC dims);
+
+/// Counting sort частиц по ячейкам на одном потоке (стадии 1–3 с одним воркером)
+/// positions       — xy первой частицы, шаг strideFloats между частицами
+/// cellStarts      — [cellCount + 1], начало диапазона ячейки в sorted*
+/// cellCursors     — [cellCount], рабочий буфер раскладки
+/// particleCells   — [count], ячейка каждой частицы
+/// sortedIndices   — [count], исходные индексы в порядке ячеек
+/// sortedPositions — [2 * count], xy в порядке ячеек
+void buildNeighborGridC(const float* positions, int strideFloats, int count,
+                        NeighborGridDimsC dims,
+                        uint32_t* cellStarts, uint32_t* cellCursors,
+                        uint32_t* particleCells, uint32_t* sortedIndices,
+                        float* sortedPositions);
+
+/// Параллельный counting sort — те же стадии по воркерам (как в PointSpriteRasterC):
+///   1. neighborGridCountC(worker)   — ячейки диапазона воркера в свою гистограмму
+///   2. neighborGridScanC            — один раз: cellStarts и смещения воркеров в ячейках
+///   3. neighborGridScatterC(worker) — раскладка диапазона по своим смещениям
+/// Частицы делятся на workerCount равных диапазонов. У каждого воркера своя
+/// гистограмма, поэтому стадии 1 и 3 идут без атомиков, а порядок внутри ячейки
+/// тот же, что у последовательного buildNeighborGridC.
+typedef struct {
+    const float* positions;     // xy первой частицы, шаг strideFloats
+    int strideFloats;
+    int count;
+    NeighborGridDimsC dims;
+    int workerCount;
+    uint32_t* cellStarts;       // [cellCount + 1]
+    uint32_t* workerCursors;    // [workerCount * cellCount], гистограммы → смещения воркеров
+    uint32_t* particleCells;    // [count]
+    uint32_t* sortedIndices;    // [count]
+    float* sortedPositions;     // [2 * count]
+} NeighborGridBuildC;
+
+/// Стадия 1 для воркера worker ∈ [0, workerCount)
+void neighborGridCountC(const NeighborGridBuildC* build, int worker);
+
+/// Стадия 2: исключающая префиксная сумма по (ячейка, воркер)
+void neighborGridScanC(const NeighborGridBuildC* build);
+
+/// Стадия 3 для воркера worker ∈ [0, workerCount)
+void neighborGridScatterC(const NeighborGridBuildC* build, int worker);
+
+/// Силы соседей для отсортированных частиц [startIndex, startIndex + count)
+/// Диапазон в порядке ячеек — воркеры могут делить его без пересечений
+/// forces — [2 * particleCount], результат пишется по исходному индексу
+/// Возвращает количество учтенных пар
+long applyNeighborForcesC(NeighborGridDimsC dims, NeighborForceParamsC params,
+                          const uint32_t* cellStarts, const uint32_t* sortedIndices,
+                          const float* sortedPositions,
+                          int startIndex, int count, float* forces);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NeighborGridC_h */
@@ -0,0 +1,49 @@
+//
+//  ParticleSeeds.c
+//  PixelFlow
+//
+//  CPU-эталон для per-particle сидов. Формулы повторяют те, что раньше
+//  считались в шейдерах каждый кадр (Basic.h, Physics.h, Utils.h).
+//
+
+#include "ParticleSeeds.h"
+
+#include <math.h>
+
+// Константы из шейдеров (держать синхронно!)
+#define SEED_HASH_MULTIPLIER 43758.5453123f   // HASH_MULTIPLIER, Utils.h
+#define SEED_TWO_PI 6.283185307f              // TWO_PI, Simulation.h
+#define SEED_SUBPIXEL_HASH_1 7.3f             // SUBPIXEL_HASH_SEED_1, Basic.h
+#define SEED_SUBPIXEL_HASH_2 13.7f            // SUBPIXEL_HASH_SEED_2, Basic.h
+#define SEED_SUBPIXEL_SCALE 0.5f              // SUBPIXEL_OFFSET_SCALE, Basic.h
+#define SEED_SUBPIXEL_CENTER 0.25f            // SUBPIXEL_OFFSET_CENTER, Basic.h
+#define SEED_STORM_FACTOR 13.7f               // seed = id * 13.7, calculateStormMovement
+#define SEED_FRACTAL_FREQUENCY_SCALE 2.3f     // FRACTAL_FREQUENCY_SCALE, Utils.h
+
+float particleSeedHashC(float n) {
+    float v = sinf(n) * SEED_HASH_MULTIPLIER;
+    return v - floorf(v);
+}
+
+void bakeParticleSeedsC(ParticleSeedsC* seeds, int startIndex, int count) {
+    if (!seeds || count <= 0 || startIndex < 0) return;
+
+    for (int i = 0; i < count; i++) {
+        ParticleSeedsC* s = &seeds[i];
+        float id = (float)(startIndex + i);
+
+        s->subpixelOffset[0] = particleSeedHashC(id * SEED_SUBPIXEL_HASH_1) * SEED_SUBPIXEL_SCALE - SEED_SUBPIXEL_CENTER;
+        s->subpixelOffset[1] = particleSeedHashC(id * SEED_SUBPIXEL_HASH_2) * SEED_SUBPIXEL_SCALE - SEED_SUBPIXEL_CENTER;
+
+        s->stormHuePhase = particleSeedHashC(id * SEED_STORM_FACTOR) * SEED_TWO_PI;
+        s->stormSizeJitter = particleSeedHashC(id);
+
+        // Октавы fractalChaos: раньше hash(seed * frequency + i * 13) каждый кадр
+        float frequency = 1.0f;
+        for (int octave = 0; octave < PARTICLE_SEEDS_FRACTAL_OCTAVES; octave++) {
+            s->fractalPhaseX[octave] = particleSeedHashC(id * frequency + (float)octave * 13.0f);
+            s->fractalPhaseY[octave] = particleSeedHashC(id * frequency * 1.7f + (float)octave * 19.0f);
+            frequency *= SEED_FRACTAL_FREQUENCY_SCALE;
+        }
+    }
+}
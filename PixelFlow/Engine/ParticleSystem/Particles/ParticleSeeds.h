@@ -0,0 +1,43 @@
+//
+//  ParticleSeeds.h
+//  PixelFlow
+//
+//  Инвариантные per-particle значения (сиды и фазы), которые раньше
+//  пересчитывались шейдерами каждый кадр из id частицы.
+//
+
+#ifndef ParticleSeeds_h
+#define ParticleSeeds_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Количество октав fractalChaos (FRACTAL_OCTAVES в Utils.h)
+#define PARTICLE_SEEDS_FRACTAL_OCTAVES 4
+
+/// Раскладка ДОЛЖНА совпадать с ParticleSeeds в Shaders/Core/Common.h (48 байт)
+typedef struct {
+    float subpixelOffset[2];                              // субпиксельное смещение в пикселях
+    float stormHuePhase;                                  // hash(id * 13.7) * 2π — фаза электрического цвета
+    float stormSizeJitter;                                // hash(id) — разброс размера в буре
+    float fractalPhaseX[PARTICLE_SEEDS_FRACTAL_OCTAVES];  // фазы октав fractalChaos по X (в долях периода)
+    float fractalPhaseY[PARTICLE_SEEDS_FRACTAL_OCTAVES];  // фазы октав fractalChaos по Y (в долях периода)
+} ParticleSeedsC;
+
+/// Тот же хэш, что и hash() в Shaders/Core/Utils.h
+float particleSeedHashC(float n);
+
+/// Заполняет seeds[startIndex ..< startIndex + count]
+/// seeds       — выходной массив (Metal buffer contents)
+/// startIndex  — id первой частицы
+/// count       — количество частиц
+void bakeParticleSeedsC(ParticleSeedsC* seeds, int startIndex, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ParticleSeeds_h */
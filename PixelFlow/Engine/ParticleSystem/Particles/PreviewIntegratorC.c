@@ -0,0 +1,97 @@
+//
+//  PreviewIntegratorC.c
+//  PixelFlow
+//
+
+#include "PreviewIntegratorC.h"
+
+#include <stddef.h>
+#include <string.h>
+
+typedef float PreviewVec4 __attribute__((vector_size(16)));
+typedef int32_t PreviewMask4 __attribute__((vector_size(16)));
+
+#define PREVIEW_BOUND_MIN  (-1.0f + PREVIEW_BOUNDS_PADDING_C)
+#define PREVIEW_BOUND_MAX  (1.0f - PREVIEW_BOUNDS_PADDING_C)
+
+// Потоки ГСЧ: толчок по x и по y
+#define PREVIEW_STREAM_IMPULSE_X  0x68E31DA4u
+#define PREVIEW_STREAM_IMPULSE_Y  0xB5297A4Du
+
+/// lowbias32 (Chris Wellons): хорошее перемешивание за 2 умножения
+static inline uint32_t previewHash(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+float previewRandomC(uint32_t index, uint32_t frame, uint32_t stream) {
+    uint32_t h = previewHash(index ^ previewHash(frame ^ stream));
+    // Старшие 24 бита — точно представимы во float
+    return (float)(h >> 8) * (1.0f / 16777216.0f);
+}
+
+static inline PreviewVec4 loadVec4(const float* p) {
+    PreviewVec4 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void storeVec4(float* p, PreviewVec4 v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+/// mask ? a : b по компонентам (тернарный оператор над векторами в C не переносим)
+static inline PreviewVec4 selectVec4(PreviewMask4 mask, PreviewVec4 a, PreviewVec4 b) {
+    return (PreviewVec4)((mask & (PreviewMask4)a) | (~mask & (PreviewMask4)b));
+}
+
+void previewIntegrateC(const ParticleC* source, ParticleC* target,
+                       int startIndex, int count, float deltaTime, uint32_t frame) {
+    if (!source || !target || count <= 0 || startIndex < 0) return;
+
+    // Двигаются и ограничиваются только x и y; z и w (выравнивание) не трогаем
+    const PreviewVec4 step = { deltaTime, deltaTime, 0.0f, 0.0f };
+    const PreviewVec4 lo = { PREVIEW_BOUND_MIN, PREVIEW_BOUND_MIN, -__builtin_inff(), -__builtin_inff() };
+    const PreviewVec4 hi = { PREVIEW_BOUND_MAX, PREVIEW_BOUND_MAX, __builtin_inff(), __builtin_inff() };
+    const PreviewVec4 rebound = { PREVIEW_VELOCITY_REBOUND_C, PREVIEW_VELOCITY_REBOUND_C, 1.0f, 1.0f };
+    const PreviewVec4 one = { 1.0f, 1.0f, 1.0f, 1.0f };
+    const float minSpeedSquared = PREVIEW_MIN_VELOCITY_C * PREVIEW_MIN_VELOCITY_C;
+
+    const int end = startIndex + count;
+    for (int i = startIndex; i < end; i++) {
+        const ParticleC* in = &source[i];
+        ParticleC* out = &target[i];
+
+        PreviewVec4 position = loadVec4(in->position);
+        PreviewVec4 velocity = loadVec4(in->velocity);
+
+        PreviewVec4 moved = position + velocity * step;
+        PreviewVec4 clamped = selectVec4(moved < lo, lo, moved);
+        clamped = selectVec4(clamped > hi, hi, clamped);
+
+        // Удар о границу — отскок с потерей половины скорости
+        PreviewMask4 hit = moved != clamped;
+        velocity *= selectVec4(hit, rebound, one);
+
+        // Защита от залипания: |velocity.xyz| (как simd.length в Swift)
+        float speedSquared = velocity[0] * velocity[0] + velocity[1] * velocity[1] + velocity[2] * velocity[2];
+        if (speedSquared < minSpeedSquared) {
+            uint32_t index = (uint32_t)i;
+            velocity[0] = (previewRandomC(index, frame, PREVIEW_STREAM_IMPULSE_X) * 2.0f - 1.0f) * PREVIEW_IMPULSE_RANGE_C;
+            velocity[1] = (previewRandomC(index, frame, PREVIEW_STREAM_IMPULSE_Y) * 2.0f - 1.0f) * PREVIEW_IMPULSE_RANGE_C;
+            velocity[2] = 0.0f;
+        }
+
+        // Остальные поля переносятся из source: один проход вместо копии слота + шага
+        if (out != in) {
+            memcpy(out->targetPosition, in->targetPosition,
+                   sizeof(ParticleC) - offsetof(ParticleC, targetPosition));
+        }
+        storeVec4(out->position, clamped);
+        storeVec4(out->velocity, velocity);
+    }
+}
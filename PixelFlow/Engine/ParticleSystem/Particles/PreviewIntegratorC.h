@@ -0,0 +1,42 @@
+//
+//  PreviewIntegratorC.h
+//  PixelFlow
+//
+//  Интегратор fast preview (ParticleStorage.integrateVelocities): сдвиг по
+//  скорости, отскок от границ NDC и толчок застрявших частиц. Частица
+//  обрабатывается векторами float4 (position/velocity выровнены до 16 байт),
+//  случайный толчок — счетчиковый ГСЧ от (индекс, кадр): результат не
+//  зависит от разбиения диапазона между потоками.
+//
+
+#ifndef PreviewIntegratorC_h
+#define PreviewIntegratorC_h
+
+#include <stdint.h>
+
+#include "SimulationStepC.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Константы ParticleStorage.swift — держать синхронно!
+#define PREVIEW_BOUNDS_PADDING_C         0.01f   // Constants.boundsPadding
+#define PREVIEW_VELOCITY_REBOUND_C      -0.5f    // скорость после удара о границу
+#define PREVIEW_MIN_VELOCITY_C           0.001f  // медленнее — частица застряла
+#define PREVIEW_IMPULSE_RANGE_C          0.01f   // толчок застрявшей: [-range, range] по x и y
+
+/// Счетчиковый ГСЧ: равномерное [0, 1) от (index, frame, stream)
+float previewRandomC(uint32_t index, uint32_t frame, uint32_t stream);
+
+/// Шаг для частиц [startIndex, startIndex + count): читает source, пишет target
+/// (свободный слот кольца) — поля без изменений переносятся в том же проходе.
+/// source == target — шаг на месте. frame — номер кадра превью (сид ГСЧ)
+void previewIntegrateC(const ParticleC* source, ParticleC* target,
+                       int startIndex, int count, float deltaTime, uint32_t frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PreviewIntegratorC_h */
@@ -0,0 +1,116 @@
+//
+//  SimulationCommandRingC.c
+//  PixelFlow
+//
+
+#include "SimulationCommandRingC.h"
+
+#include <stdlib.h>
+
+// Позиции производителей и потребителя — на разных кэш-линиях
+#define COMMAND_RING_CACHE_LINE 64
+
+typedef struct {
+    uint64_t sequence;  // == позиции: ячейка свободна; == позиции + 1: заполнена
+    SimulationCommandC command;
+} CommandCellC;
+
+struct SimulationCommandRingC {
+    CommandCellC* cells;
+    uint64_t mask;
+    uint8_t pad0[COMMAND_RING_CACHE_LINE - sizeof(CommandCellC*) - sizeof(uint64_t)];
+    uint64_t enqueuePos;
+    uint8_t pad1[COMMAND_RING_CACHE_LINE - sizeof(uint64_t)];
+    uint64_t dequeuePos;
+    uint8_t pad2[COMMAND_RING_CACHE_LINE - sizeof(uint64_t)];
+    uint64_t dropped;
+};
+
+SimulationCommandRingC* simulationCommandRingCreateC(uint32_t capacity) {
+    uint64_t size = 2;
+    while (size < capacity) size <<= 1;
+
+    SimulationCommandRingC* ring = calloc(1, sizeof(SimulationCommandRingC));
+    if (!ring) return NULL;
+
+    ring->cells = calloc(size, sizeof(CommandCellC));
+    if (!ring->cells) {
+        free(ring);
+        return NULL;
+    }
+
+    ring->mask = size - 1;
+    for (uint64_t i = 0; i < size; i++) {
+        ring->cells[i].sequence = i;
+    }
+    return ring;
+}
+
+void simulationCommandRingDestroyC(SimulationCommandRingC* ring) {
+    if (!ring) return;
+    free(ring->cells);
+    free(ring);
+}
+
+int simulationCommandRingPushC(SimulationCommandRingC* ring, const SimulationCommandC* command) {
+    if (!ring || !command) return 0;
+
+    uint64_t pos = __atomic_load_n(&ring->enqueuePos, __ATOMIC_RELAXED);
+    for (;;) {
+        CommandCellC* cell = &ring->cells[pos & ring->mask];
+        uint64_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        int64_t diff = (int64_t)(sequence - pos);
+
+        if (diff == 0) {
+            // Ячейка свободна — резервируем позицию; при гонке pos обновится
+            if (__atomic_compare_exchange_n(&ring->enqueuePos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                cell->command = *command;
+                __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+                return 1;
+            }
+        } else if (diff < 0) {
+            // Потребитель еще не освободил ячейку круга назад — очередь полна
+            __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+            return 0;
+        } else {
+            pos = __atomic_load_n(&ring->enqueuePos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+int simulationCommandRingPopC(SimulationCommandRingC* ring, SimulationCommandC* command) {
+    if (!ring || !command) return 0;
+
+    // Единственный потребитель — позиция чтения без CAS
+    uint64_t pos = ring->dequeuePos;
+    CommandCellC* cell = &ring->cells[pos & ring->mask];
+    uint64_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+
+    // Ячейка зарезервирована, но еще не опубликована — ждать не будем,
+    // команда уйдет в следующий кадр
+    if (sequence != pos + 1) return 0;
+
+    *command = cell->command;
+    ring->dequeuePos = pos + 1;
+    __atomic_store_n(&cell->sequence, pos + ring->mask + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+uint32_t simulationCommandRingDrainC(SimulationCommandRingC* ring, SimulationCommandC* commands, uint32_t maxCount) {
+    if (!ring || !commands) return 0;
+
+    uint32_t count = 0;
+    while (count < maxCount && simulationCommandRingPopC(ring, &commands[count])) {
+        count++;
+    }
+    return count;
+}
+
+uint32_t simulationCommandRingCapacityC(const SimulationCommandRingC* ring) {
+    return ring ? (uint32_t)(ring->mask + 1) : 0;
+}
+
+uint64_t simulationCommandRingDroppedC(const SimulationCommandRingC* ring) {
+    return ring ? __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED) : 0;
+}
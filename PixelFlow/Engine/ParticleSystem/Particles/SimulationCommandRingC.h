@@ -0,0 +1,68 @@
+//
+//  SimulationCommandRingC.h
+//  PixelFlow
+//
+//  Ограниченная lock-free очередь команд симуляции: много производителей
+//  (UI, генерация, completion handlers GPU), один потребитель — кадр
+//  (SimulationEngine.update разбирает очередь в начале кадра).
+//
+//  Ячейки с порядковым номером (схема Вьюкова): производитель резервирует
+//  позицию CAS-ом и публикует ячейку store-release номера, потребитель
+//  читает без CAS. Ни одна сторона не берет замков и не ждет другую:
+//  полная очередь отклоняет команду (счетчик dropped).
+//
+
+#ifndef SimulationCommandRingC_h
+#define SimulationCommandRingC_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIMULATION_COMMAND_START_C                  0u  // HQ готовы: автомат → chaotic
+#define SIMULATION_COMMAND_STOP_C                   1u
+#define SIMULATION_COMMAND_COLLECT_SCATTER_C        2u
+#define SIMULATION_COMMAND_COLLECT_IMAGE_C          3u
+#define SIMULATION_COMMAND_LIGHTNING_STORM_C        4u
+#define SIMULATION_COMMAND_SWARM_C                  5u
+#define SIMULATION_COMMAND_SET_ATTRACTOR_C          6u  // id, values: x, y, radius, strength
+#define SIMULATION_COMMAND_REMOVE_ATTRACTOR_C       7u  // id
+#define SIMULATION_COMMAND_UPDATE_PROGRESS_C        8u  // values[0]: прогресс 0…1
+#define SIMULATION_COMMAND_SET_HIGH_QUALITY_READY_C 9u  // id: 0/1
+
+/// Команда фиксированного размера (32 байта) — копируется в ячейку целиком
+typedef struct {
+    uint32_t type;       // SIMULATION_COMMAND_*_C
+    int32_t id;
+    float values[4];
+    uint64_t timestamp;  // время постановки (для замера задержки), 0 — не задано
+} SimulationCommandC;
+
+typedef struct SimulationCommandRingC SimulationCommandRingC;
+
+/// capacity округляется вверх до степени двойки (минимум 2). NULL — нет памяти
+SimulationCommandRingC* simulationCommandRingCreateC(uint32_t capacity);
+
+void simulationCommandRingDestroyC(SimulationCommandRingC* ring);
+
+/// Любой поток. 1 — команда поставлена, 0 — очередь полна (команда отброшена)
+int simulationCommandRingPushC(SimulationCommandRingC* ring, const SimulationCommandC* command);
+
+/// Только поток-потребитель. 1 — команда прочитана, 0 — очередь пуста
+int simulationCommandRingPopC(SimulationCommandRingC* ring, SimulationCommandC* command);
+
+/// Только поток-потребитель: до maxCount команд, возвращает количество прочитанных
+uint32_t simulationCommandRingDrainC(SimulationCommandRingC* ring, SimulationCommandC* commands, uint32_t maxCount);
+
+uint32_t simulationCommandRingCapacityC(const SimulationCommandRingC* ring);
+
+/// Команды, отброшенные из-за переполнения (за все время)
+uint64_t simulationCommandRingDroppedC(const SimulationCommandRingC* ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SimulationCommandRingC_h */
@@ -0,0 +1,536 @@
+//
+//  SimulationStepC.c
+//  PixelFlow
+//
+//  Порт updateParticles и его хелперов (Physics.h, Utils.h) на C.
+//  Константы продублированы из шейдеров — держать синхронно!
+//
+//  Как specializedState у updateParticles, состояние подставляется при
+//  компиляции: STEP_VARIANT порождает цикл шага на каждое состояние,
+//  и проверки состояния внутри цикла сворачиваются.
+//
+
+#include "SimulationStepC.h"
+#include "../Utils/FastMathC.h"
+
+#include <math.h>
+#include <stddef.h>
+
+_Static_assert(sizeof(ParticleC) == 96, "ParticleC must match Particle (96 bytes)");
+_Static_assert(sizeof(SimulationParamsC) == 272, "SimulationParamsC must match SimulationParams stride (272 bytes)");
+_Static_assert(offsetof(SimulationParamsC, neighborGrid) == 80, "neighborGrid offset");
+_Static_assert(offsetof(SimulationParamsC, attractors) == 112, "attractors offset");
+
+// Simulation.h
+#define STEP_DEFAULT_DT          0.016666667f
+#define STEP_MIN_DT              0.0001f
+#define STEP_MAX_DT              0.1f
+#define STEP_TWO_PI              6.283185307f
+#define STEP_MIN_VECTOR_LENGTH   0.0001f
+#define STEP_MAX_FLOAT_VALUE     1e10f
+#define STEP_PARTICLE_ALIVE      0.0f
+#define STEP_PARTICLE_COLLECTED  -1.0f
+
+// Physics.h
+#define COLLECTION_BASE_SPEED            30.0f
+#define COLLECTION_MIN_SPEED             0.25f
+#define COLLECTION_SNAP_PIXELS           2.0f
+#define COLLECTION_VELOCITY_DAMPING      0.9f
+#define CHAOTIC_MOVEMENT_SCALE           0.08f
+#define CHAOTIC_VELOCITY_DAMPING_NORMAL  0.98f
+#define CHAOTIC_VELOCITY_DAMPING_HIGH    0.95f
+#define CHAOTIC_HIGH_SPEED_THRESHOLD     0.3f
+#define STORM_ELECTRIC_FORCE             2.6f
+#define STORM_ELECTRIC_DAMPING           0.2f
+#define STORM_BASE_TURBULENCE            0.32f
+#define STORM_VELOCITY_DAMPING           0.95f
+#define STORM_VORTEX_FORCE               0.85f
+#define STORM_VORTEX_PULL                0.12f
+#define SWARM_VELOCITY_DAMPING           0.97f
+#define ELECTRIC_HUE_OFFSET_G            2.1f
+#define ELECTRIC_HUE_OFFSET_B            4.2f
+#define MAX_VELOCITY                     15.0f
+#define BOUNDARY_BOUNCE_DAMPING          0.90f
+#define PARTICLE_PULSE_AMPLITUDE         0.1f
+#define NDC_MAX_POS                      1.0f
+#define NDC_MIN_POS                      -1.0f
+#define BOUNDARY_MARGIN                  0.02f
+#define REPULSION_ZONE                   0.05f
+#define REPULSION_STRENGTH               2.0f
+
+// Utils.h
+#define HASH_MULTIPLIER                  43758.5453123f
+#define CHAOTIC_PARTICLE_SEED_FACTOR     13.7f
+#define CHAOTIC_TIME_SCALE               0.01f
+#define CHAOTIC_LOW_FREQ_TIME            0.3f
+#define CHAOTIC_LOW_FREQ_AMP             2.0f
+#define CHAOTIC_MID_FREQ_TIME            1.2f
+#define CHAOTIC_MID_FREQ_AMP             0.8f
+#define CHAOTIC_HIGH_FREQ_TIME           4.0f
+#define CHAOTIC_HIGH_FREQ_AMP            0.3f
+#define CHAOTIC_Y_LOW_FREQ_TIME          0.7f
+#define CHAOTIC_Y_LOW_FREQ_AMP           0.5f
+#define CHAOTIC_Y_MID_FREQ_TIME          2.1f
+#define CHAOTIC_Y_MID_FREQ_AMP           0.2f
+#define CHAOTIC_IMPULSE_THRESHOLD        0.95f
+#define CHAOTIC_IMPULSE_STRENGTH         2.0f
+#define TURBULENT_SEED_FACTOR            17.3f
+#define TURBULENT_LARGE_FREQ_X           0.2f
+#define TURBULENT_LARGE_FREQ_Y           0.15f
+#define TURBULENT_LARGE_FREQ_Y_MOD       1.3f
+#define TURBULENT_LARGE_AMP              1.5f
+#define TURBULENT_MID_FREQ_X             0.8f
+#define TURBULENT_MID_FREQ_X_MOD         0.7f
+#define TURBULENT_MID_FREQ_Y             1.1f
+#define TURBULENT_MID_FREQ_Y_MOD         1.1f
+#define TURBULENT_MID_AMP                0.8f
+#define TURBULENT_SMALL_FREQ_X           3.0f
+#define TURBULENT_SMALL_FREQ_X_MOD       2.0f
+#define TURBULENT_SMALL_FREQ_Y           3.5f
+#define TURBULENT_SMALL_FREQ_Y_MOD       2.5f
+#define TURBULENT_SMALL_AMP              0.3f
+#define TURBULENT_JUMP_TRIGGER_THRESHOLD 0.98f
+#define TURBULENT_JUMP_TIME_SCALE        0.5f
+#define TURBULENT_JUMP_STRENGTH          4.0f
+#define FRACTAL_SEED_TIME_SCALE          0.01f
+#define FRACTAL_AMPLITUDE_DECAY          0.5f
+#define FRACTAL_FREQUENCY_SCALE          2.3f
+#define FRACTAL_FREQ_X_TIME              0.5f
+#define FRACTAL_FREQ_Y_TIME              0.7f
+#define FRACTAL_IMPULSE_THRESHOLD        0.97f
+#define FRACTAL_IMPULSE_STRENGTH         3.0f
+
+/// Функции с параметром-состоянием: встраиваются в вариант и сворачиваются
+#define STEP_SPECIALIZED static inline __attribute__((always_inline))
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+static inline float stepHash(float n) {
+    float v = sinf(n) * HASH_MULTIPLIER;
+    return v - floorf(v);
+}
+
+static inline float effectSinC(float x, int fastMath) {
+    return fastMath ? approxSinC(x) : sinf(x);
+}
+
+static inline float effectCosC(float x, int fastMath) {
+    return fastMath ? approxCosC(x) : cosf(x);
+}
+
+static inline float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static inline float safeDeltaTime(float dt) {
+    return (isfinite(dt) && dt > STEP_MIN_DT && dt < STEP_MAX_DT) ? dt : STEP_DEFAULT_DT;
+}
+
+static inline int isFloatSafe(float value) {
+    return isfinite(value) && fabsf(value) < STEP_MAX_FLOAT_VALUE;
+}
+
+static inline void safeNormalize2(float x, float y, float* nx, float* ny) {
+    float len = sqrtf(x * x + y * y);
+    if (len > STEP_MIN_VECTOR_LENGTH) {
+        *nx = x / len;
+        *ny = y / len;
+    } else {
+        *nx = 0.0f;
+        *ny = 0.0f;
+    }
+}
+
+// ============================================================================
+// MOTION FIELDS (Utils.h)
+// ============================================================================
+
+static void randomChaoticMotion(float time, uint32_t id, int fastMath, float* outX, float* outY) {
+    float seed = (float)id * CHAOTIC_PARTICLE_SEED_FACTOR + time * CHAOTIC_TIME_SCALE;
+
+    float noise1 = stepHash(seed);
+    float noise2 = stepHash(seed + 17.3f);
+    float noise3 = stepHash(seed + 23.9f);
+    float noise4 = stepHash(seed + 31.1f);
+
+    float lowFreq = effectSinC(time * CHAOTIC_LOW_FREQ_TIME + noise1 * STEP_TWO_PI, fastMath) * CHAOTIC_LOW_FREQ_AMP;
+    float midFreq = effectCosC(time * CHAOTIC_MID_FREQ_TIME + noise2 * STEP_TWO_PI, fastMath) * CHAOTIC_MID_FREQ_AMP;
+    float highFreq = effectSinC(time * CHAOTIC_HIGH_FREQ_TIME + noise3 * STEP_TWO_PI, fastMath) * CHAOTIC_HIGH_FREQ_AMP;
+
+    float impulse = (stepHash(noise4 + time * 0.1f) > CHAOTIC_IMPULSE_THRESHOLD)
+        ? (stepHash(noise4 * 2.0f) - 0.5f) * CHAOTIC_IMPULSE_STRENGTH : 0.0f;
+
+    *outX = lowFreq + midFreq + highFreq + impulse;
+    *outY = effectCosC(time * CHAOTIC_Y_LOW_FREQ_TIME + noise1 * STEP_TWO_PI, fastMath) * CHAOTIC_Y_LOW_FREQ_AMP +
+            effectSinC(time * CHAOTIC_Y_MID_FREQ_TIME + noise2 * STEP_TWO_PI, fastMath) * CHAOTIC_Y_MID_FREQ_AMP +
+            impulse * 0.5f;
+}
+
+static void turbulentMotion(float px, float py, float time, uint32_t id, int fastMath, float* outX, float* outY) {
+    float baseSeed = (float)id * TURBULENT_SEED_FACTOR;
+    float fx = px * 2.5f;
+    float fy = py * 2.5f;
+    float ox = 0.0f, oy = 0.0f;
+
+    ox += effectSinC(fy * TURBULENT_LARGE_FREQ_X + time * 0.6f + baseSeed, fastMath) * TURBULENT_LARGE_AMP;
+    oy += effectCosC(fx * TURBULENT_LARGE_FREQ_Y + time * 0.6f + baseSeed * TURBULENT_LARGE_FREQ_Y_MOD, fastMath) * TURBULENT_LARGE_AMP;
+
+    ox += effectCosC(fx * TURBULENT_MID_FREQ_X + time * 1.1f + baseSeed * TURBULENT_MID_FREQ_X_MOD, fastMath) * TURBULENT_MID_AMP;
+    oy += effectSinC(fy * TURBULENT_MID_FREQ_Y + time * 1.1f + baseSeed * TURBULENT_MID_FREQ_Y_MOD, fastMath) * TURBULENT_MID_AMP;
+
+    ox += effectSinC((fx + fy) * TURBULENT_SMALL_FREQ_X + time * 2.0f + baseSeed * TURBULENT_SMALL_FREQ_X_MOD, fastMath) * TURBULENT_SMALL_AMP;
+    oy += effectCosC((fy - fx) * TURBULENT_SMALL_FREQ_Y + time * 2.0f + baseSeed * TURBULENT_SMALL_FREQ_Y_MOD, fastMath) * TURBULENT_SMALL_AMP;
+
+    float jumpSeed = stepHash(floorf(fx * 3.0f) +
+                              floorf(fy * 3.0f) * 17.0f +
+                              floorf(time * TURBULENT_JUMP_TIME_SCALE) +
+                              baseSeed);
+    if (jumpSeed > TURBULENT_JUMP_TRIGGER_THRESHOLD) {
+        float impulse = (stepHash(jumpSeed + baseSeed) - 0.5f) * TURBULENT_JUMP_STRENGTH;
+        ox += impulse;
+        oy += impulse;
+    }
+
+    *outX = ox;
+    *outY = oy;
+}
+
+static void fractalChaos(float time, uint32_t id, const ParticleSeedsC* seeds, int fastMath, float* outX, float* outY) {
+    float seed = (float)id + time * FRACTAL_SEED_TIME_SCALE;
+    float mx = 0.0f, my = 0.0f;
+    float amplitude = 1.0f;
+    float frequency = 1.0f;
+
+    for (int i = 0; i < PARTICLE_SEEDS_FRACTAL_OCTAVES; i++) {
+        mx += effectSinC(time * frequency * FRACTAL_FREQ_X_TIME + seeds->fractalPhaseX[i] * STEP_TWO_PI, fastMath) * amplitude;
+        my += effectCosC(time * frequency * FRACTAL_FREQ_Y_TIME + seeds->fractalPhaseY[i] * STEP_TWO_PI, fastMath) * amplitude;
+        amplitude *= FRACTAL_AMPLITUDE_DECAY;
+        frequency *= FRACTAL_FREQUENCY_SCALE;
+    }
+
+    float impulseChance = stepHash(seed + floorf(time));
+    if (impulseChance > FRACTAL_IMPULSE_THRESHOLD) {
+        float impulseStrength = stepHash(seed * time) * FRACTAL_IMPULSE_STRENGTH;
+        mx += (stepHash(seed * 2.0f) - 0.5f) * impulseStrength;
+        my += (stepHash(seed * 3.0f) - 0.5f) * impulseStrength;
+    }
+
+    *outX = mx;
+    *outY = my;
+}
+
+// ============================================================================
+// MOVEMENT (Physics.h)
+// ============================================================================
+
+static uint32_t collectionMovement(ParticleC* p, const SimulationParamsC* params, float dt) {
+    float dx = p->targetPosition[0] - p->position[0];
+    float dy = p->targetPosition[1] - p->position[1];
+    float distToTarget = sqrtf(dx * dx + dy * dy);
+
+    float sx = params->screenSize[0] > 1.0f ? params->screenSize[0] : 1.0f;
+    float sy = params->screenSize[1] > 1.0f ? params->screenSize[1] : 1.0f;
+    float pixelToNDC = fminf(2.0f / sx, 2.0f / sy);
+    float snapThreshold = pixelToNDC * COLLECTION_SNAP_PIXELS;
+
+    if (distToTarget <= snapThreshold) {
+        p->position[0] = p->targetPosition[0];
+        p->position[1] = p->targetPosition[1];
+        p->velocity[0] = 0.0f;
+        p->velocity[1] = 0.0f;
+        if (p->life >= STEP_PARTICLE_ALIVE) {
+            p->life = STEP_PARTICLE_COLLECTED;
+            return 1;
+        }
+        return 0;
+    }
+
+    float baseSpeedPixels = params->collectionSpeed > 0.0f
+        ? params->collectionSpeed * COLLECTION_BASE_SPEED
+        : COLLECTION_BASE_SPEED;
+
+    float distPixels = distToTarget / fmaxf(pixelToNDC, 1e-6f);
+    float ease = clampf(distPixels / 12.0f, 0.1f, 1.0f);
+    float moveDistance = baseSpeedPixels * dt * ease * pixelToNDC;
+    moveDistance = fmaxf(moveDistance, pixelToNDC * COLLECTION_MIN_SPEED);
+    moveDistance = fminf(moveDistance, distToTarget);
+
+    float prevX = p->position[0];
+    float prevY = p->position[1];
+    float nx, ny;
+    safeNormalize2(dx, dy, &nx, &ny);
+    p->position[0] += nx * moveDistance;
+    p->position[1] += ny * moveDistance;
+
+    float vx = (p->position[0] - prevX) / dt;
+    float vy = (p->position[1] - prevY) / dt;
+    p->velocity[0] += (vx - p->velocity[0]) * COLLECTION_VELOCITY_DAMPING;
+    p->velocity[1] += (vy - p->velocity[1]) * COLLECTION_VELOCITY_DAMPING;
+    return 0;
+}
+
+static void chaoticMovement(ParticleC* p, uint32_t id, const SimulationParamsC* params,
+                            const ParticleSeedsC* seeds, float dt) {
+    int fastMath = params->fastEffectsMath != 0;
+    float weight = stepHash((float)id * 0.37f + floorf(params->time * 0.5f));
+
+    float tx, ty, fx, fy;
+    turbulentMotion(p->position[0], p->position[1], params->time, id, fastMath, &tx, &ty);
+    fractalChaos(params->time, id, seeds, fastMath, &fx, &fy);
+
+    float dirX, dirY;
+    safeNormalize2(tx + (fx - tx) * weight, ty + (fy - ty) * weight, &dirX, &dirY);
+    p->velocity[0] += dirX * CHAOTIC_MOVEMENT_SCALE * dt;
+    p->velocity[1] += dirY * CHAOTIC_MOVEMENT_SCALE * dt;
+
+    float speedSq = p->velocity[0] * p->velocity[0] + p->velocity[1] * p->velocity[1];
+    float damping = speedSq > CHAOTIC_HIGH_SPEED_THRESHOLD * CHAOTIC_HIGH_SPEED_THRESHOLD
+        ? CHAOTIC_VELOCITY_DAMPING_HIGH : CHAOTIC_VELOCITY_DAMPING_NORMAL;
+    p->velocity[0] *= damping;
+    p->velocity[1] *= damping;
+}
+
+static void stormMovement(ParticleC* p, uint32_t id, const SimulationParamsC* params, const ParticleSeedsC* seeds) {
+    float seed = (float)id * 13.7f;
+    float time = params->time;
+    int fastMath = params->fastEffectsMath != 0;
+
+    float fieldX = stepHash(seed + time * 1.5f) - 0.5f;
+    float fieldY = stepHash(seed + time * 2.1f + 100.0f) - 0.5f;
+    p->velocity[0] += fieldX * STORM_ELECTRIC_FORCE * STORM_ELECTRIC_DAMPING;
+    p->velocity[1] += fieldY * STORM_ELECTRIC_FORCE * STORM_ELECTRIC_DAMPING;
+
+    float baseTurbulence = effectSinC(time * 3.0f + seed, fastMath) * STORM_BASE_TURBULENCE;
+    p->velocity[0] += baseTurbulence;
+    p->velocity[1] += baseTurbulence * 0.7f;
+
+    float cx = p->position[0];
+    float cy = p->position[1];
+    float tanX, tanY;
+    safeNormalize2(-cy, cx, &tanX, &tanY);
+    float spiralPhase = effectSinC(time * 0.8f + seed * 0.3f, fastMath) * 0.5f + 0.5f;
+    float vortex = STORM_VORTEX_FORCE * (0.65f + spiralPhase * 0.35f);
+    float pull = STORM_VORTEX_PULL * (0.5f + spiralPhase * 0.5f);
+    p->velocity[0] += tanX * vortex - cx * pull;
+    p->velocity[1] += tanY * vortex - cy * pull;
+
+    p->velocity[0] *= STORM_VELOCITY_DAMPING;
+    p->velocity[1] *= STORM_VELOCITY_DAMPING;
+
+    float electricHue = seeds->stormHuePhase + time * 2.0f;
+    p->color[0] = 0.3f + 0.7f * effectSinC(electricHue, fastMath);
+    p->color[1] = 0.4f + 0.6f * effectSinC(electricHue + ELECTRIC_HUE_OFFSET_G, fastMath);
+    p->color[2] = 0.8f + 0.2f * effectSinC(electricHue + ELECTRIC_HUE_OFFSET_B, fastMath);
+    p->color[3] = 0.7f + 0.3f * effectSinC(time * 3.0f + seed, fastMath);
+
+    float jx, jy;
+    randomChaoticMotion(time, id, fastMath, &jx, &jy);
+    p->velocity[0] += jx * 0.005f;
+    p->velocity[1] += jy * 0.005f;
+}
+
+// ============================================================================
+// INTEGRATION (Physics.h)
+// ============================================================================
+
+static void limitVelocity(ParticleC* p) {
+    float speed = sqrtf(p->velocity[0] * p->velocity[0] + p->velocity[1] * p->velocity[1]);
+    if (speed > MAX_VELOCITY) {
+        p->velocity[0] = p->velocity[0] / speed * MAX_VELOCITY;
+        p->velocity[1] = p->velocity[1] / speed * MAX_VELOCITY;
+    }
+}
+
+static void integrate(ParticleC* p, float dt) {
+    float speed = sqrtf(p->velocity[0] * p->velocity[0] + p->velocity[1] * p->velocity[1]);
+    if (!isFloatSafe(speed)) {
+        p->velocity[0] = p->velocity[1] = p->velocity[2] = 0.0f;
+    }
+    limitVelocity(p);
+
+    float oldX = p->position[0];
+    float oldY = p->position[1];
+    p->position[0] += p->velocity[0] * dt;
+    p->position[1] += p->velocity[1] * dt;
+    if (!isFloatSafe(p->position[0])) p->position[0] = oldX;
+    if (!isFloatSafe(p->position[1])) p->position[1] = oldY;
+}
+
+static void boundaryAxis(float* pos, float* vel) {
+    float repulsionMin = NDC_MIN_POS + REPULSION_ZONE;
+    float repulsionMax = NDC_MAX_POS - REPULSION_ZONE;
+
+    if (*pos < repulsionMin) {
+        *vel += (repulsionMin - *pos) * REPULSION_STRENGTH * STEP_DEFAULT_DT;
+        if (*pos <= NDC_MIN_POS) {
+            *pos = NDC_MIN_POS + BOUNDARY_MARGIN;
+            if (*vel < 0.0f) *vel = -*vel * BOUNDARY_BOUNCE_DAMPING;
+        }
+    } else if (*pos > repulsionMax) {
+        *vel -= (*pos - repulsionMax) * REPULSION_STRENGTH * STEP_DEFAULT_DT;
+        if (*pos >= NDC_MAX_POS) {
+            *pos = NDC_MAX_POS - BOUNDARY_MARGIN;
+            if (*vel > 0.0f) *vel = -*vel * BOUNDARY_BOUNCE_DAMPING;
+        }
+    }
+}
+
+STEP_SPECIALIZED void applyBoundaryConditions(ParticleC* p, const uint32_t state) {
+    if (!isFloatSafe(p->position[0])) p->position[0] = 0.0f;
+    if (!isFloatSafe(p->position[1])) p->position[1] = 0.0f;
+
+    if (state == SIMULATION_STATE_COLLECTING_C || state == SIMULATION_STATE_COLLECTED_C) {
+        p->position[0] = clampf(p->position[0], NDC_MIN_POS, NDC_MAX_POS);
+        p->position[1] = clampf(p->position[1], NDC_MIN_POS, NDC_MAX_POS);
+    } else {
+        boundaryAxis(&p->position[0], &p->velocity[0]);
+        boundaryAxis(&p->position[1], &p->velocity[1]);
+    }
+    limitVelocity(p);
+}
+
+STEP_SPECIALIZED float particleSize(const ParticleC* p, const SimulationParamsC* params, uint32_t id,
+                                    const uint32_t state) {
+    float size;
+    if (state == SIMULATION_STATE_COLLECTING_C || state == SIMULATION_STATE_COLLECTED_C) {
+        size = p->baseSize;
+    } else {
+        size = p->baseSize * (sinf(p->life * 2.0f + (float)id * 0.01f) * PARTICLE_PULSE_AMPLITUDE + 1.0f);
+    }
+    if (!isFloatSafe(size) || size < 0.0f) {
+        size = params->minParticleSize;
+    }
+    return clampf(size, params->minParticleSize, params->maxParticleSize);
+}
+
+// ============================================================================
+// STEP
+// ============================================================================
+
+typedef uint32_t (*SimulationStepFnC)(ParticleC* particles, const SimulationParamsC* params,
+                                      const SimulationStepInputsC* inputs, int startIndex, int end);
+
+STEP_SPECIALIZED uint32_t stepRange(ParticleC* particles, const SimulationParamsC* params,
+                                    const SimulationStepInputsC* inputs, int startIndex, int end,
+                                    const uint32_t state) {
+    float dt = safeDeltaTime(params->deltaTime);
+    int useAttractors = inputs->attractorTileMasks && params->attractorCount > 0 &&
+        (state == SIMULATION_STATE_CHAOTIC_C ||
+         state == SIMULATION_STATE_LIGHTNING_STORM_C ||
+         state == SIMULATION_STATE_SWARM_C);
+    float screenW = params->screenSize[0] > 1.0f ? params->screenSize[0] : 1.0f;
+    float screenH = params->screenSize[1] > 1.0f ? params->screenSize[1] : 1.0f;
+    uint32_t snapped = 0;
+
+    for (int i = startIndex; i < end; i++) {
+        ParticleC* p = &particles[i];
+        uint32_t id = (uint32_t)i;
+        const ParticleSeedsC* seeds = &inputs->seeds[i];
+
+        if (p->life == STEP_PARTICLE_COLLECTED && state == SIMULATION_STATE_COLLECTED_C) continue;
+
+        if (state != SIMULATION_STATE_LIGHTNING_STORM_C) {
+            for (int c = 0; c < 4; c++) p->color[c] = p->originalColor[c];
+        }
+
+        int needsIntegration = 1;
+        switch (state) {
+            case SIMULATION_STATE_COLLECTING_C:
+                snapped += collectionMovement(p, params, dt);
+                needsIntegration = 0;
+                break;
+
+            case SIMULATION_STATE_COLLECTED_C:
+                p->position[0] = p->targetPosition[0];
+                p->position[1] = p->targetPosition[1];
+                p->velocity[0] = 0.0f;
+                p->velocity[1] = 0.0f;
+                p->life = STEP_PARTICLE_COLLECTED;
+                needsIntegration = 0;
+                break;
+
+            case SIMULATION_STATE_LIGHTNING_STORM_C:
+                stormMovement(p, id, params, seeds);
+                break;
+
+            case SIMULATION_STATE_SWARM_C:
+                chaoticMovement(p, id, params, seeds, dt);
+                if (inputs->neighborForces) {
+                    p->velocity[0] += inputs->neighborForces[2 * i] * dt;
+                    p->velocity[1] += inputs->neighborForces[2 * i + 1] * dt;
+                }
+                p->velocity[0] *= SWARM_VELOCITY_DAMPING;
+                p->velocity[1] *= SWARM_VELOCITY_DAMPING;
+                break;
+
+            default:
+                chaoticMovement(p, id, params, seeds, dt);
+                break;
+        }
+
+        if (useAttractors) {
+            float ax, ay;
+            if (attractorAccelerationC(p->position[0], p->position[1], params->attractors,
+                                       inputs->attractorTileMasks, screenW, screenH, &ax, &ay)) {
+                p->velocity[0] += ax * dt;
+                p->velocity[1] += ay * dt;
+            }
+        }
+
+        if (needsIntegration) {
+            integrate(p, dt);
+        }
+        applyBoundaryConditions(p, state);
+        p->size = particleSize(p, params, id, state);
+
+        if (isFloatSafe(p->life) && p->life >= STEP_PARTICLE_ALIVE) {
+            p->life += dt;
+            if (p->life > STEP_TWO_PI) p->life -= STEP_TWO_PI;
+        }
+    }
+
+    return snapped;
+}
+
+// MARK: - Variants
+
+// Имя варианта из значения константы: stepRange_<state>
+#define STEP_VARIANT_NAME_(state) stepRange_##state
+#define STEP_VARIANT_NAME(state) STEP_VARIANT_NAME_(state)
+
+#define STEP_VARIANT(state) \
+    static uint32_t STEP_VARIANT_NAME(state)(ParticleC* particles, const SimulationParamsC* params, \
+                                             const SimulationStepInputsC* inputs, int startIndex, int end) { \
+        return stepRange(particles, params, inputs, startIndex, end, state); \
+    }
+
+STEP_VARIANT(SIMULATION_STATE_IDLE_C)
+STEP_VARIANT(SIMULATION_STATE_CHAOTIC_C)
+STEP_VARIANT(SIMULATION_STATE_COLLECTING_C)
+STEP_VARIANT(SIMULATION_STATE_COLLECTED_C)
+STEP_VARIANT(SIMULATION_STATE_LIGHTNING_STORM_C)
+STEP_VARIANT(SIMULATION_STATE_SWARM_C)
+
+/// Порядок — SIMULATION_STATE_*_C
+static const SimulationStepFnC stepVariants[SIMULATION_STATE_COUNT_C] = {
+    STEP_VARIANT_NAME(SIMULATION_STATE_IDLE_C),
+    STEP_VARIANT_NAME(SIMULATION_STATE_CHAOTIC_C),
+    STEP_VARIANT_NAME(SIMULATION_STATE_COLLECTING_C),
+    STEP_VARIANT_NAME(SIMULATION_STATE_COLLECTED_C),
+    STEP_VARIANT_NAME(SIMULATION_STATE_LIGHTNING_STORM_C),
+    STEP_VARIANT_NAME(SIMULATION_STATE_SWARM_C),
+};
+
+uint32_t simulationStepC(ParticleC* particles, const SimulationParamsC* params,
+                         SimulationStepInputsC inputs, int startIndex, int count) {
+    if (!particles || !params || !inputs.seeds || count <= 0 || startIndex < 0) return 0;
+
+    int end = startIndex + count;
+    if ((uint32_t)end > params->particleCount) end = (int)params->particleCount;
+
+    // Неизвестное состояние шейдер ведет веткой default — это шаг idle
+    uint32_t state = params->state < SIMULATION_STATE_COUNT_C ? params->state : SIMULATION_STATE_IDLE_C;
+    return stepVariants[state](particles, params, &inputs, startIndex, end);
+}
@@ -0,0 +1,92 @@
+//
+//  SimulationStepC.h
+//  PixelFlow
+//
+//  CPU-бэкенд updateParticles (Shaders/Compute/Physics.h): тот же шаг
+//  по состояниям, те же константы и порядок операций. Нужен для
+//  headless-воспроизведения трасс (SimulationTraceC.h) и как эталон шейдера.
+//
+//  Раскладки ParticleC / SimulationParamsC ДОЛЖНЫ совпадать с Particle /
+//  SimulationParams в Shaders/Core/Common.h и Models/Particle.swift.
+//
+
+#ifndef SimulationStepC_h
+#define SimulationStepC_h
+
+#include <stdint.h>
+
+#include "AttractorFieldC.h"
+#include "ParticleSeeds.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Значения SimulationState.shaderValue (Simulation.h)
+#define SIMULATION_STATE_IDLE_C             0
+#define SIMULATION_STATE_CHAOTIC_C          1
+#define SIMULATION_STATE_COLLECTING_C       2
+#define SIMULATION_STATE_COLLECTED_C        3
+#define SIMULATION_STATE_LIGHTNING_STORM_C  4
+#define SIMULATION_STATE_SWARM_C            5
+#define SIMULATION_STATE_COUNT_C            6
+
+/// Частица (96 байт, float3 выровнены до 16 байт как в Metal)
+typedef struct {
+    float position[4];
+    float velocity[4];
+    float targetPosition[4];
+    float color[4];
+    float originalColor[4];
+    float size;
+    float baseSize;
+    float life;
+    uint32_t idleChaoticMotion;
+} ParticleC;
+
+/// Параметры кадра (272 байта — stride SimulationParams в Swift)
+typedef struct {
+    uint32_t state;
+    uint32_t pixelSizeMode;
+    uint32_t colorsLocked;
+    uint32_t fastEffectsMath;
+    float deltaTime;
+    float collectionSpeed;
+    float brightnessBoost;
+    float _pad2;
+    float screenSize[2];
+    float _pad3[2];
+    float minParticleSize;
+    float maxParticleSize;
+    float time;
+    uint32_t particleCount;
+    uint32_t idleChaoticMotion;
+    uint32_t threadsPerThreadgroup;
+    uint32_t colorsLinear;
+    uint32_t _alignPad;              // float4 neighborGrid выровнен до 16 байт
+    float neighborGrid[4];
+    float neighborForces[4];
+    AttractorPackedC attractors[ATTRACTOR_MAX_COUNT_C];
+    uint32_t attractorCount;
+    uint32_t _attractorPad0;
+    float _attractorPad1[2];
+    uint32_t _stridePadding[4];
+} SimulationParamsC;
+
+/// Входы, которые на GPU приходят отдельными буферами
+typedef struct {
+    const ParticleSeedsC* seeds;           // [particleCount], обязательно
+    const float* neighborForces;           // [2 * particleCount] из applyNeighborForcesC; NULL — без сил соседей
+    const uint16_t* attractorTileMasks;    // маски buildAttractorTileMasksC; NULL — без точек касаний
+} SimulationStepInputsC;
+
+/// Шаг updateParticles для частиц [startIndex, startIndex + count)
+/// Возвращает количество частиц, собранных в этом кадре (вклад в collectedCounter)
+uint32_t simulationStepC(ParticleC* particles, const SimulationParamsC* params,
+                         SimulationStepInputsC inputs, int startIndex, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SimulationStepC_h */
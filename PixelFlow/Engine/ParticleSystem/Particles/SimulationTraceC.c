@@ -0,0 +1,204 @@
+//
+//  SimulationTraceC.c
+//  PixelFlow
+//
+
+#include "SimulationTraceC.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct SimulationTraceWriterC {
+    FILE* file;
+    uint32_t previous[SIMULATION_TRACE_PARAMS_WORDS];
+    uint32_t frameCount;
+    uint64_t bytesWritten;
+};
+
+struct SimulationTraceReaderC {
+    FILE* file;
+    SimulationTraceHeaderC header;
+    uint32_t frameCount;
+};
+
+// MARK: - Writer
+
+static int writeBytes(SimulationTraceWriterC* writer, const void* data, size_t size) {
+    if (fwrite(data, 1, size, writer->file) != size) return 0;
+    writer->bytesWritten += size;
+    return 1;
+}
+
+SimulationTraceWriterC* simulationTraceOpenWriterC(const char* path, const void* particles, uint32_t particleCount) {
+    if (!path || (!particles && particleCount > 0)) return NULL;
+
+    SimulationTraceWriterC* writer = calloc(1, sizeof(SimulationTraceWriterC));
+    if (!writer) return NULL;
+
+    writer->file = fopen(path, "wb");
+    if (!writer->file) {
+        free(writer);
+        return NULL;
+    }
+
+    SimulationTraceHeaderC header = {
+        .magic = SIMULATION_TRACE_MAGIC,
+        .version = SIMULATION_TRACE_VERSION,
+        .paramsSize = SIMULATION_TRACE_PARAMS_SIZE,
+        .particleStride = SIMULATION_TRACE_PARTICLE_SIZE,
+        .particleCount = particleCount,
+    };
+
+    if (!writeBytes(writer, &header, sizeof(header)) ||
+        !writeBytes(writer, particles, (size_t)particleCount * SIMULATION_TRACE_PARTICLE_SIZE)) {
+        simulationTraceCloseWriterC(writer);
+        return NULL;
+    }
+    return writer;
+}
+
+int simulationTraceWriteFrameC(SimulationTraceWriterC* writer, const void* params, float frameSeconds) {
+    if (!writer || !params) return 0;
+
+    uint32_t words[SIMULATION_TRACE_PARAMS_WORDS];
+    memcpy(words, params, SIMULATION_TRACE_PARAMS_SIZE);
+
+    // Запись собирается целиком и уходит одним fwrite
+    uint32_t record[2 + 1 + SIMULATION_TRACE_MASK_WORDS + SIMULATION_TRACE_PARAMS_WORDS];
+    uint32_t* mask = &record[3];
+    uint32_t* changed = &record[3 + SIMULATION_TRACE_MASK_WORDS];
+    uint32_t changedCount = 0;
+
+    memset(mask, 0, sizeof(uint32_t) * SIMULATION_TRACE_MASK_WORDS);
+    for (uint32_t i = 0; i < SIMULATION_TRACE_PARAMS_WORDS; i++) {
+        if (words[i] == writer->previous[i]) continue;
+        mask[i >> 5] |= 1u << (i & 31u);
+        changed[changedCount++] = words[i];
+    }
+
+    uint32_t bodySize = (uint32_t)sizeof(uint32_t) * (1 + SIMULATION_TRACE_MASK_WORDS + changedCount);
+    record[0] = SIMULATION_TRACE_TAG_FRAME;
+    record[1] = bodySize;
+    memcpy(&record[2], &frameSeconds, sizeof(float));
+
+    if (!writeBytes(writer, record, sizeof(uint32_t) * 2 + bodySize)) return 0;
+
+    memcpy(writer->previous, words, SIMULATION_TRACE_PARAMS_SIZE);
+    writer->frameCount++;
+    return 1;
+}
+
+int simulationTraceWriteStateC(SimulationTraceWriterC* writer, uint32_t fromState, uint32_t toState) {
+    if (!writer) return 0;
+
+    uint32_t record[5] = {
+        SIMULATION_TRACE_TAG_STATE,
+        sizeof(uint32_t) * 3,
+        writer->frameCount,
+        fromState,
+        toState,
+    };
+    return writeBytes(writer, record, sizeof(record));
+}
+
+uint32_t simulationTraceFrameCountC(const SimulationTraceWriterC* writer) {
+    return writer ? writer->frameCount : 0;
+}
+
+uint64_t simulationTraceBytesWrittenC(const SimulationTraceWriterC* writer) {
+    return writer ? writer->bytesWritten : 0;
+}
+
+void simulationTraceCloseWriterC(SimulationTraceWriterC* writer) {
+    if (!writer) return;
+    if (writer->file) fclose(writer->file);
+    free(writer);
+}
+
+// MARK: - Reader
+
+SimulationTraceReaderC* simulationTraceOpenReaderC(const char* path) {
+    if (!path) return NULL;
+
+    SimulationTraceReaderC* reader = calloc(1, sizeof(SimulationTraceReaderC));
+    if (!reader) return NULL;
+
+    reader->file = fopen(path, "rb");
+    if (!reader->file ||
+        fread(&reader->header, sizeof(reader->header), 1, reader->file) != 1 ||
+        reader->header.magic != SIMULATION_TRACE_MAGIC ||
+        reader->header.version != SIMULATION_TRACE_VERSION ||
+        reader->header.paramsSize != SIMULATION_TRACE_PARAMS_SIZE ||
+        reader->header.particleStride != SIMULATION_TRACE_PARTICLE_SIZE) {
+        simulationTraceCloseReaderC(reader);
+        return NULL;
+    }
+    return reader;
+}
+
+uint32_t simulationTraceParticleCountC(const SimulationTraceReaderC* reader) {
+    return reader ? reader->header.particleCount : 0;
+}
+
+int simulationTraceReadParticlesC(SimulationTraceReaderC* reader, void* particles) {
+    if (!reader || !particles) return 0;
+    size_t size = (size_t)reader->header.particleCount * SIMULATION_TRACE_PARTICLE_SIZE;
+    return fread(particles, 1, size, reader->file) == size;
+}
+
+int simulationTraceNextC(SimulationTraceReaderC* reader, SimulationTraceEventC* event, void* params) {
+    if (!reader || !event || !params) return -1;
+
+    uint32_t head[2];
+    size_t got = fread(head, 1, sizeof(head), reader->file);
+    if (got == 0) return 0;
+    if (got != sizeof(head)) return -1;
+
+    uint32_t body[1 + SIMULATION_TRACE_MASK_WORDS + SIMULATION_TRACE_PARAMS_WORDS];
+    if (head[1] > sizeof(body) || head[1] % sizeof(uint32_t) != 0) return -1;
+    if (fread(body, 1, head[1], reader->file) != head[1]) return -1;
+
+    memset(event, 0, sizeof(*event));
+    event->tag = head[0];
+
+    switch (head[0]) {
+        case SIMULATION_TRACE_TAG_FRAME: {
+            uint32_t words = head[1] / (uint32_t)sizeof(uint32_t);
+            if (words < 1 + SIMULATION_TRACE_MASK_WORDS) return -1;
+
+            const uint32_t* mask = &body[1];
+            const uint32_t* changed = &body[1 + SIMULATION_TRACE_MASK_WORDS];
+            uint32_t available = words - 1 - SIMULATION_TRACE_MASK_WORDS;
+            uint32_t* out = params;
+            uint32_t next = 0;
+
+            for (uint32_t i = 0; i < SIMULATION_TRACE_PARAMS_WORDS; i++) {
+                if (!(mask[i >> 5] & (1u << (i & 31u)))) continue;
+                if (next >= available) return -1;
+                out[i] = changed[next++];
+            }
+
+            memcpy(&event->frameSeconds, &body[0], sizeof(float));
+            event->frameIndex = reader->frameCount++;
+            return 1;
+        }
+
+        case SIMULATION_TRACE_TAG_STATE:
+            if (head[1] != sizeof(uint32_t) * 3) return -1;
+            event->frameIndex = body[0];
+            event->fromState = body[1];
+            event->toState = body[2];
+            return 1;
+
+        default:
+            // Неизвестные записи будущих версий пропускаются
+            return simulationTraceNextC(reader, event, params);
+    }
+}
+
+void simulationTraceCloseReaderC(SimulationTraceReaderC* reader) {
+    if (!reader) return;
+    if (reader->file) fclose(reader->file);
+    free(reader);
+}
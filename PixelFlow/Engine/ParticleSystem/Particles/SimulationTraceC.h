@@ -0,0 +1,98 @@
+//
+//  SimulationTraceC.h
+//  PixelFlow
+//
+//  Компактная бинарная трасса сессии симуляции для headless-воспроизведения
+//  (Tools/TraceReplay). Пишется из MetalRenderer (SimulationTraceRecorder).
+//
+//  Формат (little-endian, порядок байт устройства):
+//  - заголовок SimulationTraceHeaderC
+//  - исходный буфер частиц: particleCount * particleStride байт
+//  - записи: uint32 tag, uint32 size (байт после этого поля), затем тело
+//    FRAME: float frameSeconds, uint32 changed[3], затем измененные слова
+//           SimulationParams (по 4 байта, в порядке битов). Параметры кодируются
+//           дельтой к предыдущему кадру — обычно меняются только time/deltaTime
+//    STATE: uint32 frameIndex, uint32 fromState, uint32 toState
+//
+
+#ifndef SimulationTraceC_h
+#define SimulationTraceC_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIMULATION_TRACE_MAGIC          0x52544650u  // "PFTR"
+#define SIMULATION_TRACE_VERSION        1u
+#define SIMULATION_TRACE_PARAMS_SIZE    272u         // stride SimulationParams
+#define SIMULATION_TRACE_PARTICLE_SIZE  96u          // stride Particle
+#define SIMULATION_TRACE_PARAMS_WORDS   (SIMULATION_TRACE_PARAMS_SIZE / 4u)
+#define SIMULATION_TRACE_MASK_WORDS     3u           // 96 бит ≥ 68 слов параметров
+
+#define SIMULATION_TRACE_TAG_FRAME      1u
+#define SIMULATION_TRACE_TAG_STATE      2u
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t paramsSize;
+    uint32_t particleStride;
+    uint32_t particleCount;
+    uint32_t reserved[3];
+} SimulationTraceHeaderC;
+
+/// Событие трассы при чтении
+typedef struct {
+    uint32_t tag;            // SIMULATION_TRACE_TAG_*
+    uint32_t frameIndex;     // FRAME: номер кадра; STATE: кадр, после которого сменилось состояние
+    float frameSeconds;      // FRAME: реальная длительность кадра на устройстве
+    uint32_t fromState;      // STATE
+    uint32_t toState;        // STATE
+} SimulationTraceEventC;
+
+typedef struct SimulationTraceWriterC SimulationTraceWriterC;
+typedef struct SimulationTraceReaderC SimulationTraceReaderC;
+
+// MARK: - Writer
+
+/// Создает файл и пишет заголовок + снимок буфера частиц (particleCount * 96 байт)
+/// Возвращает NULL при ошибке ввода-вывода
+SimulationTraceWriterC* simulationTraceOpenWriterC(const char* path, const void* particles, uint32_t particleCount);
+
+/// params — SIMULATION_TRACE_PARAMS_SIZE байт (содержимое paramsBuffer)
+/// Возвращает 0 при ошибке записи
+int simulationTraceWriteFrameC(SimulationTraceWriterC* writer, const void* params, float frameSeconds);
+
+int simulationTraceWriteStateC(SimulationTraceWriterC* writer, uint32_t fromState, uint32_t toState);
+
+/// Количество записанных кадров и байт (для логов)
+uint32_t simulationTraceFrameCountC(const SimulationTraceWriterC* writer);
+uint64_t simulationTraceBytesWrittenC(const SimulationTraceWriterC* writer);
+
+void simulationTraceCloseWriterC(SimulationTraceWriterC* writer);
+
+// MARK: - Reader
+
+/// Открывает трассу и проверяет заголовок; NULL — не трасса или другая версия
+SimulationTraceReaderC* simulationTraceOpenReaderC(const char* path);
+
+uint32_t simulationTraceParticleCountC(const SimulationTraceReaderC* reader);
+
+/// Читает исходный буфер частиц; вызывать один раз сразу после открытия
+int simulationTraceReadParticlesC(SimulationTraceReaderC* reader, void* particles);
+
+/// Следующее событие. Для FRAME params (SIMULATION_TRACE_PARAMS_SIZE байт)
+/// обновляется на месте — передавайте один и тот же буфер на всю трассу,
+/// обнуленный перед первым вызовом (дельта первого кадра считается от нулей)
+/// Возвращает 1 — событие прочитано, 0 — конец трассы, -1 — поврежденная запись
+int simulationTraceNextC(SimulationTraceReaderC* reader, SimulationTraceEventC* event, void* params);
+
+void simulationTraceCloseReaderC(SimulationTraceReaderC* reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SimulationTraceC_h */
@@ -0,0 +1,119 @@
+//
+//  TransitionBlendC.c
+//  PixelFlow
+//
+
+#include "TransitionBlendC.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "PreviewIntegratorC.h"
+
+typedef float TransitionVec4 __attribute__((vector_size(16)));
+typedef int32_t TransitionMask4 __attribute__((vector_size(16)));
+
+#define TRANSITION_VECTORS_PER_PARTICLE  6
+
+_Static_assert(sizeof(ParticleC) == TRANSITION_VECTORS_PER_PARTICLE * sizeof(TransitionVec4),
+               "ParticleC must be a whole number of float4");
+_Static_assert(offsetof(ParticleC, idleChaoticMotion) == sizeof(ParticleC) - sizeof(uint32_t),
+               "idleChaoticMotion must be the last lane of the last float4");
+
+// Поток ГСЧ задержки старта (previewRandomC)
+#define TRANSITION_STREAM_STAGGER  0x2C1B3C6Du
+
+float transitionStartDelayC(uint32_t index, float stagger) {
+    if (stagger <= 0.0f) return 0.0f;
+    // frame = 0: задержка постоянна на весь переход
+    return previewRandomC(index, 0, TRANSITION_STREAM_STAGGER) * stagger;
+}
+
+static inline TransitionVec4 loadVec4(const float* p) {
+    TransitionVec4 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void storeVec4(float* p, TransitionVec4 v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+/// mask ? a : b по компонентам (тернарный оператор над векторами в C не переносим)
+static inline TransitionVec4 selectVec4(TransitionMask4 mask, TransitionVec4 a, TransitionVec4 b) {
+    return (TransitionVec4)((mask & (TransitionMask4)a) | (~mask & (TransitionMask4)b));
+}
+
+/// Хоть одна дорожка маски ненулевая. Через две 64-битные половины: извлечение
+/// четырех дорожек по одной заметно дороже на SSE2
+static inline int anyLane(TransitionMask4 mask) {
+    uint64_t halves[2];
+    memcpy(halves, &mask, sizeof(halves));
+    return (halves[0] | halves[1]) != 0;
+}
+
+int transitionBlendC(const ParticleC* source, const ParticleC* targets, ParticleC* out,
+                     int startIndex, int count, float lerpFactor, float elapsed, float stagger) {
+    if (!source || !targets || !out || count <= 0 || startIndex < 0) return 0;
+
+    const TransitionVec4 factor = { lerpFactor, lerpFactor, lerpFactor, lerpFactor };
+    const TransitionVec4 epsilon = {
+        TRANSITION_SNAP_EPSILON_C, TRANSITION_SNAP_EPSILON_C,
+        TRANSITION_SNAP_EPSILON_C, TRANSITION_SNAP_EPSILON_C
+    };
+    const TransitionMask4 absMask = { 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF, 0x7FFFFFFF };
+    // idleChaoticMotion — uint в последней дорожке последнего вектора: не смешивается
+    const TransitionMask4 idleLane = { 0, 0, 0, -1 };
+    const int switchIdle = lerpFactor >= TRANSITION_IDLE_SWITCH_C;
+
+    int pending = 0;
+    const int end = startIndex + count;
+    for (int i = startIndex; i < end; i++) {
+        if (stagger > 0.0f && elapsed < transitionStartDelayC((uint32_t)i, stagger)) {
+            if (out != source) memcpy(&out[i], &source[i], sizeof(ParticleC));
+            pending++;
+            continue;
+        }
+
+        // Уже на цели (побитово) — без пересчета; шаг на месте — и без записи
+        if (memcmp(&source[i], &targets[i], sizeof(ParticleC)) == 0) {
+            if (out != source) memcpy(&out[i], &source[i], sizeof(ParticleC));
+            continue;
+        }
+
+        const float* in = (const float*)&source[i];
+        const float* goal = (const float*)&targets[i];
+        float* dst = (float*)&out[i];
+        const int last = TRANSITION_VECTORS_PER_PARTICLE - 1;
+        TransitionVec4 rawCurrent = loadVec4(in + 4 * last);
+        TransitionVec4 rawTarget = loadVec4(goal + 4 * last);
+
+        // Один проход, без ветвлений: совпавшие поля дают (target - current) == 0
+        TransitionMask4 differs = { 0, 0, 0, 0 };
+        for (int k = 0; k < TRANSITION_VECTORS_PER_PARTICLE; k++) {
+            TransitionVec4 current = loadVec4(in + 4 * k);
+            TransitionVec4 target = loadVec4(goal + 4 * k);
+            if (k == last) {
+                // Дорожка idleChaoticMotion обнуляется до арифметики: ее биты как float —
+                // денормали, а операции над ними на части ядер в десятки раз медленнее
+                current = (TransitionVec4)((TransitionMask4)current & ~idleLane);
+                target = (TransitionVec4)((TransitionMask4)target & ~idleLane);
+            }
+
+            TransitionVec4 next = current + (target - current) * factor;
+            TransitionVec4 distance = (TransitionVec4)((TransitionMask4)(target - next) & absMask);
+            next = selectVec4(distance < epsilon, target, next);
+            differs |= (TransitionMask4)next != (TransitionMask4)target;
+
+            if (k == last) {
+                // Дошедшая до цели частица защелкивается вместе с idleChaoticMotion
+                int settled = !anyLane(differs);
+                TransitionVec4 idle = (settled || switchIdle) ? rawTarget : rawCurrent;
+                next = selectVec4(idleLane, idle, next);
+                pending += !settled;
+            }
+            storeVec4(dst + 4 * k, next);
+        }
+    }
+    return pending;
+}
@@ -0,0 +1,41 @@
+//
+//  TransitionBlendC.h
+//  PixelFlow
+//
+//  Шаг перехода к HQ-целям (ParticleStorage.updateHighQualityTransition):
+//  частица — поток из 6 × float4 (96 байт), каждый вектор смешивается
+//  с целью одним FMA. Частица, уже совпавшая с целью, не пересчитывается,
+//  дошедшая до цели — защелкивается на ней. Старт частицы может
+//  быть разнесен во времени (stagger) — задержка из счетчикового ГСЧ.
+//
+
+#ifndef TransitionBlendC_h
+#define TransitionBlendC_h
+
+#include <stdint.h>
+
+#include "SimulationStepC.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Поведение прежнего перехода ParticleStorage.swift
+#define TRANSITION_IDLE_SWITCH_C   0.9f    // с этого lerpFactor берется idleChaoticMotion цели
+#define TRANSITION_SNAP_EPSILON_C  1e-5f   // ближе к цели — компонента защелкивается на ней
+
+/// Задержка старта частицы index в [0, stagger) секунд
+float transitionStartDelayC(uint32_t index, float stagger);
+
+/// Шаг перехода для частиц [startIndex, startIndex + count): читает source и
+/// targets, пишет out (source == out — шаг на месте). elapsed — секунды с начала
+/// перехода; частица, чья задержка еще не прошла, переносится без изменений.
+/// Возвращает число частиц диапазона, еще не совпавших с целью
+int transitionBlendC(const ParticleC* source, const ParticleC* targets, ParticleC* out,
+                     int startIndex, int count, float lerpFactor, float elapsed, float stagger);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TransitionBlendC_h */
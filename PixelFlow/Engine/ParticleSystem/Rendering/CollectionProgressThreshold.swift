@@ -0,0 +1,41 @@
+//
+//  CollectionProgressThreshold.swift
+//  PixelFlow
+//
+//  Превращает монотонный счетчик собранных частиц в редкие события
+//  прогресса: событие возникает только при пересечении очередной ступени.
+//
+
+import Foundation
+
+struct CollectionProgressThreshold {
+
+    /// Размер ступени прогресса (0...1)
+    let step: Float
+
+    /// Последний отправленный прогресс
+    private(set) var lastReported: Float = 0
+
+    init(step: Float) {
+        self.step = max(step, .ulpOfOne)
+    }
+
+    mutating func reset() {
+        lastReported = 0
+    }
+
+    /// Возвращает прогресс, если пересечена следующая ступень или достигнуто 100%.
+    /// Иначе nil — событие не нужно.
+    mutating func advance(collected: Int, total: Int) -> Float? {
+        guard total > 0 else { return nil }
+
+        let ratio = min(1, Float(collected) / Float(total))
+        let crossedStep = ratio - lastReported >= step
+        let reachedEnd = ratio >= 1 && lastReported < 1
+
+        guard crossedStep || reachedEnd else { return nil }
+
+        lastReported = ratio
+        return ratio
+    }
+}
@@ -29,19 +29,29 @@ final class MetalRenderer: NSObject, MTKViewDelegate {
         static let defaultThreadsPerThreadgroup: UInt32 = 256
         static let defaultDisplayScale: Float = 1.0
         static let defaultFPS = 60
-        static let collectionProgressLogThreshold: Float = 0.05
+        // Шаг, с которым прогресс сбора уходит на main (а не каждый кадр)
+        static let collectionProgressEventStep: Float = 0.05
         // 272 bytes — SimulationParams layout (согласовано с Simulation.h)
         // Включает: state, time, deltaTime, screenSize, particleCount, и др.
         static let expectedSimulationParamsStride = 272
+        // 48 bytes — ParticleSeeds (согласовано с Common.h / ParticleSeeds.h)
+        static let expectedParticleSeedsStride = 48
+        // Маска на тайл (uint16) для ATTRACTOR_TILE_DIM_C × ATTRACTOR_TILE_DIM_C тайлов
+        static let attractorTileCount = Int(ATTRACTOR_TILE_DIM_C * ATTRACTOR_TILE_DIM_C)
+        // Радиальные профили освещения: таблица на каждое состояние (RadialProfileC.h)
+        static let radialProfileSampleCount = Int(RADIAL_PROFILE_SIZE_C) * Int(SIMULATION_STATE_COUNT_C)
+        // [[function_constant(0)]] specializedState в Simulation.h
+        static let specializedStateIndex = 0
+        // Путь трассы сессии (переменная окружения схемы), см. SimulationTraceRecorder
+        static let traceEnvironmentKey = "PIXELFLOW_TRACE_PATH"
         static let maxDeltaTime: CFTimeInterval = 0.1 // 100ms cap для предотвращения spiral of death
         static let fallbackFrameDuration = 1.0 / Double(defaultFPS)
+        // Слоты params/масок: кадры в полете + один, который пишет CPU
+        static let frameParamsSlotCount = ParticleBufferRing.maxFramesInFlight + 1
     }
     
     private enum ShaderNames {
         static let updateParticles = "updateParticles"
-        static let vertexParticle = "vertexParticle"
-        static let fragmentParticle = "fragmentParticle"
-        static let fragmentParticlePerformance = "fragmentParticlePerformance"
     }
     
     // MARK: - Dependencies
@@ -60,42 +70,103 @@ final class MetalRenderer: NSObject, MTKViewDelegate {
 
     // MARK: - Metal Resources
 
+    /// Pipeline последнего кадра — вариант из pipelineCache под его params
     var renderPipeline: MTLRenderPipelineState?
+    /// Вариант updateParticles текущего состояния (из computePipelines)
     var computePipeline: MTLComputePipelineState?
+    /// updateParticles, специализированный по состоянию; индекс — SimulationState.shaderValue
+    private var computePipelines: [MTLComputePipelineState] = []
     private var threadsPerThreadgroup: UInt32 = Constants.defaultThreadsPerThreadgroup
 
-    var particleBuffer: MTLBuffer?
-    var paramsBuffer: MTLBuffer?
+    /// Кольцо буферов частиц хранилища; кадр работает с его актуальным слотом
+    private var particleRing: ParticleBufferRing?
+    var particleBuffer: MTLBuffer? { particleRing?.latestBuffer }
+    /// Params текущего слота кадра (см. frameParamsBuffers)
+    var paramsBuffer: MTLBuffer? {
+        frameParamsBuffers.indices.contains(frameParamsSlot) ? frameParamsBuffers[frameParamsSlot] : nil
+    }
     var collectedCounterBuffer: MTLBuffer?
+    /// Инвариантные per-particle сиды/фазы (считаются один раз, а не каждый кадр)
+    var particleSeedsBuffer: MTLBuffer?
+    private var particleSeedsCapacity: Int = 0
+    /// Сетка соседей для режима swarm (пайплайны + буферы сетки)
+    private var neighborGrid: NeighborGridEncoder?
+    /// Маски тайлов для точек касаний — перестраиваются на CPU в updateSimulationParams()
+    var attractorTileMaskBuffer: MTLBuffer? {
+        frameTileMaskBuffers.indices.contains(frameParamsSlot) ? frameTileMaskBuffers[frameParamsSlot] : nil
+    }
+    /// Params и маски по слотам: GPU читает их, пока кадр в полете, поэтому
+    /// закодированный слот не переписывается. Новые params идут в следующий слот —
+    /// он свободен, т.к. в полете не больше maxFramesInFlight кадров
+    private var frameParamsBuffers: [MTLBuffer] = []
+    private var frameTileMaskBuffers: [MTLBuffer] = []
+    private var frameParamsSlot: Int = 0
+    /// Текущий слот уже отдан закодированному кадру — следующая запись берет новый
+    private var isFrameParamsSlotEncoded = false
+    /// Радиальные профили освещения для текущего renderQuality — фрагменты читают их вместо pow
+    var radialProfileBuffer: MTLBuffer?
     private var collectedCounterPointer: UnsafeMutablePointer<UInt32>?
     
     // MARK: - State
 
     private weak var mtkView: MTKView?
     private var particleCount: Int = 0
+    /// Количество, запрошенное на лету (requestParticleCount); применяет начало кадра
+    private var pendingParticleCount: Int?
     private(set) var screenSize: CGSize = .zero
     private var currentConfig: ParticleGenerationConfig = .standard
     private var renderQuality: RenderQuality = .standard
     private var enableIdleChaotic: Bool = false
+    /// Состояние swarm на момент последнего updateSimulationParams()
+    private var isNeighborGridActive: Bool = false
     private var displayScale: Float = Constants.defaultDisplayScale
 
     private weak var simulationEngine: SimulationEngineProtocol?
     private var paramsUpdater: SimulationParamsUpdater?
     private var shaderLibrary: MTLLibrary?
+    /// Специализированные варианты fragmentParticle (состояние × качество × режимы)
+    private var pipelineCache: RenderPipelineCache?
     
     // MARK: - Frame Tracking
 
     private var lastFrameTimestamp: CFTimeInterval = 0
-    private var lastLoggedCollectionProgress: Float = 0
+    /// Реальная длительность последнего кадра (без ограничения maxDeltaTime)
+    private var lastFrameDuration: CFTimeInterval = Constants.fallbackFrameDuration
+
+    // MARK: - Trace Recording
+
+    /// nil — запись выключена; трасса начинается с первого кадра вне idle
+    private let tracePath: String? = ProcessInfo.processInfo.environment[Constants.traceEnvironmentKey]
+    private var traceRecorder: SimulationTraceRecorder?
+    /// Одна трасса на запуск — повторное открытие перезаписало бы файл
+    private var isTraceComplete = false
+    // Доступ только внутри counterAccessQueue
+    private var collectionProgressThreshold = CollectionProgressThreshold(
+        step: Constants.collectionProgressEventStep
+    )
+    // Эпоха, к которой относится collectionProgressThreshold; только внутри counterAccessQueue
+    private var collectionThresholdEpoch: UInt64 = 0
+    /// Растет при каждом сбросе счетчика (только main). Кадр несет свою эпоху
+    /// в completion handler — порог сбрасывается там, без замка на render-потоке
+    private var collectionEpoch: UInt64 = 0
+    /// Сброс счетчика ждет своего кадра (только main): запись CPU в буфер,
+    /// к которому атомарно прибавляют кадры в полете, потерялась бы или
+    /// смешалась с их вкладом. Обнуление кодируется blit-ом в compute-буфер кадра
+    private var isCounterResetPending = false
     private var isPipelineConfigured: Bool = false
 
     // MARK: - Synchronization
 
     // Сериальная очередь для синхронизации доступа к collectedCounterPointer
+    // и collectionProgressThreshold между main (настройка/cleanup) и completion handlers.
+    // Render-поток ее не берет: указатель меняется только на main
     private let counterAccessQueue = DispatchQueue(
         label: "com.pixelflow.counter.access",
         qos: .userInitiated
     )
+
+    // Кадры в полете: больше — и CPU не найдет свободный слот кольца частиц
+    private let inFlightSemaphore = DispatchSemaphore(value: ParticleBufferRing.maxFramesInFlight)
     
     // MARK: - Initialization
     
@@ -171,59 +242,91 @@ final class MetalRenderer: NSObject, MTKViewDelegate {
     }
     
     private func setupComputePipeline(library: MTLLibrary) throws {
-        guard let computeFunction = library.makeFunction(name: ShaderNames.updateParticles) else {
-            throw MetalError.functionNotFound(name: ShaderNames.updateParticles)
+        // Варианты всех состояний собираются сразу: переход не ждет компиляции
+        computePipelines = try (0..<Int32(SIMULATION_STATE_COUNT_C)).map { state in
+            try makeComputePipeline(library: library, state: state)
         }
-        
-        let pipeline = try device.makeComputePipelineState(function: computeFunction)
-        computePipeline = pipeline
-        threadsPerThreadgroup = UInt32(pipeline.threadExecutionWidth)
+        selectComputePipeline(state: SimulationState.idle.shaderValue)
+        if let pipeline = computePipeline {
+            threadsPerThreadgroup = UInt32(pipeline.threadExecutionWidth)
+        }
+
+        let grid = try NeighborGridEncoder(device: device, library: library)
+        try grid.ensureCapacity(particleCount: particleCount)
+        neighborGrid = grid
     }
     
+    private func makeComputePipeline(library: MTLLibrary, state: Int32) throws -> MTLComputePipelineState {
+        var value = state
+        let constants = MTLFunctionConstantValues()
+        constants.setConstantValue(&value, type: .int, index: Constants.specializedStateIndex)
+
+        let computeFunction: MTLFunction
+        do {
+            computeFunction = try library.makeFunction(name: ShaderNames.updateParticles, constantValues: constants)
+        } catch {
+            throw MetalError.functionNotFound(name: ShaderNames.updateParticles)
+        }
+        return try device.makeComputePipelineState(function: computeFunction)
+    }
+
+    /// Неизвестное состояние ядро ведет веткой default — это вариант idle
+    private func selectComputePipeline(state: UInt32) {
+        let index = Int(state) < computePipelines.count ? Int(state) : Int(SimulationState.idle.shaderValue)
+        guard computePipelines.indices.contains(index) else { return }
+        computePipeline = computePipelines[index]
+    }
+
     private func setupRenderPipeline(library: MTLLibrary) throws {
-        let descriptor = try createRenderPipelineDescriptor(library: library)
-        configureBlending(descriptor: descriptor)
-        renderPipeline = try device.makeRenderPipelineState(descriptor: descriptor)
+        let cache = try RenderPipelineCache(device: device, library: library)
+        pipelineCache = cache
+        try prewarmRenderPipelines()
+        renderPipeline = try cache.pipeline(for: currentPipelineKey(state: SimulationState.idle.shaderValue))
+    }
+
+    /// Варианты всех состояний для текущих качества и пресета
+    private func prewarmRenderPipelines() throws {
+        guard let cache = pipelineCache else { return }
+        let key = currentPipelineKey(state: SimulationState.idle.shaderValue)
+        try cache.prewarm(quality: key.quality, pixelPerfect: key.pixelPerfect, fastMath: key.fastMath)
+        logger.debug("Render pipelines prewarmed: \(cache.count) variants")
+    }
+
+    /// Ключ до первого заполнения params: SimulationParamsUpdater фиксирует pixelSizeMode = 2
+    private func currentPipelineKey(state: UInt32) -> RenderPipelineCache.Key {
+        RenderPipelineCache.Key(
+            state: state,
+            quality: renderQuality.lightingQuality,
+            pixelPerfect: true,
+            fastMath: currentConfig.qualityPreset.usesFastEffectsMath
+        )
     }
-    
-    private func createRenderPipelineDescriptor(library: MTLLibrary) throws -> MTLRenderPipelineDescriptor {
-        let descriptor = MTLRenderPipelineDescriptor()
-        let fragmentFunctionName: String
 
-        switch renderQuality {
-        case .standard:
-            fragmentFunctionName = ShaderNames.fragmentParticle
-        case .performance:
-            fragmentFunctionName = ShaderNames.fragmentParticlePerformance
-        }
-        
-        guard let vertexFunction = library.makeFunction(name: ShaderNames.vertexParticle),
-              let fragmentFunction = library.makeFunction(name: fragmentFunctionName) else {
-            throw MetalError.functionNotFound(
-                name: "\(ShaderNames.vertexParticle)/\(fragmentFunctionName)"
-            )
+    /// Вариант под params текущего кадра (после updateSimulationParams)
+    private func selectRenderPipeline(paramsBuffer: MTLBuffer) -> MTLRenderPipelineState? {
+        guard let cache = pipelineCache else { return nil }
+        let params = paramsBuffer.contents().load(as: SimulationParams.self)
+        let key = RenderPipelineCache.Key(params: params, quality: renderQuality.lightingQuality)
+
+        do {
+            let pipeline = try cache.pipeline(for: key)
+            renderPipeline = pipeline
+            return pipeline
+        } catch {
+            logger.error("Failed to build render pipeline for \(key): \(error)")
+            return renderPipeline
         }
-        
-        descriptor.vertexFunction = vertexFunction
-        descriptor.fragmentFunction = fragmentFunction
-        descriptor.colorAttachments[0].pixelFormat = .bgra8Unorm_srgb
-        
-        return descriptor
-    }
-    
-    private func configureBlending(descriptor: MTLRenderPipelineDescriptor) {
-        guard let attachment = descriptor.colorAttachments[0] else { return }
-        
-        attachment.isBlendingEnabled = true
-        attachment.rgbBlendOperation = .add
-        attachment.alphaBlendOperation = .add
-        attachment.sourceRGBBlendFactor = .sourceAlpha
-        attachment.sourceAlphaBlendFactor = .sourceAlpha
-        attachment.destinationRGBBlendFactor = .oneMinusSourceAlpha
-        attachment.destinationAlphaBlendFactor = .oneMinusSourceAlpha
     }
     
     private func validateStructLayouts() throws {
+        let seedsStride = MemoryLayout<ParticleSeedsC>.stride
+        guard seedsStride == Constants.expectedParticleSeedsStride else {
+            throw MetalError.structLayoutMismatch(
+                actual: seedsStride,
+                expected: Constants.expectedParticleSeedsStride
+            )
+        }
+
         let stride = MemoryLayout<SimulationParams>.stride
 
         #if DEBUG
@@ -253,30 +356,38 @@ final class MetalRenderer: NSObject, MTKViewDelegate {
 
         self.particleCount = particleCount
 
-        guard let newParticleBuffer = device.makeBuffer(
-            length: MemoryLayout<Particle>.stride * particleCount,
-            options: .storageModeShared
-        ) else {
-            throw MetalError.bufferCreationFailed
-        }
-        
-        guard let newParamsBuffer = device.makeBuffer(
-            length: MemoryLayout<SimulationParams>.stride,
-            options: .storageModeShared
-        ) else {
-            throw MetalError.bufferCreationFailed
+        // Буфер частиц — кольцо хранилища (setParticleRing)
+        var newParamsBuffers: [MTLBuffer] = []
+        var newTileMaskBuffers: [MTLBuffer] = []
+        for _ in 0..<Constants.frameParamsSlotCount {
+            guard let paramsBuffer = device.makeBuffer(
+                length: MemoryLayout<SimulationParams>.stride,
+                options: .storageModeShared
+            ), let maskBuffer = device.makeBuffer(
+                length: MemoryLayout<UInt16>.stride * Constants.attractorTileCount,
+                options: .storageModeShared
+            ) else {
+                throw MetalError.bufferCreationFailed
+            }
+            newParamsBuffers.append(paramsBuffer)
+            newTileMaskBuffers.append(maskBuffer)
         }
-        
+
         guard let newCollectedCounterBuffer = device.makeBuffer(
             length: MemoryLayout<UInt32>.stride,
             options: .storageModeShared
         ) else {
             throw MetalError.bufferCreationFailed
         }
-        
-        particleBuffer = newParticleBuffer
-        paramsBuffer = newParamsBuffer
+
+        frameParamsBuffers = newParamsBuffers
+        frameTileMaskBuffers = newTileMaskBuffers
+        frameParamsSlot = 0
+        isFrameParamsSlotEncoded = false
         collectedCounterBuffer = newCollectedCounterBuffer
+        try bakeParticleSeeds(count: particleCount)
+        try bakeRadialProfiles()
+        try neighborGrid?.ensureCapacity(particleCount: particleCount)
 
         // Защищаем запись указателя от гонок с cleanup()/checkCollectionCompletion()
         counterAccessQueue.sync {
@@ -286,14 +397,58 @@ final class MetalRenderer: NSObject, MTKViewDelegate {
     }
     
     private func cleanupBuffers() {
+        stopTraceRecording()
+
         // Сначала обнуляем pointer под защитой очереди
         counterAccessQueue.sync {
             collectedCounterPointer = nil
         }
 
-        particleBuffer = nil
-        paramsBuffer = nil
+        frameParamsBuffers = []
+        frameTileMaskBuffers = []
+        frameParamsSlot = 0
+        isFrameParamsSlotEncoded = false
         collectedCounterBuffer = nil
+        isCounterResetPending = false
+        particleSeedsBuffer = nil
+        particleSeedsCapacity = 0
+        radialProfileBuffer = nil
+    }
+
+    /// Считает сиды один раз на CPU — шейдеры только читают их по id частицы
+    private func bakeParticleSeeds(count: Int) throws {
+        guard let newSeedsBuffer = device.makeBuffer(
+            length: MemoryLayout<ParticleSeedsC>.stride * count,
+            options: .storageModeShared
+        ) else {
+            throw MetalError.bufferCreationFailed
+        }
+
+        let seeds = newSeedsBuffer.contents().bindMemory(to: ParticleSeedsC.self, capacity: count)
+        bakeParticleSeedsC(seeds, 0, Int32(count))
+
+        particleSeedsBuffer = newSeedsBuffer
+        particleSeedsCapacity = count
+    }
+
+    /// Печет профили всех состояний сразу: смена состояния только меняет смещение
+    /// таблицы в шейдере. При смене качества создается новый буфер — кадры
+    /// в полете дочитывают старый
+    private func bakeRadialProfiles() throws {
+        guard let newProfileBuffer = device.makeBuffer(
+            length: MemoryLayout<RadialProfileSampleC>.stride * Constants.radialProfileSampleCount,
+            options: .storageModeShared
+        ) else {
+            throw MetalError.bufferCreationFailed
+        }
+
+        let profiles = newProfileBuffer.contents().bindMemory(
+            to: RadialProfileSampleC.self,
+            capacity: Constants.radialProfileSampleCount
+        )
+        bakeRadialProfilesC(profiles, renderQuality.lightingQuality)
+
+        radialProfileBuffer = newProfileBuffer
     }
     
     // MARK: - MTKViewDelegate
@@ -305,37 +460,77 @@ final class MetalRenderer: NSObject, MTKViewDelegate {
     }
     
     func draw(in view: MTKView) {
-        guard shouldRender(view: view),
-              particleCount > 0 else {
-            return
+        guard shouldRender(view: view) else { return }
+
+        // До записей CPU этого кадра: с maxFramesInFlight кадрами в полете
+        // кольцо всегда отдает свободный слот
+        inFlightSemaphore.wait()
+        var isCommitted = false
+        defer {
+            if !isCommitted { inFlightSemaphore.signal() }
         }
 
+        // Граница кадра: прошлые кадры уже закодированы, этот еще не начат
+        applyPendingParticleCount()
+        guard particleCount > 0 else { return }
+
         // Кэшируем drawable — избегаем повторного обращения к view.currentDrawable
         guard let drawable = view.currentDrawable,
               let renderPassDesc = view.currentRenderPassDescriptor,
-              let commandBuffer = commandQueue.makeCommandBuffer(),
-              let pipeline = renderPipeline,
-              let particleBuf = particleBuffer,
-              let paramsBuf = paramsBuffer else {
+              let computeCommandBuffer = commandQueue.makeCommandBuffer(),
+              let renderCommandBuffer = commandQueue.makeCommandBuffer(),
+              let ring = particleRing,
+              let seedsBuf = particleSeedsBuffer,
+              let profileBuf = radialProfileBuffer else {
             logger.debug("draw(in:) skipped — missing resources")
             return
         }
 
         let dt = calculateDeltaTime(view: view)
+        // Записи CPU (fast preview и т.п.) публикуют новый latest-слот кольца
         simulationEngine?.update(deltaTime: Float(dt))
 
+        // Params кадра — в свободном слоте, не в том, что читает предыдущий кадр
         updateSimulationParams()
-        encodeCompute(into: commandBuffer)
-        encodeRender(into: commandBuffer, renderPassDesc: renderPassDesc, pipeline: pipeline, particleBuf: particleBuf, paramsBuf: paramsBuf)
-
-        commandBuffer.addCompletedHandler { [weak self] _ in
-            DispatchQueue.main.async {
-                self?.checkCollectionCompletion()
-            }
+        guard let paramsBuf = paramsBuffer,
+              let pipeline = selectRenderPipeline(paramsBuffer: paramsBuf),
+              let frame = ring.beginFrame() else {
+            logger.debug("draw(in:) skipped — no render pipeline or particle slot")
+            return
+        }
+        recordTraceFrame(particleBuf: frame.buffer)
+
+        // Compute и render — разные command buffer: CPU может копировать слот,
+        // как только compute кадра его дописал, не дожидаясь render.
+        // Пока CPU пишет слот по копии latest, кадр только рисует — не ждем записи
+        encodeCounterResetIfNeeded(into: computeCommandBuffer)
+        if frame.writes {
+            encodeCompute(into: computeCommandBuffer, particleBuf: frame.buffer)
+        }
+        computeCommandBuffer.addCompletedHandler { _ in
+            ring.completeWrite(serial: frame.serial)
+        }
+        computeCommandBuffer.commit()
+        // Слот params теперь читает GPU — следующие записи уходят в новый
+        isFrameParamsSlotEncoded = true
+
+        encodeRender(into: renderCommandBuffer, renderPassDesc: renderPassDesc, pipeline: pipeline, particleBuf: frame.buffer, paramsBuf: paramsBuf, seedsBuf: seedsBuf, profileBuf: profileBuf)
+
+        // Счетчик читаем прямо в completion handler; в очередь команд уходит только
+        // событие пересечения ступени прогресса
+        let frameParticleCount = particleCount
+        let frameEpoch = collectionEpoch
+        let commands = simulationEngine?.commands
+        let semaphore = inFlightSemaphore
+        renderCommandBuffer.addCompletedHandler { [weak self] _ in
+            ring.retire(serial: frame.serial)
+            self?.pollCollectionProgress(particleCount: frameParticleCount, epoch: frameEpoch, commands: commands)
+            semaphore.signal()
         }
 
-        commandBuffer.present(drawable)
-        commandBuffer.commit()
+        renderCommandBuffer.present(drawable)
+        renderCommandBuffer.commit()
+        isCommitted = true
     }
 
     // MARK: - Deinit
@@ -343,7 +538,7 @@ final class MetalRenderer: NSObject, MTKViewDelegate {
     deinit {
         // Safety net: предотвращает вызов delegate методов после dealloc
         // Если cleanup() не был вызван — логируем предупреждение
-        if particleBuffer != nil || paramsBuffer != nil {
+        if paramsBuffer != nil {
             logger.warning("MetalRenderer deallocated without cleanup() — GPU resources may leak")
         }
         mtkView?.delegate = nil
@@ -359,7 +554,9 @@ final class MetalRenderer: NSObject, MTKViewDelegate {
         renderPipeline != nil &&
         particleBuffer != nil &&
         paramsBuffer != nil &&
-        collectedCounterBuffer != nil
+        collectedCounterBuffer != nil &&
+        particleSeedsBuffer != nil &&
+        radialProfileBuffer != nil
     }
     
     private func calculateDeltaTime(view: MTKView) -> CFTimeInterval {
@@ -371,6 +568,7 @@ final class MetalRenderer: NSObject, MTKViewDelegate {
         }
 
         let dt = now - lastFrameTimestamp
+        lastFrameDuration = max(dt, 0)
         return min(max(dt, 0), Constants.maxDeltaTime)
     }
     
@@ -379,10 +577,37 @@ final class MetalRenderer: NSObject, MTKViewDelegate {
     @MainActor
     func updateSimulationParams() {
         guard let updater = paramsUpdater,
-              let buffer = paramsBuffer,
-              let engine = simulationEngine else { return }
+              let engine = simulationEngine,
+              !frameParamsBuffers.isEmpty else { return }
+
+        // Слот закодированного кадра не трогаем: пишем в следующий
+        if isFrameParamsSlotEncoded {
+            frameParamsSlot = (frameParamsSlot + 1) % frameParamsBuffers.count
+            isFrameParamsSlotEncoded = false
+        }
+        let buffer = frameParamsBuffers[frameParamsSlot]
         
         let safeSize = screenSize.width > 0 ? screenSize : CGSize(width: 1, height: 1)
+
+        if case .swarm = engine.state {
+            isNeighborGridActive = true
+        } else {
+            isNeighborGridActive = false
+        }
+        // Вариант updateParticles меняется только на переходах состояния
+        selectComputePipeline(state: engine.state.shaderValue)
+
+        // Точки упаковываются один раз: тот же список уходит в params и в маски тайлов
+        let attractors = engine.attractorField.packed()
+        if let maskBuffer = attractorTileMaskBuffer {
+            buildAttractorTileMasksC(
+                attractors,
+                Int32(attractors.count),
+                Float(safeSize.width),
+                Float(safeSize.height),
+                maskBuffer.contents().assumingMemoryBound(to: UInt16.self)
+            )
+        }
         
         updater.fill(
             buffer: buffer,
@@ -393,34 +618,118 @@ final class MetalRenderer: NSObject, MTKViewDelegate {
             config: currentConfig,
             enableIdleChaotic: enableIdleChaotic,
             displayScale: displayScale,
+            attractors: attractors,
             threadsPerThreadgroup: threadsPerThreadgroup
         )
     }
     
+    // MARK: - Trace Recording
+
+    /// Пишет params кадра после updateSimulationParams(); снимок частиц — слот кадра до его compute
+    @MainActor
+    private func recordTraceFrame(particleBuf: MTLBuffer) {
+        guard let path = tracePath, !isTraceComplete,
+              let paramsBuf = paramsBuffer,
+              let engine = simulationEngine else { return }
+
+        let state = engine.state.shaderValue
+        if traceRecorder == nil {
+            guard state != SimulationState.idle.shaderValue else { return }
+            let url = URL(fileURLWithPath: path)
+            traceRecorder = SimulationTraceRecorder(
+                url: url,
+                particles: particleBuf.contents(),
+                particleCount: particleCount
+            )
+            if traceRecorder == nil {
+                logger.error("Failed to open simulation trace at \(path)")
+                return
+            }
+            logger.info("Recording simulation trace to \(path)")
+        }
+
+        traceRecorder?.recordFrame(
+            params: paramsBuf.contents(),
+            state: state,
+            frameSeconds: Float(lastFrameDuration)
+        )
+    }
+
+    private func stopTraceRecording() {
+        guard let recorder = traceRecorder else { return }
+        logger.info("Simulation trace finished: \(recorder.frameCount) frames, \(recorder.bytesWritten) bytes → \(recorder.url.path)")
+        recorder.finish()
+        traceRecorder = nil
+        isTraceComplete = true
+    }
+
+    // MARK: - CPU Snapshot
+
+    /// Кадр текущего состояния без GPU (PointSpriteRasterC.h).
+    /// Буферы читаются как есть — для golden-кадров снимок берут при mtkView.isPaused = true
+    func makeCPUSnapshot(width: Int, height: Int) -> CGImage? {
+        guard let particleBuf = particleBuffer,
+              let paramsBuf = paramsBuffer,
+              let seedsBuf = particleSeedsBuffer,
+              let renderer = PointSpriteSnapshotRenderer(width: width, height: height) else { return nil }
+
+        return renderer.render(
+            particles: particleBuf.contents(),
+            seeds: seedsBuf.contents(),
+            particleCount: particleCount,
+            params: paramsBuf.contents()
+        )
+    }
+
     // MARK: - Compute / Render
 
     /// Публичный метод для encode compute (совместимость с протоколом)
     func encodeCompute(into commandBuffer: MTLCommandBuffer) {
+        guard let particleBuf = particleBuffer else { return }
+        encodeCompute(into: commandBuffer, particleBuf: particleBuf)
+    }
+
+    /// particleBuf — слот кольца, выданный кадру beginFrame()
+    private func encodeCompute(into commandBuffer: MTLCommandBuffer, particleBuf: MTLBuffer) {
         guard let pipeline = computePipeline,
-              let particleBuf = particleBuffer,
               let paramsBuf = paramsBuffer,
-              let counterBuf = collectedCounterBuffer else { return }
+              let counterBuf = collectedCounterBuffer,
+              let seedsBuf = particleSeedsBuffer,
+              let maskBuf = attractorTileMaskBuffer,
+              let grid = neighborGrid else { return }
+
+        // Сетка соседей нужна только рою — в остальных состояниях не перестраиваем
+        if isNeighborGridActive {
+            grid.encodeBuild(
+                into: commandBuffer,
+                particleBuffer: particleBuf,
+                paramsBuffer: paramsBuf,
+                particleCount: particleCount
+            )
+        }
 
         encodeComputeInternal(
             into: commandBuffer,
             pipeline: pipeline,
             particleBuf: particleBuf,
             paramsBuf: paramsBuf,
-            counterBuf: counterBuf
+            counterBuf: counterBuf,
+            seedsBuf: seedsBuf,
+            maskBuf: maskBuf,
+            grid: grid
         )
     }
 
+    // swiftlint:disable:next function_parameter_count
     private func encodeComputeInternal(
         into commandBuffer: MTLCommandBuffer,
         pipeline: MTLComputePipelineState,
         particleBuf: MTLBuffer,
         paramsBuf: MTLBuffer,
-        counterBuf: MTLBuffer
+        counterBuf: MTLBuffer,
+        seedsBuf: MTLBuffer,
+        maskBuf: MTLBuffer,
+        grid: NeighborGridEncoder
     ) {
         guard let encoder = commandBuffer.makeComputeCommandEncoder() else { return }
 
@@ -428,6 +737,12 @@ final class MetalRenderer: NSObject, MTKViewDelegate {
         encoder.setBuffer(particleBuf, offset: 0, index: 0)
         encoder.setBuffer(paramsBuf, offset: 0, index: 1)
         encoder.setBuffer(counterBuf, offset: 0, index: 2)
+        encoder.setBuffer(seedsBuf, offset: 0, index: 3)
+        encoder.setBuffer(maskBuf, offset: 0, index: 7)
+        guard grid.bind(to: encoder) else {
+            encoder.endEncoding()
+            return
+        }
 
         let w = pipeline.threadExecutionWidth
         let groups = (particleCount + w - 1) / w
@@ -440,19 +755,24 @@ final class MetalRenderer: NSObject, MTKViewDelegate {
         encoder.endEncoding()
     }
 
+    // swiftlint:disable:next function_parameter_count
     private func encodeRender(
         into commandBuffer: MTLCommandBuffer,
         renderPassDesc: MTLRenderPassDescriptor,
         pipeline: MTLRenderPipelineState,
         particleBuf: MTLBuffer,
-        paramsBuf: MTLBuffer
+        paramsBuf: MTLBuffer,
+        seedsBuf: MTLBuffer,
+        profileBuf: MTLBuffer
     ) {
         guard let encoder = commandBuffer.makeRenderCommandEncoder(descriptor: renderPassDesc) else { return }
 
         encoder.setRenderPipelineState(pipeline)
         encoder.setVertexBuffer(particleBuf, offset: 0, index: 0)
         encoder.setVertexBuffer(paramsBuf, offset: 0, index: 1)
+        encoder.setVertexBuffer(seedsBuf, offset: 0, index: 2)
         encoder.setFragmentBuffer(paramsBuf, offset: 0, index: 1)
+        encoder.setFragmentBuffer(profileBuf, offset: 0, index: 2)
         encoder.drawPrimitives(type: .point, vertexStart: 0, vertexCount: particleCount)
         encoder.endEncoding()
     }
@@ -477,41 +797,91 @@ extension MetalRenderer: MetalRendererProtocol {
             await buffer.completed()
         }
 
+        stopTraceRecording()
+
         // Обнуляем pointer под защитой и освобождаем буферы
         counterAccessQueue.sync {
             collectedCounterPointer = nil
         }
 
-        particleBuffer = nil
-        paramsBuffer = nil
+        particleRing = nil
+        frameParamsBuffers = []
+        frameTileMaskBuffers = []
+        frameParamsSlot = 0
+        isFrameParamsSlotEncoded = false
         collectedCounterBuffer = nil
+        isCounterResetPending = false
+        particleSeedsBuffer = nil
+        particleSeedsCapacity = 0
+        neighborGrid = nil
+        isNeighborGridActive = false
 
         // Сбрасываем состояние
         particleCount = 0
         lastFrameTimestamp = 0
-        lastLoggedCollectionProgress = 0
+        counterAccessQueue.sync {
+            collectionProgressThreshold.reset()
+        }
         isPipelineConfigured = false
         simulationEngine = nil
         shaderLibrary = nil
+        computePipeline = nil
+        computePipelines = []
+        pipelineCache = nil
+        renderPipeline = nil
         renderQuality = .standard
         currentConfig = .standard
 
         logger.info("MetalRenderer cleanup completed")
     }
 
-    func setParticleBuffer(_ buffer: MTLBuffer?) {
-        // Вызывать только при mtkView?.isPaused = true
-        // Рендеринг должен быть остановлен чтобы избежать гонки с GPU
-        particleBuffer = buffer
+    func setParticleRing(_ ring: ParticleBufferRing?) {
+        // Кольцо живет в хранилище; кадры в полете держат свои слоты до retire
+        particleRing = ring
+    }
+
+    /// Смена количества во время рендера (LOD, перегрев): применяется в начале
+    /// следующего draw после ожидания inFlightSemaphore, а не посреди кадра.
+    /// На паузе — тоже при первом кадре
+    func requestParticleCount(_ count: Int) {
+        pendingParticleCount = count
+    }
+
+    private func applyPendingParticleCount() {
+        guard let count = pendingParticleCount else { return }
+        updateParticleCount(count)
     }
 
     func updateParticleCount(_ count: Int) {
+        // Прямая установка (пересоздание буферов) отменяет запрос на лету
+        pendingParticleCount = nil
         guard count >= 0 else {
             logger.error("Invalid particle count: \(count)")
             return
         }
 
-        // Вызывать только при mtkView?.isPaused = true
+        // Вызывать только при mtkView?.isPaused = true или из начала draw
+        if count > particleSeedsCapacity {
+            do {
+                try bakeParticleSeeds(count: count)
+            } catch {
+                logger.error("Failed to bake particle seeds for \(count) particles: \(error)")
+                return
+            }
+        }
+
+        do {
+            try neighborGrid?.ensureCapacity(particleCount: count)
+        } catch {
+            logger.error("Failed to allocate neighbor grid for \(count) particles: \(error)")
+            return
+        }
+
+        // Трасса хранит один снимок буфера — при смене количества частиц она заканчивается
+        if count != particleCount {
+            stopTraceRecording()
+        }
+
         particleCount = count
         resetCollectedCounter()
     }
@@ -525,57 +895,115 @@ extension MetalRenderer: MetalRendererProtocol {
     func setParticleGenerationConfig(_ config: ParticleGenerationConfig) {
         currentConfig = config
         updateSimulationParams()
+
+        // fastMath пресета — часть ключа pipeline
+        guard isPipelineConfigured else { return }
+        do {
+            try prewarmRenderPipelines()
+        } catch {
+            logger.error("Failed to prewarm render pipelines: \(error)")
+        }
     }
 
     func setRenderQuality(_ quality: RenderQuality) {
         guard renderQuality != quality else { return }
         renderQuality = quality
 
-        guard isPipelineConfigured else { return }
-        guard let library = shaderLibrary else {
-            logger.warning("Render quality changed to \(quality) before shader library was cached")
-            return
+        if radialProfileBuffer != nil {
+            do {
+                try bakeRadialProfiles()
+            } catch {
+                logger.error("Failed to bake radial profiles for \(quality): \(error)")
+            }
         }
 
+        // Варианты прошлого качества остаются в кэше — переключение обратно бесплатно
+        guard isPipelineConfigured else { return }
         do {
-            try setupRenderPipeline(library: library)
+            try prewarmRenderPipelines()
             logger.info("Render quality switched to \(quality)")
         } catch {
             logger.error("Failed to switch render quality to \(quality): \(error)")
         }
     }
     
+    /// Вызывается и с render-потока (команды кадра) — без counterAccessQueue:
+    /// порог сбросит completion handler первого кадра новой эпохи
     func resetCollectedCounter() {
-        counterAccessQueue.sync {
-            guard let ptr = collectedCounterPointer else { return }
-            ptr.pointee = 0
-            lastLoggedCollectionProgress = 0
-        }
+        collectionEpoch &+= 1
+        isCounterResetPending = true
     }
 
-    func checkCollectionCompletion() {
-        // Читаем pointer под защитой очереди
-        let collectedValue: Int? = counterAccessQueue.sync { [weak self] in
-            guard let ptr = self?.collectedCounterPointer else { return nil }
-            return Int(ptr.pointee)
-        }
+    /// Обнуляет счетчик в начале compute-буфера кадра: команды одной очереди
+    /// выполняются по порядку, поэтому прибавления прошлых кадров уже позади,
+    /// а updateParticles этого кадра считает с нуля
+    private func encodeCounterResetIfNeeded(into commandBuffer: MTLCommandBuffer) {
+        guard isCounterResetPending,
+              let counterBuf = collectedCounterBuffer,
+              let blit = commandBuffer.makeBlitCommandEncoder() else { return }
+        blit.fill(buffer: counterBuf, range: 0..<MemoryLayout<UInt32>.stride, value: 0)
+        blit.endEncoding()
+        isCounterResetPending = false
+    }
 
-        guard let collected = collectedValue,
-              let engine = simulationEngine,
-              particleCount > 0 else { return }
+    /// Принудительная проверка прогресса (без порога), вызывать на main
+    func checkCollectionCompletion() {
+        // Указатель меняется только на main — читаем без очереди
+        guard let ptr = collectedCounterPointer, particleCount > 0 else { return }
+        // Сброс еще не дошел до GPU — в буфере значение прошлой эпохи
+        let collected = isCounterResetPending ? 0 : Int(ptr.pointee)
 
         let ratio = min(1, Float(collected) / Float(particleCount))
+        reportCollectionProgress(ratio, collected: collected, total: particleCount)
+    }
+
+    /// Вызывается из completion handler (не main): читает счетчик и ставит команду
+    /// прогресса только при пересечении очередной ступени; кадры прошлой эпохи молчат
+    private func pollCollectionProgress(particleCount total: Int, epoch: UInt64, commands: SimulationCommandQueue?) {
+        let event: (ratio: Float, collected: Int)? = counterAccessQueue.sync {
+            if epoch > collectionThresholdEpoch {
+                collectionProgressThreshold.reset()
+                collectionThresholdEpoch = epoch
+            } else if epoch < collectionThresholdEpoch {
+                return nil
+            }
+            guard let ptr = collectedCounterPointer else { return nil }
+            let collected = Int(ptr.pointee)
+            guard let ratio = collectionProgressThreshold.advance(collected: collected, total: total) else {
+                return nil
+            }
+            return (ratio, collected)
+        }
 
-        // Метод вызывается из DispatchQueue.main.async — уже на основном потоке
-        guard case .collecting = engine.state else { return }
+        guard let event = event, let commands = commands else { return }
 
-        if ratio - lastLoggedCollectionProgress >= Constants.collectionProgressLogThreshold || ratio >= 1 {
-            lastLoggedCollectionProgress = ratio
-            logger.info("Collection progress: \(Int(ratio * 100))% (\(collected)/\(particleCount))")
-        }
+        logger.info("Collection progress: \(Int(event.ratio * 100))% (\(event.collected)/\(total))")
+        commands.push(.updateProgress(event.ratio))
+    }
+
+    private func reportCollectionProgress(_ ratio: Float, collected: Int, total: Int) {
+        guard let engine = simulationEngine,
+              case .collecting = engine.state else { return }
 
+        logger.info("Collection progress: \(Int(ratio * 100))% (\(collected)/\(total))")
         engine.updateProgress(ratio)
     }
 }
 
+// MARK: - RenderQuality → LIGHTING_QUALITY
+
+private extension RenderQuality {
+    /// specializedQuality для fragmentParticle и уровень профилей (RadialProfileC.h)
+    var lightingQuality: Int32 {
+        switch self {
+        case .performance:
+            return LIGHTING_QUALITY_LOW_C
+        case .standard:
+            return LIGHTING_QUALITY_MEDIUM_C
+        case .high:
+            return LIGHTING_QUALITY_HIGH_C
+        }
+    }
+}
+
 // swiftlint:enable identifier_name
@@ -0,0 +1,173 @@
+//
+//  NeighborGridEncoder.swift
+//  PixelFlow
+//
+//  Перестройка равномерной сетки соседей на GPU для режима swarm:
+//  обнуление счетчиков → countNeighborGrid → scanNeighborGrid → scatterNeighborGrid.
+//  Результат (cellStarts, sortedIndices, sortedPositions) читает updateParticles.
+//
+
+import Foundation
+import Metal
+
+final class NeighborGridEncoder {
+
+    // MARK: - Constants
+
+    private enum Constants {
+        // Должно совпадать с NEIGHBOR_SCAN_THREADS в NeighborGrid.h
+        static let scanThreads = 256
+    }
+
+    private enum ShaderNames {
+        static let count = "countNeighborGrid"
+        static let scan = "scanNeighborGrid"
+        static let scatter = "scatterNeighborGrid"
+    }
+
+    // MARK: - Metal Resources
+
+    private let device: MTLDevice
+    private let countPipeline: MTLComputePipelineState
+    private let scanPipeline: MTLComputePipelineState
+    private let scatterPipeline: MTLComputePipelineState
+
+    /// Счетчики ячеек, после scan — курсоры раскладки
+    private let cellCountsBuffer: MTLBuffer
+    /// Начала диапазонов ячеек [cellCount + 1]
+    private let cellStartsBuffer: MTLBuffer
+    private var particleCellsBuffer: MTLBuffer?
+    private var sortedIndicesBuffer: MTLBuffer?
+    private var sortedPositionsBuffer: MTLBuffer?
+    private(set) var particleCapacity: Int = 0
+
+    // MARK: - Initialization
+
+    init(device: MTLDevice, library: MTLLibrary) throws {
+        self.device = device
+        countPipeline = try Self.makePipeline(device: device, library: library, name: ShaderNames.count)
+        scanPipeline = try Self.makePipeline(device: device, library: library, name: ShaderNames.scan)
+        scatterPipeline = try Self.makePipeline(device: device, library: library, name: ShaderNames.scatter)
+
+        // Сетка ограничена NeighborInteraction.maxGridDim — буферы ячеек выделяются один раз
+        let cellCount = NeighborInteraction.maxCellCount
+        guard let counts = device.makeBuffer(
+            length: MemoryLayout<UInt32>.stride * cellCount,
+            options: .storageModePrivate
+        ), let starts = device.makeBuffer(
+            length: MemoryLayout<UInt32>.stride * (cellCount + 1),
+            options: .storageModePrivate
+        ) else {
+            throw MetalError.bufferCreationFailed
+        }
+        cellCountsBuffer = counts
+        cellStartsBuffer = starts
+    }
+
+    private static func makePipeline(
+        device: MTLDevice,
+        library: MTLLibrary,
+        name: String
+    ) throws -> MTLComputePipelineState {
+        guard let function = library.makeFunction(name: name) else {
+            throw MetalError.functionNotFound(name: name)
+        }
+        return try device.makeComputePipelineState(function: function)
+    }
+
+    // MARK: - Buffers
+
+    /// Буферы на частицу только растут — как и ParticleSeeds в MetalRenderer
+    func ensureCapacity(particleCount: Int) throws {
+        guard particleCount > particleCapacity else { return }
+
+        guard let cells = device.makeBuffer(
+            length: MemoryLayout<UInt32>.stride * particleCount,
+            options: .storageModePrivate
+        ), let indices = device.makeBuffer(
+            length: MemoryLayout<UInt32>.stride * particleCount,
+            options: .storageModePrivate
+        ), let positions = device.makeBuffer(
+            length: MemoryLayout<SIMD2<Float>>.stride * particleCount,
+            options: .storageModePrivate
+        ) else {
+            throw MetalError.bufferCreationFailed
+        }
+
+        particleCellsBuffer = cells
+        sortedIndicesBuffer = indices
+        sortedPositionsBuffer = positions
+        particleCapacity = particleCount
+    }
+
+    // MARK: - Encoding
+
+    /// Кодирует перестройку сетки; вызывать перед updateParticles в том же командном буфере
+    func encodeBuild(
+        into commandBuffer: MTLCommandBuffer,
+        particleBuffer: MTLBuffer,
+        paramsBuffer: MTLBuffer,
+        particleCount: Int
+    ) {
+        guard particleCount > 0, particleCount <= particleCapacity,
+              let cells = particleCellsBuffer,
+              let indices = sortedIndicesBuffer,
+              let positions = sortedPositionsBuffer else { return }
+
+        if let blit = commandBuffer.makeBlitCommandEncoder() {
+            blit.fill(buffer: cellCountsBuffer, range: 0..<cellCountsBuffer.length, value: 0)
+            blit.endEncoding()
+        }
+
+        guard let encoder = commandBuffer.makeComputeCommandEncoder() else { return }
+
+        encoder.setBuffer(particleBuffer, offset: 0, index: 0)
+        encoder.setBuffer(paramsBuffer, offset: 0, index: 1)
+        encoder.setBuffer(cellCountsBuffer, offset: 0, index: 2)
+        encoder.setBuffer(cells, offset: 0, index: 3)
+        encoder.setBuffer(cellStartsBuffer, offset: 0, index: 4)
+        encoder.setBuffer(indices, offset: 0, index: 5)
+        encoder.setBuffer(positions, offset: 0, index: 6)
+
+        // Диспатчи в одном последовательном энкодере выполняются по порядку
+        dispatchPerParticle(encoder: encoder, pipeline: countPipeline, particleCount: particleCount)
+
+        encoder.setComputePipelineState(scanPipeline)
+        encoder.dispatchThreadgroups(
+            MTLSize(width: 1, height: 1, depth: 1),
+            threadsPerThreadgroup: MTLSize(width: Constants.scanThreads, height: 1, depth: 1)
+        )
+
+        dispatchPerParticle(encoder: encoder, pipeline: scatterPipeline, particleCount: particleCount)
+
+        encoder.endEncoding()
+    }
+
+    /// Привязывает результат сетки к updateParticles (buffer 4...6)
+    /// Буферы привязываются во всех состояниях — ядро объявляет их всегда
+    func bind(to encoder: MTLComputeCommandEncoder) -> Bool {
+        guard let indices = sortedIndicesBuffer,
+              let positions = sortedPositionsBuffer else { return false }
+
+        encoder.setBuffer(cellStartsBuffer, offset: 0, index: 4)
+        encoder.setBuffer(indices, offset: 0, index: 5)
+        encoder.setBuffer(positions, offset: 0, index: 6)
+        return true
+    }
+
+    private func dispatchPerParticle(
+        encoder: MTLComputeCommandEncoder,
+        pipeline: MTLComputePipelineState,
+        particleCount: Int
+    ) {
+        encoder.setComputePipelineState(pipeline)
+
+        let width = pipeline.threadExecutionWidth
+        let groups = (particleCount + width - 1) / width
+
+        encoder.dispatchThreadgroups(
+            MTLSize(width: groups, height: 1, depth: 1),
+            threadsPerThreadgroup: MTLSize(width: width, height: 1, depth: 1)
+        )
+    }
+}
@@ -0,0 +1,861 @@
+//
+//  PointSpriteRasterC.c
+//  PixelFlow
+//
+//  Порт vertexParticle / fragmentParticle (Basic.h) и используемой ими части
+//  Lighting.h на C. Константы продублированы из шейдеров — держать синхронно!
+//  Радиальные множители освещения берутся из той же таблицы, что и на GPU
+//  (RadialProfileC.h).
+//
+//  Как function constants fragmentParticle, состояние и уровень качества
+//  подставляются при компиляции: RASTER_VARIANT порождает функцию тайла на
+//  каждую пару (состояние × качество), и ветки по ним сворачиваются.
+//  pixelSizeMode и fastMath остаются полями кадра — на CPU это одна
+//  предсказуемая проверка, а вариантов стало бы вчетверо больше.
+//
+
+#include "PointSpriteRasterC.h"
+#include "RadialProfileC.h"
+#include "../Utils/FastMathC.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Basic.h
+#define RASTER_EDGE_SOFTNESS          0.95f
+#define RASTER_MIN_PARTICLE_SIZE      0.1f
+#define RASTER_STORM_BRIGHTNESS       4.5f
+#define RASTER_STORM_SIZE_MIN         0.55f
+#define RASTER_STORM_SIZE_MAX         0.9f
+#define RASTER_STORM_MAX_BRIGHTNESS   3.0f
+#define RASTER_STORM_SPARK_THRESHOLD  0.995f
+#define RASTER_STORM_WAVE_FREQ        15.0f
+#define RASTER_STORM_UV_SCALE         8.0f
+#define RASTER_STORM_TIME_SCALE_1     3.0f
+#define RASTER_STORM_TIME_SCALE_2     2.0f
+#define RASTER_STORM_HUE_SPEED_1      4.0f
+#define RASTER_STORM_HUE_SPEED_2      6.0f
+#define RASTER_BOLT_PERIOD            4.0f
+#define RASTER_BOLT_DURATION          0.5f
+#define RASTER_BOLT_WIDTH             0.02f
+#define RASTER_BOLT_BRIGHTNESS        5.0f
+#define RASTER_ZIGZAG_FREQ            30.0f
+#define RASTER_ZIGZAG_AMOUNT          0.02f
+#define RASTER_TWO_PI                 6.283185307f
+
+// Lighting.h
+#define RASTER_BLOOM_THRESHOLD        0.8f
+
+#define RASTER_TILE                   POINT_SPRITE_TILE_SIZE_C
+#define RASTER_SRGB_LUT_SIZE          4096
+
+/// Функции с параметрами-константами: встраиваются в вариант и сворачиваются
+#define RASTER_SPECIALIZED static inline __attribute__((always_inline))
+
+/// Результат вершинной стадии
+typedef struct {
+    float x0, y0;              // левый верхний угол квадрата точки в пикселях кадра
+    float size, invSize;       // сторона квадрата в пикселях кадра
+    float screenX, screenY;    // in.screenPos: пиксели экрана, y вверх (освещение)
+    float r, g, b;             // color.rgb в linear
+    float alpha;               // color.a
+    float bolt;                // вклад молнии (буря) — постоянен по спрайту
+    uint16_t tileX0, tileY0;   // диапазон тайлов [tile0, tile1)
+    uint16_t tileX1, tileY1;
+} RasterSpriteC;
+
+typedef struct PointSpriteRasterC PointSpriteRasterC;
+
+/// Растеризация одного тайла вариантом (состояние × качество)
+typedef void (*RasterTileFnC)(PointSpriteRasterC* raster, int tile);
+
+static RasterTileFnC selectTileVariant(uint32_t state, int quality);
+
+/// Константы кадра из SimulationParams
+typedef struct {
+    uint32_t state;
+    uint32_t pixelSizeMode;
+    int fastMath;
+    int colorsLinear;          // 0 — старые буферы/трассы с цветами в sRGB
+    float time;
+    float brightnessBoost;
+    float screenWidth, screenHeight;
+    float scale;               // пиксели кадра / пиксели экрана
+    float safeMinSize, safeMaxSize;
+    // Молния бури: концы зависят только от времени
+    float boltProgress;        // < 0 — молнии в этом кадре нет
+    float boltStartX, boltDirX, boltDirY, boltLength;
+    const RadialProfileSampleC* profile;   // таблица текущего состояния
+    RasterTileFnC tileFn;                  // вариант стадии 3 для state × quality
+} RasterFrameC;
+
+struct PointSpriteRasterC {
+    int width, height;
+    int tilesX, tilesY, tileCount;
+    int workerCount;
+
+    const ParticleC* particles;
+    const ParticleSeedsC* seeds;
+    uint32_t particleCount;
+    RasterFrameC frame;
+
+    RasterSpriteC* sprites;
+    uint32_t spriteCapacity;
+    uint32_t* workerTileOffsets;   // [workerCount * tileCount]: счетчики, затем курсоры
+    uint32_t* tileStarts;          // [tileCount + 1]
+    uint32_t* tileSprites;
+    uint64_t tileSpriteCapacity;
+
+    uint8_t* pixels;
+    uint8_t srgbLUT[RASTER_SRGB_LUT_SIZE];
+    int quality;                   // LIGHTING_QUALITY_*_C
+    // Перепекается только при смене состояния или качества
+    RadialProfileSampleC profile[RADIAL_PROFILE_SIZE_C];
+    uint32_t profileState;
+    int profileQuality;
+};
+
+// MARK: - Math helpers
+
+typedef float RasterVec4 __attribute__((vector_size(16)));
+
+static inline float rasterHash(float n) {
+    return particleSeedHashC(n);
+}
+
+static inline float effectSin(float x, int fastMath) {
+    return fastMath ? approxSinC(x) : sinf(x);
+}
+
+static inline float effectExp(float x, int fastMath) {
+    return fastMath ? approxExpC(x) : expf(x);
+}
+
+static inline float clamp01(float x) {
+    return fminf(fmaxf(x, 0.0f), 1.0f);
+}
+
+static inline float smoothstepC(float edge0, float edge1, float x) {
+    float t = clamp01((x - edge0) / (edge1 - edge0));
+    return t * t * (3.0f - 2.0f * t);
+}
+
+static inline float srgbToLinear(float c) {
+    return c > 0.04045f ? powf((c + 0.055f) / 1.055f, 2.4f) : c / 12.92f;
+}
+
+static inline float linearToSrgb(float c) {
+    return c > 0.0031308f ? 1.055f * powf(c, 1.0f / 2.4f) - 0.055f : c * 12.92f;
+}
+
+// MARK: - Lighting.h
+
+static inline void applyGlobalLight(float col[3], float ndcY, float lr, float lg, float lb, float intensity) {
+    float lightFactor = 0.7f + 0.3f * (1.0f - (ndcY * 0.5f + 0.5f));
+    col[0] *= 1.0f + lr * intensity * lightFactor;
+    col[1] *= 1.0f + lg * intensity * lightFactor;
+    col[2] *= 1.0f + lb * intensity * lightFactor;
+}
+
+/// bloomGlow — profile.bloom (уже умножен на BLOOM_RADIUS)
+static inline void applyBloom(float col[3], float bloomGlow) {
+    float brightness = col[0] * 0.299f + col[1] * 0.587f + col[2] * 0.114f;
+    if (brightness <= RASTER_BLOOM_THRESHOLD) return;
+    float amount = (brightness - RASTER_BLOOM_THRESHOLD) / (1.0f - RASTER_BLOOM_THRESHOLD);
+    float k = 1.0f + amount * bloomGlow;
+    col[0] *= k;
+    col[1] *= k;
+    col[2] *= k;
+}
+
+/// calculateProfiledParticle2DLighting для состояний, которые доходят до него
+/// из fragmentParticle: idle, collecting, swarm (ветка default).
+/// Время в этих ветках не участвует — getStateTimeScale не нужен
+RASTER_SPECIALIZED void particleLighting(float col[3], const RasterFrameC* f, const RasterSpriteC* s,
+                                         const RadialProfileSampleC* profile,
+                                         const uint32_t state, const int quality) {
+    float ndcY = (s->screenY / fmaxf(f->screenHeight, 1.0f)) * 2.0f - 1.0f;
+
+    col[0] *= f->brightnessBoost;
+    col[1] *= f->brightnessBoost;
+    col[2] *= f->brightnessBoost;
+
+    if (state == SIMULATION_STATE_COLLECTING_C) {
+        applyGlobalLight(col, ndcY, 0.95f, 0.82f, 0.62f, 0.07f);
+    } else {
+        applyGlobalLight(col, ndcY, 0.15f, 0.2f, 0.32f, 0.05f);
+    }
+    col[0] = col[0] * profile->occlusion + profile->glow;
+    col[1] = col[1] * profile->occlusion + profile->glow;
+    col[2] = col[2] * profile->occlusion + profile->glow;
+
+    if (quality == LIGHTING_QUALITY_HIGH_C) {
+        applyBloom(col, profile->bloom);
+    }
+    col[0] = fmaxf(col[0], 0.0f);
+    col[1] = fmaxf(col[1], 0.0f);
+    col[2] = fmaxf(col[2], 0.0f);
+}
+
+// MARK: - Fragment stage
+
+static void stormColor(float col[3], const RasterFrameC* f, const RasterSpriteC* s,
+                       float u, float v, float dist, float core) {
+    int fastMath = f->fastMath;
+    float time = f->time;
+
+    float eu = u * RASTER_STORM_UV_SCALE + time * RASTER_STORM_TIME_SCALE_1;
+    float ev = v * RASTER_STORM_UV_SCALE + time * RASTER_STORM_TIME_SCALE_2;
+    float seed = eu * 12.9898f + ev * 78.233f;
+    float seedHash = rasterHash(seed);
+
+    float hue1 = seedHash * RASTER_TWO_PI + time * RASTER_STORM_HUE_SPEED_1;
+    float hue2 = rasterHash(seed + 100.0f) * RASTER_TWO_PI + time * RASTER_STORM_HUE_SPEED_2;
+
+    col[0] = 0.8f * fabsf(effectSin(hue1, fastMath));
+    col[1] = 0.2f + 0.6f * fabsf(effectSin(hue1 + 1.57f, fastMath));
+    col[2] = 0.8f + 0.2f * fabsf(effectSin(hue2, fastMath));
+
+    float turbulence = rasterHash(seed + time * 2.0f) * 0.3f;
+    col[0] += 0.1f * turbulence;
+    col[1] += 0.2f * turbulence;
+    col[2] += 0.4f * turbulence;
+
+    float sparkSeed = (u + v) * 100.0f + time * 10.0f;
+    if (rasterHash(sparkSeed) > RASTER_STORM_SPARK_THRESHOLD) {
+        col[0] = col[1] = col[2] = 3.0f;
+    }
+
+    col[0] += 0.25f * core;
+    col[1] += 0.45f * core;
+    col[2] += 0.75f * core;
+
+    float waveFreq = 8.0f + seedHash * 4.0f;
+    float wave = (effectSin(time * waveFreq + dist * RASTER_STORM_WAVE_FREQ, fastMath) * 0.4f + 0.6f) * RASTER_STORM_BRIGHTNESS;
+    for (int c = 0; c < 3; c++) {
+        col[c] = fminf(fmaxf(col[c] * wave + s->bolt, 0.0f), RASTER_STORM_MAX_BRIGHTNESS);
+    }
+}
+
+/// LIGHTING_QUALITY_LOW: lowQualityParticleColor (Basic.h) — без молний,
+/// блума и мягкого края; glow — профиль качества LOW
+RASTER_SPECIALIZED void lowQualityColor(float col[3], const RasterFrameC* f, float u, float v,
+                                        float glow, const uint32_t state) {
+    if (state == SIMULATION_STATE_LIGHTNING_STORM_C) {
+        float seed = u * 12.9898f + v * 78.233f + f->time;
+        float hue = rasterHash(seed) * RASTER_TWO_PI;
+        float c = f->fastMath ? approxCosC(hue) : cosf(hue);
+        col[0] = (0.3f + 0.7f * effectSin(hue, f->fastMath)) * 3.0f + 0.2f * glow;
+        col[1] = (0.4f + 0.6f * c) * 3.0f + 0.4f * glow;
+        col[2] = 0.8f * 3.0f + 0.7f * glow;
+    } else {
+        col[0] = clamp01(col[0] * f->brightnessBoost) + glow;
+        col[1] = clamp01(col[1] * f->brightnessBoost) + glow;
+        col[2] = clamp01(col[2] * f->brightnessBoost) + glow;
+    }
+}
+
+/// fragmentParticle для одного пикселя; uv ∈ [-1, 1] как point_coord * 2 - 1
+/// state / quality — константы варианта (specializedState / specializedQuality)
+/// out — цвет, уже ограниченный [0, 1] (unorm-цель), и альфа смешивания
+RASTER_SPECIALIZED void shadeFragment(const RasterFrameC* f, const RasterSpriteC* s, float u, float v, float out[4],
+                                      const uint32_t state, const int quality) {
+    float dist = sqrtf(u * u + v * v);
+    float col[3] = { s->r, s->g, s->b };
+    float finalAlpha;
+
+    if (quality == LIGHTING_QUALITY_LOW_C) {
+        lowQualityColor(col, f, u, v, sampleRadialProfileC(f->profile, dist).glow, state);
+        finalAlpha = 1.0f;
+    } else if (state == SIMULATION_STATE_LIGHTNING_STORM_C) {
+        float alpha = 1.0f;
+        if (f->pixelSizeMode == 0) {
+            alpha = 1.0f - smoothstepC(1.0f - RASTER_EDGE_SOFTNESS, 1.0f, dist);
+        }
+        RadialProfileSampleC profile = sampleRadialProfileC(f->profile, dist);
+        stormColor(col, f, s, u, v, dist, profile.glow);
+        finalAlpha = alpha;
+    } else if (f->pixelSizeMode != 0) {
+        // Pixel-perfect: исходный цвет без освещения
+        finalAlpha = 1.0f;
+    } else {
+        float alpha = 1.0f - smoothstepC(1.0f - RASTER_EDGE_SOFTNESS, 1.0f, dist);
+        RadialProfileSampleC profile = sampleRadialProfileC(f->profile, dist);
+        if (state == SIMULATION_STATE_CHAOTIC_C || state == SIMULATION_STATE_COLLECTED_C) {
+            col[0] += profile.glow;
+            col[1] += profile.glow;
+            col[2] += profile.glow;
+        } else {
+            particleLighting(col, f, s, &profile, state, quality);
+
+            if (state == SIMULATION_STATE_IDLE_C) {
+                col[0] *= 0.6f;
+                col[1] *= 0.6f;
+                col[2] *= 0.6f;
+            } else if (state == SIMULATION_STATE_COLLECTING_C) {
+                col[0] += profile.rim;
+                col[1] += 0.9f * profile.rim;
+                col[2] += 0.7f * profile.rim;
+            }
+        }
+
+        if (state == SIMULATION_STATE_COLLECTING_C || state == SIMULATION_STATE_COLLECTED_C) {
+            finalAlpha = 1.0f;
+        } else {
+            float pixelAlpha = s->alpha;
+            if (pixelAlpha >= 0.1f && pixelAlpha < 0.8f) {
+                pixelAlpha = fmaxf(0.6f, fminf(pixelAlpha * 2.0f, 1.0f));
+            }
+            finalAlpha = alpha * pixelAlpha;
+        }
+    }
+
+    out[0] = clamp01(col[0]);
+    out[1] = clamp01(col[1]);
+    out[2] = clamp01(col[2]);
+    out[3] = clamp01(finalAlpha);
+}
+
+// MARK: - Vertex stage
+
+static void prepareFrame(PointSpriteRasterC* raster, const SimulationParamsC* params) {
+    RasterFrameC* f = &raster->frame;
+    memset(f, 0, sizeof(*f));
+
+    f->state = params->state;
+    f->pixelSizeMode = params->pixelSizeMode;
+    f->fastMath = params->fastEffectsMath != 0;
+    f->colorsLinear = params->colorsLinear != 0;
+    f->time = params->time;
+    f->brightnessBoost = params->brightnessBoost;
+    f->screenWidth = params->screenSize[0] > 0.0f ? params->screenSize[0] : (float)raster->width;
+    f->screenHeight = params->screenSize[1] > 0.0f ? params->screenSize[1] : (float)raster->height;
+    f->scale = fminf((float)raster->width / f->screenWidth, (float)raster->height / f->screenHeight);
+
+    f->safeMinSize = fmaxf(params->minParticleSize, RASTER_MIN_PARTICLE_SIZE);
+    f->safeMaxSize = fmaxf(params->maxParticleSize, f->safeMinSize);
+    if (f->state == SIMULATION_STATE_LIGHTNING_STORM_C) {
+        f->safeMinSize *= RASTER_STORM_SIZE_MIN;
+        f->safeMaxSize *= RASTER_STORM_SIZE_MAX;
+    }
+
+    if (raster->profileState != f->state || raster->profileQuality != raster->quality) {
+        bakeRadialProfileC(raster->profile, f->state, raster->quality);
+        raster->profileState = f->state;
+        raster->profileQuality = raster->quality;
+    }
+    f->profile = raster->profile;
+    f->tileFn = selectTileVariant(f->state, raster->quality);
+
+    f->boltProgress = -1.0f;
+    float boltTime = fmodf(f->time * 0.3f, RASTER_BOLT_PERIOD);
+    if (f->state == SIMULATION_STATE_LIGHTNING_STORM_C && boltTime < RASTER_BOLT_DURATION) {
+        float second = floorf(f->time);
+        float startX = rasterHash(second * 7.389f) * 2.0f - 1.0f;
+        float endX = rasterHash(second * 13.23f) * 2.0f - 1.0f;
+        float dx = endX - startX;
+        float dy = -2.0f;
+        float length = sqrtf(dx * dx + dy * dy);
+
+        f->boltProgress = boltTime / RASTER_BOLT_DURATION;
+        f->boltStartX = startX;
+        f->boltDirX = dx / length;
+        f->boltDirY = dy / length;
+        f->boltLength = length;
+    }
+}
+
+/// Молния бури в точке экрана (screenPos → NDC), как в fragmentParticle
+static float boltContribution(const RasterFrameC* f, float screenX, float screenY) {
+    if (f->boltProgress < 0.0f) return 0.0f;
+
+    float px = (screenX / f->screenWidth) * 2.0f - 1.0f;
+    float py = (screenY / f->screenHeight) * 2.0f - 1.0f;
+    float tx = px - f->boltStartX;
+    float ty = py - 1.0f;
+    float along = tx * f->boltDirX + ty * f->boltDirY;
+    float t = fminf(fmaxf(along, 0.0f), f->boltLength);
+    float cx = f->boltStartX + f->boltDirX * t - px;
+    float cy = 1.0f + f->boltDirY * t - py;
+    float across = sqrtf(cx * cx + cy * cy);
+
+    float core = effectExp(-across / RASTER_BOLT_WIDTH, f->fastMath);
+    float zigzag = effectSin(along * RASTER_ZIGZAG_FREQ + f->time * 20.0f, f->fastMath) * RASTER_ZIGZAG_AMOUNT;
+    float zigzagMask = effectExp(-fabsf(zigzag) * 25.0f, f->fastMath);
+    float timeMask = smoothstepC(0.0f, 0.15f, f->boltProgress) * smoothstepC(1.0f, 0.7f, f->boltProgress);
+
+    return core * zigzagMask * timeMask * RASTER_BOLT_BRIGHTNESS;
+}
+
+static void vertexSprite(const PointSpriteRasterC* raster, uint32_t index, RasterSpriteC* s) {
+    const RasterFrameC* f = &raster->frame;
+    const ParticleC* p = &raster->particles[index];
+    const ParticleSeedsC* seeds = &raster->seeds[index];
+
+    float ndcX = p->position[0];
+    float ndcY = p->position[1];
+    if (f->pixelSizeMode == 2) {
+        ndcX = ((floorf((ndcX * 0.5f + 0.5f) * f->screenWidth) + 0.5f) / f->screenWidth) * 2.0f - 1.0f;
+        ndcY = ((floorf((ndcY * 0.5f + 0.5f) * f->screenHeight) + 0.5f) / f->screenHeight) * 2.0f - 1.0f;
+    }
+    if (f->pixelSizeMode == 0) {
+        ndcX += seeds->subpixelOffset[0] / f->screenWidth * 2.0f;
+        ndcY += seeds->subpixelOffset[1] / f->screenHeight * 2.0f;
+    }
+
+    float pixelSize = fmaxf(p->size, f->safeMinSize);
+    if (f->state == SIMULATION_STATE_LIGHTNING_STORM_C) {
+        pixelSize *= RASTER_STORM_SIZE_MIN + (RASTER_STORM_SIZE_MAX - RASTER_STORM_SIZE_MIN) * seeds->stormSizeJitter;
+    }
+    float pointSize = fminf(fmaxf(pixelSize, f->safeMinSize), f->safeMaxSize) * f->scale;
+
+    s->screenX = (ndcX * 0.5f + 0.5f) * f->screenWidth;
+    s->screenY = (ndcY * 0.5f + 0.5f) * f->screenHeight;
+    s->size = pointSize;
+    s->invSize = pointSize > 0.0f ? 1.0f / pointSize : 0.0f;
+    s->x0 = (ndcX * 0.5f + 0.5f) * (float)raster->width - 0.5f * pointSize;
+    s->y0 = (0.5f - ndcY * 0.5f) * (float)raster->height - 0.5f * pointSize;
+    s->r = clamp01(p->color[0]);
+    s->g = clamp01(p->color[1]);
+    s->b = clamp01(p->color[2]);
+    if (!f->colorsLinear) {
+        s->r = srgbToLinear(s->r);
+        s->g = srgbToLinear(s->g);
+        s->b = srgbToLinear(s->b);
+    }
+    s->alpha = clamp01(p->color[3]);
+    s->bolt = boltContribution(f, s->screenX, s->screenY);
+
+    // Покрываются пиксели, центр которых внутри [x0, x0 + size)
+    int px0 = (int)ceilf(s->x0 - 0.5f);
+    int py0 = (int)ceilf(s->y0 - 0.5f);
+    int px1 = (int)ceilf(s->x0 + pointSize - 0.5f);
+    int py1 = (int)ceilf(s->y0 + pointSize - 0.5f);
+    if (px0 < 0) px0 = 0;
+    if (py0 < 0) py0 = 0;
+    if (px1 > raster->width) px1 = raster->width;
+    if (py1 > raster->height) py1 = raster->height;
+
+    if (!(pointSize > 0.0f) || px0 >= px1 || py0 >= py1) {
+        s->tileX0 = s->tileX1 = 0;
+        s->tileY0 = s->tileY1 = 0;
+        return;
+    }
+    s->tileX0 = (uint16_t)(px0 / RASTER_TILE);
+    s->tileY0 = (uint16_t)(py0 / RASTER_TILE);
+    s->tileX1 = (uint16_t)((px1 - 1) / RASTER_TILE + 1);
+    s->tileY1 = (uint16_t)((py1 - 1) / RASTER_TILE + 1);
+}
+
+// MARK: - Lifecycle
+
+PointSpriteRasterC* pointSpriteRasterCreateC(int width, int height, int workerCount) {
+    if (width <= 0 || height <= 0) return NULL;
+    if (workerCount < 1) workerCount = 1;
+
+    PointSpriteRasterC* raster = calloc(1, sizeof(PointSpriteRasterC));
+    if (!raster) return NULL;
+
+    raster->width = width;
+    raster->height = height;
+    raster->tilesX = (width + RASTER_TILE - 1) / RASTER_TILE;
+    raster->tilesY = (height + RASTER_TILE - 1) / RASTER_TILE;
+    raster->tileCount = raster->tilesX * raster->tilesY;
+    raster->workerCount = workerCount;
+
+    raster->workerTileOffsets = malloc(sizeof(uint32_t) * (size_t)workerCount * (size_t)raster->tileCount);
+    raster->tileStarts = malloc(sizeof(uint32_t) * ((size_t)raster->tileCount + 1));
+    raster->pixels = malloc((size_t)width * (size_t)height * 4);
+    if (!raster->workerTileOffsets || !raster->tileStarts || !raster->pixels) {
+        pointSpriteRasterDestroyC(raster);
+        return NULL;
+    }
+
+    // linear → sRGB при записи в bgra8Unorm_srgb
+    for (int i = 0; i < RASTER_SRGB_LUT_SIZE; i++) {
+        float srgb = linearToSrgb((float)i / (float)(RASTER_SRGB_LUT_SIZE - 1));
+        raster->srgbLUT[i] = (uint8_t)(clamp01(srgb) * 255.0f + 0.5f);
+    }
+    raster->quality = LIGHTING_QUALITY_HIGH_C;
+    raster->profileState = UINT32_MAX;
+    return raster;
+}
+
+void pointSpriteRasterDestroyC(PointSpriteRasterC* raster) {
+    if (!raster) return;
+    free(raster->sprites);
+    free(raster->workerTileOffsets);
+    free(raster->tileStarts);
+    free(raster->tileSprites);
+    free(raster->pixels);
+    free(raster);
+}
+
+int pointSpriteRasterWorkerCountC(const PointSpriteRasterC* raster) {
+    return raster ? raster->workerCount : 0;
+}
+
+void pointSpriteRasterSetQualityC(PointSpriteRasterC* raster, int quality) {
+    if (!raster || quality < 0 || quality >= LIGHTING_QUALITY_COUNT_C) return;
+    raster->quality = quality;
+}
+
+int pointSpriteRasterTileCountC(const PointSpriteRasterC* raster) {
+    return raster ? raster->tileCount : 0;
+}
+
+const uint8_t* pointSpriteRasterPixelsC(const PointSpriteRasterC* raster) {
+    return raster ? raster->pixels : NULL;
+}
+
+uint64_t pointSpriteRasterBinnedCountC(const PointSpriteRasterC* raster) {
+    return raster ? raster->tileStarts[raster->tileCount] : 0;
+}
+
+// MARK: - Stages
+
+int pointSpriteRasterBeginC(PointSpriteRasterC* raster,
+                            const ParticleC* particles,
+                            const ParticleSeedsC* seeds,
+                            uint32_t particleCount,
+                            const SimulationParamsC* params) {
+    if (!raster || !params || (particleCount > 0 && (!particles || !seeds))) return 0;
+
+    if (particleCount > raster->spriteCapacity) {
+        RasterSpriteC* grown = realloc(raster->sprites, sizeof(RasterSpriteC) * particleCount);
+        if (!grown) return 0;
+        raster->sprites = grown;
+        raster->spriteCapacity = particleCount;
+    }
+
+    raster->particles = particles;
+    raster->seeds = seeds;
+    raster->particleCount = particleCount;
+    prepareFrame(raster, params);
+
+    memset(raster->workerTileOffsets, 0,
+           sizeof(uint32_t) * (size_t)raster->workerCount * (size_t)raster->tileCount);
+    raster->tileStarts[raster->tileCount] = 0;
+    return 1;
+}
+
+static inline void workerRange(const PointSpriteRasterC* raster, int worker, uint32_t* start, uint32_t* end) {
+    uint64_t n = raster->particleCount;
+    *start = (uint32_t)(n * (uint64_t)worker / (uint64_t)raster->workerCount);
+    *end = (uint32_t)(n * (uint64_t)(worker + 1) / (uint64_t)raster->workerCount);
+}
+
+void pointSpriteRasterBinC(PointSpriteRasterC* raster, int worker) {
+    if (!raster || worker < 0 || worker >= raster->workerCount) return;
+
+    uint32_t start, end;
+    workerRange(raster, worker, &start, &end);
+    uint32_t* counts = raster->workerTileOffsets + (size_t)worker * (size_t)raster->tileCount;
+
+    for (uint32_t i = start; i < end; i++) {
+        RasterSpriteC* s = &raster->sprites[i];
+        vertexSprite(raster, i, s);
+        for (int ty = s->tileY0; ty < s->tileY1; ty++) {
+            for (int tx = s->tileX0; tx < s->tileX1; tx++) {
+                counts[ty * raster->tilesX + tx]++;
+            }
+        }
+    }
+}
+
+int pointSpriteRasterPrepareScatterC(PointSpriteRasterC* raster) {
+    if (!raster) return 0;
+
+    // Тайл за тайлом, внутри — воркеры по порядку: частицы в списке тайла
+    // остаются в порядке индексов, как у вершин в drawPrimitives
+    uint64_t running = 0;
+    for (int t = 0; t < raster->tileCount; t++) {
+        raster->tileStarts[t] = (uint32_t)running;
+        for (int w = 0; w < raster->workerCount; w++) {
+            uint32_t* slot = &raster->workerTileOffsets[(size_t)w * (size_t)raster->tileCount + (size_t)t];
+            uint32_t count = *slot;
+            *slot = (uint32_t)running;
+            running += count;
+        }
+    }
+    if (running > UINT32_MAX) return 0;
+    raster->tileStarts[raster->tileCount] = (uint32_t)running;
+
+    if (running > raster->tileSpriteCapacity) {
+        uint32_t* grown = realloc(raster->tileSprites, sizeof(uint32_t) * (size_t)running);
+        if (!grown) return 0;
+        raster->tileSprites = grown;
+        raster->tileSpriteCapacity = running;
+    }
+    return 1;
+}
+
+void pointSpriteRasterScatterC(PointSpriteRasterC* raster, int worker) {
+    if (!raster || worker < 0 || worker >= raster->workerCount) return;
+
+    uint32_t start, end;
+    workerRange(raster, worker, &start, &end);
+    uint32_t* cursors = raster->workerTileOffsets + (size_t)worker * (size_t)raster->tileCount;
+
+    for (uint32_t i = start; i < end; i++) {
+        const RasterSpriteC* s = &raster->sprites[i];
+        for (int ty = s->tileY0; ty < s->tileY1; ty++) {
+            for (int tx = s->tileX0; tx < s->tileX1; tx++) {
+                raster->tileSprites[cursors[ty * raster->tilesX + tx]++] = i;
+            }
+        }
+    }
+}
+
+/// dst = src * a + dst * (1 - a) по 4 пикселя (sourceAlpha / oneMinusSourceAlpha)
+static inline void blendSpan(float* dst, const float* src, const float* alpha, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        RasterVec4 d, s, a;
+        memcpy(&d, dst + i, sizeof(d));
+        memcpy(&s, src + i, sizeof(s));
+        memcpy(&a, alpha + i, sizeof(a));
+        d = s * a + d * (1.0f - a);
+        memcpy(dst + i, &d, sizeof(d));
+    }
+    for (; i < n; i++) {
+        dst[i] = src[i] * alpha[i] + dst[i] * (1.0f - alpha[i]);
+    }
+}
+
+RASTER_SPECIALIZED void rasterTile(PointSpriteRasterC* raster, int tile,
+                                   const uint32_t state, const int quality) {
+    // Тайл в SoA-раскладке: строки по RASTER_TILE float на канал
+    float red[RASTER_TILE * RASTER_TILE];
+    float green[RASTER_TILE * RASTER_TILE];
+    float blue[RASTER_TILE * RASTER_TILE];
+    float spanR[RASTER_TILE], spanG[RASTER_TILE], spanB[RASTER_TILE], spanA[RASTER_TILE];
+
+    // Clear color MTKView — черный
+    memset(red, 0, sizeof(red));
+    memset(green, 0, sizeof(green));
+    memset(blue, 0, sizeof(blue));
+
+    int tileX = (tile % raster->tilesX) * RASTER_TILE;
+    int tileY = (tile / raster->tilesX) * RASTER_TILE;
+    int tileW = raster->width - tileX < RASTER_TILE ? raster->width - tileX : RASTER_TILE;
+    int tileH = raster->height - tileY < RASTER_TILE ? raster->height - tileY : RASTER_TILE;
+    const RasterFrameC* f = &raster->frame;
+
+    for (uint32_t k = raster->tileStarts[tile]; k < raster->tileStarts[tile + 1]; k++) {
+        const RasterSpriteC* s = &raster->sprites[raster->tileSprites[k]];
+
+        int px0 = (int)ceilf(s->x0 - 0.5f) - tileX;
+        int py0 = (int)ceilf(s->y0 - 0.5f) - tileY;
+        int px1 = (int)ceilf(s->x0 + s->size - 0.5f) - tileX;
+        int py1 = (int)ceilf(s->y0 + s->size - 0.5f) - tileY;
+        if (px0 < 0) px0 = 0;
+        if (py0 < 0) py0 = 0;
+        if (px1 > tileW) px1 = tileW;
+        if (py1 > tileH) py1 = tileH;
+        int n = px1 - px0;
+        if (n <= 0) continue;
+
+        for (int y = py0; y < py1; y++) {
+            float v = (((float)(tileY + y) + 0.5f - s->y0) * s->invSize) * 2.0f - 1.0f;
+            for (int x = 0; x < n; x++) {
+                float u = (((float)(tileX + px0 + x) + 0.5f - s->x0) * s->invSize) * 2.0f - 1.0f;
+                float out[4];
+                shadeFragment(f, s, u, v, out, state, quality);
+                spanR[x] = out[0];
+                spanG[x] = out[1];
+                spanB[x] = out[2];
+                spanA[x] = out[3];
+            }
+            int row = y * RASTER_TILE + px0;
+            blendSpan(red + row, spanR, spanA, n);
+            blendSpan(green + row, spanG, spanA, n);
+            blendSpan(blue + row, spanB, spanA, n);
+        }
+    }
+
+    // Запись в sRGB-цель
+    const float lutScale = (float)(RASTER_SRGB_LUT_SIZE - 1);
+    for (int y = 0; y < tileH; y++) {
+        uint8_t* dst = raster->pixels + ((size_t)(tileY + y) * (size_t)raster->width + (size_t)tileX) * 4;
+        for (int x = 0; x < tileW; x++) {
+            int i = y * RASTER_TILE + x;
+            dst[x * 4 + 0] = raster->srgbLUT[(int)(red[i] * lutScale + 0.5f)];
+            dst[x * 4 + 1] = raster->srgbLUT[(int)(green[i] * lutScale + 0.5f)];
+            dst[x * 4 + 2] = raster->srgbLUT[(int)(blue[i] * lutScale + 0.5f)];
+            dst[x * 4 + 3] = 255;
+        }
+    }
+}
+
+// MARK: - Variants
+
+// Имя варианта из значений констант: rasterTile_<state>_<quality>
+#define RASTER_VARIANT_NAME_(state, quality) rasterTile_##state##_##quality
+#define RASTER_VARIANT_NAME(state, quality) RASTER_VARIANT_NAME_(state, quality)
+
+#define RASTER_VARIANT(state, quality) \
+    static void RASTER_VARIANT_NAME(state, quality)(PointSpriteRasterC* raster, int tile) { \
+        rasterTile(raster, tile, state, quality); \
+    }
+
+#define RASTER_STATE_VARIANTS(state) \
+    RASTER_VARIANT(state, LIGHTING_QUALITY_LOW_C) \
+    RASTER_VARIANT(state, LIGHTING_QUALITY_MEDIUM_C) \
+    RASTER_VARIANT(state, LIGHTING_QUALITY_HIGH_C)
+
+RASTER_STATE_VARIANTS(SIMULATION_STATE_IDLE_C)
+RASTER_STATE_VARIANTS(SIMULATION_STATE_CHAOTIC_C)
+RASTER_STATE_VARIANTS(SIMULATION_STATE_COLLECTING_C)
+RASTER_STATE_VARIANTS(SIMULATION_STATE_COLLECTED_C)
+RASTER_STATE_VARIANTS(SIMULATION_STATE_LIGHTNING_STORM_C)
+RASTER_STATE_VARIANTS(SIMULATION_STATE_SWARM_C)
+
+#define RASTER_STATE_ROW(state) { \
+    RASTER_VARIANT_NAME(state, LIGHTING_QUALITY_LOW_C), \
+    RASTER_VARIANT_NAME(state, LIGHTING_QUALITY_MEDIUM_C), \
+    RASTER_VARIANT_NAME(state, LIGHTING_QUALITY_HIGH_C) }
+
+/// [state][quality], порядок строк — SIMULATION_STATE_*_C
+static const RasterTileFnC rasterTileVariants[SIMULATION_STATE_COUNT_C][LIGHTING_QUALITY_COUNT_C] = {
+    RASTER_STATE_ROW(SIMULATION_STATE_IDLE_C),
+    RASTER_STATE_ROW(SIMULATION_STATE_CHAOTIC_C),
+    RASTER_STATE_ROW(SIMULATION_STATE_COLLECTING_C),
+    RASTER_STATE_ROW(SIMULATION_STATE_COLLECTED_C),
+    RASTER_STATE_ROW(SIMULATION_STATE_LIGHTNING_STORM_C),
+    RASTER_STATE_ROW(SIMULATION_STATE_SWARM_C),
+};
+
+static RasterTileFnC selectTileVariant(uint32_t state, int quality) {
+    // Неизвестное состояние шейдер освещает веткой default — как idle без множителя 0.6
+    if (state >= SIMULATION_STATE_COUNT_C) state = SIMULATION_STATE_SWARM_C;
+    return rasterTileVariants[state][quality];
+}
+
+void pointSpriteRasterTilesC(PointSpriteRasterC* raster, int firstTile, int tileCount) {
+    if (!raster || firstTile < 0) return;
+    int end = firstTile + tileCount;
+    if (end > raster->tileCount) end = raster->tileCount;
+    RasterTileFnC tileFn = raster->frame.tileFn;
+    for (int t = firstTile; t < end; t++) {
+        tileFn(raster, t);
+    }
+}
+
+// MARK: - Image output
+
+int pointSpriteWritePPMC(const char* path, const uint8_t* rgba, int width, int height) {
+    if (!path || !rgba || width <= 0 || height <= 0) return 0;
+    FILE* file = fopen(path, "wb");
+    if (!file) return 0;
+
+    int ok = fprintf(file, "P6\n%d %d\n255\n", width, height) > 0;
+    uint8_t* row = malloc((size_t)width * 3);
+    ok = ok && row;
+    for (int y = 0; ok && y < height; y++) {
+        const uint8_t* src = rgba + (size_t)y * (size_t)width * 4;
+        for (int x = 0; x < width; x++) {
+            row[x * 3 + 0] = src[x * 4 + 0];
+            row[x * 3 + 1] = src[x * 4 + 1];
+            row[x * 3 + 2] = src[x * 4 + 2];
+        }
+        ok = fwrite(row, 1, (size_t)width * 3, file) == (size_t)width * 3;
+    }
+    free(row);
+    return fclose(file) == 0 && ok;
+}
+
+static void qoiWrite32(uint8_t* out, size_t* pos, uint32_t value) {
+    out[(*pos)++] = (uint8_t)(value >> 24);
+    out[(*pos)++] = (uint8_t)(value >> 16);
+    out[(*pos)++] = (uint8_t)(value >> 8);
+    out[(*pos)++] = (uint8_t)value;
+}
+
+int pointSpriteWriteQOIC(const char* path, const uint8_t* rgba, int width, int height) {
+    if (!path || !rgba || width <= 0 || height <= 0) return 0;
+
+    // Худший случай: QOI_OP_RGB на каждый пиксель + заголовок и маркер конца
+    size_t pixelCount = (size_t)width * (size_t)height;
+    uint8_t* out = malloc(14 + pixelCount * 4 + 8);
+    if (!out) return 0;
+
+    size_t pos = 0;
+    out[pos++] = 'q';
+    out[pos++] = 'o';
+    out[pos++] = 'i';
+    out[pos++] = 'f';
+    qoiWrite32(out, &pos, (uint32_t)width);
+    qoiWrite32(out, &pos, (uint32_t)height);
+    out[pos++] = 3;   // RGB
+    out[pos++] = 0;   // sRGB с линейной альфой
+
+    // Индекс начинается с (0, 0, 0, 0) — альфа нужна, чтобы черный
+    // непрозрачный пиксель не совпал с пустым слотом
+    uint8_t index[64][4];
+    memset(index, 0, sizeof(index));
+    uint8_t pr = 0, pg = 0, pb = 0;
+    int run = 0;
+
+    for (size_t i = 0; i < pixelCount; i++) {
+        uint8_t r = rgba[i * 4 + 0];
+        uint8_t g = rgba[i * 4 + 1];
+        uint8_t b = rgba[i * 4 + 2];
+
+        if (r == pr && g == pg && b == pb) {
+            run++;
+            if (run == 62 || i == pixelCount - 1) {
+                out[pos++] = (uint8_t)(0xC0 | (run - 1));   // QOI_OP_RUN
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0) {
+            out[pos++] = (uint8_t)(0xC0 | (run - 1));
+            run = 0;
+        }
+
+        int slot = (r * 3 + g * 5 + b * 7 + 255 * 11) % 64;
+        if (index[slot][0] == r && index[slot][1] == g && index[slot][2] == b && index[slot][3] == 255) {
+            out[pos++] = (uint8_t)slot;                     // QOI_OP_INDEX
+        } else {
+            index[slot][0] = r;
+            index[slot][1] = g;
+            index[slot][2] = b;
+            index[slot][3] = 255;
+
+            int8_t dr = (int8_t)(r - pr);
+            int8_t dg = (int8_t)(g - pg);
+            int8_t db = (int8_t)(b - pb);
+            int8_t drdg = (int8_t)(dr - dg);
+            int8_t dbdg = (int8_t)(db - dg);
+
+            if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                out[pos++] = (uint8_t)(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));   // QOI_OP_DIFF
+            } else if (dg >= -32 && dg <= 31 && drdg >= -8 && drdg <= 7 && dbdg >= -8 && dbdg <= 7) {
+                out[pos++] = (uint8_t)(0x80 | (dg + 32));                                  // QOI_OP_LUMA
+                out[pos++] = (uint8_t)((drdg + 8) << 4 | (dbdg + 8));
+            } else {
+                out[pos++] = 0xFE;                                                          // QOI_OP_RGB
+                out[pos++] = r;
+                out[pos++] = g;
+                out[pos++] = b;
+            }
+        }
+        pr = r;
+        pg = g;
+        pb = b;
+    }
+
+    static const uint8_t padding[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    memcpy(out + pos, padding, sizeof(padding));
+    pos += sizeof(padding);
+
+    FILE* file = fopen(path, "wb");
+    int ok = file && fwrite(out, 1, pos, file) == pos;
+    if (file && fclose(file) != 0) ok = 0;
+    free(out);
+    return ok;
+}
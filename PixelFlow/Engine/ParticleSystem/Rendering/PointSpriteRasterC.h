@@ -0,0 +1,87 @@
+//
+//  PointSpriteRasterC.h
+//  PixelFlow
+//
+//  CPU-растеризатор point-спрайтов — эталон пары vertexParticle /
+//  fragmentParticle (Shaders/Rendering/Basic.h) без GPU: golden-кадры,
+//  превью и миниатюры. Повторяет pixelSizeMode, мягкий круглый край,
+//  освещение по состояниям, sRGB-фреймбуфер и альфа-смешивание пайплайна.
+//
+//  Кадр строится в три стадии, каждая параллелится по своему диапазону:
+//  1. pointSpriteRasterBinC      — вершинная стадия + подсчет тайлов (по воркерам)
+//  2. pointSpriteRasterScatterC  — раскладка спрайтов по тайлам (по воркерам)
+//  3. pointSpriteRasterTilesC    — растеризация и смешивание тайлов (по тайлам)
+//  Между 1 и 2 один раз вызывается pointSpriteRasterPrepareScatterC.
+//  Порядок спрайтов внутри тайла совпадает с порядком частиц — как у GPU.
+//
+
+#ifndef PointSpriteRasterC_h
+#define PointSpriteRasterC_h
+
+#include <stdint.h>
+
+#include "../Particles/SimulationStepC.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POINT_SPRITE_TILE_SIZE_C 32
+
+typedef struct PointSpriteRasterC PointSpriteRasterC;
+
+/// width/height — размер выходного кадра в пикселях; если он отличается от
+/// params->screenSize, позиции и размеры спрайтов масштабируются (миниатюры)
+/// workerCount — количество диапазонов частиц для стадий 1–2
+PointSpriteRasterC* pointSpriteRasterCreateC(int width, int height, int workerCount);
+
+void pointSpriteRasterDestroyC(PointSpriteRasterC* raster);
+
+/// Уровень качества освещения LIGHTING_QUALITY_*_C (RadialProfileC.h),
+/// как specializedQuality у fragmentParticle. По умолчанию HIGH.
+/// Действует со следующего pointSpriteRasterBeginC
+void pointSpriteRasterSetQualityC(PointSpriteRasterC* raster, int quality);
+
+int pointSpriteRasterWorkerCountC(const PointSpriteRasterC* raster);
+int pointSpriteRasterTileCountC(const PointSpriteRasterC* raster);
+
+/// Начало кадра. Буферы читаются до конца стадии 1 и не копируются
+/// particleCount — количество вершин в drawPrimitives
+/// Возвращает 0 при нехватке памяти
+int pointSpriteRasterBeginC(PointSpriteRasterC* raster,
+                            const ParticleC* particles,
+                            const ParticleSeedsC* seeds,
+                            uint32_t particleCount,
+                            const SimulationParamsC* params);
+
+/// Стадия 1 для воркера worker ∈ [0, workerCount)
+void pointSpriteRasterBinC(PointSpriteRasterC* raster, int worker);
+
+/// Префиксная сумма по воркерам и тайлам; возвращает 0 при нехватке памяти
+int pointSpriteRasterPrepareScatterC(PointSpriteRasterC* raster);
+
+/// Стадия 2 для воркера worker ∈ [0, workerCount)
+void pointSpriteRasterScatterC(PointSpriteRasterC* raster, int worker);
+
+/// Стадия 3 для тайлов [firstTile, firstTile + tileCount)
+void pointSpriteRasterTilesC(PointSpriteRasterC* raster, int firstTile, int tileCount);
+
+/// Итоговый кадр: RGBA8, sRGB, строки сверху вниз, альфа 255
+const uint8_t* pointSpriteRasterPixelsC(const PointSpriteRasterC* raster);
+
+/// Сколько пар спрайт–тайл было растеризовано в последнем кадре
+uint64_t pointSpriteRasterBinnedCountC(const PointSpriteRasterC* raster);
+
+// MARK: - Image output
+
+/// PPM (P6, RGB) из RGBA8; возвращает 0 при ошибке записи
+int pointSpriteWritePPMC(const char* path, const uint8_t* rgba, int width, int height);
+
+/// QOI (RGB) из RGBA8; возвращает 0 при ошибке записи
+int pointSpriteWriteQOIC(const char* path, const uint8_t* rgba, int width, int height);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PointSpriteRasterC_h */
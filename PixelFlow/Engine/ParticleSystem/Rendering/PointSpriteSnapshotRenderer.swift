@@ -0,0 +1,110 @@
+//
+//  PointSpriteSnapshotRenderer.swift
+//  PixelFlow
+//
+//  Кадр без GPU через CPU-растеризатор (PointSpriteRasterC.h):
+//  миниатюры, golden-кадры, превью. Стадии растеризатора раскладываются
+//  по ядрам через DispatchQueue.concurrentPerform.
+//
+
+import Foundation
+import CoreGraphics
+
+final class PointSpriteSnapshotRenderer {
+
+    // MARK: - Constants
+
+    private enum Constants {
+        /// Тайлов на одну итерацию concurrentPerform
+        static let tilesPerIteration = 8
+    }
+
+    // MARK: - Properties
+
+    let width: Int
+    let height: Int
+    private let raster: OpaquePointer
+    private let workerCount: Int
+
+    // MARK: - Initialization
+
+    /// width/height — размер кадра; при отличии от screenSize кадр масштабируется
+    init?(width: Int, height: Int, workerCount: Int = ProcessInfo.processInfo.activeProcessorCount) {
+        let workers = max(1, workerCount)
+        guard let raster = pointSpriteRasterCreateC(Int32(width), Int32(height), Int32(workers)) else {
+            return nil
+        }
+        self.width = width
+        self.height = height
+        self.raster = raster
+        self.workerCount = workers
+    }
+
+    deinit {
+        pointSpriteRasterDestroyC(raster)
+    }
+
+    // MARK: - Rendering
+
+    /// particles / seeds / params — содержимое particleBuffer, particleSeedsBuffer и paramsBuffer
+    func render(particles: UnsafeRawPointer,
+                seeds: UnsafeRawPointer,
+                particleCount: Int,
+                params: UnsafeRawPointer) -> CGImage? {
+        guard particleCount >= 0,
+              MemoryLayout<Particle>.stride == MemoryLayout<ParticleC>.stride,
+              MemoryLayout<SimulationParams>.stride == MemoryLayout<SimulationParamsC>.stride else {
+            return nil
+        }
+
+        guard pointSpriteRasterBeginC(
+            raster,
+            particles.assumingMemoryBound(to: ParticleC.self),
+            seeds.assumingMemoryBound(to: ParticleSeedsC.self),
+            UInt32(particleCount),
+            params.assumingMemoryBound(to: SimulationParamsC.self)
+        ) != 0 else { return nil }
+
+        let raster = self.raster
+        DispatchQueue.concurrentPerform(iterations: workerCount) { worker in
+            pointSpriteRasterBinC(raster, Int32(worker))
+        }
+        guard pointSpriteRasterPrepareScatterC(raster) != 0 else { return nil }
+        DispatchQueue.concurrentPerform(iterations: workerCount) { worker in
+            pointSpriteRasterScatterC(raster, Int32(worker))
+        }
+
+        let tileCount = Int(pointSpriteRasterTileCountC(raster))
+        let batchSize = Constants.tilesPerIteration
+        DispatchQueue.concurrentPerform(iterations: (tileCount + batchSize - 1) / batchSize) { batch in
+            pointSpriteRasterTilesC(raster, Int32(batch * batchSize), Int32(batchSize))
+        }
+
+        return makeImage()
+    }
+
+    // MARK: - Private Methods
+
+    private func makeImage() -> CGImage? {
+        guard let pixels = pointSpriteRasterPixelsC(raster) else { return nil }
+        let bytesPerRow = width * 4
+        let data = Data(bytes: pixels, count: bytesPerRow * height)
+
+        guard let provider = CGDataProvider(data: data as CFData),
+              let colorSpace = CGColorSpace(name: CGColorSpace.sRGB) else { return nil }
+
+        return CGImage(
+            width: width,
+            height: height,
+            bitsPerComponent: 8,
+            bitsPerPixel: 32,
+            bytesPerRow: bytesPerRow,
+            space: colorSpace,
+            bitmapInfo: CGBitmapInfo(rawValue: CGImageAlphaInfo.noneSkipLast.rawValue),
+            provider: provider,
+            decode: nil,
+            shouldInterpolate: false,
+            intent: .defaultIntent
+        )
+    }
+}
@@ -0,0 +1,115 @@
+//
+//  RadialProfileC.c
+//  PixelFlow
+//
+//  Формулы повторяют fragmentParticle (Basic.h, все уровни качества)
+//  и Lighting.h — держать синхронно!
+//
+
+#include "RadialProfileC.h"
+
+#include <math.h>
+
+// Lighting.h
+#define PROFILE_GLOW_BASE_INTENSITY   0.4f
+#define PROFILE_GLOW_MAX_INTENSITY    1.0f
+#define PROFILE_BLOOM_INTENSITY       0.5f
+#define PROFILE_BLOOM_RADIUS          1.5f
+#define PROFILE_AMBIENT_MIN           0.1f
+#define PROFILE_AMBIENT_MAX           0.3f
+
+// Basic.h
+#define PROFILE_STORM_CORE_SOFTNESS   0.7f
+#define PROFILE_STORM_GLOW_BOOST      0.28f
+
+static inline float clamp01(float x) {
+    return fminf(fmaxf(x, 0.0f), 1.0f);
+}
+
+/// pow(max(1 - dist, 0), power): за краем круга основание отрицательное
+static inline float falloff(float dist, float power) {
+    return powf(fmaxf(1.0f - dist, 0.0f), power);
+}
+
+/// calculateGlow из Lighting.h
+static inline float glowC(float dist, float power, float intensity) {
+    return falloff(dist, power) * fminf(fmaxf(intensity, 0.0f), PROFILE_GLOW_MAX_INTENSITY);
+}
+
+/// calculateAmbientOcclusion2D из Lighting.h
+static inline float ambientOcclusionC(float particleDensity) {
+    float ao = 1.0f - clamp01(particleDensity * 0.1f);
+    return PROFILE_AMBIENT_MIN + (PROFILE_AMBIENT_MAX - PROFILE_AMBIENT_MIN) * ao;
+}
+
+RadialProfileSampleC radialProfileEvaluateC(uint32_t state, int quality, float dist) {
+    RadialProfileSampleC s = { 1.0f, 0.0f, 0.0f, 0.0f };
+    float inv = 1.0f - clamp01(dist);
+
+    if (quality == LIGHTING_QUALITY_LOW_C) {
+        if (state == SIMULATION_STATE_LIGHTNING_STORM_C) {
+            s.glow = falloff(dist, 3.0f) * PROFILE_STORM_CORE_SOFTNESS;
+        } else {
+            s.glow = falloff(dist, 2.5f) * PROFILE_GLOW_BASE_INTENSITY;
+        }
+        return s;
+    }
+
+    switch (state) {
+        case SIMULATION_STATE_LIGHTNING_STORM_C:
+            s.glow = falloff(dist, 3.2f) * PROFILE_STORM_GLOW_BOOST * PROFILE_STORM_CORE_SOFTNESS;
+            break;
+
+        case SIMULATION_STATE_CHAOTIC_C:
+        case SIMULATION_STATE_COLLECTED_C:
+            s.glow = falloff(dist, 2.5f) * 0.2f;
+            break;
+
+        case SIMULATION_STATE_COLLECTING_C:
+            s.occlusion = ambientOcclusionC(0.85f + inv * 1.2f);
+            s.glow = glowC(dist, 2.0f, PROFILE_GLOW_BASE_INTENSITY * 0.7f) * 0.22f;
+            s.bloom = glowC(dist, 2.0f, PROFILE_BLOOM_INTENSITY) * PROFILE_BLOOM_RADIUS;
+            s.rim = falloff(dist, 2.0f) * 0.25f;
+            break;
+
+        case SIMULATION_STATE_IDLE_C:
+        default:
+            // swarm освещается веткой default в applyStateLighting
+            s.occlusion = ambientOcclusionC(0.55f + inv * 0.4f);
+            s.glow = glowC(dist, 2.0f, PROFILE_GLOW_BASE_INTENSITY * 0.5f) * 0.2f;
+            s.bloom = glowC(dist, 2.0f, PROFILE_BLOOM_INTENSITY) * PROFILE_BLOOM_RADIUS;
+            break;
+    }
+    return s;
+}
+
+void bakeRadialProfileC(RadialProfileSampleC* out, uint32_t state, int quality) {
+    if (!out) return;
+    for (int i = 0; i < RADIAL_PROFILE_SIZE_C; i++) {
+        float dist = (float)i / (float)(RADIAL_PROFILE_SIZE_C - 1);
+        out[i] = radialProfileEvaluateC(state, quality, dist);
+    }
+}
+
+void bakeRadialProfilesC(RadialProfileSampleC* out, int quality) {
+    if (!out) return;
+    for (uint32_t state = 0; state < SIMULATION_STATE_COUNT_C; state++) {
+        bakeRadialProfileC(out + state * RADIAL_PROFILE_SIZE_C, state, quality);
+    }
+}
+
+float radialProfileMaxErrorC(const RadialProfileSampleC* table, uint32_t state, int quality, int probeCount) {
+    if (!table || probeCount < 2) return 0.0f;
+
+    float maxError = 0.0f;
+    for (int i = 0; i < probeCount; i++) {
+        float dist = 1.41421356f * (float)i / (float)(probeCount - 1);
+        RadialProfileSampleC exact = radialProfileEvaluateC(state, quality, dist);
+        RadialProfileSampleC lut = sampleRadialProfileC(table, dist);
+        maxError = fmaxf(maxError, fabsf(exact.occlusion - lut.occlusion));
+        maxError = fmaxf(maxError, fabsf(exact.glow - lut.glow));
+        maxError = fmaxf(maxError, fabsf(exact.bloom - lut.bloom));
+        maxError = fmaxf(maxError, fabsf(exact.rim - lut.rim));
+    }
+    return maxError;
+}
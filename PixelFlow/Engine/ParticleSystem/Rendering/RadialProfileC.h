@@ -0,0 +1,82 @@
+//
+//  RadialProfileC.h
+//  PixelFlow
+//
+//  Радиальные профили освещения частицы. Свечение, ambient occlusion, bloom
+//  и rim во фрагментных шейдерах (Basic.h, Lighting.h) — чистые функции
+//  расстояния от центра спрайта и констант состояния, поэтому они
+//  запекаются на CPU в таблицу и читаются по dist вместо pow на фрагмент.
+//
+//  Таблица — RADIAL_PROFILE_SIZE_C записей на dist ∈ [0, 1] с линейной
+//  интерполяцией; за краем круга (dist > 1) все профили постоянны.
+//
+
+#ifndef RadialProfileC_h
+#define RadialProfileC_h
+
+#include <stdint.h>
+
+#include "../Particles/SimulationStepC.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Держать синхронно с RADIAL_PROFILE_SIZE в Shaders/Effects/Lighting.h!
+#define RADIAL_PROFILE_SIZE_C 128
+
+// Уровни качества освещения — LIGHTING_QUALITY_* в Basic.h, держать синхронно!
+// LOW — упрощенный путь со своими профилями; MEDIUM и HIGH читают одни
+// таблицы (MEDIUM просто не использует канал bloom)
+#define LIGHTING_QUALITY_LOW_C     0
+#define LIGHTING_QUALITY_MEDIUM_C  1
+#define LIGHTING_QUALITY_HIGH_C    2
+#define LIGHTING_QUALITY_COUNT_C   3
+
+/// Одна запись профиля (float4 на GPU)
+typedef struct {
+    float occlusion;   // множитель цвета (ambient occlusion)
+    float glow;        // аддитивное свечение (в буре — ядро stormCore)
+    float bloom;       // bloomGlow * BLOOM_RADIUS, масштабируется яркостью
+    float rim;         // аддитивный rim, окрашивается в шейдере
+} RadialProfileSampleC;
+
+/// Аналитическое значение профиля — эталон для таблицы
+RadialProfileSampleC radialProfileEvaluateC(uint32_t state, int quality, float dist);
+
+/// Запекает RADIAL_PROFILE_SIZE_C записей профиля состояния state в out
+void bakeRadialProfileC(RadialProfileSampleC* out, uint32_t state, int quality);
+
+/// Запекает таблицы всех состояний подряд:
+/// out[state * RADIAL_PROFILE_SIZE_C + i], SIMULATION_STATE_COUNT_C таблиц
+void bakeRadialProfilesC(RadialProfileSampleC* out, int quality);
+
+/// Значение таблицы в точке dist (как sampleRadialProfile в Lighting.h).
+/// Inline — вызывается растеризатором на каждый фрагмент
+static inline RadialProfileSampleC sampleRadialProfileC(const RadialProfileSampleC* table, float dist) {
+    float x = dist < 0.0f ? 0.0f : (dist > 1.0f ? 1.0f : dist);
+    x *= (float)(RADIAL_PROFILE_SIZE_C - 1);
+    int i = (int)x;
+    if (i > RADIAL_PROFILE_SIZE_C - 2) i = RADIAL_PROFILE_SIZE_C - 2;
+    float t = x - (float)i;
+
+    const RadialProfileSampleC* a = &table[i];
+    const RadialProfileSampleC* b = &table[i + 1];
+    RadialProfileSampleC s = {
+        a->occlusion + (b->occlusion - a->occlusion) * t,
+        a->glow + (b->glow - a->glow) * t,
+        a->bloom + (b->bloom - a->bloom) * t,
+        a->rim + (b->rim - a->rim) * t
+    };
+    return s;
+}
+
+/// Максимальная абсолютная ошибка таблицы относительно аналитики
+/// по probeCount равномерным точкам dist ∈ [0, √2] (все каналы)
+float radialProfileMaxErrorC(const RadialProfileSampleC* table, uint32_t state, int quality, int probeCount);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RadialProfileC_h */
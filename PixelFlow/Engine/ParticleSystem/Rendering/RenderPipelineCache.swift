@@ -0,0 +1,143 @@
+//
+//  RenderPipelineCache.swift
+//  PixelFlow
+//
+//  Специализированные варианты fragmentParticle (Shaders/Rendering/Basic.h):
+//  состояние, качество освещения, pixel-perfect и fastMath задаются
+//  function constants при сборке pipeline, а не читаются из params.
+//  Варианты собираются лениво и живут до cleanup рендерера.
+//
+
+import Foundation
+import Metal
+
+final class RenderPipelineCache {
+
+    // MARK: - Constants
+
+    /// Индексы [[function_constant(n)]] в Basic.h (state — в Simulation.h) — держать синхронно!
+    private enum ConstantIndex {
+        static let state = 0
+        static let quality = 1
+        static let pixelPerfect = 2
+        static let fastMath = 3
+    }
+
+    private enum ShaderNames {
+        static let vertexParticle = "vertexParticle"
+        static let fragmentParticle = "fragmentParticle"
+    }
+
+    // MARK: - Key
+
+    struct Key: Hashable {
+        let state: UInt32
+        let quality: Int32
+        let pixelPerfect: Bool
+        let fastMath: Bool
+
+        /// Ключ кадра из заполненных SimulationParams
+        init(params: SimulationParams, quality: Int32) {
+            self.state = params.state
+            self.quality = quality
+            self.pixelPerfect = params.pixelSizeMode != 0
+            self.fastMath = params.fastEffectsMath != 0
+        }
+
+        init(state: UInt32, quality: Int32, pixelPerfect: Bool, fastMath: Bool) {
+            self.state = state
+            self.quality = quality
+            self.pixelPerfect = pixelPerfect
+            self.fastMath = fastMath
+        }
+    }
+
+    // MARK: - Properties
+
+    private let device: MTLDevice
+    private let library: MTLLibrary
+    private let vertexFunction: MTLFunction
+    private var pipelines: [Key: MTLRenderPipelineState] = [:]
+
+    var count: Int { pipelines.count }
+
+    // MARK: - Initialization
+
+    init(device: MTLDevice, library: MTLLibrary) throws {
+        guard let vertexFunction = library.makeFunction(name: ShaderNames.vertexParticle) else {
+            throw MetalError.functionNotFound(name: ShaderNames.vertexParticle)
+        }
+        self.device = device
+        self.library = library
+        self.vertexFunction = vertexFunction
+    }
+
+    // MARK: - Pipelines
+
+    func pipeline(for key: Key) throws -> MTLRenderPipelineState {
+        if let pipeline = pipelines[key] {
+            return pipeline
+        }
+        let pipeline = try makePipeline(for: key)
+        pipelines[key] = pipeline
+        return pipeline
+    }
+
+    /// Собирает варианты всех состояний заранее — смена состояния
+    /// не должна компилировать шейдер посреди анимации
+    func prewarm(quality: Int32, pixelPerfect: Bool, fastMath: Bool) throws {
+        for state in 0..<UInt32(SIMULATION_STATE_COUNT_C) {
+            _ = try pipeline(for: Key(
+                state: state,
+                quality: quality,
+                pixelPerfect: pixelPerfect,
+                fastMath: fastMath
+            ))
+        }
+    }
+
+    // MARK: - Private Methods
+
+    private func makePipeline(for key: Key) throws -> MTLRenderPipelineState {
+        var state = Int32(key.state)
+        var quality = key.quality
+        var pixelPerfect = key.pixelPerfect
+        var fastMath = key.fastMath
+
+        let constants = MTLFunctionConstantValues()
+        constants.setConstantValue(&state, type: .int, index: ConstantIndex.state)
+        constants.setConstantValue(&quality, type: .int, index: ConstantIndex.quality)
+        constants.setConstantValue(&pixelPerfect, type: .bool, index: ConstantIndex.pixelPerfect)
+        constants.setConstantValue(&fastMath, type: .bool, index: ConstantIndex.fastMath)
+
+        let fragmentFunction: MTLFunction
+        do {
+            fragmentFunction = try library.makeFunction(
+                name: ShaderNames.fragmentParticle,
+                constantValues: constants
+            )
+        } catch {
+            throw MetalError.functionNotFound(name: ShaderNames.fragmentParticle)
+        }
+
+        let descriptor = MTLRenderPipelineDescriptor()
+        descriptor.vertexFunction = vertexFunction
+        descriptor.fragmentFunction = fragmentFunction
+        descriptor.colorAttachments[0].pixelFormat = .bgra8Unorm_srgb
+        configureBlending(descriptor: descriptor)
+
+        return try device.makeRenderPipelineState(descriptor: descriptor)
+    }
+
+    private func configureBlending(descriptor: MTLRenderPipelineDescriptor) {
+        guard let attachment = descriptor.colorAttachments[0] else { return }
+
+        attachment.isBlendingEnabled = true
+        attachment.rgbBlendOperation = .add
+        attachment.alphaBlendOperation = .add
+        attachment.sourceRGBBlendFactor = .sourceAlpha
+        attachment.sourceAlphaBlendFactor = .sourceAlpha
+        attachment.destinationRGBBlendFactor = .oneMinusSourceAlpha
+        attachment.destinationAlphaBlendFactor = .oneMinusSourceAlpha
+    }
+}
@@ -0,0 +1,65 @@
+//
+//  AttractorField.swift
+//  PixelFlow
+//
+//  Точки притяжения/отталкивания от касаний (до ATTRACTOR_MAX_COUNT_C).
+//  Слот точки стабилен, пока касание активно — бит в маске тайлов
+//  (buildAttractorTileMasksC) совпадает с индексом в SimulationParams.attractors.
+//
+
+import Foundation
+
+struct AttractorField {
+
+    // MARK: - Constants
+
+    static let capacity = Int(ATTRACTOR_MAX_COUNT_C)
+    /// Радиус влияния касания в точках (умножается на масштаб drawable)
+    static let touchRadiusPoints: Float = 120
+    /// Первое касание притягивает, последующие — отталкивают
+    static let attractStrength: Float = 3
+    static let repelStrength: Float = -4
+
+    // MARK: - Storage
+
+    private var slots: [(id: Int, attractor: AttractorC)?] = Array(repeating: nil, count: capacity)
+
+    var isEmpty: Bool { slots.allSatisfy { $0 == nil } }
+
+    // MARK: - Mutation
+
+    /// Добавляет или перемещает точку. position — NDC, radius — пиксели drawable
+    /// Возвращает false, если свободных слотов нет
+    @discardableResult
+    mutating func set(id: Int, position: SIMD2<Float>, radius: Float, strength: Float) -> Bool {
+        let attractor = AttractorC(x: position.x, y: position.y, radius: radius, strength: strength)
+
+        if let index = slots.firstIndex(where: { $0?.id == id }) {
+            slots[index] = (id, attractor)
+            return true
+        }
+        guard let free = slots.firstIndex(where: { $0 == nil }) else { return false }
+        slots[free] = (id, attractor)
+        return true
+    }
+
+    mutating func remove(id: Int) {
+        guard let index = slots.firstIndex(where: { $0?.id == id }) else { return }
+        slots[index] = nil
+    }
+
+    mutating func removeAll() {
+        slots = Array(repeating: nil, count: Self.capacity)
+    }
+
+    // MARK: - Packing
+
+    /// Упакованный список для SimulationParams.attractors
+    /// Пустые слоты в середине сохраняются с нулевой силой — маска их пропускает
+    func packed() -> [AttractorPackedC] {
+        guard let last = slots.lastIndex(where: { $0 != nil }) else { return [] }
+        return slots[...last].map { slot in
+            packAttractorC(slot?.attractor ?? AttractorC(x: 0, y: 0, radius: 0, strength: 0))
+        }
+    }
+}
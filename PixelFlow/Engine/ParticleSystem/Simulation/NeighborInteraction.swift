@@ -0,0 +1,54 @@
+//
+//  NeighborInteraction.swift
+//  PixelFlow
+//
+//  Параметры взаимодействия соседей в режиме swarm.
+//  Размеры сетки считает C-бэкенд (neighborGridDimsC), поэтому
+//  CPU и GPU всегда используют одинаковую сетку.
+//
+
+import Foundation
+
+enum NeighborInteraction {
+
+    // MARK: - Constants
+
+    /// Радиус взаимодействия в точках (умножается на displayScale)
+    static let radiusPoints: Float = 4
+    /// Максимум ячеек по стороне сетки — ограничивает память и стоимость префиксной суммы
+    static let maxGridDim: Int32 = 256
+    static let separationStrength: Float = 0.3
+    static let cohesionStrength: Float = 0.05
+    /// Лимит соседей на частицу — стоимость кадра линейна по числу частиц при любой плотности
+    static let maxNeighbors: Int32 = 27
+
+    /// Верхняя граница числа ячеек — под нее выделяются буферы сетки
+    static var maxCellCount: Int { Int(maxGridDim) * Int(maxGridDim) }
+
+    // MARK: - Parameters
+
+    static func forceParams(screenSize: SIMD2<Float>, displayScale: Float) -> NeighborForceParamsC {
+        let minSide = max(min(screenSize.x, screenSize.y), 1)
+        let radius = radiusPoints * max(displayScale, 1) * 2 / minSide
+        return NeighborForceParamsC(
+            radius: radius,
+            separationStrength: separationStrength,
+            cohesionStrength: cohesionStrength,
+            maxNeighbors: maxNeighbors
+        )
+    }
+
+    /// Значения для SimulationParams.neighborGrid / neighborForces
+    static func shaderValues(
+        screenSize: SIMD2<Float>,
+        displayScale: Float
+    ) -> (grid: SIMD4<Float>, forces: SIMD4<Float>) {
+        let forces = forceParams(screenSize: screenSize, displayScale: displayScale)
+        let dims = neighborGridDimsC(forces.radius, maxGridDim)
+
+        return (
+            SIMD4<Float>(dims.cellSize, dims.invCellSize, Float(dims.gridDim), Float(dims.cellCount)),
+            SIMD4<Float>(forces.radius, forces.separationStrength, forces.cohesionStrength, Float(forces.maxNeighbors))
+        )
+    }
+}
@@ -0,0 +1,162 @@
+//
+//  SimulationCommandQueue.swift
+//  PixelFlow
+//
+//  Типизированные команды симуляции поверх SimulationCommandRingC.
+//  Ставить — с любого потока (UI, генерация, completion handlers GPU);
+//  разбирать — только кадру (SimulationEngine.update), без замков.
+//
+
+import Foundation
+
+// MARK: - Simulation Command
+
+enum SimulationCommand {
+    /// HQ-цели готовы: автомат переходит в chaotic, счетчик сбора сбрасывается
+    case start
+    case stop
+    case startCollecting(toImage: Bool)
+    case startLightningStorm
+    case startSwarm
+    /// position — NDC, radius — пиксели drawable
+    case setAttractor(id: Int, position: SIMD2<Float>, radius: Float, strength: Float)
+    case removeAttractor(id: Int)
+    case updateProgress(Float)
+    case setHighQualityReady(Bool)
+}
+
+// MARK: - Simulation Command Queue
+
+final class SimulationCommandQueue {
+
+    // MARK: - Constants
+
+    private enum Constants {
+        // Касания приходят чаще кадров — запас на паузу рендера в несколько кадров
+        static let capacity: UInt32 = 256
+    }
+
+    // MARK: - Properties
+
+    private let ring: OpaquePointer
+    /// Буфер разбора — без аллокаций в кадре; трогает только потребитель
+    private let scratch: UnsafeMutablePointer<SimulationCommandC>
+    private let scratchCount: Int
+
+    /// Команды, отброшенные из-за переполнения
+    var droppedCount: UInt64 {
+        simulationCommandRingDroppedC(ring)
+    }
+
+    // MARK: - Initialization
+
+    init?() {
+        guard let ring = simulationCommandRingCreateC(Constants.capacity) else { return nil }
+        self.ring = ring
+        self.scratchCount = Int(simulationCommandRingCapacityC(ring))
+        self.scratch = .allocate(capacity: scratchCount)
+    }
+
+    deinit {
+        scratch.deallocate()
+        simulationCommandRingDestroyC(ring)
+    }
+
+    // MARK: - Producer
+
+    /// Любой поток. false — очередь полна, команда отброшена
+    @discardableResult
+    func push(_ command: SimulationCommand) -> Bool {
+        var raw = command.raw
+        raw.timestamp = DispatchTime.now().uptimeNanoseconds
+        return simulationCommandRingPushC(ring, &raw) != 0
+    }
+
+    // MARK: - Consumer
+
+    /// Только поток кадра: команды в порядке постановки и время ожидания каждой (нс).
+    /// Команды, поставленные во время разбора, уходят в следующий кадр
+    func drain(_ apply: (SimulationCommand, UInt64) -> Void) {
+        let count = Int(simulationCommandRingDrainC(ring, scratch, UInt32(scratchCount)))
+        guard count > 0 else { return }
+
+        let now = DispatchTime.now().uptimeNanoseconds
+        for index in 0..<count {
+            let raw = scratch[index]
+            guard let command = SimulationCommand(raw: raw) else { continue }
+            apply(command, now &- raw.timestamp)
+        }
+    }
+
+    /// Только поток кадра (или при остановленном кадре): выбрасывает накопленное
+    func removeAll() {
+        while simulationCommandRingDrainC(ring, scratch, UInt32(scratchCount)) > 0 {}
+    }
+}
+
+// MARK: - SimulationCommand ↔ SimulationCommandC
+
+private extension SimulationCommand {
+
+    var raw: SimulationCommandC {
+        var raw = SimulationCommandC()
+        switch self {
+        case .start:
+            raw.type = SIMULATION_COMMAND_START_C
+        case .stop:
+            raw.type = SIMULATION_COMMAND_STOP_C
+        case .startCollecting(let toImage):
+            raw.type = toImage ? SIMULATION_COMMAND_COLLECT_IMAGE_C : SIMULATION_COMMAND_COLLECT_SCATTER_C
+        case .startLightningStorm:
+            raw.type = SIMULATION_COMMAND_LIGHTNING_STORM_C
+        case .startSwarm:
+            raw.type = SIMULATION_COMMAND_SWARM_C
+        case let .setAttractor(id, position, radius, strength):
+            raw.type = SIMULATION_COMMAND_SET_ATTRACTOR_C
+            raw.id = Int32(truncatingIfNeeded: id)
+            raw.values = (position.x, position.y, radius, strength)
+        case .removeAttractor(let id):
+            raw.type = SIMULATION_COMMAND_REMOVE_ATTRACTOR_C
+            raw.id = Int32(truncatingIfNeeded: id)
+        case .updateProgress(let progress):
+            raw.type = SIMULATION_COMMAND_UPDATE_PROGRESS_C
+            raw.values.0 = progress
+        case .setHighQualityReady(let ready):
+            raw.type = SIMULATION_COMMAND_SET_HIGH_QUALITY_READY_C
+            raw.id = ready ? 1 : 0
+        }
+        return raw
+    }
+
+    init?(raw: SimulationCommandC) {
+        switch raw.type {
+        case SIMULATION_COMMAND_START_C:
+            self = .start
+        case SIMULATION_COMMAND_STOP_C:
+            self = .stop
+        case SIMULATION_COMMAND_COLLECT_SCATTER_C:
+            self = .startCollecting(toImage: false)
+        case SIMULATION_COMMAND_COLLECT_IMAGE_C:
+            self = .startCollecting(toImage: true)
+        case SIMULATION_COMMAND_LIGHTNING_STORM_C:
+            self = .startLightningStorm
+        case SIMULATION_COMMAND_SWARM_C:
+            self = .startSwarm
+        case SIMULATION_COMMAND_SET_ATTRACTOR_C:
+            self = .setAttractor(
+                id: Int(raw.id),
+                position: SIMD2<Float>(raw.values.0, raw.values.1),
+                radius: raw.values.2,
+                strength: raw.values.3
+            )
+        case SIMULATION_COMMAND_REMOVE_ATTRACTOR_C:
+            self = .removeAttractor(id: Int(raw.id))
+        case SIMULATION_COMMAND_UPDATE_PROGRESS_C:
+            self = .updateProgress(raw.values.0)
+        case SIMULATION_COMMAND_SET_HIGH_QUALITY_READY_C:
+            self = .setHighQualityReady(raw.id != 0)
+        default:
+            return nil
+        }
+    }
+}
@@ -11,6 +11,12 @@ import QuartzCore
 
 final class SimulationEngine {
     
+    // MARK: - Constants
+    private enum Constants {
+        // Команда, ждавшая дольше, — признак остановленного кадра
+        static let staleCommandNanoseconds: UInt64 = 250_000_000
+    }
+    
     // MARK: - Properties
     private let stateMachine: SimulationStateMachine
     internal let clock: SimulationClockProtocol
@@ -20,8 +26,19 @@ final class SimulationEngine {
     var state: SimulationState { stateMachine.state }
     var resetCounterCallback: (() -> Void)?
     var customForces: ((Float) -> Void)?
+    /// Точки касаний — MetalRenderer упаковывает их в SimulationParams каждый кадр
+    private(set) var attractorField = AttractorField()
+    /// Команды от UI, генерации и GPU; применяются в начале кадра (update)
+    let commands: SimulationCommandQueue
+    /// Подготовка сбора (цели + загрузка в кольцо) вне кадра. Команды, меняющие
+    /// состояние, идут через эту же последовательную очередь, чтобы сохранить порядок
+    private let preparationQueue = DispatchQueue(label: "com.particleflow.simulation.preparation",
+                                                 qos: .userInitiated)
     
     private var hqParticlesReady = false
+    /// Копия hqParticlesReady для подготовки сбора; только внутри preparationQueue.
+    /// Обновляется до постановки команды, поэтому подготовка видит то же, что применит кадр
+    private var isPreparationHighQualityReady = false
     
     // MARK: - Initialization
     init(stateManager: SimulationStateMachine,
@@ -33,6 +50,10 @@ final class SimulationEngine {
         self.clock = clock
         self.logger = logger
         self.particleStorage = particleStorage
+        guard let commands = SimulationCommandQueue() else {
+            fatalError("Failed to allocate simulation command queue")
+        }
+        self.commands = commands
         
         logger.info("SimulationEngine initialized")
     }
@@ -53,12 +74,18 @@ final class SimulationEngine {
                 return
             }
             // Progress now comes from GPU collectedCounterBuffer to avoid CPU lerp desync.
+            // Прогресс приходит ступенями, поэтому таймаут проверяем каждый кадр.
+            stateMachine.checkCollectionTimeout()
             
         case .collected:
             stateMachine.tickCollected()
             
         case .lightningStorm:
             particleStorage.updateFastPreview(deltaTime: deltaTime)
+
+        case .swarm:
+            // Силы соседей считаются на GPU (сетка строится в MetalRenderer)
+            particleStorage.updateFastPreview(deltaTime: deltaTime)
         }
     }
     
@@ -66,6 +93,90 @@ final class SimulationEngine {
     internal func applyForces() {
         customForces?(clock.deltaTime)
     }
+    
+    /// Разбирает очередь команд — единственное место, где кадр меняет состояние
+    @MainActor private func applyPendingCommands() {
+        commands.drain { command, waitNanoseconds in
+            if waitNanoseconds > Constants.staleCommandNanoseconds {
+                logger.debug("Command \(command) waited \(waitNanoseconds / 1_000_000) ms")
+            }
+            apply(command)
+        }
+    }
+    
+    private func apply(_ command: SimulationCommand) {
+        switch command {
+        case .start:
+            hqParticlesReady = true
+            stateMachine.start()
+            resetCounterCallback?()
+            logger.info("Simulation started with HQ particles ready")
+            
+        case .stop:
+            stateMachine.stop()
+            
+        case .startCollecting(let toImage):
+            // Цели уже в кольце (prepareCollecting) — кадр только переключает автомат
+            guard hqParticlesReady else { return }
+            stateMachine.startCollecting(mode: toImage ? .toImage : .toScatter)
+            resetCounterCallback?()
+            
+        case .startLightningStorm:
+            stateMachine.startLightningStorm()
+            
+        case .startSwarm:
+            guard hqParticlesReady else { return }
+            stateMachine.startSwarm()
+            
+        case let .setAttractor(id, position, radius, strength):
+            attractorField.set(id: id, position: position, radius: radius, strength: strength)
+            
+        case .removeAttractor(let id):
+            attractorField.remove(id: id)
+            
+        case .updateProgress(let progress):
+            guard case .collecting = stateMachine.state else { return }
+            // StateMachine сам обработает условия завершения
+            stateMachine.updateProgress(progress)
+            
+        case .setHighQualityReady(let ready):
+            hqParticlesReady = ready
+        }
+    }
+    
+    private func enqueue(_ command: SimulationCommand) {
+        guard commands.push(command) else {
+            logger.warning("Simulation command queue full — dropped \(command)")
+            return
+        }
+    }
+    
+    /// Команда, меняющая состояние: ставится после уже начатой подготовки сбора
+    private func enqueueOrdered(_ command: SimulationCommand) {
+        preparationQueue.async { [weak self] in
+            self?.enqueue(command)
+        }
+    }
+    
+    /// Генерирует цели и загружает их в кольцо вне кадра (O(N) и ожидание
+    /// свободного слота), затем ставит команду, которая только переключает автомат
+    private func prepareCollecting(toImage: Bool) {
+        preparationQueue.async { [weak self] in
+            guard let self = self else { return }
+            // Без HQ-частиц кадр все равно отбросит команду — не трогаем кольцо
+            guard self.isPreparationHighQualityReady else {
+                self.logger.debug("Collecting skipped — HQ particles not ready")
+                return
+            }
+            if toImage {
+                self.particleStorage.applyHighQualityTargetsToBuffer()
+            } else {
+                self.particleStorage.createScatteredTargets()
+                self.particleStorage.applyScatteredTargetsToBuffer()
+            }
+            self.enqueue(.startCollecting(toImage: toImage))
+        }
+    }
 }
 
 // MARK: - SimulationEngineProtocol
@@ -82,61 +193,66 @@ extension SimulationEngine: SimulationEngineProtocol {
         // Создаем fast preview частицы с начальными скоростями
         particleStorage.createFastPreviewParticles()
         
-        // Генерируем HQ частицы асинхронно
+        // Генерируем HQ частицы асинхронно; старт применит кадр
         particleStorage.generateHighQualityParticles { [weak self] in
-            guard let self = self else { return }
-            self.hqParticlesReady = true
-            self.stateMachine.start()
-            self.resetCounterCallback?()
-            self.logger.info("Simulation started with HQ particles ready")
+            self?.preparationQueue.async {
+                guard let self = self else { return }
+                self.isPreparationHighQualityReady = true
+                self.enqueue(.start)
+            }
         }
     }
     
+    // Команды ниже ставятся в очередь и применяются в начале следующего кадра:
+    // вызывающий поток не ждет кадр, кадр не ждет вызывающий поток.
+    // Смена состояния проходит через preparationQueue после подготовки сбора
+    
     /// Останавливает симуляцию
     func stop() {
         logger.info("Stopping simulation")
-        stateMachine.stop()
+        enqueueOrdered(.stop)
     }
     
     /// Запускает режим сбора частиц
     func startCollecting() {
         logger.info("Starting particle scattering (breaking apart)")
-        guard hqParticlesReady else {
-            return
-        }
-        
-        particleStorage.createScatteredTargets()
-        particleStorage.applyScatteredTargetsToBuffer()
-        stateMachine.startCollecting(mode: .toScatter)
-        resetCounterCallback?()
+        prepareCollecting(toImage: false)
     }
 
     /// Запускает сбор частиц к подготовленным целям изображения
     func startCollectingToImage() {
         logger.info("Starting particle collection to image")
-        guard hqParticlesReady else {
-            return
-        }
-        particleStorage.applyHighQualityTargetsToBuffer()
-        stateMachine.startCollecting(mode: .toImage)
-        resetCounterCallback?()
+        prepareCollecting(toImage: true)
     }
     
     /// Запускает режим молний
     func startLightningStorm() {
         logger.info("Starting lightning storm")
-        stateMachine.startLightningStorm()
+        enqueueOrdered(.startLightningStorm)
+    }
+
+    /// Запускает режим роя (взаимодействие соседей)
+    func startSwarm() {
+        logger.info("Starting swarm")
+        enqueueOrdered(.startSwarm)
+    }
+
+    /// Добавляет или перемещает точку касания (position — NDC, radius — пиксели)
+    func setAttractor(id: Int, position: SIMD2<Float>, radius: Float, strength: Float) {
+        enqueue(.setAttractor(id: id, position: position, radius: radius, strength: strength))
+    }
+
+    func removeAttractor(id: Int) {
+        enqueue(.removeAttractor(id: id))
     }
     
     func updateProgress(_ progress: Float) {
-        guard case .collecting = stateMachine.state else { return }
-        
-        // StateMachine сам обработает условия завершения
-        stateMachine.updateProgress(progress)
+        enqueue(.updateProgress(progress))
     }
     
     /// Обновляет состояние симуляции на основе прошедшего времени
     @MainActor func update(deltaTime: Float) {
+        applyPendingCommands()
         let clampedDeltaTime = min(deltaTime, 0.1)
         clock.update(with: clampedDeltaTime)
         applyForces()
@@ -150,14 +266,25 @@ extension SimulationEngine: SimulationEngineProtocol {
     
     func reset() {
         logger.info("Resetting simulation engine")
+        // Кадр остановлен (cleanup) — накопленные команды относятся к старой сессии.
+        // Сначала дожидаемся начатой подготовки, иначе ее команда придет после очистки
+        preparationQueue.sync {
+            isPreparationHighQualityReady = false
+        }
+        commands.removeAll()
         clock.reset()
         stateMachine.stop()
         particleStorage.clear()
+        attractorField.removeAll()
         hqParticlesReady = false
     }
 
     func setHighQualityReady(_ ready: Bool) {
-        hqParticlesReady = ready
+        preparationQueue.async { [weak self] in
+            guard let self = self else { return }
+            self.isPreparationHighQualityReady = ready
+            self.enqueue(.setHighQualityReady(ready))
+        }
     }
     
     // MARK: - Public Methods
@@ -22,6 +22,7 @@ final class SimulationParamsUpdater {
         displayScale: Float = 1.0,
         collectionSpeed: Float = 8.0,
         brightnessBoost: Float = 2.0,
+        attractors: [AttractorPackedC] = [],
         threadsPerThreadgroup: UInt32 = 256
     ) {
         guard buffer.length >= MemoryLayout<SimulationParams>.stride else {
@@ -61,6 +62,8 @@ final class SimulationParamsUpdater {
         // Фиксируем pixelSizeMode=2 для всех режимов, чтобы исключить субпиксельные отличия
         params.pixelSizeMode = 2
         params.colorsLocked = 0       // 0 = шейдеры могут изменять цвета, 1 = заблокировано на оригинальные
+        params.fastEffectsMath = config.qualityPreset.usesFastEffectsMath ? 1 : 0
+        params.colorsLinear = 1       // Сборка и ParticleStorage пишут цвета в linear (ColorSpaceC.h)
 
         // ПОДДЕРЖКА ХАОТИЧНОГО ДВИЖЕНИЯ В IDLE
         if case .idle = state, enableIdleChaotic {
@@ -69,6 +72,25 @@ final class SimulationParamsUpdater {
             params.idleChaoticMotion = 0 // Disabled
         }
 
+        // СЕТКА СОСЕДЕЙ ДЛЯ РЕЖИМА SWARM (шейдеры читают ее только в этом состоянии)
+        let neighbor = NeighborInteraction.shaderValues(
+            screenSize: params.screenSize,
+            displayScale: displayScale
+        )
+        params.neighborGrid = neighbor.grid
+        params.neighborForces = neighbor.forces
+
+        // ТОЧКИ КАСАНИЙ (маску тайлов строит MetalRenderer из того же списка)
+        let attractorCount = min(attractors.count, AttractorField.capacity)
+        withUnsafeMutableBytes(of: &params.attractors) { raw in
+            let slots = raw.bindMemory(to: SIMD4<UInt16>.self)
+            for index in 0..<attractorCount {
+                let attractor = attractors[index]
+                slots[index] = SIMD4(attractor.x, attractor.y, attractor.radius, attractor.strength)
+            }
+        }
+        params.attractorCount = UInt32(attractorCount)
+
         // РАЗМЕР THREADGROUP ДЛЯ COMPUTE SHADER
         params.threadsPerThreadgroup = threadsPerThreadgroup
 
@@ -16,6 +16,7 @@ enum SimulationState: Equatable {
     case collecting(progress: Float)
     case collected(frames: Int)
     case lightningStorm
+    case swarm
 }
 
 final class SimulationStateMachine {
@@ -74,29 +75,13 @@ final class SimulationStateMachine {
         let currentTime = ProcessInfo.processInfo.systemUptime
 
         // Проверяем условия завершения сбора
-        var shouldComplete = false
-        var reason = ""
-
         // 1. Полная готовность (100%)
         if clampedProgress >= 1.0 {
-            shouldComplete = true
-            reason = "progress >= 100%"
+            completeCollection(reason: "progress >= 100%")
         }
         // 2. Общий таймаут (30 секунд)
         else if currentTime - collectionStartTime > maxCollectionTime {
-            shouldComplete = true
-            reason = "timeout (\(String(format: "%.1f", maxCollectionTime))s)"
-        }
-
-        if shouldComplete {
-            lastProgress = 1.0
-            Logger.shared.info("[StateMachine] Collection complete → .collected(0) [\(reason)]")
-            switch collectMode {
-            case .toImage:
-                state = .collected(frames: 0)
-            case .toScatter:
-                state = .chaotic
-            }
+            completeCollection(reason: "timeout (\(String(format: "%.1f", maxCollectionTime))s)")
         } else {
             // Обновляем время последнего прогресса только если он действительно изменился
             let epsilon: Float = 1e-6
@@ -107,6 +92,28 @@ final class SimulationStateMachine {
             state = .collecting(progress: clampedProgress)
         }
     }
+
+    /// Проверка общего таймаута сбора. Прогресс с GPU приходит только
+    /// при пересечении ступеней, поэтому таймаут проверяется каждый кадр отдельно.
+    func checkCollectionTimeout() {
+        guard case .collecting = state else { return }
+
+        let currentTime = ProcessInfo.processInfo.systemUptime
+        if currentTime - collectionStartTime > maxCollectionTime {
+            completeCollection(reason: "timeout (\(String(format: "%.1f", maxCollectionTime))s)")
+        }
+    }
+
+    private func completeCollection(reason: String) {
+        lastProgress = 1.0
+        Logger.shared.info("[StateMachine] Collection complete → .collected(0) [\(reason)]")
+        switch collectMode {
+        case .toImage:
+            state = .collected(frames: 0)
+        case .toScatter:
+            state = .chaotic
+        }
+    }
     
     func tickCollected() {
         guard case .collected(let frames) = state else { return }
@@ -123,4 +130,9 @@ final class SimulationStateMachine {
         Logger.shared.info("[StateMachine] startLightningStorm() → .lightningStorm")
         state = .lightningStorm
     }
+
+    func startSwarm() {
+        Logger.shared.info("[StateMachine] startSwarm() → .swarm")
+        state = .swarm
+    }
 }
@@ -0,0 +1,65 @@
+//
+//  SimulationTraceRecorder.swift
+//  PixelFlow
+//
+//  Запись трассы сессии (SimulationTraceC.h): снимок буфера частиц,
+//  затем SimulationParams каждого кадра и смены состояния.
+//  Воспроизводится на Linux через Tools/TraceReplay.
+//
+
+import Foundation
+
+final class SimulationTraceRecorder {
+
+    // MARK: - Properties
+
+    let url: URL
+    private var writer: OpaquePointer?
+    private var lastState: UInt32 = SimulationState.idle.shaderValue
+
+    var frameCount: UInt32 { simulationTraceFrameCountC(writer) }
+    var bytesWritten: UInt64 { simulationTraceBytesWrittenC(writer) }
+
+    // MARK: - Initialization
+
+    /// particles — содержимое particleBuffer (Particle stride 96 байт)
+    init?(url: URL, particles: UnsafeRawPointer, particleCount: Int) {
+        guard particleCount >= 0,
+              MemoryLayout<Particle>.stride == Int(SIMULATION_TRACE_PARTICLE_SIZE),
+              MemoryLayout<SimulationParams>.stride == Int(SIMULATION_TRACE_PARAMS_SIZE),
+              let writer = url.withUnsafeFileSystemRepresentation({ path -> OpaquePointer? in
+                  guard let path else { return nil }
+                  return simulationTraceOpenWriterC(path, particles, UInt32(particleCount))
+              }) else {
+            return nil
+        }
+        self.url = url
+        self.writer = writer
+    }
+
+    deinit {
+        finish()
+    }
+
+    // MARK: - Recording
+
+    /// params — содержимое paramsBuffer после SimulationParamsUpdater.fill
+    func recordFrame(params: UnsafeRawPointer, state: UInt32, frameSeconds: Float) {
+        guard let writer else { return }
+
+        if state != lastState {
+            simulationTraceWriteStateC(writer, lastState, state)
+            lastState = state
+        }
+        if simulationTraceWriteFrameC(writer, params, frameSeconds) == 0 {
+            // Диск заполнен или файл недоступен — дальше не пишем
+            finish()
+        }
+    }
+
+    func finish() {
+        guard let writer else { return }
+        simulationTraceCloseWriterC(writer)
+        self.writer = nil
+    }
+}
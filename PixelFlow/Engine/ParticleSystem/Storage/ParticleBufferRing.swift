@@ -0,0 +1,346 @@
+//
+//  ParticleBufferRing.swift
+//  PixelFlow
+//
+//  Кольцо буферов частиц: GPU работает in-place в актуальном слоте,
+//  CPU пишет в свободный и публикует его для следующего кадра.
+//  Учет слотов и заборов кадров — BufferRingC.h, здесь — память и ожидание.
+//  Для каждого слота хранится, чем он отличается от latest (DirtyRangeC.h):
+//  запись копирует из latest только эти отрезки, а не весь буфер.
+//
+
+import Foundation
+import Metal
+
+final class ParticleBufferRing {
+
+    // MARK: - Constants
+
+    private enum Constants {
+        static let slotCount: Int32 = 3
+        // Предел ожидания GPU: дольше — кадр потерян, запись пропускаем
+        static let gpuWaitTimeout: TimeInterval = 1.0
+        static let dirtyGranularity = UInt64(DIRTY_RANGE_CACHE_LINE_C)
+    }
+
+    /// Кадров в полете, при которых CPU всегда находит свободный слот:
+    /// каждый кадр занимает не больше одного слота, плюс latest
+    static let maxFramesInFlight = Int(Constants.slotCount) - 1
+
+    // MARK: - Properties
+
+    private let device: MTLDevice
+    private let logger: LoggerProtocol
+
+    // Доступ к ring/buffers/particleCount — только под condition
+    private let condition = NSCondition()
+    private var ring = BufferRingC()
+    private var buffers: [MTLBuffer] = []
+    private var particleCount: Int = 0
+    /// Отрезки, в которых слот расходится с latest; у latest — пусто
+    private var stale: [DirtyRangeSetC] = []
+    /// Растет при каждом размещении и освобождении слотов: захват прошлого
+    /// поколения не публикуется
+    private var generation: UInt64 = 0
+
+    /// Слот с актуальным содержимым — его читает/пишет следующий кадр GPU
+    var latestBuffer: MTLBuffer? {
+        condition.lock()
+        defer { condition.unlock() }
+        return buffers.isEmpty ? nil : buffers[Int(ring.latest)]
+    }
+
+    /// Кадров GPU, еще не завершенных целиком
+    var framesInFlight: Int {
+        condition.lock()
+        defer { condition.unlock() }
+        return Int(bufferRingInFlightC(&ring))
+    }
+
+    // MARK: - Initialization
+
+    init(device: MTLDevice, logger: LoggerProtocol) {
+        self.device = device
+        self.logger = logger
+        bufferRingInitC(&ring, Constants.slotCount)
+    }
+
+    // MARK: - Allocation
+
+    /// Размещает слоты под particleCount частиц и обнуляет их.
+    /// Ждет завершения кадров в полете: они еще держат старые слоты
+    @discardableResult
+    func resize(particleCount: Int) -> Bool {
+        condition.lock()
+        defer { condition.unlock() }
+
+        waitUntilIdle()
+
+        guard particleCount > 0 else {
+            releaseSlots()
+            return true
+        }
+
+        let stride = MemoryLayout<Particle>.stride
+        let (bufferSize, overflow) = stride.multipliedReportingOverflow(by: particleCount)
+        guard !overflow, bufferSize > 0 else {
+            logger.error("Particle ring size overflow for count: \(particleCount)")
+            return false
+        }
+
+        if buffers.count != Int(ring.slotCount) || buffers.contains(where: { $0.length < bufferSize }) {
+            var newBuffers: [MTLBuffer] = []
+            for _ in 0..<ring.slotCount {
+                guard let buffer = device.makeBuffer(length: bufferSize, options: .storageModeShared) else {
+                    logger.error("Failed to create particle ring slot (\(bufferSize) bytes)")
+                    return false
+                }
+                newBuffers.append(buffer)
+            }
+            buffers = newBuffers
+        }
+
+        for buffer in buffers {
+            memset(buffer.contents(), 0, bufferSize)
+        }
+        self.particleCount = particleCount
+        generation &+= 1
+
+        // Все слоты обнулены — совпадают с latest
+        var empty = DirtyRangeSetC()
+        dirtyRangeInitC(&empty, Constants.dirtyGranularity, UInt64(bufferSize))
+        stale = Array(repeating: empty, count: buffers.count)
+        return true
+    }
+
+    func clear() {
+        condition.lock()
+        defer { condition.unlock() }
+        waitUntilIdle()
+        releaseSlots()
+    }
+
+    // MARK: - CPU Writes
+
+    /// Запись CPU в свободный слот с публикацией.
+    /// preservingContents — слот стартует с копии latest (частичное обновление):
+    /// копируются только отрезки, где слот отстал; modifiedRange — частицы, которые
+    /// меняет body (nil — любые). Иначе содержимое слота не определено и body
+    /// перезаписывает все частицы.
+    /// Замок держится только на захват и публикацию слота: копия и body идут без
+    /// него, beginFrame() на render-потоке их не ждет.
+    /// false — кольцо пусто или GPU не отпустил слот за gpuWaitTimeout
+    @discardableResult
+    func write(
+        preservingContents: Bool = true,
+        modifiedRange: Range<Int>? = nil,
+        _ body: (UnsafeMutablePointer<Particle>, Int) -> Void
+    ) -> Bool {
+        guard let claim = claimSlot(waitingForGPU: true, readingLatest: preservingContents) else { return false }
+
+        if preservingContents, var dirty = claim.dirty {
+            dirtyRangeCopyC(&dirty, claim.target.contents(), claim.source.contents())
+        }
+        let pointer = claim.target.contents().bindMemory(to: Particle.self, capacity: claim.count)
+        body(pointer, claim.count)
+
+        condition.lock()
+        publish(claim, modifiedRange: preservingContents ? modifiedRange : nil)
+        condition.unlock()
+        return true
+    }
+
+    /// Запись CPU, которая сама переносит latest в свободный слот: body читает
+    /// source (latest) и пишет target целиком — один проход по памяти вместо
+    /// memcpy + изменения. Body идет без замка, как и у write.
+    /// waitingForGPU = false — для render-потока: если слот занят или compute
+    /// прошлого кадра еще пишет latest, запись пропускается сразу, без ожидания.
+    /// false — как у write(preservingContents:) или пропуск без ожидания
+    @discardableResult
+    func transform(
+        waitingForGPU: Bool = true,
+        _ body: (UnsafePointer<Particle>, UnsafeMutablePointer<Particle>, Int) -> Void
+    ) -> Bool {
+        guard let claim = claimSlot(waitingForGPU: waitingForGPU, readingLatest: true) else { return false }
+
+        let source = claim.source.contents().bindMemory(to: Particle.self, capacity: claim.count)
+        let target = claim.target.contents().bindMemory(to: Particle.self, capacity: claim.count)
+        body(UnsafePointer(source), target, claim.count)
+
+        condition.lock()
+        publish(claim, modifiedRange: nil)
+        condition.unlock()
+        return true
+    }
+
+    // MARK: - GPU Frames
+
+    /// Начало кадра GPU: слот, с которым работают compute и render кадра.
+    /// writes = false — CPU сейчас пишет слот по копии latest: кадр только рисует
+    /// latest, compute пропускается (его результат заменила бы публикация CPU)
+    func beginFrame() -> (buffer: MTLBuffer, serial: UInt64, writes: Bool)? {
+        condition.lock()
+        defer { condition.unlock() }
+
+        guard !buffers.isEmpty else { return nil }
+        var slot: Int32 = 0
+        var writes: Int32 = 0
+        let serial = bufferRingBeginFrameC(&ring, &slot, &writes)
+        // Compute кадра пишет latest in-place — остальные слоты отстают целиком
+        if writes != 0 {
+            markStale(exceptSlot: slot, modifiedRange: nil)
+        }
+        return (buffers[Int(slot)], serial, writes != 0)
+    }
+
+    /// Из completion handler compute-буфера кадра
+    func completeWrite(serial: UInt64) {
+        condition.lock()
+        bufferRingCompleteWriteC(&ring, serial)
+        condition.broadcast()
+        condition.unlock()
+    }
+
+    /// Из completion handler render-буфера кадра
+    func retire(serial: UInt64) {
+        condition.lock()
+        bufferRingRetireC(&ring, serial)
+        condition.broadcast()
+        condition.unlock()
+    }
+
+    // MARK: - Private Methods
+
+    private struct SlotClaim {
+        let slot: Int32
+        let source: MTLBuffer
+        let target: MTLBuffer
+        let count: Int
+        /// Отрезки, в которых target отстал от source; nil — копия не нужна
+        let dirty: DirtyRangeSetC?
+        let generation: UInt64
+    }
+
+    /// Захват слота под замком. Пока слот захвачен, beginFrame() не пускает
+    /// compute в latest, а resize/clear ждут публикации — source и target
+    /// можно читать и писать без замка
+    private func claimSlot(waitingForGPU: Bool, readingLatest: Bool) -> SlotClaim? {
+        condition.lock()
+        defer { condition.unlock() }
+
+        guard !buffers.isEmpty, particleCount > 0 else { return nil }
+
+        let slot: Int32
+        if waitingForGPU {
+            let deadline = Date().addingTimeInterval(Constants.gpuWaitTimeout)
+            guard let acquired = acquireSlot(until: deadline) else { return nil }
+            if readingLatest {
+                guard waitLatestReadable(until: deadline, releasing: acquired) else { return nil }
+            }
+            slot = acquired
+        } else {
+            let acquired = bufferRingAcquireC(&ring)
+            guard acquired >= 0 else { return nil }
+            if readingLatest && bufferRingIsReadableC(&ring, ring.latest) == 0 {
+                bufferRingCancelC(&ring, acquired)
+                condition.broadcast()
+                return nil
+            }
+            slot = acquired
+        }
+
+        return SlotClaim(
+            slot: slot,
+            source: buffers[Int(ring.latest)],
+            target: buffers[Int(slot)],
+            count: particleCount,
+            dirty: readingLatest ? stale[Int(slot)] : nil,
+            generation: generation
+        )
+    }
+
+    /// Вызывать под condition: слот захвата записан и становится latest
+    private func publish(_ claim: SlotClaim, modifiedRange: Range<Int>?) {
+        let slot = claim.slot
+        // resize/clear ждут запись, но захват другого поколения не публикуем никогда:
+        // его индекс указывает на новые, не записанные слоты
+        guard claim.generation == generation, stale.indices.contains(Int(slot)) else {
+            logger.warning("Particle ring: write from a released generation discarded")
+            bufferRingCancelC(&ring, slot)
+            condition.broadcast()
+            return
+        }
+        dirtyRangeClearC(&stale[Int(slot)])
+        markStale(exceptSlot: slot, modifiedRange: modifiedRange)
+        bufferRingPublishC(&ring, slot)
+        condition.broadcast()
+    }
+
+    /// Вызывать под condition: latest изменился в modifiedRange (nil — целиком)
+    private func markStale(exceptSlot latest: Int32, modifiedRange: Range<Int>?) {
+        let stride = UInt64(MemoryLayout<Particle>.stride)
+        for index in stale.indices where index != Int(latest) {
+            guard let range = modifiedRange else {
+                dirtyRangeMarkAllC(&stale[index])
+                continue
+            }
+            let clamped = range.clamped(to: 0..<particleCount)
+            guard !clamped.isEmpty else { continue }
+            dirtyRangeMarkC(&stale[index], UInt64(clamped.lowerBound) * stride, UInt64(clamped.count) * stride)
+        }
+    }
+
+    /// Вызывать под condition. nil — GPU не отпустил слот к deadline
+    private func acquireSlot(until deadline: Date) -> Int32? {
+        var slot = bufferRingAcquireC(&ring)
+        while slot < 0 {
+            guard condition.wait(until: deadline) else {
+                logger.warning("Particle ring: no free slot, write skipped")
+                return nil
+            }
+            slot = bufferRingAcquireC(&ring)
+        }
+        return slot
+    }
+
+    /// Вызывать под condition: compute последнего кадра должен дописать latest.
+    /// false — не дождались, захваченный slot возвращен кольцу
+    private func waitLatestReadable(until deadline: Date, releasing slot: Int32) -> Bool {
+        while bufferRingIsReadableC(&ring, ring.latest) == 0 {
+            guard condition.wait(until: deadline) else {
+                bufferRingCancelC(&ring, slot)
+                condition.broadcast()
+                logger.warning("Particle ring: latest slot not readable, write skipped")
+                return false
+            }
+        }
+        return true
+    }
+
+    /// Вызывать под condition: ждет запись CPU вне замка и кадры в полете.
+    /// Запись ждем без предела — она всегда заканчивается публикацией, а слоты
+    /// под ней освобождать нельзя. Кадры GPU — до gpuWaitTimeout: command buffer
+    /// сам удерживает свои MTLBuffer
+    private func waitUntilIdle() {
+        let deadline = Date().addingTimeInterval(Constants.gpuWaitTimeout)
+        var gpuTimedOut = false
+        while ring.writing >= 0 || (!gpuTimedOut && bufferRingInFlightC(&ring) > 0) {
+            if gpuTimedOut {
+                condition.wait()
+            } else if !condition.wait(until: deadline) {
+                if bufferRingInFlightC(&ring) > 0 {
+                    logger.warning("Particle ring: frames still in flight after timeout")
+                }
+                gpuTimedOut = true
+            }
+        }
+    }
+
+    /// Вызывать под condition
+    private func releaseSlots() {
+        buffers = []
+        particleCount = 0
+        stale = []
+        generation &+= 1
+    }
+}
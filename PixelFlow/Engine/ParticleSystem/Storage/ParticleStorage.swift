@@ -41,11 +41,13 @@ final class ParticleStorage {
         static let safeAlpha: Float = 0.8
         static let scatterRatio: Float = 0.2
         static let lerpSpeed: Float = 2.0
-        static let velocityReboundFactor: Float = -0.5
-        static let minVelocityThreshold: Float = 0.001
         static let randomVelocityRange: Float = 0.1
-        static let randomImpulseRange: Float = 0.01
-        static let lerpThreshold: Float = 0.9
+        // Частиц на поток C-ядер превью и перехода: меньше — не окупается запуск потоков
+        static let parallelChunk = 131_072
+        // Разброс старта частиц в переходе к HQ, секунды
+        static let transitionStagger: Float = 0.3
+        // Шаги, пропущенные render-потоком, копятся не дольше этого, секунды
+        static let maxDeferredDelta: Float = 0.1
     }
     
     private enum NDCBounds {
@@ -63,7 +65,10 @@ final class ParticleStorage {
     
     // MARK: - Properties
     
-    var particleBuffer: MTLBuffer?
+    /// Кольцо буферов частиц: CPU пишет в свободный слот, GPU работает с latest
+    let particleRing: ParticleBufferRing
+    /// Актуальный слот кольца
+    var particleBuffer: MTLBuffer? { particleRing.latestBuffer }
     public private(set) var particleCount: Int = 0
     
     private let device: MTLDevice
@@ -81,7 +86,26 @@ final class ParticleStorage {
     private var sourcePixels: [Pixel] = []
     private var imageTargets: [Particle] = []
     private var scatterTargets: [Particle] = []
+    /// Переход к HQ: render-поток берет замок через try() и при занятом замке
+    /// пропускает шаг. Под замком только O(1) — ссылка на цели и счетчики
+    private let transitionLock = NSLock()
+    /// Снимок imageTargets на момент resetTransition (под transitionLock)
+    private var transitionTargets: [Particle] = []
     private var transitionProgress: Float = 0
+    /// Секунды с начала перехода к HQ — отсчет задержек старта частиц
+    private var transitionElapsed: Float = 0
+    private var transitionSettled = false
+    /// Растет на каждом resetTransition — шаг по старым целям не трогает новый переход
+    private var transitionGeneration: UInt64 = 0
+    /// dt шагов, которые render-поток пропустил, не дождавшись слота (только render-поток)
+    private var deferredPreviewDelta: Float = 0
+    private var deferredTransitionDelta: Float = 0
+    /// HQ-цели, набираемые порциями потоковой генерации
+    private var streamedTargets: [Particle] = []
+    /// Начало потока (uptime, нс); nil — поток не идет
+    private var streamStartTime: UInt64?
+    /// Номер кадра превью — сид счетчикового ГСЧ интегратора (только render-поток)
+    private var previewFrame: UInt32 = 0
     
     // MARK: - Initialization
     
@@ -90,10 +114,16 @@ final class ParticleStorage {
         logger: LoggerProtocol,
         viewSize: CGSize
     ) {
+        // Интегратор превью читает буфер как ParticleC (SimulationStepC.h)
+        guard MemoryLayout<Particle>.stride == MemoryLayout<ParticleC>.stride else {
+            logger.error("Particle layout mismatch: \(MemoryLayout<Particle>.stride) != \(MemoryLayout<ParticleC>.stride)")
+            return nil
+        }
         self.device = device
         self.logger = logger
         self.viewWidth = Float(viewSize.width)
         self.viewHeight = Float(viewSize.height)
+        self.particleRing = ParticleBufferRing(device: device, logger: logger)
         self.bufferQueue.setSpecific(key: bufferQueueKey, value: ())
         logger.info("ParticleStorage initialized")
     }
@@ -101,7 +131,7 @@ final class ParticleStorage {
     // MARK: - Buffer Management
     
     private func copyParticlesToBuffer(_ particles: [Particle]) {
-        guard let particleBuffer = particleBuffer else {
+        guard particleBuffer != nil else {
             logger.error("Particle buffer is nil")
             return
         }
@@ -112,14 +142,15 @@ final class ParticleStorage {
             return
         }
         
-        let bufferPointer = particleBuffer.contents().bindMemory(
-            to: Particle.self,
-            capacity: particleCount
-        )
-        
-        // Простое копирование поэлементно
-        for (index, particle) in particles.enumerated() {
-            bufferPointer[index] = particle
+        // Неполная замена сохраняет хвост актуального слота
+        particleRing.write(
+            preservingContents: particles.count < particleCount,
+            modifiedRange: 0..<particles.count
+        ) { bufferPointer, _ in
+            // Простое копирование поэлементно
+            for (index, particle) in particles.enumerated() {
+                bufferPointer[index] = particle
+            }
         }
     }
 
@@ -220,21 +251,26 @@ final class ParticleStorage {
     // MARK: - Color Management
     
     private func randomSourceColor() -> SIMD4<Float> {
-        guard !sourcePixels.isEmpty else {
+        randomSourceColor(in: sourcePixels)
+    }
+
+    private func randomSourceColor(in pixels: [Pixel]) -> SIMD4<Float> {
+        guard !pixels.isEmpty else {
             return SIMD4<Float>(1, 1, 1, 1)
         }
 
-        guard let randomPixel = sourcePixels.randomElement() else {
+        guard let randomPixel = pixels.randomElement() else {
             return SIMD4<Float>(1, 1, 1, 1)
         }
         return pixelToColor(randomPixel)
     }
     
+    /// Цвет частицы в linear (params.colorsLinear); альфа остается линейной
     private func pixelToColor(_ px: Pixel) -> SIMD4<Float> {
         return SIMD4<Float>(
-            Float(px.r) / 255.0,
-            Float(px.g) / 255.0,
-            Float(px.b) / 255.0,
+            srgb8ToLinearC(px.r),
+            srgb8ToLinearC(px.g),
+            srgb8ToLinearC(px.b),
             Float(px.a) / 255.0
         )
     }
@@ -277,6 +313,42 @@ final class ParticleStorage {
     private func clamp<T: Comparable>(_ value: T, min minValue: T, max maxValue: T) -> T {
         return min(max(value, minValue), maxValue)
     }
+    
+    /// Вызывать под bufferQueue: новые цели — переход и задержки старта с нуля
+    private func resetTransition() {
+        transitionLock.lock()
+        transitionTargets = imageTargets
+        transitionGeneration &+= 1
+        transitionProgress = 0
+        transitionElapsed = 0
+        transitionSettled = false
+        transitionLock.unlock()
+    }
+    
+    /// Делит [0, count) на куски от parallelChunk частиц между ядрами и
+    /// возвращает сумму результатов body(start, length)
+    @discardableResult
+    private func performChunked(count: Int, _ body: (Int, Int) -> Int) -> Int {
+        let chunkCount = max(1, min(
+            ProcessInfo.processInfo.activeProcessorCount,
+            count / Constants.parallelChunk
+        ))
+        guard chunkCount > 1 else {
+            return count > 0 ? body(0, count) : 0
+        }
+        
+        let chunkSize = (count + chunkCount - 1) / chunkCount
+        var results = [Int](repeating: 0, count: chunkCount)
+        results.withUnsafeMutableBufferPointer { results in
+            DispatchQueue.concurrentPerform(iterations: chunkCount) { chunk in
+                let start = chunk * chunkSize
+                let length = min(chunkSize, count - start)
+                guard length > 0 else { return }
+                results[chunk] = body(start, length)
+            }
+        }
+        return results.reduce(0, +)
+    }
 
     private func withBufferQueueSync<T>(_ work: () -> T) -> T {
         if DispatchQueue.getSpecific(key: bufferQueueKey) != nil {
@@ -298,32 +370,14 @@ extension ParticleStorage: ParticleStorageProtocol {
         withBufferQueueSync {
             if particleCount <= 0 {
                 self.particleCount = 0
-                particleBuffer = nil
+                particleRing.clear()
                 logger.warning("Particle count <= 0; storage cleared")
                 return
             }
 
-            let stride = MemoryLayout<Particle>.stride
-            let (bufferSize, overflow) = stride.multipliedReportingOverflow(by: particleCount)
-            guard !overflow, bufferSize > 0 else {
-                logger.error("Particle buffer size overflow for count: \(particleCount)")
-                return
-            }
-
-            if let buffer = particleBuffer, buffer.length >= bufferSize {
-                self.particleCount = particleCount
-                memset(buffer.contents(), 0, bufferSize)
-                return
-            }
-
-            guard let newBuffer = device.makeBuffer(length: bufferSize, options: .storageModeShared) else {
-                logger.error("Failed to create particle buffer (\(bufferSize) bytes)")
-                return
-            }
-
-            particleBuffer = newBuffer
+            // Слоты переиспользуются, если вмещают particleCount
+            guard particleRing.resize(particleCount: particleCount) else { return }
             self.particleCount = particleCount
-            memset(newBuffer.contents(), 0, bufferSize)
         }
     }
     
@@ -455,23 +509,20 @@ extension ParticleStorage: ParticleStorageProtocol {
     
     func recreateHighQualityParticles() {
         bufferQueue.sync {
-            guard let particleBuffer = particleBuffer else {
+            guard particleBuffer != nil else {
                 logger.warning("No particle buffer for high quality recreation")
                 return
             }
             
-            let bufferPointer = particleBuffer.contents().bindMemory(
-                to: Particle.self,
-                capacity: particleCount
-            )
-            
-            if !sourcePixels.isEmpty {
-                updateBufferWithSourcePixels(bufferPointer: bufferPointer)
-            } else {
-                fallbackToCurrentPositions(bufferPointer: bufferPointer)
+            particleRing.write { bufferPointer, _ in
+                if !sourcePixels.isEmpty {
+                    updateBufferWithSourcePixels(bufferPointer: bufferPointer)
+                } else {
+                    fallbackToCurrentPositions(bufferPointer: bufferPointer)
+                }
             }
             
-            transitionProgress = 0
+            resetTransition()
             logger.info("Recreated high quality particles")
         }
     }
@@ -520,7 +571,7 @@ extension ParticleStorage: ParticleStorageProtocol {
     func createScatteredTargets() {
         bufferQueue.sync {
             scatterTargets = generateScatteredTargets()
-            transitionProgress = 0
+            resetTransition()
             logger.info("Created scattered targets for breaking apart")
         }
     }
@@ -605,7 +656,7 @@ extension ParticleStorage: ParticleStorageProtocol {
     func setHighQualityTargets(_ particles: [Particle]) {
         bufferQueue.sync {
             imageTargets = prepareHighQualityTargets(from: particles)
-            transitionProgress = 0
+            resetTransition()
             logger.info("High quality targets set: \(imageTargets.count)")
         }
     }
@@ -627,20 +678,83 @@ extension ParticleStorage: ParticleStorageProtocol {
         return targets
     }
     
-    func applyHighQualityTargetsToBuffer() {
+    // MARK: - High Quality Stream
+    
+    func beginHighQualityStream() {
         bufferQueue.sync {
-            applyTargetsToBuffer(targets: imageTargets, name: "HQ")
+            streamedTargets = []
+            streamedTargets.reserveCapacity(particleCount)
+            streamStartTime = DispatchTime.now().uptimeNanoseconds
         }
     }
     
-    func applyScatteredTargetsToBuffer() {
+    /// Под bufferQueue — только цели; порция пишется в свободный слот кольца вне очереди,
+    /// копируя из latest лишь отставшие диапазоны (DirtyRangeC)
+    func installHighQualityChunk(_ chunk: ParticleChunk) {
+        let range = bufferQueue.sync { () -> Range<Int>? in
+            guard let startTime = streamStartTime else { return nil }
+            
+            let lower = chunk.startIndex
+            let upper = min(lower + chunk.particles.count, particleCount)
+            guard lower >= 0, lower < upper else { return nil }
+            
+            if streamedTargets.isEmpty {
+                let elapsedMs = Double(DispatchTime.now().uptimeNanoseconds &- startTime) / 1_000_000
+                logger.info("First HQ chunk after \(String(format: "%.1f", elapsedMs)) ms: \(upper - lower) particles")
+            }
+            
+            // Пропуск между порциями — разбросанные частицы, как у недостающих целей
+            while streamedTargets.count < lower {
+                streamedTargets.append(createScatteredParticle())
+            }
+            let replaced = lower..<min(streamedTargets.count, upper)
+            streamedTargets.replaceSubrange(replaced, with: chunk.particles.prefix(upper - lower))
+            return lower..<upper
+        }
+        
+        guard let range = range else { return }
+        
+        particleRing.write(modifiedRange: range) { bufferPointer, _ in
+            chunk.particles.withUnsafeBufferPointer { particles in
+                guard let base = particles.baseAddress else { return }
+                memcpy(bufferPointer + range.lowerBound, base, MemoryLayout<Particle>.stride * range.count)
+            }
+        }
+    }
+    
+    func finishHighQualityStream() -> Int {
         bufferQueue.sync {
-            applyTargetsToBuffer(targets: scatterTargets, name: "scattered")
+            guard streamStartTime != nil else { return 0 }
+            streamStartTime = nil
+            
+            let installed = streamedTargets.count
+            guard installed > 0 else { return 0 }
+            
+            // Недостающие цели — разбросанные, как в prepareHighQualityTargets
+            while streamedTargets.count < particleCount {
+                streamedTargets.append(createScatteredParticle())
+            }
+            imageTargets = streamedTargets
+            streamedTargets = []
+            resetTransition()
+            logger.info("High quality stream finished: \(installed) particles")
+            return installed
         }
     }
     
+    // Под bufferQueue берется только снимок целей — запись идет в свободный слот кольца
+    func applyHighQualityTargetsToBuffer() {
+        let targets = bufferQueue.sync { imageTargets }
+        applyTargetsToBuffer(targets: targets, name: "HQ")
+    }
+    
+    func applyScatteredTargetsToBuffer() {
+        let targets = bufferQueue.sync { scatterTargets }
+        applyTargetsToBuffer(targets: targets, name: "scattered")
+    }
+    
     private func applyTargetsToBuffer(targets: [Particle], name: String) {
-        guard let particleBuffer = particleBuffer else {
+        guard particleBuffer != nil else {
             logger.warning("No particle buffer for applying \(name) targets")
             return
         }
@@ -651,13 +765,10 @@ extension ParticleStorage: ParticleStorageProtocol {
             return
         }
         
-        let bufferPointer = particleBuffer.contents().bindMemory(
-            to: Particle.self,
-            capacity: particleCount
-        )
-        
-        for i in 0..<count {
-            applyTargetToParticle(target: targets[i], bufferPointer: bufferPointer, index: i)
+        particleRing.write(modifiedRange: 0..<count) { bufferPointer, _ in
+            for i in 0..<count {
+                applyTargetToParticle(target: targets[i], bufferPointer: bufferPointer, index: i)
+            }
         }
         
         logger.info("Applied \(name) targets to buffer: \(count)")
@@ -680,150 +791,129 @@ extension ParticleStorage: ParticleStorageProtocol {
     // MARK: - Update Methods
     
     func updateFastPreview(deltaTime: Float) {
-        bufferQueue.sync { /* гарантируем завершение всех CPU-записей */ }
         integrateVelocities(deltaTime: deltaTime)
     }
     
+    /// Вызывается с render-потока каждый кадр: без bufferQueue, порядок
+    /// с GPU и другими CPU-записями обеспечивает кольцо.
+    /// Шаг — previewIntegrateC (PreviewIntegratorC.h): latest читается и пишется
+    /// в свободный слот за один проход, большие буферы делятся между ядрами.
+    /// Кольцо не ждем: если compute прошлого кадра еще пишет latest или слот
+    /// занят другой записью, шаг переносится на следующий кадр вместе с dt
     func integrateVelocities(deltaTime: Float) {
-        bufferQueue.sync {
-            guard particleCount > 0, let particleBuffer = particleBuffer else {
-                logger.warning("Cannot integrate velocities - invalid state")
-                return
-            }
-            
-            let bufferPointer = particleBuffer.contents().bindMemory(
-                to: Particle.self,
-                capacity: particleCount
-            )
+        let frame = previewFrame
+        let stepDelta = min(deltaTime + deferredPreviewDelta, Constants.maxDeferredDelta)
+        
+        let written = particleRing.transform(waitingForGPU: false) { source, target, count in
+            let sourceC = UnsafeRawPointer(source).assumingMemoryBound(to: ParticleC.self)
+            let targetC = UnsafeMutableRawPointer(target).assumingMemoryBound(to: ParticleC.self)
             
-            for i in 0..<particleCount {
-                updateParticlePhysics(bufferPointer: bufferPointer, index: i, deltaTime: deltaTime)
+            // ГСЧ счетчиковый — результат не зависит от разбиения
+            performChunked(count: count) { start, length in
+                previewIntegrateC(sourceC, targetC, Int32(start), Int32(length), stepDelta, frame)
+                return 0
             }
         }
-    }
-    
-    private func updateParticlePhysics(
-        bufferPointer: UnsafeMutablePointer<Particle>,
-        index: Int,
-        deltaTime: Float
-    ) {
-        var particle = bufferPointer[index]
-        
-        // Обновляем позицию
-        particle.position.x += particle.velocity.x * deltaTime
-        particle.position.y += particle.velocity.y * deltaTime
-        
-        // Ограничение границами (можно объединить)
-        let clampedX = clamp(
-            particle.position.x,
-            min: NDCBounds.minWithPadding,
-            max: NDCBounds.maxWithPadding
-        )
-        let clampedY = clamp(
-            particle.position.y,
-            min: NDCBounds.minWithPadding,
-            max: NDCBounds.maxWithPadding
-        )
-        
-        particle.position = SIMD3<Float>(clampedX, clampedY, particle.position.z)
-        
-        // Обработка столкновений с границами
-        if particle.position.x != clampedX {
-            particle.velocity.x *= Constants.velocityReboundFactor
-        }
-        
-        if particle.position.y != clampedY {
-            particle.velocity.y *= Constants.velocityReboundFactor
-        }
         
-        // Защита от залипания
-        preventStuckParticles(particle: &particle)
-        
-        bufferPointer[index] = particle
-    }
-    
-    private func preventStuckParticles(particle: inout Particle) {
-        if simd.length(particle.velocity) < Constants.minVelocityThreshold {
-            particle.velocity = SIMD3<Float>(
-                Float.random(in: -Constants.randomImpulseRange...Constants.randomImpulseRange),
-                Float.random(in: -Constants.randomImpulseRange...Constants.randomImpulseRange),
-                0
-            )
+        if written {
+            previewFrame &+= 1
+            deferredPreviewDelta = 0
+        } else {
+            deferredPreviewDelta = stepDelta
         }
     }
     
+    /// Render-поток: ни bufferQueue, ни ожидания кольца. Занятый transitionLock
+    /// (его держат только O(1)) или кольцо — шаг переносится на следующий кадр
     func updateHighQualityTransition(deltaTime: Float) {
-        bufferQueue.sync {
-            performHighQualityTransition(deltaTime: deltaTime)
+        let stepDelta = min(deltaTime + deferredTransitionDelta, Constants.maxDeferredDelta)
+        guard transitionLock.try() else {
+            deferredTransitionDelta = stepDelta
+            return
         }
-    }
-    
-    private func performHighQualityTransition(deltaTime: Float) {
-        let count = min(particleCount, imageTargets.count)
-        guard count > 0, let particleBuffer = particleBuffer else {
-            logger.warning("No high quality particles or buffer for transition")
+        let targets = transitionTargets
+        let generation = transitionGeneration
+        let elapsed = transitionElapsed + stepDelta
+        let lerpFactor = min(1.0, Constants.lerpSpeed * stepDelta)
+        transitionLock.unlock()
+        
+        guard performHighQualityTransition(targets: targets, lerpFactor: lerpFactor, elapsed: elapsed) else {
+            deferredTransitionDelta = stepDelta
             return
         }
+        deferredTransitionDelta = 0
         
-        let lerpFactor = calculateLerpFactor(deltaTime: deltaTime)
-        
-        let bufferPointer = particleBuffer.contents().bindMemory(
-            to: Particle.self,
-            capacity: particleCount
-        )
-        
-        for i in 0..<count {
-            interpolateParticle(
-                bufferPointer: bufferPointer,
-                index: i,
-                target: imageTargets[i],
-                lerpFactor: lerpFactor
-            )
+        // Счетчики двигаем только за выполненный шаг; занятый замок — догоним в следующем
+        guard transitionLock.try() else { return }
+        if generation == transitionGeneration {
+            transitionProgress = min(1.0, transitionProgress + lerpFactor)
+            transitionElapsed = elapsed
         }
+        transitionLock.unlock()
     }
     
-    private func calculateLerpFactor(deltaTime: Float) -> Float {
-        let lerpFactor = min(1.0, Constants.lerpSpeed * deltaTime)
-        transitionProgress = min(1.0, transitionProgress + lerpFactor)
-        return lerpFactor
-    }
-    
-    private func interpolateParticle(
-        bufferPointer: UnsafeMutablePointer<Particle>,
-        index: Int,
-        target: Particle,
-        lerpFactor: Float
-    ) {
-        var current = bufferPointer[index]
-        
-        // Интерполяция полей
-        current.position += (target.position - current.position) * lerpFactor
-        current.velocity += (target.velocity - current.velocity) * lerpFactor
-        current.targetPosition += (target.targetPosition - current.targetPosition) * lerpFactor
-        current.color += (target.color - current.color) * lerpFactor
-        current.originalColor += (target.originalColor - current.originalColor) * lerpFactor
-        current.size += (target.size - current.size) * lerpFactor
-        current.baseSize += (target.baseSize - current.baseSize) * lerpFactor
-        current.life += (target.life - current.life) * lerpFactor
+    /// Шаг — transitionBlendC (TransitionBlendC.h): latest и цели смешиваются
+    /// векторами float4 сразу в свободный слот, большие буферы делятся между ядрами.
+    /// false — кольцо занято, шаг не сделан
+    private func performHighQualityTransition(targets: [Particle], lerpFactor: Float, elapsed: Float) -> Bool {
+        let count = min(particleCount, targets.count)
+        guard count > 0, particleBuffer != nil else {
+            logger.warning("No high quality particles or buffer for transition")
+            return true
+        }
         
-        // idleChaoticMotion - uint, не интерполируется
-        if lerpFactor >= Constants.lerpThreshold {
-            current.idleChaoticMotion = target.idleChaoticMotion
+        var pending = 0
+        let written = targets.withUnsafeBufferPointer { targetBuffer -> Bool in
+            guard let targetBase = targetBuffer.baseAddress else { return false }
+            let targetsC = UnsafeRawPointer(targetBase).assumingMemoryBound(to: ParticleC.self)
+            
+            return particleRing.transform(waitingForGPU: false) { source, target, total in
+                let sourceC = UnsafeRawPointer(source).assumingMemoryBound(to: ParticleC.self)
+                let outC = UnsafeMutableRawPointer(target).assumingMemoryBound(to: ParticleC.self)
+                let blendCount = min(count, total)
+                
+                pending = performChunked(count: blendCount) { start, length in
+                    Int(transitionBlendC(
+                        sourceC, targetsC, outC,
+                        Int32(start), Int32(length),
+                        lerpFactor, elapsed, Constants.transitionStagger
+                    ))
+                }
+                
+                // Частицы без цели переносятся как есть
+                if blendCount < total {
+                    memcpy(
+                        target + blendCount,
+                        source + blendCount,
+                        MemoryLayout<Particle>.stride * (total - blendCount)
+                    )
+                }
+            }
         }
         
-        bufferPointer[index] = current
+        guard written else { return false }
+        
+        if pending == 0, transitionLock.try() {
+            let settles = !transitionSettled
+            transitionSettled = true
+            transitionLock.unlock()
+            if settles {
+                logger.info("High quality transition settled: \(count) particles")
+            }
+        }
+        return true
     }
     
     // MARK: - Cleanup
     
     func clear() {
         bufferQueue.sync {
-            particleBuffer = nil
+            particleRing.clear()
             particleCount = 0
             sourcePixels.removeAll()
             imageTargets.removeAll()
             scatterTargets.removeAll()
-            transitionProgress = 0
+            resetTransition()
             
             logger.info("Particle storage cleared")
         }
@@ -832,7 +922,9 @@ extension ParticleStorage: ParticleStorageProtocol {
     // MARK: - State Access
     
     func getTransitionProgress() -> Float {
-        bufferQueue.sync { transitionProgress }
+        transitionLock.lock()
+        defer { transitionLock.unlock() }
+        return transitionProgress
     }
     
     func saveHighQualityPixels(from particles: [Particle]) {
@@ -848,9 +940,9 @@ extension ParticleStorage: ParticleStorageProtocol {
             return Pixel(
                 x: Int(screenCoords.x.rounded()),
                 y: Int(screenCoords.y.rounded()),
-                r: UInt8(clamping: Int((particle.color.x * 255).rounded())),
-                g: UInt8(clamping: Int((particle.color.y * 255).rounded())),
-                b: UInt8(clamping: Int((particle.color.z * 255).rounded())),
+                r: linearToSrgb8C(particle.color.x),
+                g: linearToSrgb8C(particle.color.y),
+                b: linearToSrgb8C(particle.color.z),
                 a: UInt8(clamping: Int((particle.color.w * 255).rounded()))
             )
         }
@@ -865,28 +957,28 @@ extension ParticleStorage: ParticleStorageProtocol {
     // MARK: - Particle Updates
     
     func updateParticles(_ particles: [Particle]) {
-        bufferQueue.sync {
-            copyParticlesToBuffer(particles)
-        }
+        copyParticlesToBuffer(particles)
     }
     
     func updateParticles(_ particles: [Particle], startIndex: Int) {
-        bufferQueue.sync {
-            guard let particleBuffer = particleBuffer else {
-                logger.error("Particle buffer is nil")
-                return
-            }
-            
-            guard startIndex >= 0, startIndex + particles.count <= particleCount else {
+        guard particleBuffer != nil else {
+            logger.error("Particle buffer is nil")
+            return
+        }
+        
+        guard startIndex >= 0 else {
+            logger.warning("Invalid startIndex or particles count for updateParticles")
+            return
+        }
+        
+        // Границу проверяем по размеру захваченного слота: particleCount снаружи
+        // кольца может отстать от resize
+        let logger = self.logger
+        particleRing.write(modifiedRange: startIndex..<(startIndex + particles.count)) { bufferPointer, count in
+            guard startIndex + particles.count <= count else {
                 logger.warning("Invalid startIndex or particles count for updateParticles")
                 return
             }
-            
-            let bufferPointer = particleBuffer.contents().bindMemory(
-                to: Particle.self,
-                capacity: particleCount
-            )
-            
             for (i, particle) in particles.enumerated() {
                 bufferPointer[startIndex + i] = particle
             }
@@ -899,16 +991,28 @@ extension ParticleStorage: ParticleStorageProtocol {
         DispatchQueue.global(qos: .userInitiated).async { [weak self] in
             guard let self = self else { return }
             
-            let shouldSkip = self.bufferQueue.sync { () -> Bool in
-                if !self.imageTargets.isEmpty {
-                    return true
-                }
-                
-                self.generateImageTargets()
-                return false
+            // Под bufferQueue — только снимок входных данных и публикация результата:
+            // генерация не держит очередь, которую ждут записи с render-потока
+            let context = self.bufferQueue.sync { () -> PreviewContext? in
+                guard self.imageTargets.isEmpty else { return nil }
+                return PreviewContext(
+                    viewWidth: self.viewWidth,
+                    viewHeight: self.viewHeight,
+                    sourcePixels: self.sourcePixels
+                )
             }
             
-            if shouldSkip {
+            if let context = context {
+                let count = self.bufferQueue.sync { self.particleCount }
+                let targets = self.generateImageTargets(context: context, count: count)
+                
+                self.bufferQueue.sync {
+                    guard self.imageTargets.isEmpty else { return }
+                    self.imageTargets = targets
+                    self.resetTransition()
+                }
+                self.logger.info("High quality particles generated")
+            } else {
                 self.logger.info("High quality targets already set - skipping generation")
             }
             
@@ -918,26 +1022,15 @@ extension ParticleStorage: ParticleStorageProtocol {
         }
     }
     
-    private func generateImageTargets() {
-        imageTargets = []
-        imageTargets.reserveCapacity(particleCount)
-        
-        if !sourcePixels.isEmpty {
-            generateTargetsFromSource()
-        } else {
-            generateRandomTargets()
-        }
+    private func generateImageTargets(context: PreviewContext, count: Int) -> [Particle] {
+        var targets: [Particle] = []
+        targets.reserveCapacity(count)
         
-        transitionProgress = 0
-        logger.info("High quality particles generated")
-    }
-    
-    private func generateTargetsFromSource() {
-        let count = min(particleCount, sourcePixels.count)
+        let sourceCount = min(count, context.sourcePixels.count)
         
-        for i in 0..<count {
-            let px = sourcePixels[i]
-            let pos = normalizePixelToNDC(px, viewWidth: viewWidth, viewHeight: viewHeight)
+        for i in 0..<sourceCount {
+            let px = context.sourcePixels[i]
+            let pos = normalizePixelToNDC(px, viewWidth: context.viewWidth, viewHeight: context.viewHeight)
             let color = pixelToColor(px)
             let particle = createNDCParticle(
                 x: pos.x,
@@ -945,26 +1038,20 @@ extension ParticleStorage: ParticleStorageProtocol {
                 color: color,
                 size: Constants.highQualityParticleSize
             )
-            imageTargets.append(particle)
+            targets.append(particle)
         }
         
-        for _ in count..<particleCount {
-            let particle = createRandomNDCParticle()
-            imageTargets.append(particle)
-        }
-    }
-    
-    private func generateRandomTargets() {
-        for _ in 0..<particleCount {
-            let particle = createRandomNDCParticle()
-            imageTargets.append(particle)
+        for _ in sourceCount..<count {
+            targets.append(createRandomNDCParticle(sourcePixels: context.sourcePixels))
         }
+        
+        return targets
     }
     
-    private func createRandomNDCParticle() -> Particle {
+    private func createRandomNDCParticle(sourcePixels: [Pixel]) -> Particle {
         let randX = Float.random(in: NDCBounds.min...NDCBounds.max)
         let randY = Float.random(in: NDCBounds.min...NDCBounds.max)
-        let color = randomSourceColor()
+        let color = randomSourceColor(in: sourcePixels)
         return createNDCParticle(
             x: randX,
             y: randY,
@@ -0,0 +1,91 @@
+//
+//  BufferRingC.c
+//  PixelFlow
+//
+
+#include "BufferRingC.h"
+
+#include <string.h>
+
+static inline int32_t isValidSlot(const BufferRingC* ring, int32_t slot) {
+    return slot >= 0 && slot < ring->slotCount;
+}
+
+void bufferRingInitC(BufferRingC* ring, int32_t slotCount) {
+    if (!ring) return;
+    if (slotCount < 2) slotCount = 2;
+    if (slotCount > BUFFER_RING_MAX_SLOTS_C) slotCount = BUFFER_RING_MAX_SLOTS_C;
+
+    memset(ring, 0, sizeof(*ring));
+    ring->slotCount = slotCount;
+    ring->latest = 0;
+    ring->writing = -1;
+}
+
+int32_t bufferRingAcquireC(BufferRingC* ring) {
+    if (!ring || ring->writing >= 0) return -1;
+
+    int32_t best = -1;
+    for (int32_t slot = 0; slot < ring->slotCount; slot++) {
+        if (slot == ring->latest) continue;
+        // Кадр в полете еще читает/пишет слот
+        if (ring->useSerial[slot] > ring->retired) continue;
+        if (best < 0 || ring->useSerial[slot] < ring->useSerial[best]) {
+            best = slot;
+        }
+    }
+
+    ring->writing = best;
+    return best;
+}
+
+int32_t bufferRingIsReadableC(const BufferRingC* ring, int32_t slot) {
+    if (!ring || !isValidSlot(ring, slot)) return 0;
+    return ring->writeSerial[slot] <= ring->written;
+}
+
+void bufferRingPublishC(BufferRingC* ring, int32_t slot) {
+    if (!ring || slot != ring->writing) return;
+
+    ring->writeSerial[slot] = 0;
+    ring->latest = slot;
+    ring->writing = -1;
+}
+
+void bufferRingCancelC(BufferRingC* ring, int32_t slot) {
+    if (!ring || slot != ring->writing) return;
+    ring->writing = -1;
+}
+
+uint64_t bufferRingBeginFrameC(BufferRingC* ring, int32_t* outSlot, int32_t* outWrites) {
+    if (!ring) return 0;
+
+    uint64_t serial = ++ring->submitted;
+    int32_t slot = ring->latest;
+    int32_t writes = ring->writing < 0;
+    // Кадр только для чтения не делает latest нечитаемым для CPU
+    if (writes) ring->writeSerial[slot] = serial;
+    ring->useSerial[slot] = serial;
+
+    if (outSlot) *outSlot = slot;
+    if (outWrites) *outWrites = writes;
+    return serial;
+}
+
+void bufferRingCompleteWriteC(BufferRingC* ring, uint64_t serial) {
+    if (!ring) return;
+    // Completion handlers одной очереди приходят по порядку, но не полагаемся на это
+    if (serial > ring->written) ring->written = serial;
+}
+
+void bufferRingRetireC(BufferRingC* ring, uint64_t serial) {
+    if (!ring) return;
+    if (serial > ring->retired) ring->retired = serial;
+    // Завершенный кадр завершил и compute
+    if (serial > ring->written) ring->written = serial;
+}
+
+int32_t bufferRingInFlightC(const BufferRingC* ring) {
+    if (!ring) return 0;
+    return (int32_t)(ring->submitted - ring->retired);
+}
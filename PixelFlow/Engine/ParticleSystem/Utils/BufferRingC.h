@@ -0,0 +1,81 @@
+//
+//  BufferRingC.h
+//  PixelFlow
+//
+//  Кольцо слотов буфера частиц с заборами кадров GPU.
+//  Только учет индексов и serial кадров — памятью владеет вызывающий
+//  (ParticleBufferRing.swift держит по MTLBuffer на слот).
+//
+//  Схема:
+//  - GPU работает in-place в актуальном слоте (latest): compute кадра пишет
+//    в него, render того же кадра читает;
+//  - CPU пишет только в свободный слот (не latest и не занятый кадром
+//    в полете), затем публикует его как latest;
+//  - кадр GPU отпускает слот после retire (завершение render);
+//  - пока CPU держит слот (writing >= 0), новые кадры только читают latest:
+//    CPU копирует latest без замка, и compute не должен писать его в это время.
+//
+//  Не потокобезопасно: все вызовы — под замком владельца.
+//
+
+#ifndef BufferRingC_h
+#define BufferRingC_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Максимум слотов в кольце
+#define BUFFER_RING_MAX_SLOTS_C 4
+
+typedef struct {
+    int32_t slotCount;
+    int32_t latest;                                 // слот с актуальным содержимым
+    int32_t writing;                                // слот, захваченный CPU; -1 — нет
+    uint64_t submitted;                             // serial последнего отправленного кадра GPU
+    uint64_t written;                               // последний кадр с завершенным compute
+    uint64_t retired;                               // последний кадр, завершенный целиком
+    uint64_t writeSerial[BUFFER_RING_MAX_SLOTS_C];  // кадр, пишущий в слот (0 — записан CPU)
+    uint64_t useSerial[BUFFER_RING_MAX_SLOTS_C];    // последний кадр, использующий слот
+} BufferRingC;
+
+/// Инициализация: слот 0 — latest, все слоты свободны.
+/// slotCount ограничивается [2, BUFFER_RING_MAX_SLOTS_C]
+void bufferRingInitC(BufferRingC* ring, int32_t slotCount);
+
+/// Захват свободного слота под запись CPU.
+/// Свободный — не latest и отпущен всеми кадрами GPU; из нескольких берется
+/// дольше всех не использовавшийся. -1 — свободных нет или CPU уже пишет
+int32_t bufferRingAcquireC(BufferRingC* ring);
+
+/// 1 — содержимое слота можно читать на CPU (кадр, писавший в него, завершил compute)
+int32_t bufferRingIsReadableC(const BufferRingC* ring, int32_t slot);
+
+/// Публикация записанного слота: следующий кадр GPU пойдет в него
+void bufferRingPublishC(BufferRingC* ring, int32_t slot);
+
+/// Отмена записи без публикации — слот снова свободен
+void bufferRingCancelC(BufferRingC* ring, int32_t slot);
+
+/// Начало кадра GPU на latest. Возвращает serial кадра, слот — в outSlot.
+/// outWrites — 1, если кадр может писать слот (compute); 0 — CPU держит слот
+/// под запись, кадр только рисует latest. Результат такого compute все равно
+/// заменила бы публикация CPU
+uint64_t bufferRingBeginFrameC(BufferRingC* ring, int32_t* outSlot, int32_t* outWrites);
+
+/// Compute кадра serial завершен — его запись видна CPU
+void bufferRingCompleteWriteC(BufferRingC* ring, uint64_t serial);
+
+/// Кадр serial завершен целиком — его слот отпущен
+void bufferRingRetireC(BufferRingC* ring, uint64_t serial);
+
+/// Количество кадров GPU в полете
+int32_t bufferRingInFlightC(const BufferRingC* ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BufferRingC_h */
@@ -0,0 +1,138 @@
+//
+//  DirtyRangeC.c
+//  PixelFlow
+//
+
+#include "DirtyRangeC.h"
+
+#include <string.h>
+
+void dirtyRangeInitC(DirtyRangeSetC* set, uint64_t granularity, uint64_t limit) {
+    if (!set) return;
+
+    uint64_t aligned = 1;
+    if (granularity == 0) granularity = DIRTY_RANGE_CACHE_LINE_C;
+    while (aligned < granularity) aligned <<= 1;
+
+    memset(set, 0, sizeof(*set));
+    set->granularity = aligned;
+    set->limit = limit;
+}
+
+/// Вставка отрезка [start, end) с выровненными границами: сливает все
+/// пересекающиеся и смежные отрезки в один
+static void insertRange(DirtyRangeSetC* set, uint64_t start, uint64_t end) {
+    // Первый отрезок, который не лежит целиком левее нового (с касанием)
+    uint32_t first = 0;
+    while (first < set->count && set->ranges[first].end < start) first++;
+
+    // Отрезки [first, last) пересекаются с новым или касаются его
+    uint32_t last = first;
+    while (last < set->count && set->ranges[last].start <= end) {
+        if (set->ranges[last].start < start) start = set->ranges[last].start;
+        if (set->ranges[last].end > end) end = set->ranges[last].end;
+        last++;
+    }
+
+    uint32_t merged = last - first;
+    if (merged == 0) {
+        // Новый отрезок: при полном множестве сначала сливаем пару с наименьшим зазором
+        if (set->count == DIRTY_RANGE_MAX_C) {
+            uint32_t closest = 0;
+            uint64_t smallestGap = UINT64_MAX;
+            for (uint32_t i = 0; i + 1 < set->count; i++) {
+                uint64_t gap = set->ranges[i + 1].start - set->ranges[i].end;
+                if (gap < smallestGap) {
+                    smallestGap = gap;
+                    closest = i;
+                }
+            }
+
+            // Зазор вокруг нового отрезка меньше — он сам сливается с соседом
+            uint64_t leftGap = first > 0 ? start - set->ranges[first - 1].end : UINT64_MAX;
+            uint64_t rightGap = first < set->count ? set->ranges[first].start - end : UINT64_MAX;
+            if (leftGap <= smallestGap && leftGap <= rightGap) {
+                set->ranges[first - 1].end = end;
+                return;
+            }
+            if (rightGap <= smallestGap) {
+                set->ranges[first].start = start;
+                return;
+            }
+
+            set->ranges[closest].end = set->ranges[closest + 1].end;
+            memmove(&set->ranges[closest + 1], &set->ranges[closest + 2],
+                    (set->count - closest - 2) * sizeof(DirtyRangeC));
+            set->count--;
+            if (first > closest) first--;
+        }
+
+        memmove(&set->ranges[first + 1], &set->ranges[first],
+                (set->count - first) * sizeof(DirtyRangeC));
+        set->count++;
+    } else if (merged > 1) {
+        memmove(&set->ranges[first + 1], &set->ranges[last],
+                (set->count - last) * sizeof(DirtyRangeC));
+        set->count -= merged - 1;
+    }
+
+    set->ranges[first].start = start;
+    set->ranges[first].end = end;
+}
+
+void dirtyRangeMarkC(DirtyRangeSetC* set, uint64_t offset, uint64_t length) {
+    if (!set || length == 0 || offset >= set->limit) return;
+
+    uint64_t mask = set->granularity - 1;
+    uint64_t end = (length > set->limit - offset) ? set->limit : offset + length;
+    uint64_t start = offset & ~mask;
+    end = (end + mask) & ~mask;
+    if (end > set->limit) end = set->limit;
+
+    insertRange(set, start, end);
+}
+
+void dirtyRangeMarkAllC(DirtyRangeSetC* set) {
+    if (!set) return;
+    set->count = 0;
+    if (set->limit == 0) return;
+    set->ranges[0].start = 0;
+    set->ranges[0].end = set->limit;
+    set->count = 1;
+}
+
+void dirtyRangeUnionC(DirtyRangeSetC* set, const DirtyRangeSetC* other) {
+    if (!set || !other || set == other) return;
+    for (uint32_t i = 0; i < other->count; i++) {
+        dirtyRangeMarkC(set, other->ranges[i].start, other->ranges[i].end - other->ranges[i].start);
+    }
+}
+
+void dirtyRangeClearC(DirtyRangeSetC* set) {
+    if (!set) return;
+    set->count = 0;
+}
+
+uint64_t dirtyRangeBytesC(const DirtyRangeSetC* set) {
+    if (!set) return 0;
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < set->count; i++) {
+        bytes += set->ranges[i].end - set->ranges[i].start;
+    }
+    return bytes;
+}
+
+int32_t dirtyRangeIsFullC(const DirtyRangeSetC* set) {
+    if (!set || set->limit == 0) return 0;
+    return set->count == 1 && set->ranges[0].start == 0 && set->ranges[0].end == set->limit;
+}
+
+void dirtyRangeCopyC(const DirtyRangeSetC* set, void* destination, const void* source) {
+    if (!set || !destination || !source) return;
+    for (uint32_t i = 0; i < set->count; i++) {
+        const DirtyRangeC* range = &set->ranges[i];
+        memcpy((uint8_t*)destination + range->start,
+               (const uint8_t*)source + range->start,
+               range->end - range->start);
+    }
+}
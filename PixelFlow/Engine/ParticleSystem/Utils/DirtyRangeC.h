@@ -0,0 +1,75 @@
+//
+//  DirtyRangeC.h
+//  PixelFlow
+//
+//  Множество измененных байтовых диапазонов буфера: отрезки выравниваются
+//  по гранулярности (кэш-линия для копий в памяти, страница — для файлов),
+//  пересекающиеся и смежные сливаются. Отрезков не больше DIRTY_RANGE_MAX_C:
+//  при переполнении сливается пара с наименьшим зазором — множество
+//  может только расшириться, изменение не теряется.
+//
+//  Применение: минимальная копия между слотами кольца частиц
+//  (ParticleBufferRing.swift), диапазоны для didModifyRange у managed-буферов
+//  и для дозаписи файла кэша.
+//
+//  Не потокобезопасно: все вызовы — под замком владельца.
+//
+
+#ifndef DirtyRangeC_h
+#define DirtyRangeC_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Максимум отрезков: дальше копия по отрезкам не дешевле одной сплошной
+#define DIRTY_RANGE_MAX_C 32
+
+/// Гранулярность по умолчанию — кэш-линия
+#define DIRTY_RANGE_CACHE_LINE_C 64u
+/// Гранулярность для файлов — страница VM Apple Silicon
+#define DIRTY_RANGE_PAGE_C 16384u
+
+typedef struct {
+    uint64_t start;  // байты, включительно
+    uint64_t end;    // байты, не включительно
+} DirtyRangeC;
+
+typedef struct {
+    uint64_t granularity;                  // степень двойки
+    uint64_t limit;                        // размер буфера: отрезки обрезаются по нему
+    uint32_t count;
+    DirtyRangeC ranges[DIRTY_RANGE_MAX_C]; // по возрастанию, без пересечений и касаний
+} DirtyRangeSetC;
+
+/// Пустое множество для буфера limit байт.
+/// granularity округляется вверх до степени двойки (0 — DIRTY_RANGE_CACHE_LINE_C)
+void dirtyRangeInitC(DirtyRangeSetC* set, uint64_t granularity, uint64_t limit);
+
+/// Отметить [offset, offset + length); расширяется до границ гранулярности
+void dirtyRangeMarkC(DirtyRangeSetC* set, uint64_t offset, uint64_t length);
+
+/// Отметить весь буфер
+void dirtyRangeMarkAllC(DirtyRangeSetC* set);
+
+/// set ∪= other (гранулярность — set)
+void dirtyRangeUnionC(DirtyRangeSetC* set, const DirtyRangeSetC* other);
+
+void dirtyRangeClearC(DirtyRangeSetC* set);
+
+/// Отмечено байт (сумма длин отрезков)
+uint64_t dirtyRangeBytesC(const DirtyRangeSetC* set);
+
+/// 1 — отмечен весь буфер одним отрезком
+int32_t dirtyRangeIsFullC(const DirtyRangeSetC* set);
+
+/// Копия отмеченных отрезков из source в destination (буферы по limit байт)
+void dirtyRangeCopyC(const DirtyRangeSetC* set, void* destination, const void* source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DirtyRangeC_h */
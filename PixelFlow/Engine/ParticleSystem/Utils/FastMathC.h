@@ -0,0 +1,104 @@
+//
+//  FastMathC.h
+//  PixelFlow
+//
+//  Быстрые аппроксимации sin/cos/exp/pow для визуальных эффектов.
+//  CPU-двойник Shaders/Core/FastMath.h — коэффициенты и редукция
+//  аргумента ДОЛЖНЫ совпадать, чтобы CPU-эталон давал тот же результат.
+//
+//  Точность и скорость — см. таблицу в Shaders/shaders.md (раздел FastMath.h).
+//
+
+#ifndef FastMathC_h
+#define FastMathC_h
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FAST_MATH_PI 3.14159265f
+#define FAST_MATH_INV_TWO_PI 0.15915494f
+#define FAST_MATH_LOG2E 1.44269504f
+
+// Минимаксный полином 7-й степени для sin на [-π/2, π/2]
+#define FAST_MATH_SIN_C1  0.99999662f
+#define FAST_MATH_SIN_C3 -0.16664828f
+#define FAST_MATH_SIN_C5  0.00830632f
+#define FAST_MATH_SIN_C7 -0.00018364f
+
+// Минимаксный полином 4-й степени для 2^f на [0, 1)
+#define FAST_MATH_EXP2_C0 1.00000370f
+#define FAST_MATH_EXP2_C1 0.69296613f
+#define FAST_MATH_EXP2_C2 0.24163842f
+#define FAST_MATH_EXP2_C3 0.05169038f
+#define FAST_MATH_EXP2_C4 0.01369766f
+
+// Минимаксный полином для log2(1 + t) = t * P(t) на [0, 1)
+#define FAST_MATH_LOG2_C1  1.44196556f
+#define FAST_MATH_LOG2_C2 -0.70966224f
+#define FAST_MATH_LOG2_C3  0.41759395f
+#define FAST_MATH_LOG2_C4 -0.19626736f
+#define FAST_MATH_LOG2_C5  0.04638439f
+
+static inline float approxSinC(float x) {
+    // Редукция к [-π, π], затем отражение в [-π/2, π/2]
+    float turns = x * FAST_MATH_INV_TWO_PI;
+    float r = (turns - floorf(turns + 0.5f)) * (2.0f * FAST_MATH_PI);
+    float a = fabsf(r);
+    r = copysignf(a > 0.5f * FAST_MATH_PI ? FAST_MATH_PI - a : a, r);
+
+    float r2 = r * r;
+    return r * (FAST_MATH_SIN_C1 + r2 * (FAST_MATH_SIN_C3 + r2 * (FAST_MATH_SIN_C5 + r2 * FAST_MATH_SIN_C7)));
+}
+
+static inline float approxCosC(float x) {
+    return approxSinC(x + 0.5f * FAST_MATH_PI);
+}
+
+static inline float approxExp2C(float x) {
+    x = fminf(fmaxf(x, -126.0f), 126.0f);
+
+    float i = floorf(x);
+    float f = x - i;
+    float p = FAST_MATH_EXP2_C0 + f * (FAST_MATH_EXP2_C1 + f * (FAST_MATH_EXP2_C2 + f * (FAST_MATH_EXP2_C3 + f * FAST_MATH_EXP2_C4)));
+
+    // 2^i собираем прямо в битах экспоненты
+    uint32_t bits = (uint32_t)((int32_t)i + 127) << 23;
+    float scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+static inline float approxLog2C(float x) {
+    // x > 0: x = m * 2^e, m в [1, 2)
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    float e = (float)((int32_t)((bits >> 23) & 0xFFu) - 127);
+    bits = (bits & 0x007FFFFFu) | 0x3F800000u;
+    float m;
+    memcpy(&m, &bits, sizeof(m));
+
+    float t = m - 1.0f;
+    float p = FAST_MATH_LOG2_C1 + t * (FAST_MATH_LOG2_C2 + t * (FAST_MATH_LOG2_C3 + t * (FAST_MATH_LOG2_C4 + t * FAST_MATH_LOG2_C5)));
+    return e + t * p;
+}
+
+static inline float approxExpC(float x) {
+    return approxExp2C(x * FAST_MATH_LOG2E);
+}
+
+/// pow для неотрицательного основания (как pow(max(x, 0), y) в эффектах)
+static inline float approxPowC(float x, float y) {
+    if (x <= 0.0f) return (y == 0.0f) ? 1.0f : 0.0f;
+    return approxExp2C(y * approxLog2C(x));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FastMathC_h */
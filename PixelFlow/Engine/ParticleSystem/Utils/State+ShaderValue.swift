@@ -15,6 +15,7 @@ extension SimulationState {
         case .collecting: return 2
         case .collected: return 3
         case .lightningStorm: return 4
+        case .swarm: return 5
         }
     }
 }
@@ -0,0 +1,206 @@
+//
+//  NeighborGrid.h - Равномерная сетка соседей для режима SWARM
+//  ===========================================================
+//
+//  Сетка перестраивается каждый кадр перед updateParticles:
+//  1. countNeighborGrid   — atomic-подсчет частиц по ячейкам
+//  2. scanNeighborGrid    — исключающая префиксная сумма (один threadgroup)
+//  3. scatterNeighborGrid — раскладка индексов и позиций в порядке ячеек
+//  Затем updateParticles обходит 3×3 ячейки вокруг частицы.
+//
+//  Позиции соседей читаются из sortedPositions (снимок кадра), поэтому
+//  updateParticles может писать particles[id] без гонок с соседями.
+//
+//  CPU-бэкенд: ParticleSystem/Particles/NeighborGridC.c — та же схема и
+//  та же формула силы. Размеры сетки считает neighborGridDimsC.
+//
+//  Автор: Yauheni Kozich
+//  Создан: 17.10.26
+//
+
+#ifndef NeighborGrid_h
+#define NeighborGrid_h
+
+#include <metal_stdlib>
+#include "../Core/Common.h"
+using namespace metal;
+
+// ============================================================================
+// NEIGHBOR GRID CONSTANTS
+// ============================================================================
+constant float NEIGHBOR_NDC_MIN = -1.0;
+constant float NEIGHBOR_MIN_DIST = 1e-6;
+constant uint NEIGHBOR_SCAN_PER_QUOTA = 4;       // Кандидатов на одно место квоты ячейки
+constant uint NEIGHBOR_SCAN_THREADS = 256;       // Размер threadgroup для scanNeighborGrid
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+static inline int2 neighborGridCoord(float2 position, constant SimulationParams * params) {
+    int gridDim = int(params[0].neighborGrid.z);
+    int2 c = int2(floor((position - NEIGHBOR_NDC_MIN) * params[0].neighborGrid.y));
+    return clamp(c, int2(0), int2(gridDim - 1));
+}
+
+static inline uint neighborGridCell(float2 position, constant SimulationParams * params) {
+    int2 c = neighborGridCoord(position, params);
+    return uint(c.y * int(params[0].neighborGrid.z) + c.x);
+}
+
+// ============================================================================
+// GRID BUILD KERNELS
+// ============================================================================
+
+// cellCounts обнуляется blit-энкодером перед этим ядром
+kernel void countNeighborGrid(
+    device const Particle*     particles      [[buffer(0)]],
+    constant SimulationParams* params         [[buffer(1)]],
+    device atomic_uint*        cellCounts     [[buffer(2)]],
+    device uint*               particleCells  [[buffer(3)]],
+    uint                       id             [[thread_position_in_grid]]
+) {
+    if (id >= params[0].particleCount) return;
+
+    uint cell = neighborGridCell(particles[id].position.xy, params);
+    particleCells[id] = cell;
+    atomic_fetch_add_explicit(&cellCounts[cell], 1u, memory_order_relaxed);
+}
+
+// Запускается одним threadgroup из NEIGHBOR_SCAN_THREADS потоков:
+// каждый поток суммирует свой непрерывный отрезок ячеек, затем префикс
+// по частичным суммам и запись начал. cellCounts превращается в курсоры раскладки.
+kernel void scanNeighborGrid(
+    constant SimulationParams* params      [[buffer(1)]],
+    device uint*               cellCounts  [[buffer(2)]],
+    device uint*               cellStarts  [[buffer(4)]],
+    uint                       tid         [[thread_position_in_threadgroup]]
+) {
+    threadgroup uint partials[NEIGHBOR_SCAN_THREADS];
+
+    uint cellCount = uint(params[0].neighborGrid.w);
+    uint chunk = (cellCount + NEIGHBOR_SCAN_THREADS - 1) / NEIGHBOR_SCAN_THREADS;
+    uint begin = min(tid * chunk, cellCount);
+    uint end = min(begin + chunk, cellCount);
+
+    uint localSum = 0;
+    for (uint c = begin; c < end; c++) {
+        localSum += cellCounts[c];
+    }
+    partials[tid] = localSum;
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+
+    // 256 сложений — дешевле, чем лог-шаги с барьерами
+    if (tid == 0) {
+        uint running = 0;
+        for (uint i = 0; i < NEIGHBOR_SCAN_THREADS; i++) {
+            uint value = partials[i];
+            partials[i] = running;
+            running += value;
+        }
+        cellStarts[cellCount] = running;
+    }
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+
+    uint running = partials[tid];
+    for (uint c = begin; c < end; c++) {
+        uint value = cellCounts[c];
+        cellStarts[c] = running;
+        cellCounts[c] = running;
+        running += value;
+    }
+}
+
+kernel void scatterNeighborGrid(
+    device const Particle*     particles        [[buffer(0)]],
+    constant SimulationParams* params           [[buffer(1)]],
+    device atomic_uint*        cellCursors      [[buffer(2)]],
+    device const uint*         particleCells    [[buffer(3)]],
+    device uint*               sortedIndices    [[buffer(5)]],
+    device float2*             sortedPositions  [[buffer(6)]],
+    uint                       id               [[thread_position_in_grid]]
+) {
+    if (id >= params[0].particleCount) return;
+
+    uint slot = atomic_fetch_add_explicit(&cellCursors[particleCells[id]], 1u, memory_order_relaxed);
+    sortedIndices[slot] = id;
+    sortedPositions[slot] = particles[id].position.xy;
+}
+
+// ============================================================================
+// NEIGHBOR FORCE
+// ============================================================================
+
+// Отталкивание от соседей в радиусе + притяжение к их центру.
+// Лимит соседей делится поровну между 9 ячейками, чтобы в плотных областях
+// сила не смещалась в сторону порядка обхода.
+static inline float2 calculateNeighborForce(
+    float2 position,
+    uint id,
+    constant SimulationParams * params,
+    device const uint* cellStarts,
+    device const uint* sortedIndices,
+    device const float2* sortedPositions
+) {
+    float radius = params[0].neighborForces.x;
+    if (radius <= 0.0) return float2(0.0);
+
+    float radiusSq = radius * radius;
+    float invRadius = 1.0 / radius;
+    uint maxNeighbors = max(uint(params[0].neighborForces.w), 1u);
+    uint cellQuota = (maxNeighbors + 8) / 9;
+    uint cellScanLimit = cellQuota * NEIGHBOR_SCAN_PER_QUOTA;
+    int gridDim = int(params[0].neighborGrid.z);
+    int2 center = neighborGridCoord(position, params);
+
+    float2 separation = float2(0.0);
+    float2 neighborSum = float2(0.0);
+    uint neighbors = 0;
+
+    for (int oy = -1; oy <= 1; oy++) {
+        int ny = center.y + oy;
+        if (ny < 0 || ny >= gridDim) continue;
+
+        for (int ox = -1; ox <= 1; ox++) {
+            int nx = center.x + ox;
+            if (nx < 0 || nx >= gridDim) continue;
+
+            uint cell = uint(ny * gridDim + nx);
+            uint begin = cellStarts[cell];
+            uint end = min(cellStarts[cell + 1], begin + cellScanLimit);
+
+            uint accepted = 0;
+            for (uint j = begin; j < end && accepted < cellQuota; j++) {
+                uint other = sortedIndices[j];
+                if (other == id) continue;
+
+                float2 otherPos = sortedPositions[j];
+                float2 delta = position - otherPos;
+                float distSq = dot(delta, delta);
+                if (distSq >= radiusSq) continue;
+
+                float dist = sqrt(distSq);
+                float weight = 1.0 - dist * invRadius;
+                if (dist < NEIGHBOR_MIN_DIST) {
+                    // Совпадающие точки расталкиваем по детерминированной оси
+                    delta = float2(id < other ? -1.0 : 1.0, 0.0);
+                    dist = 1.0;
+                }
+
+                separation += delta / dist * weight;
+                neighborSum += otherPos;
+                accepted++;
+            }
+            neighbors += accepted;
+        }
+    }
+
+    float2 force = separation * params[0].neighborForces.y;
+    if (neighbors > 0 && params[0].neighborForces.z != 0.0) {
+        float2 cohesion = (neighborSum / float(neighbors) - position) * invRadius;
+        force += cohesion * params[0].neighborForces.z;
+    }
+    return force;
+}
+
+#endif /* NeighborGrid_h */
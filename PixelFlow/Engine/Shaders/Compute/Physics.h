@@ -21,6 +21,7 @@
 #include "../Core/Common.h"
 #include "../Core/Utils.h"
 #include "Simulation.h"
+#include "NeighborGrid.h"
 using namespace metal;
 
 // ============================================================================
@@ -47,6 +48,14 @@ using namespace metal;
 #define STORM_VORTEX_FORCE            0.85
 #define STORM_VORTEX_PULL             0.12
 
+// Swarm physics (силы соседей — см. NeighborGrid.h)
+#define SWARM_VELOCITY_DAMPING        0.97
+
+// Attractor field (должно совпадать с AttractorFieldC.h)
+#define ATTRACTOR_TILE_DIM            16
+#define ATTRACTOR_MAX_STRENGTH        8.0
+#define ATTRACTOR_MIN_DIST_PX         1.0
+
 #define ELECTRIC_HUE_OFFSET_G          2.1
 #define ELECTRIC_HUE_OFFSET_B          4.2
 
@@ -92,11 +101,13 @@ static inline bool isFloat2Safe(float2 value) {
 // MOVEMENT CALCULATION FUNCTIONS
 // ============================================================================
 
+// snapped = 1, если частица собрана в этом кадре. Глобальный счетчик
+// обновляется в конце updateParticles одной атомарной операцией на SIMD-группу.
 static inline float2 calculateCollectionMovement(
     thread Particle& p,
     constant SimulationParams * params,
     float safeDt,
-    device atomic_uint* collectedCounter
+    thread uint& snapped
 ) {
     float2 pos   = p.position.xy;
     float2 target = p.targetPosition.xy;
@@ -112,7 +123,7 @@ static inline float2 calculateCollectionMovement(
         p.velocity.xy = float2(0.0);
         if (p.life >= PARTICLE_ALIVE) {
             p.life = PARTICLE_COLLECTED;
-            atomic_fetch_add_explicit(collectedCounter, 1u, memory_order_relaxed);
+            snapped = 1;
         }
         return p.velocity.xy;
     }
@@ -150,15 +161,20 @@ static inline float2 calculateChaoticMovement(
     thread Particle& p,
     uint id,
     constant SimulationParams * params,
+    ParticleSeeds seeds,
     float safeDt
 ) {
     float turbulenceWeight = hash(float(id) * 0.37 + floor(params[0].time * 0.5));
+    bool fastMath = params[0].fastEffectsMath != 0;
     float2 turbulentField = turbulentMotion(p.position.xy,
                                             params[0].time,
-                                            id);
+                                            id,
+                                            fastMath);
     float2 fractalField = fractalChaos(p.position.xy,
                                        params[0].time,
-                                       id);
+                                       id,
+                                       seeds,
+                                       fastMath);
     float2 chaoticMovement = mix(turbulentField, fractalField, turbulenceWeight);
 
     float2 chaoticDir = safeNormalize2(chaoticMovement);
@@ -182,40 +198,113 @@ static inline float2 calculateChaoticMovement(
 static inline void calculateStormMovement(
     thread Particle& p,
     uint id,
-    constant SimulationParams * params
+    constant SimulationParams * params,
+    ParticleSeeds seeds
 ) {
     float seed = float(id) * 13.7;
+    bool fastMath = params[0].fastEffectsMath != 0;
 
     float fieldX = hash(seed + params[0].time * 1.5) - 0.5;
     float fieldY = hash(seed + params[0].time * 2.1 + 100.0) - 0.5;
     float2 electricForce = float2(fieldX, fieldY) * STORM_ELECTRIC_FORCE;
     p.velocity.xy += electricForce * STORM_ELECTRIC_DAMPING;
 
-    float baseTurbulence = sin(params[0].time * 3.0 + seed) * STORM_BASE_TURBULENCE;
+    float baseTurbulence = effectSin(params[0].time * 3.0 + seed, fastMath) * STORM_BASE_TURBULENCE;
     p.velocity.xy += float2(baseTurbulence, baseTurbulence * 0.7);
 
     // Вихревой компонент вокруг центра экрана делает бурю более плавной и цельной
     float2 centerOffset = p.position.xy;
     float2 tangent = safeNormalize2(float2(-centerOffset.y, centerOffset.x));
-    float spiralPhase = sin(params[0].time * 0.8 + seed * 0.3) * 0.5 + 0.5;
+    float spiralPhase = effectSin(params[0].time * 0.8 + seed * 0.3, fastMath) * 0.5 + 0.5;
     p.velocity.xy += tangent * STORM_VORTEX_FORCE * (0.65 + spiralPhase * 0.35);
     p.velocity.xy += -centerOffset * STORM_VORTEX_PULL * (0.5 + spiralPhase * 0.5);
 
     p.velocity.xy *= STORM_VELOCITY_DAMPING;
 
-    float electricHue = hash(seed) * TWO_PI + params[0].time * 2.0;
+    // hash(seed) * TWO_PI заранее посчитан в ParticleSeeds
+    float electricHue = seeds.stormHuePhase + params[0].time * 2.0;
     p.color = float4(
-        0.3 + 0.7 * sin(electricHue),
-        0.4 + 0.6 * sin(electricHue + ELECTRIC_HUE_OFFSET_G),
-        0.8 + 0.2 * sin(electricHue + ELECTRIC_HUE_OFFSET_B),
-        0.7 + 0.3 * sin(params[0].time * 3.0 + seed)
+        0.3 + 0.7 * effectSin(electricHue, fastMath),
+        0.4 + 0.6 * effectSin(electricHue + ELECTRIC_HUE_OFFSET_G, fastMath),
+        0.8 + 0.2 * effectSin(electricHue + ELECTRIC_HUE_OFFSET_B, fastMath),
+        0.7 + 0.3 * effectSin(params[0].time * 3.0 + seed, fastMath)
     );
 
     // Легкий хаотический jitter делает бурю визуально живее без разрыва траектории
-    float2 stormChaos = randomChaoticMotion(p.position.xy, params[0].time, id);
+    float2 stormChaos = randomChaoticMotion(p.position.xy, params[0].time, id, fastMath);
     p.velocity.xy += stormChaos * 0.005;
 }
 
+// ============================================================================
+// SWARM MOVEMENT
+// ============================================================================
+// Хаотичный дрейф + силы соседей из равномерной сетки.
+// Сетка построена в этом же кадре (countNeighborGrid → scanNeighborGrid → scatterNeighborGrid).
+static inline void calculateSwarmMovement(
+    thread Particle& p,
+    uint id,
+    constant SimulationParams * params,
+    ParticleSeeds seeds,
+    float safeDt,
+    device const uint* cellStarts,
+    device const uint* sortedIndices,
+    device const float2* sortedPositions
+) {
+    calculateChaoticMovement(p, id, params, seeds, safeDt);
+
+    float2 neighborForce = calculateNeighborForce(p.position.xy, id, params,
+                                                  cellStarts, sortedIndices, sortedPositions);
+    p.velocity.xy += neighborForce * safeDt;
+    p.velocity.xy *= SWARM_VELOCITY_DAMPING;
+}
+
+// ============================================================================
+// ATTRACTOR FORCES
+// ============================================================================
+// Точки касаний из params[0].attractors. Маска тайлов строится на CPU раз в кадр
+// (buildAttractorTileMasksC): частица вне всех радиусов делает одну загрузку маски.
+// Направление считается в пикселях, ускорение — в NDC относительно короткой стороны.
+static inline void applyAttractorForces(
+    thread Particle& p,
+    constant SimulationParams * params,
+    constant ushort* tileMasks,
+    float safeDt
+) {
+    if (params[0].attractorCount == 0) return;
+
+    float2 screen = max(params[0].screenSize, float2(1.0));
+    int2 tile = clamp(int2(floor((p.position.xy * 0.5 + 0.5) * float(ATTRACTOR_TILE_DIM))),
+                      int2(0), int2(ATTRACTOR_TILE_DIM - 1));
+    uint mask = tileMasks[tile.y * ATTRACTOR_TILE_DIM + tile.x];
+    if (mask == 0) return;
+
+    float2 halfScreen = screen * 0.5;
+    float2 scale = min(screen.x, screen.y) / screen;
+    float2 accel = float2(0.0);
+
+    while (mask != 0) {
+        uint bit = ctz(mask);
+        mask &= mask - 1;
+
+        ushort4 a = params[0].attractors[bit];
+        float2 center = float2(a.xy) / 65535.0 * 2.0 - 1.0;
+        float radius = float(a.z);
+        float strength = float(as_type<short>(a.w)) / 32767.0 * ATTRACTOR_MAX_STRENGTH;
+
+        float2 deltaPx = (center - p.position.xy) * halfScreen;
+        float distSq = dot(deltaPx, deltaPx);
+        if (distSq >= radius * radius) continue;
+
+        float dist = sqrt(distSq);
+        if (dist < ATTRACTOR_MIN_DIST_PX) continue;
+
+        float falloff = 1.0 - dist / radius;
+        accel += deltaPx * (strength * falloff * falloff / dist) * scale;
+    }
+
+    p.velocity.xy += accel * safeDt;
+}
+
 // ============================================================================
 // PARTICLE PROPERTY CALCULATIONS
 // ============================================================================
@@ -223,12 +312,13 @@ static inline void calculateStormMovement(
 static inline float calculateParticleSize(
     thread Particle& p,
     constant SimulationParams * params,
-    uint id
+    uint id,
+    int state
 ) {
     float size;
 
-    if (params[0].state == SIMULATION_STATE_COLLECTING ||
-        params[0].state == SIMULATION_STATE_COLLECTED) {
+    if (state == SIMULATION_STATE_COLLECTING ||
+        state == SIMULATION_STATE_COLLECTED) {
         size = p.baseSize;
     } else {
         float pulse = sin(p.life * 2.0 + float(id) * 0.01) *
@@ -251,15 +341,15 @@ static inline float calculateParticleSize(
 
 static inline void applyBoundaryConditionsForPhysics(
     thread Particle& p,
-    constant SimulationParams * params
+    int state
 ) {
     if (!isFloatSafe(p.position.x)) p.position.x = 0.0;
     if (!isFloatSafe(p.position.y)) p.position.y = 0.0;
 
     // Во время сбора не ограничиваем частицы "внутренними" границами,
     // иначе крайние пиксели (близко к NDC ±1.0) никогда не достигаются.
-    if (params[0].state == SIMULATION_STATE_COLLECTING ||
-        params[0].state == SIMULATION_STATE_COLLECTED) {
+    if (state == SIMULATION_STATE_COLLECTING ||
+        state == SIMULATION_STATE_COLLECTED) {
         p.position.x = clamp(p.position.x, NDC_MIN_POS, NDC_MAX_POS);
         p.position.y = clamp(p.position.y, NDC_MIN_POS, NDC_MAX_POS);
         if (length(p.velocity.xy) > MAX_VELOCITY) {
@@ -362,32 +452,45 @@ static inline void applyPixelPerfectMode(thread Particle& p, uint pixelSizeMode)
 // ============================================================================
 // COMPUTE SHADER – PARTICLE PHYSICS UPDATE
 // ============================================================================
+// Собирается отдельно для каждого состояния (specializedState, Simulation.h):
+// MetalRenderer выбирает вариант по params кадра, а ветки других состояний —
+// восстановление цвета, пульсация размера, точки касаний — вырезаны компилятором.
+// CPU-эталон вариантов: SimulationStepC.c (STEP_VARIANT).
 
 kernel void updateParticles(
     device Particle*          particles          [[buffer(0)]],
     constant SimulationParams* params           [[buffer(1)]],
     device atomic_uint*       collectedCounter  [[buffer(2)]],
+    device const ParticleSeeds* particleSeeds   [[buffer(3)]],
+    device const uint*        cellStarts        [[buffer(4)]],
+    device const uint*        sortedIndices     [[buffer(5)]],
+    device const float2*      sortedPositions   [[buffer(6)]],
+    constant ushort*          attractorTileMasks [[buffer(7)]],
     uint                     thread_position_in_grid [[thread_position_in_grid]]
 ) {
+    // Потоки за пределами particleCount выходят сразу — simd_sum ниже
+    // учитывает только активные потоки SIMD-группы.
     uint id = thread_position_in_grid;
     if (id >= params[0].particleCount) return;
 
+    const int state = specializedState;
     Particle p = particles[id];
     float safeDt = safeDeltaTimeForPhysics(params[0].deltaTime);
 
     bool isFullyCollected = (p.life == PARTICLE_COLLECTED &&
-                             params[0].state == SIMULATION_STATE_COLLECTED);
+                             state == SIMULATION_STATE_COLLECTED);
     bool needsPhysicsIntegration = true;
+    uint snapped = 0;
 
     if (!isFullyCollected) {
         // Restore original color at the start of each update except storm mode
-        if (params[0].state != SIMULATION_STATE_LIGHTNING_STORM) {
+        if (state != SIMULATION_STATE_LIGHTNING_STORM) {
             p.color = p.originalColor;
         }
         
-        switch (params[0].state) {
+        switch (state) {
             case SIMULATION_STATE_COLLECTING:
-                calculateCollectionMovement(p, params, safeDt, collectedCounter);
+                calculateCollectionMovement(p, params, safeDt, snapped);
                 needsPhysicsIntegration = false;
                 break;
 
@@ -400,21 +503,32 @@ kernel void updateParticles(
                 break;
 
             case SIMULATION_STATE_LIGHTNING_STORM:
-                calculateStormMovement(p, id, params);
+                calculateStormMovement(p, id, params, particleSeeds[id]);
+                break;
+
+            case SIMULATION_STATE_SWARM:
+                calculateSwarmMovement(p, id, params, particleSeeds[id], safeDt,
+                                       cellStarts, sortedIndices, sortedPositions);
                 break;
 
             case SIMULATION_STATE_IDLE:
             case SIMULATION_STATE_CHAOTIC:
             default:
-                calculateChaoticMovement(p, id, params, safeDt);
+                calculateChaoticMovement(p, id, params, particleSeeds[id], safeDt);
                 break;
         }
 
+        if (state == SIMULATION_STATE_CHAOTIC ||
+            state == SIMULATION_STATE_LIGHTNING_STORM ||
+            state == SIMULATION_STATE_SWARM) {
+            applyAttractorForces(p, params, attractorTileMasks, safeDt);
+        }
+
         if (needsPhysicsIntegration) {
             integrateParticleForPhysics(p, safeDt, float2(0.0));
         }
-        applyBoundaryConditionsForPhysics(p, params);
-        p.size = calculateParticleSize(p, params, id);
+        applyBoundaryConditionsForPhysics(p, state);
+        p.size = calculateParticleSize(p, params, id, state);
 
         if (isFloatSafe(p.life) && p.life >= PARTICLE_ALIVE) {
             p.life += safeDt;
@@ -425,6 +539,15 @@ kernel void updateParticles(
     }
 
     particles[id] = p;
+
+    // Иерархическая редукция счетчика собранных частиц:
+    // сумма по SIMD-группе, затем одна атомарная операция на группу.
+    // MetalRenderer диспатчит threadgroup = threadExecutionWidth,
+    // поэтому SIMD-группа совпадает с threadgroup.
+    uint groupSnapped = simd_sum(snapped);
+    if (simd_is_first() && groupSnapped > 0) {
+        atomic_fetch_add_explicit(collectedCounter, groupSnapped, memory_order_relaxed);
+    }
 }
 
 #endif /* Physics_h */
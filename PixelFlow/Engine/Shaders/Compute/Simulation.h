@@ -11,6 +11,7 @@
 //  - COLLECTING: собирает вещи
 //  - COLLECTED: отдыхает после работы
 //  - LIGHTNING_STORM: в экстазе от молний
+//  - SWARM: толпа, где каждый держит дистанцию
 //
 //  Здесь же константы, лимиты и вспомогательные функции.
 //  Все, что нужно для координации между CPU и GPU.
@@ -90,6 +91,25 @@ constant int SIMULATION_STATE_LIGHTNING_STORM = 4;
     Самый драматичный и энергичный режим.
 */
 
+//  РОЙ - частицы чувствуют соседей
+constant int SIMULATION_STATE_SWARM = 5;
+
+/*
+    Хаотичный дрейф плюс взаимодействие с соседями в малом радиусе:
+    частицы расталкиваются и слегка тянутся к центру своей группы.
+    Соседи ищутся через равномерную сетку (Compute/NeighborGrid.h).
+*/
+
+/*
+    СПЕЦИАЛИЗАЦИЯ ПО СОСТОЯНИЮ
+
+    Состояние одинаково для всего dispatch и всего кадра, поэтому
+    updateParticles и fragmentParticle собираются с ним как с function
+    constant: на каждое состояние свой вариант без ветвлений по params.
+    Индекс держать синхронно с MetalRenderer / RenderPipelineCache.swift!
+*/
+constant int specializedState [[function_constant(0)]];  // SIMULATION_STATE_*
+
 // ============================================================================
 // ДЕФОЛТНЫЕ ПАРАМЕТРЫ - "ФАБРИЧНЫЕ НАСТРОЙКИ"
 // ============================================================================
@@ -115,6 +135,7 @@ constant float TIME_SCALE_CHAOTIC = 1.0;            // Chaotic: нормальн
 constant float TIME_SCALE_COLLECTING = 0.8;         // Collecting: чуть медленнее для плавности
 constant float TIME_SCALE_COLLECTED = 0.0;          // Collected: остановлено (заморозка)
 constant float TIME_SCALE_STORM = 1.0;              // Storm: нормальное время (как в chaotic)
+constant float TIME_SCALE_SWARM = 1.0;              // Swarm: нормальное время (как в chaotic)
 
 // ПАРАМЕТРЫ СБОРА - как частицы находят свои места
 constant float COLLECTION_SPEED_BASE = 0.005;       // Базовая скорость движения к цели
@@ -203,6 +224,8 @@ static inline float getStateTimeScale(int state) {
             return TIME_SCALE_COLLECTED;       // Остановлено (заморозка)
         case SIMULATION_STATE_LIGHTNING_STORM:
             return TIME_SCALE_STORM;           // Нормальное время как в chaotic
+        case SIMULATION_STATE_SWARM:
+            return TIME_SCALE_SWARM;           // Нормальное время как в chaotic
         default:
             return TIME_SCALE_CHAOTIC;         // По умолчанию - нормальная скорость
     }
@@ -229,9 +252,10 @@ static inline bool canTransitionToState(int currentState, int targetState) {
             return targetState == SIMULATION_STATE_CHAOTIC;
 
         case SIMULATION_STATE_CHAOTIC:
-            // Из хаоса можно начать сбор или бурю
+            // Из хаоса можно начать сбор, бурю или рой
             return targetState == SIMULATION_STATE_COLLECTING ||
-                   targetState == SIMULATION_STATE_LIGHTNING_STORM;
+                   targetState == SIMULATION_STATE_LIGHTNING_STORM ||
+                   targetState == SIMULATION_STATE_SWARM;
 
         case SIMULATION_STATE_COLLECTING:
             // Сбор автоматически завершается в collected
@@ -245,6 +269,11 @@ static inline bool canTransitionToState(int currentState, int targetState) {
             // Из бури возвращаемся в хаос
             return targetState == SIMULATION_STATE_CHAOTIC;
 
+        case SIMULATION_STATE_SWARM:
+            // Из роя возвращаемся в хаос или собираем изображение
+            return targetState == SIMULATION_STATE_CHAOTIC ||
+                   targetState == SIMULATION_STATE_COLLECTING;
+
         default:
             // Неизвестное состояние - запрещаем переход
             return false;
@@ -40,14 +40,15 @@ struct Particle {
 // - Total size MUST be exactly 272 bytes for Metal buffer alignment (stride)
 //
 // Structure layout breakdown:
-// - uint fields (state, pixelSizeMode, colorsLocked, _pad1): 16 bytes
+// - uint fields (state, pixelSizeMode, colorsLocked, fastEffectsMath): 16 bytes
 // - float fields (deltaTime, collectionSpeed, brightnessBoost, _pad2): 16 bytes
 // - float2 fields (screenSize, _pad3): 16 bytes
-// - particle params (minParticleSize, maxParticleSize, time, particleCount, idleChaoticMotion, threadsPerThreadgroup, padding): 28 bytes
-// - reserved array (11 * float4): 176 bytes
+// - particle params (minParticleSize, maxParticleSize, time, particleCount, idleChaoticMotion, threadsPerThreadgroup, colorsLinear): 28 bytes
+// - neighbor grid (neighborGrid, neighborForces): 32 bytes
+// - attractors (16 * ushort4 + attractorCount + padding): 144 bytes
 // - final padding: 4 bytes
 // - compiler alignment padding: +12 bytes (to reach 272 stride)
-// Total: 16 + 16 + 16 + 28 + 176 + 4 + 12 = 272 bytes (verified with Swift MemoryLayout)
+// Total: 16 + 16 + 16 + 28 + 32 + 144 + 4 + 12 = 272 bytes (verified with Swift MemoryLayout)
 //
 // DO NOT modify field order or types without updating Particle.swift!
 // ============================================================================
@@ -55,7 +56,7 @@ struct SimulationParams {
     uint state;
     uint pixelSizeMode;
     uint colorsLocked;
-    uint _pad1;
+    uint fastEffectsMath;  // 1 = аппроксимации из FastMath.h для эффектов
     float deltaTime;
     float collectionSpeed;
     float brightnessBoost;
@@ -70,8 +71,32 @@ struct SimulationParams {
     uint particleCount;
     uint idleChaoticMotion;
     uint threadsPerThreadgroup;
-    uint padding;
-    float4 _reserved[11];  // 176 bytes (11 * 16)
+    uint colorsLinear;      // 1 = color/originalColor уже linear (ColorSpaceC.h), srgbToLinear не нужен
+    float4 neighborGrid;    // SWARM: x = cellSize, y = invCellSize, z = gridDim, w = cellCount
+    float4 neighborForces;  // SWARM: x = radius, y = separation, z = cohesion, w = maxNeighbors
+    // Точки касаний (см. applyAttractorForces в Physics.h, AttractorFieldC.h):
+    // x, y — NDC в unorm16, z — радиус в пикселях, w — strength в snorm16
+    ushort4 attractors[16];  // 128 bytes (16 * 8)
+    uint attractorCount;
+    uint _attractorPad0;
+    float2 _attractorPad1;
+};
+
+// ============================================================================
+// PARTICLE SEEDS - ИНВАРИАНТНЫЕ PER-PARTICLE ЗНАЧЕНИЯ
+// ============================================================================
+//
+// Значения зависят только от id частицы, поэтому считаются один раз на CPU
+// (bakeParticleSeedsC в ParticleSeeds.c) при создании буферов, а не каждый кадр.
+//
+// CRITICAL: Must match ParticleSeedsC in ParticleSeeds.h EXACTLY (48 bytes)
+// ============================================================================
+struct ParticleSeeds {
+    float2 subpixelOffset;   // Субпиксельное смещение в пикселях
+    float stormHuePhase;     // Фаза электрического цвета в буре [0, 2π)
+    float stormSizeJitter;   // Разброс размера в буре [0, 1)
+    float4 fractalPhaseX;    // Фазы октав fractalChaos по X [0, 1)
+    float4 fractalPhaseY;    // Фазы октав fractalChaos по Y [0, 1)
 };
 
 
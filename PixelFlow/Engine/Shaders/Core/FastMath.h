@@ -0,0 +1,130 @@
+//
+//  FastMath.h - Быстрые аппроксимации для математики эффектов
+//  ==========================================================
+//
+//  Эффекты (свечение, молнии, турбулентность) спокойно переживают
+//  ошибку ~1e-3, поэтому полная точность sin/cos/exp/pow им не нужна.
+//  Здесь минимаксные полиномы с редукцией аргумента.
+//
+//  CPU-двойник: ParticleSystem/Utils/FastMathC.h — коэффициенты
+//  ДОЛЖНЫ совпадать!
+//
+//  Включается флагом SimulationParams.fastEffectsMath
+//  (QualityPreset.usesFastEffectsMath на стороне Swift).
+//
+//  Автор: Yauheni Kozich
+//  Создан: 17.10.26
+//
+
+#ifndef FastMath_h
+#define FastMath_h
+
+#include <metal_stdlib>
+using namespace metal;
+
+// ============================================================================
+// КОЭФФИЦИЕНТЫ
+// ============================================================================
+
+constant float FAST_MATH_PI = 3.14159265;
+constant float FAST_MATH_INV_TWO_PI = 0.15915494;
+constant float FAST_MATH_LOG2E = 1.44269504;
+
+// sin на [-π/2, π/2], степень 7 — с редукцией ошибка 7.2e-6 абс. на [-100, 100]
+// (cos через сдвиг — 1.3e-5), замер: Tools/FastMathBench
+constant float FAST_MATH_SIN_C1 = 0.99999662;
+constant float FAST_MATH_SIN_C3 = -0.16664828;
+constant float FAST_MATH_SIN_C5 = 0.00830632;
+constant float FAST_MATH_SIN_C7 = -0.00018364;
+
+// 2^f на [0, 1), степень 4 — exp на [-20, 20]: относительная ошибка 4.4e-6
+constant float FAST_MATH_EXP2_C0 = 1.00000370;
+constant float FAST_MATH_EXP2_C1 = 0.69296613;
+constant float FAST_MATH_EXP2_C2 = 0.24163842;
+constant float FAST_MATH_EXP2_C3 = 0.05169038;
+constant float FAST_MATH_EXP2_C4 = 0.01369766;
+
+// log2(1 + t) = t * P(t) на [0, 1) — ошибка ~1.5e-5
+constant float FAST_MATH_LOG2_C1 = 1.44196556;
+constant float FAST_MATH_LOG2_C2 = -0.70966224;
+constant float FAST_MATH_LOG2_C3 = 0.41759395;
+constant float FAST_MATH_LOG2_C4 = -0.19626736;
+constant float FAST_MATH_LOG2_C5 = 0.04638439;
+
+// ============================================================================
+// АППРОКСИМАЦИИ
+// ============================================================================
+
+static inline float approxSin(float x) {
+    // Редукция к [-π, π], затем отражение в [-π/2, π/2]
+    float turns = x * FAST_MATH_INV_TWO_PI;
+    float r = (turns - floor(turns + 0.5)) * (2.0 * FAST_MATH_PI);
+    float a = abs(r);
+    r = copysign(select(a, FAST_MATH_PI - a, a > 0.5 * FAST_MATH_PI), r);
+
+    float r2 = r * r;
+    return r * (FAST_MATH_SIN_C1 + r2 * (FAST_MATH_SIN_C3 + r2 * (FAST_MATH_SIN_C5 + r2 * FAST_MATH_SIN_C7)));
+}
+
+static inline float approxCos(float x) {
+    return approxSin(x + 0.5 * FAST_MATH_PI);
+}
+
+static inline float approxExp2(float x) {
+    x = clamp(x, -126.0, 126.0);
+
+    float i = floor(x);
+    float f = x - i;
+    float p = FAST_MATH_EXP2_C0 + f * (FAST_MATH_EXP2_C1 + f * (FAST_MATH_EXP2_C2 + f * (FAST_MATH_EXP2_C3 + f * FAST_MATH_EXP2_C4)));
+
+    // 2^i собираем прямо в битах экспоненты
+    return p * as_type<float>(uint(int(i) + 127) << 23);
+}
+
+static inline float approxLog2(float x) {
+    // x > 0: x = m * 2^e, m в [1, 2)
+    uint bits = as_type<uint>(x);
+    float e = float(int((bits >> 23) & 0xFFu) - 127);
+    float m = as_type<float>((bits & 0x007FFFFFu) | 0x3F800000u);
+
+    float t = m - 1.0;
+    float p = FAST_MATH_LOG2_C1 + t * (FAST_MATH_LOG2_C2 + t * (FAST_MATH_LOG2_C3 + t * (FAST_MATH_LOG2_C4 + t * FAST_MATH_LOG2_C5)));
+    return e + t * p;
+}
+
+static inline float approxExp(float x) {
+    return approxExp2(x * FAST_MATH_LOG2E);
+}
+
+// pow для неотрицательного основания (как pow(max(x, 0), y) в эффектах)
+static inline float approxPow(float x, float y) {
+    if (x <= 0.0) return (y == 0.0) ? 1.0 : 0.0;
+    return approxExp2(y * approxLog2(x));
+}
+
+static inline float3 approxPow(float3 x, float3 y) {
+    return float3(approxPow(x.x, y.x), approxPow(x.y, y.y), approxPow(x.z, y.z));
+}
+
+// ============================================================================
+// ПЕРЕКЛЮЧАТЕЛИ ДЛЯ ЭФФЕКТОВ
+// ============================================================================
+// fastMath одинаков для всего dispatch/draw, поэтому ветка не дивергирует.
+
+static inline float effectSin(float x, bool fastMath) {
+    return fastMath ? approxSin(x) : sin(x);
+}
+
+static inline float effectCos(float x, bool fastMath) {
+    return fastMath ? approxCos(x) : cos(x);
+}
+
+static inline float effectExp(float x, bool fastMath) {
+    return fastMath ? approxExp(x) : exp(x);
+}
+
+static inline float effectPow(float x, float y, bool fastMath) {
+    return fastMath ? approxPow(x, y) : pow(x, y);
+}
+
+#endif /* FastMath_h */
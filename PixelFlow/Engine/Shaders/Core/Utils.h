@@ -17,6 +17,7 @@
 
 #include <metal_stdlib>
 #include "Common.h"
+#include "FastMath.h"
 #include "../Compute/Simulation.h"
 using namespace metal;
 
@@ -96,7 +97,7 @@ static inline float noise(float3 p) {
 // Сильно рандомизированное движение.
 // Оставлено как альтернативный профиль для будущих хаотичных режимов.
 
-static inline float2 randomChaoticMotion(float2 position, float time, uint particleId) {
+static inline float2 randomChaoticMotion(float2 position, float time, uint particleId, bool fastMath = false) {
     float seed = float(particleId) * CHAOTIC_PARTICLE_SEED_FACTOR + time * CHAOTIC_TIME_SCALE;
     
     // Генерируем несколько слоев случайности
@@ -106,9 +107,9 @@ static inline float2 randomChaoticMotion(float2 position, float time, uint parti
     float noise4 = hash(seed + 31.1);
     
     // Комбинируем разные частоты движения
-    float lowFreq = sin(time * CHAOTIC_LOW_FREQ_TIME + noise1 * TWO_PI) * CHAOTIC_LOW_FREQ_AMP;
-    float midFreq = cos(time * CHAOTIC_MID_FREQ_TIME + noise2 * TWO_PI) * CHAOTIC_MID_FREQ_AMP;
-    float highFreq = sin(time * CHAOTIC_HIGH_FREQ_TIME + noise3 * TWO_PI) * CHAOTIC_HIGH_FREQ_AMP;
+    float lowFreq = effectSin(time * CHAOTIC_LOW_FREQ_TIME + noise1 * TWO_PI, fastMath) * CHAOTIC_LOW_FREQ_AMP;
+    float midFreq = effectCos(time * CHAOTIC_MID_FREQ_TIME + noise2 * TWO_PI, fastMath) * CHAOTIC_MID_FREQ_AMP;
+    float highFreq = effectSin(time * CHAOTIC_HIGH_FREQ_TIME + noise3 * TWO_PI, fastMath) * CHAOTIC_HIGH_FREQ_AMP;
     
     // Добавляем импульсные движения (редкие, но сильные)
     float impulse = (hash(noise4 + time * 0.1) > CHAOTIC_IMPULSE_THRESHOLD) ?
@@ -117,15 +118,15 @@ static inline float2 randomChaoticMotion(float2 position, float time, uint parti
     // Возвращаем 2D вектор смещения
     return float2(
         lowFreq + midFreq + highFreq + impulse,
-        cos(time * CHAOTIC_Y_LOW_FREQ_TIME + noise1 * TWO_PI) * CHAOTIC_Y_LOW_FREQ_AMP +
-        sin(time * CHAOTIC_Y_MID_FREQ_TIME + noise2 * TWO_PI) * CHAOTIC_Y_MID_FREQ_AMP +
+        effectCos(time * CHAOTIC_Y_LOW_FREQ_TIME + noise1 * TWO_PI, fastMath) * CHAOTIC_Y_LOW_FREQ_AMP +
+        effectSin(time * CHAOTIC_Y_MID_FREQ_TIME + noise2 * TWO_PI, fastMath) * CHAOTIC_Y_MID_FREQ_AMP +
         impulse * 0.5
     );
 }
 
 // Турбулентное движение
 
-static inline float2 turbulentMotion(float2 position, float time, uint particleId) {
+static inline float2 turbulentMotion(float2 position, float time, uint particleId, bool fastMath = false) {
     // Spatially-correlated turbulent field in NDC space
 
     float baseSeed = float(particleId) * TURBULENT_SEED_FACTOR;
@@ -136,31 +137,31 @@ static inline float2 turbulentMotion(float2 position, float time, uint particleI
     float2 offset = float2(0.0);
 
     // Large-scale vortices (spatial + temporal)
-    offset.x += sin(fieldPos.y * TURBULENT_LARGE_FREQ_X +
+    offset.x += effectSin(fieldPos.y * TURBULENT_LARGE_FREQ_X +
                     time * 0.6 +
-                    baseSeed) * TURBULENT_LARGE_AMP;
+                    baseSeed, fastMath) * TURBULENT_LARGE_AMP;
 
-    offset.y += cos(fieldPos.x * TURBULENT_LARGE_FREQ_Y +
+    offset.y += effectCos(fieldPos.x * TURBULENT_LARGE_FREQ_Y +
                     time * 0.6 +
-                    baseSeed * TURBULENT_LARGE_FREQ_Y_MOD) * TURBULENT_LARGE_AMP;
+                    baseSeed * TURBULENT_LARGE_FREQ_Y_MOD, fastMath) * TURBULENT_LARGE_AMP;
 
     // Mid-scale turbulence
-    offset.x += cos(fieldPos.x * TURBULENT_MID_FREQ_X +
+    offset.x += effectCos(fieldPos.x * TURBULENT_MID_FREQ_X +
                     time * 1.1 +
-                    baseSeed * TURBULENT_MID_FREQ_X_MOD) * TURBULENT_MID_AMP;
+                    baseSeed * TURBULENT_MID_FREQ_X_MOD, fastMath) * TURBULENT_MID_AMP;
 
-    offset.y += sin(fieldPos.y * TURBULENT_MID_FREQ_Y +
+    offset.y += effectSin(fieldPos.y * TURBULENT_MID_FREQ_Y +
                     time * 1.1 +
-                    baseSeed * TURBULENT_MID_FREQ_Y_MOD) * TURBULENT_MID_AMP;
+                    baseSeed * TURBULENT_MID_FREQ_Y_MOD, fastMath) * TURBULENT_MID_AMP;
 
     // Small-scale jitter
-    offset.x += sin((fieldPos.x + fieldPos.y) * TURBULENT_SMALL_FREQ_X +
+    offset.x += effectSin((fieldPos.x + fieldPos.y) * TURBULENT_SMALL_FREQ_X +
                     time * 2.0 +
-                    baseSeed * TURBULENT_SMALL_FREQ_X_MOD) * TURBULENT_SMALL_AMP;
+                    baseSeed * TURBULENT_SMALL_FREQ_X_MOD, fastMath) * TURBULENT_SMALL_AMP;
 
-    offset.y += cos((fieldPos.y - fieldPos.x) * TURBULENT_SMALL_FREQ_Y +
+    offset.y += effectCos((fieldPos.y - fieldPos.x) * TURBULENT_SMALL_FREQ_Y +
                     time * 2.0 +
-                    baseSeed * TURBULENT_SMALL_FREQ_Y_MOD) * TURBULENT_SMALL_AMP;
+                    baseSeed * TURBULENT_SMALL_FREQ_Y_MOD, fastMath) * TURBULENT_SMALL_AMP;
 
     // Rare spatial impulses
     float jumpSeed = hash(floor(fieldPos.x * 3.0) +
@@ -178,22 +179,20 @@ static inline float2 turbulentMotion(float2 position, float time, uint particleI
 
 // Фрактальное хаотичное движение.
 // Используется как расширяемый вариант более "слоистого" motion-эффекта.
+// Фазы октав берутся из ParticleSeeds (считаются один раз на CPU).
 
-static inline float2 fractalChaos(float2 position, float time, uint particleId) {
+static inline float2 fractalChaos(float2 position, float time, uint particleId, ParticleSeeds seeds, bool fastMath = false) {
     float seed = float(particleId) + time * FRACTAL_SEED_TIME_SCALE;
     float2 movement = float2(0.0, 0.0);
-    
+
     float amplitude = 1.0;
     float frequency = 1.0;
-    
+
     for (uint i = 0; i < FRACTAL_OCTAVES; i++) {
-        float2 noisePos = float2(
-            hash(seed * frequency + float(i) * 13.0),
-            hash(seed * frequency * 1.7 + float(i) * 19.0)
-        );
-        
-        movement.x += sin(time * frequency * FRACTAL_FREQ_X_TIME + noisePos.x * TWO_PI) * amplitude;
-        movement.y += cos(time * frequency * FRACTAL_FREQ_Y_TIME + noisePos.y * TWO_PI) * amplitude;
+        float2 noisePos = float2(seeds.fractalPhaseX[i], seeds.fractalPhaseY[i]);
+
+        movement.x += effectSin(time * frequency * FRACTAL_FREQ_X_TIME + noisePos.x * TWO_PI, fastMath) * amplitude;
+        movement.y += effectCos(time * frequency * FRACTAL_FREQ_Y_TIME + noisePos.y * TWO_PI, fastMath) * amplitude;
         
         amplitude *= FRACTAL_AMPLITUDE_DECAY;
         frequency *= FRACTAL_FREQUENCY_SCALE;
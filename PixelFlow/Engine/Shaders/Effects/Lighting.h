@@ -41,14 +41,14 @@ using namespace metal;
 // GLOW FUNCTIONS
 // ============================================================================
 
-static inline float calculateGlow(float dist, float power, float intensity) {
+static inline float calculateGlow(float dist, float power, float intensity, bool fastMath = false) {
     float glow = 1.0 - dist;
-    glow = pow(max(glow, 0.0), power);
+    glow = effectPow(max(glow, 0.0), power, fastMath);
     return glow * clamp(intensity, 0.0, GLOW_MAX_INTENSITY);
 }
 
-static inline float3 applyParticleGlow(float3 baseColor, float dist, float power, float intensity) {
-    float glow = calculateGlow(dist, power, intensity);
+static inline float3 applyParticleGlow(float3 baseColor, float dist, float power, float intensity, bool fastMath = false) {
+    float glow = calculateGlow(dist, power, intensity, fastMath);
     return baseColor + float3(glow);
 }
 
@@ -96,11 +96,11 @@ static inline float calculateAmbientOcclusion2D(float2 position, float particleD
 // BLOOM EFFECT
 // ============================================================================
 
-static inline float3 applyBloomEffect(float3 color, float dist) {
+static inline float3 applyBloomEffect(float3 color, float dist, bool fastMath = false) {
     float brightness = dot(color, float3(0.299, 0.587, 0.114));
     if (brightness > BLOOM_THRESHOLD) {
         float bloomAmount = (brightness - BLOOM_THRESHOLD) / (1.0 - BLOOM_THRESHOLD);
-        float bloomGlow = calculateGlow(dist, 2.0, BLOOM_INTENSITY);
+        float bloomGlow = calculateGlow(dist, 2.0, BLOOM_INTENSITY, fastMath);
         float3 bloom = color * bloomAmount * bloomGlow * BLOOM_RADIUS;
         return color + bloom;
     }
@@ -116,11 +116,12 @@ static inline float3 applyLightScattering(
     float3 baseColor,
     float2 position,
     float2 lightSource,
-    float intensity
+    float intensity,
+    bool fastMath = false
 ) {
     float2 toLight = lightSource - position;
     float distance = length(toLight);
-    float scattering = exp(-distance * 0.001) * intensity;
+    float scattering = effectExp(-distance * 0.001, fastMath) * intensity;
     float3 scatteredLight = float3(1.0, 0.9, 0.8) * scattering;
     return baseColor + scatteredLight * 0.2;
 }
@@ -129,9 +130,9 @@ static inline float3 applyLightScattering(
 // RIM LIGHT
 // ============================================================================
 
-static inline float3 applyRimLight(float3 baseColor, float dist, float3 rimColor, float rimPower) {
+static inline float3 applyRimLight(float3 baseColor, float dist, float3 rimColor, float rimPower, bool fastMath = false) {
     float rim = smoothstep(0.3, 1.0, dist);
-    rim = pow(rim, rimPower);
+    rim = effectPow(rim, rimPower, fastMath);
     return baseColor + rimColor * rim * 0.3;
 }
 
@@ -145,7 +146,8 @@ static inline float3 applyStateLighting(
     float2 screenSize,
     float dist,
     float time,
-    int state
+    int state,
+    bool fastMath = false
 ) {
     float3 result = baseColor;
     float2 safeScreen = max(screenSize, float2(1.0));
@@ -159,17 +161,17 @@ static inline float3 applyStateLighting(
             result *= (1.0 + STORM_AMBIENT_BOOST);
 
             float2 stormLightSource = safeScreen * float2(
-                0.5 + 0.12 * sin(time * 0.9),
-                0.42 + 0.08 * cos(time * 1.3)
+                0.5 + 0.12 * effectSin(time * 0.9, fastMath),
+                0.42 + 0.08 * effectCos(time * 1.3, fastMath)
             );
-            result = applyLightScattering(result, position, stormLightSource, 0.75);
+            result = applyLightScattering(result, position, stormLightSource, 0.75, fastMath);
             result = applyGlobalLight(result, ndcPosition, float3(0.45, 0.65, 1.0), 0.14);
 
             if (flash > 0.5) {
                 float3 flashColor = float3(0.8, 0.9, 1.0) * flashIntensity;
                 result += flashColor * (1.0 - dist);
             }
-            result = applyRimLight(result, dist, float3(0.3, 0.5, 1.0), 3.0);
+            result = applyRimLight(result, dist, float3(0.3, 0.5, 1.0), 3.0, fastMath);
             break;
         }
         case SIMULATION_STATE_COLLECTING:
@@ -178,26 +180,26 @@ static inline float3 applyStateLighting(
             float occlusion = calculateAmbientOcclusion2D(position, collectionDensity);
             result = applyGlobalLight(result, ndcPosition, float3(0.95, 0.82, 0.62), 0.07);
             result *= occlusion;
-            float glow = calculateGlow(dist, 2.0, GLOW_BASE_INTENSITY * 0.7);
+            float glow = calculateGlow(dist, 2.0, GLOW_BASE_INTENSITY * 0.7, fastMath);
             result += float3(glow * 0.22);
             if (state == SIMULATION_STATE_COLLECTED) {
-                result = applyRimLight(result, dist, float3(1.0, 0.95, 0.75), 2.4);
+                result = applyRimLight(result, dist, float3(1.0, 0.95, 0.75), 2.4, fastMath);
             }
             break;
         }
         case SIMULATION_STATE_CHAOTIC: {
-            float pulse = sin(time * 3.0) * 0.5 + 0.5;
+            float pulse = effectSin(time * 3.0, fastMath) * 0.5 + 0.5;
             float dynamicIntensity = GLOW_BASE_INTENSITY * (0.8 + pulse * 0.4);
             result = applyGlobalLight(result, ndcPosition, float3(0.5, 0.55, 0.85), 0.08);
-            result += calculateGlow(dist, GLOW_FALLOFF_POWER, dynamicIntensity);
-            result = applyBloomEffect(result, dist);
+            result += calculateGlow(dist, GLOW_FALLOFF_POWER, dynamicIntensity, fastMath);
+            result = applyBloomEffect(result, dist, fastMath);
             break;
         }
         case SIMULATION_STATE_IDLE:
         default: {
             result = applyGlobalLight(result, ndcPosition, float3(0.15, 0.2, 0.32), 0.05);
             result *= calculateAmbientOcclusion2D(position, 0.55 + (1.0 - saturate(dist)) * 0.4);
-            float glow = calculateGlow(dist, 2.0, GLOW_BASE_INTENSITY * 0.5);
+            float glow = calculateGlow(dist, 2.0, GLOW_BASE_INTENSITY * 0.5, fastMath);
             result += float3(glow * 0.2);
             break;
         }
@@ -217,15 +219,73 @@ static inline float3 calculateParticle2DLighting(
     float dist,
     float time,
     int state,
-    float brightnessBoost
+    float brightnessBoost,
+    bool fastMath = false
 ) {
     float3 result = baseColor * brightnessBoost;
-    result = applyStateLighting(result, position, screenSize, dist, time, state);
-    result = applyBloomEffect(result, dist);
+    result = applyStateLighting(result, position, screenSize, dist, time, state, fastMath);
+    result = applyBloomEffect(result, dist, fastMath);
     result = max(result, float3(0.0));
     return result;
 }
 
+// ============================================================================
+// RADIAL PROFILE (LUT)
+// ============================================================================
+// Свечение, AO, bloomGlow и rim выше — чистые функции dist и состояния.
+// CPU запекает их в таблицы (ParticleSystem/Rendering/RadialProfileC.c —
+// держать синхронно!) по одной на состояние, фрагмент читает их вместо pow.
+// x — ambient occlusion, y — аддитивное свечение (в буре — stormCore),
+// z — bloomGlow * BLOOM_RADIUS, w — rim
+
+#define RADIAL_PROFILE_SIZE 128
+#define RADIAL_PROFILE_STATE_COUNT 6
+
+static inline float4 sampleRadialProfile(constant float4* profiles, int state, float dist) {
+    constant float4* table = profiles + clamp(state, 0, RADIAL_PROFILE_STATE_COUNT - 1) * RADIAL_PROFILE_SIZE;
+    float x = saturate(dist) * float(RADIAL_PROFILE_SIZE - 1);
+    int i = min(int(x), RADIAL_PROFILE_SIZE - 2);
+    return mix(table[i], table[i + 1], x - float(i));
+}
+
+/// applyBloomEffect с bloomGlow из профиля
+static inline float3 applyProfiledBloom(float3 color, float bloomGlow) {
+    float brightness = dot(color, float3(0.299, 0.587, 0.114));
+    if (brightness > BLOOM_THRESHOLD) {
+        float bloomAmount = (brightness - BLOOM_THRESHOLD) / (1.0 - BLOOM_THRESHOLD);
+        return color + color * bloomAmount * bloomGlow;
+    }
+    return color;
+}
+
+/// calculateParticle2DLighting для состояний, которые доходят до него из
+/// fragmentParticle: idle, collecting, swarm. Радиальная часть — из профиля.
+/// state и bloom — function constants, ветки по ним сворачиваются при сборке
+static inline float3 calculateProfiledParticle2DLighting(
+    float3 baseColor,
+    float2 position,
+    float2 screenSize,
+    float4 profile,
+    int state,
+    float brightnessBoost,
+    bool bloom
+) {
+    float3 result = baseColor * brightnessBoost;
+    float2 safeScreen = max(screenSize, float2(1.0));
+    float2 ndcPosition = (position / safeScreen) * 2.0 - 1.0;
+
+    if (state == SIMULATION_STATE_COLLECTING) {
+        result = applyGlobalLight(result, ndcPosition, float3(0.95, 0.82, 0.62), 0.07);
+    } else {
+        result = applyGlobalLight(result, ndcPosition, float3(0.15, 0.2, 0.32), 0.05);
+    }
+    result = result * profile.x + profile.y;
+    if (bloom) {
+        result = applyProfiledBloom(result, profile.z);
+    }
+    return max(result, float3(0.0));
+}
+
 // ============================================================================
 // SIMPLE LIGHTING (fast path)
 // ============================================================================
@@ -233,9 +293,10 @@ static inline float3 calculateParticle2DLighting(
 static inline float3 calculateSimple2DLighting(
     float3 baseColor,
     float dist,
-    float glowIntensity
+    float glowIntensity,
+    bool fastMath = false
 ) {
-    float glow = calculateGlow(dist, GLOW_FALLOFF_POWER, glowIntensity);
+    float glow = calculateGlow(dist, GLOW_FALLOFF_POWER, glowIntensity, fastMath);
     return baseColor + float3(glow);
 }
 
@@ -32,6 +32,7 @@ using namespace metal;
 // ============================================================================
 // КОНСТАНТЫ РЕНДЕРИНГА - ПАРАМЕТРЫ "ХУДОЖЕСТВЕННОГО СТИЛЯ"
 // ============================================================================
+// CPU-двойник: ParticleSystem/Rendering/PointSpriteRasterC.c — держать синхронно!
 
 // ОСНОВНЫЕ ПАРАМЕТРЫ ПРОЗРАЧНОСТИ
 #define PARTICLE_ALPHA_THRESHOLD 0.01   // Минимальная прозрачность для отрисовки
@@ -61,6 +62,7 @@ using namespace metal;
 #define LIGHTNING_ZIGZAG_AMOUNT 0.02       // Амплитуда зигзагов
 
 // СУБПИКСЕЛЬНЫЕ СМЕЩЕНИЯ - для плавности при низком разрешении
+// Значения считаются один раз на CPU (ParticleSeeds.c) — держать синхронно!
 #define SUBPIXEL_OFFSET_SCALE 0.5          // Масштаб смещения
 #define SUBPIXEL_OFFSET_CENTER 0.25        // Центр смещения
 #define SUBPIXEL_HASH_SEED_1 7.3           // Сид для X координаты
@@ -69,7 +71,8 @@ using namespace metal;
 // ЗАЩИТНЫЕ КОНСТАНТЫ
 #define MIN_PARTICLE_SIZE 0.1              // Минимальный размер частицы
 
-// РЕЖИМЫ КАЧЕСТВА ОСВЕЩЕНИЯ
+// РЕЖИМЫ КАЧЕСТВА ОСВЕЩЕНИЯ (specializedQuality, RenderQuality)
+// CPU: LIGHTING_QUALITY_*_C в RadialProfileC.h — держать синхронно!
 #define LIGHTING_QUALITY_LOW 0             // Только простое свечение
 #define LIGHTING_QUALITY_MEDIUM 1          // Свечение + эффекты состояний
 #define LIGHTING_QUALITY_HIGH 2            // Полное освещение с блумом
@@ -81,8 +84,10 @@ using namespace metal;
 // COLOR SPACE HELPERS
 // ============================================================================
 // Particle colors come from CGImage/PixelCache in sRGB space, while the MTKView
-// renders into an sRGB framebuffer (bgra8Unorm_srgb). Convert to linear before
-// applying lighting, so the GPU can do the correct sRGB encoding at output.
+// renders into an sRGB framebuffer (bgra8Unorm_srgb). Lighting works in linear,
+// so the GPU can do the correct sRGB encoding at output.
+// Assembly converts colors once (ColorSpaceC.h) and sets params.colorsLinear;
+// the conversion below stays only as a per-vertex fallback for sRGB buffers.
 static inline float3 srgbToLinear(float3 c) {
     float3 low = c / 12.92;
     float3 high = pow((c + 0.055) / 1.055, float3(2.4));
@@ -120,18 +125,17 @@ struct VertexOut {
 
     Это как добавление "случайности" к позициям,
     чтобы частицы не выглядели как на шахматной доске.
+
+    Само смещение в пикселях зависит только от id частицы и
+    берется из ParticleSeeds, здесь остается только перевод в clip space.
 */
-static inline float2 getSubpixelOffset(uint vid, float2 screenSize, uint pixelSizeMode) {
+static inline float2 getSubpixelOffset(float2 pixelOffset, float2 screenSize, uint pixelSizeMode) {
     // Если включен пиксель-перфект режим - отключаем смещение
     if (pixelSizeMode != 0) {
         return float2(0.0, 0.0);
     }
 
-    // Вычисляем случайное смещение для каждой частицы
-    return float2(
-        hash(float(vid) * SUBPIXEL_HASH_SEED_1) * SUBPIXEL_OFFSET_SCALE - SUBPIXEL_OFFSET_CENTER,
-        hash(float(vid) * SUBPIXEL_HASH_SEED_2) * SUBPIXEL_OFFSET_SCALE - SUBPIXEL_OFFSET_CENTER
-    ) / screenSize * 2.0;  // Нормализуем в clip space
+    return pixelOffset / screenSize * 2.0;  // Нормализуем в clip space
 }
 
 /*
@@ -143,10 +147,12 @@ static inline float2 getSubpixelOffset(uint vid, float2 screenSize, uint pixelSi
 vertex VertexOut vertexParticle(
     device const Particle* particles [[buffer(0)]],    // Буфер частиц
     constant SimulationParams * params [[buffer(1)]],   // Параметры симуляции
+    device const ParticleSeeds* particleSeeds [[buffer(2)]], // Предрасчитанные сиды
     uint vid [[vertex_id]]                             // ID вершины (номер частицы)
 ) {
     // Читаем частицу из буфера
     Particle p = particles[vid];
+    ParticleSeeds seeds = particleSeeds[vid];
    // float2 screenPos = p.position.xy;
 
     // ============================================================================
@@ -170,7 +176,7 @@ vertex VertexOut vertexParticle(
     VertexOut out;
 
     // Добавляем субпиксельное смещение для плавности в NDC space
-    float2 subpixelOffset = getSubpixelOffset(vid, params[0].screenSize, params[0].pixelSizeMode);
+    float2 subpixelOffset = getSubpixelOffset(seeds.subpixelOffset, params[0].screenSize, params[0].pixelSizeMode);
     // ndc уже в clip space [-1, 1], просто добавляем смещение и выводим
     out.position = float4(ndc + subpixelOffset, 0.0, 1.0);
 
@@ -196,7 +202,7 @@ vertex VertexOut vertexParticle(
     if (params[0].state == SIMULATION_STATE_LIGHTNING_STORM) {
         pixelSize *= mix(STORM_SIZE_MULTIPLIER_MIN,
                          STORM_SIZE_MULTIPLIER_MAX,
-                         hash(float(vid)));
+                         seeds.stormSizeJitter);
     }
 
     // pointSize всегда в пикселях
@@ -214,6 +220,12 @@ vertex VertexOut vertexParticle(
         clamp(p.color.a, 0.0, 1.0)
     );
 
+    // Фрагменты получают цвет уже в linear. Обычно он переведен при сборке,
+    // иначе — один раз на вершину, а не на каждый фрагмент
+    if (params[0].colorsLinear == 0) {
+        out.color.rgb = srgbToLinear(out.color.rgb);
+    }
+
     // Передаем параметры для fragment шейдера
     out.brightnessBoost = params[0].brightnessBoost;
     out.collectionSpeed = params[0].collectionSpeed;
@@ -225,6 +237,25 @@ vertex VertexOut vertexParticle(
     return out;
 }
 
+// ============================================================================
+// СПЕЦИАЛИЗАЦИЯ FRAGMENT ШЕЙДЕРА - FUNCTION CONSTANTS
+// ============================================================================
+
+/*
+    Состояние, качество освещения, pixel-perfect режим и fastMath одинаковы
+    для всех фрагментов кадра. Поэтому они задаются не из params, а при
+    сборке pipeline (MetalRenderer → RenderPipelineCache), и компилятор
+    вырезает ненужные ветки: в горячем пути не остается ни одного
+    ветвления по uniform.
+
+    Индексы держать синхронно с RenderPipelineCache.swift!
+    specializedState (индекс 0) объявлен в Compute/Simulation.h — общий с updateParticles.
+    CPU-эталон тех же вариантов: PointSpriteRasterC.c (RASTER_VARIANT).
+*/
+constant int specializedQuality [[function_constant(1)]];        // LIGHTING_QUALITY_*
+constant bool specializedPixelPerfect [[function_constant(2)]];  // pixelSizeMode != 0
+constant bool specializedFastMath [[function_constant(3)]];      // fastEffectsMath != 0
+
 // ============================================================================
 // FRAGMENT ШЕЙДЕР - РИСОВАНИЕ И ОСВЕЩЕНИЕ ЧАСТИЦ
 // ============================================================================
@@ -239,188 +270,219 @@ vertex VertexOut vertexParticle(
 */
 
 /*
-    ОСНОВНОЙ FRAGMENT ШЕЙДЕР
+    ЭЛЕКТРИЧЕСКАЯ БУРЯ ⚡ - САМЫЙ ДРАМАТИЧНЫЙ РЕЖИМ (MEDIUM / HIGH)
 
-    Рисует частицу с полным набором эффектов освещения.
-    Поддерживает разные режимы: буря, сбор, обычное состояние.
+    stormCore — канал y радиального профиля бури.
 */
-fragment float4 fragmentParticle(
-    VertexOut in [[stage_in]],                    // Данные от vertex шейдера
-    float2 pointCoord [[point_coord]],            // Координаты внутри частицы (0-1)
-    constant SimulationParams * params [[buffer(1)]] // Параметры симуляции
+static inline float3 stormParticleColor(
+    float2 uv,
+    float dist,
+    float stormCore,
+    float2 screenPos,
+    float2 screenSize,
+    float time,
+    bool fastMath
 ) {
-    // ============================================================================
-    // ПОДГОТОВКА КООРДИНАТ И ФОРМЫ ЧАСТИЦЫ
-    // ============================================================================
+    // Создаем "электрические" UV координаты с движением
+    float2 electricUV = uv * STORM_ELECTRIC_UV_SCALE +
+                       float2(time * STORM_TIME_SCALE_1,
+                             time * STORM_TIME_SCALE_2);
+
+    // Генерируем сид для псевдо-случайности
+    float electricSeed = dot(electricUV, float2(12.9898, 78.233));
+
+    // ДИНАМИЧЕСКИЕ ЭЛЕКТРИЧЕСКИЕ ЦВЕТА - постоянно меняются
+    float hue1 = hash(electricSeed) * TWO_PI + time * STORM_HUE_SPEED_1;
+    float hue2 = hash(electricSeed + 100.0) * TWO_PI + time * STORM_HUE_SPEED_2;
+
+    // Базовый цвет: электрический голубой/фиолетовый/бирюзовый
+    float3 col = float3(
+        0.0 + 0.8 * abs(effectSin(hue1, fastMath)),              // Красный канал
+        0.2 + 0.6 * abs(effectSin(hue1 + 1.57, fastMath)),       // Зеленый канал (сдвиг фазы)
+        0.8 + 0.2 * abs(effectSin(hue2, fastMath))               // Синий канал
+    );
 
-    // Преобразование координат: (0,0) центр → (-1,-1) край
-    float2 uv = pointCoord * 2.0 - 1.0;
-    float dist = length(uv);  // Расстояние от центра
+    // ДОБАВЛЯЕМ ТУРБУЛЕНТНОСТЬ - как плазма
+    float turbulence = hash(electricSeed + time * 2.0) * 0.3;
+    col += float3(0.1, 0.2, 0.4) * turbulence;
 
-    float alpha = 1.0;
-    if (params[0].pixelSizeMode == 0) {
-        // Создаем круглую форму с мягкими краями
-        alpha = 1.0 - smoothstep(1.0 - PARTICLE_EDGE_SOFTNESS, 1.0, dist);
+    // РЕДКИЕ ЯРКИЕ ИСКРЫ - впечатляющие вспышки
+    float sparkSeed = dot(uv * 100.0, float2(1.0, 1.0)) + time * 10.0;
+    if (hash(sparkSeed) > STORM_SPARK_THRESHOLD) {
+        col = float3(3.0, 3.0, 3.0);  // Белые вспышки
     }
 
-    // ============================================================================
-    // ВЫБОР ЦВЕТА В ЗАВИСИМОСТИ ОТ СОСТОЯНИЯ
-    // ============================================================================
+    // МЕЛКИЙ ЯДЕРНЫЙ ОРЕОЛ - делаем частицы визуально тоньше и "электричнее"
+    // (STORM_GLOW_BOOST * STORM_CORE_SOFTNESS уже в профиле)
+    col += float3(0.25, 0.45, 0.75) * stormCore;
 
-    float3 col;  // Финальный цвет частицы
-    float3 baseColor = srgbToLinear(in.color.rgb);
+    // ЭНЕРГЕТИЧЕСКИЕ ВОЛНЫ - модуляция яркости
+    float waveFreq = 8.0 + hash(electricSeed) * 4.0;
+    float wave = effectSin(time * waveFreq + dist * STORM_WAVE_SPATIAL_FREQ, fastMath) * 0.4 + 0.6;
+    col *= wave;
 
-    // Pixel-perfect режим: без освещения и эффектов, только исходный цвет.
-    // Это дает максимально точное соответствие исходному изображению.
-    if (params[0].pixelSizeMode != 0 && params[0].state != SIMULATION_STATE_LIGHTNING_STORM) {
-        return float4(baseColor, 1.0);
-    }
+    // МАКСИМАЛЬНОЕ УСИЛЕНИЕ ЯРКОСТИ для видимости бури
+    col *= STORM_BRIGHTNESS_MULTIPLIER;
 
-    // СПЕЦИАЛЬНАЯ ОБРАБОТКА ЭЛЕКТРИЧЕСКОЙ БУРИ ⚡
-    if (params[0].state == SIMULATION_STATE_LIGHTNING_STORM) {
-        // ========================================================================
-        // ЭЛЕКТРИЧЕСКАЯ БУРЯ - САМЫЙ ДРАМАТИЧНЫЙ РЕЖИМ
-        // ========================================================================
+    // ========================================================================
+    // МОЛНИИ - ZIGZAG ЭФФЕКТЫ ⚡ (SCREEN SPACE, КОРРЕКТНО)
+    // ========================================================================
 
-        // Создаем "электрические" UV координаты с движением
-        float2 electricUV = uv * STORM_ELECTRIC_UV_SCALE +
-                           float2(params[0].time * STORM_TIME_SCALE_1,
-                                 params[0].time * STORM_TIME_SCALE_2);
+    float boltTime = fmod(time * 0.3, LIGHTNING_BOLT_PERIOD);
 
-        // Генерируем сид для псевдо-случайности
-        float electricSeed = dot(electricUV, float2(12.9898, 78.233));
+    if (boltTime < LIGHTNING_BOLT_DURATION) {
+        float boltProgress = boltTime / LIGHTNING_BOLT_DURATION;
 
-        // ДИНАМИЧЕСКИЕ ЭЛЕКТРИЧЕСКИЕ ЦВЕТА - постоянно меняются
-        float hue1 = hash(electricSeed) * TWO_PI + params[0].time * STORM_HUE_SPEED_1;
-        float hue2 = hash(electricSeed + 100.0) * TWO_PI + params[0].time * STORM_HUE_SPEED_2;
+        // screenPos в пикселях → нормализуем в NDC
+        float2 pixelNDC = (screenPos / screenSize) * 2.0 - 1.0;
 
-        // Базовый цвет: электрический голубой/фиолетовый/бирюзовый
-        col = float3(
-            0.0 + 0.8 * abs(sin(hue1)),              // Красный канал
-            0.2 + 0.6 * abs(sin(hue1 + 1.57)),       // Зеленый канал (сдвиг фазы)
-            0.8 + 0.2 * abs(sin(hue2))               // Синий канал
+        // Глобальная молния в NDC
+        float2 boltStart = float2(
+            hash(floor(time) * 7.389) * 2.0 - 1.0,
+            1.0
         );
 
-        // ДОБАВЛЯЕМ ТУРБУЛЕНТНОСТЬ - как плазма
-        float turbulence = hash(electricSeed + params[0].time * 2.0) * 0.3;
-        col += float3(0.1, 0.2, 0.4) * turbulence;
+        float2 boltEnd = float2(
+            hash(floor(time) * 13.23) * 2.0 - 1.0,
+            -1.0
+        );
 
-        // РЕДКИЕ ЯРКИЕ ИСКРЫ - впечатляющие вспышки
-        float sparkSeed = dot(uv * 100.0, float2(1.0, 1.0)) + params[0].time * 10.0;
-        if (hash(sparkSeed) > STORM_SPARK_THRESHOLD) {
-            col = float3(3.0, 3.0, 3.0);  // Белые вспышки
-        }
+        float2 boltDir = normalize(boltEnd - boltStart);
+        float boltLength = length(boltEnd - boltStart);
 
-        // МЕЛКИЙ ЯДЕРНЫЙ ОРЕОЛ - делаем частицы визуально тоньше и "электричнее"
-        float stormCore = pow(max(1.0 - dist, 0.0), 3.2);
-        col += float3(0.25, 0.45, 0.75) * stormCore * STORM_GLOW_BOOST * STORM_CORE_SOFTNESS;
+        float2 toPixel = pixelNDC - boltStart;
+        float alongBolt = dot(toPixel, boltDir);
+        float2 closest = boltStart + boltDir * clamp(alongBolt, 0.0, boltLength);
+        float acrossBolt = length(pixelNDC - closest);
 
-        // ЭНЕРГЕТИЧЕСКИЕ ВОЛНЫ - модуляция яркости
-        float waveFreq = 8.0 + hash(electricSeed) * 4.0;
-        float wave = sin(params[0].time * waveFreq + length(uv) * STORM_WAVE_SPATIAL_FREQ) * 0.4 + 0.6;
-        col *= wave;
+        float core = effectExp(-acrossBolt / LIGHTNING_BOLT_WIDTH, fastMath);
 
-        // МАКСИМАЛЬНОЕ УСИЛЕНИЕ ЯРКОСТИ для видимости бури
-        col *= STORM_BRIGHTNESS_MULTIPLIER;
+        float zigzag = effectSin(alongBolt * LIGHTNING_ZIGZAG_FREQ
+                           + time * 20.0, fastMath)
+                       * LIGHTNING_ZIGZAG_AMOUNT;
 
-        // ========================================================================
-        // МОЛНИИ - ZIGZAG ЭФФЕКТЫ ⚡ (SCREEN SPACE, КОРРЕКТНО)
-        // ========================================================================
+        float zigzagMask = effectExp(-abs(zigzag) * 25.0, fastMath);
 
-        float boltTime = fmod(params[0].time * 0.3, LIGHTNING_BOLT_PERIOD);
+        float timeMask = smoothstep(0.0, 0.15, boltProgress) *
+                         smoothstep(1.0, 0.7, boltProgress);
 
-        if (boltTime < LIGHTNING_BOLT_DURATION) {
-            float boltProgress = boltTime / LIGHTNING_BOLT_DURATION;
+        float boltShape = core * zigzagMask * timeMask;
 
-            // screenPos в пикселях → нормализуем в NDC
-            float2 pixelNDC = (in.screenPos / params[0].screenSize) * 2.0 - 1.0;
+        col += float3(1.0, 1.0, 1.0) * boltShape * LIGHTNING_BOLT_BRIGHTNESS;
+    }
 
-            // Глобальная молния в NDC
-            float2 boltStart = float2(
-                hash(floor(params[0].time) * 7.389) * 2.0 - 1.0,
-                1.0
-            );
+    return col;
+}
 
-            float2 boltEnd = float2(
-                hash(floor(params[0].time) * 13.23) * 2.0 - 1.0,
-                -1.0
-            );
+/*
+    LIGHTING_QUALITY_LOW - РЕЖИМ ПРОИЗВОДИТЕЛЬНОСТИ (QualityPreset.draft)
 
-            float2 boltDir = normalize(boltEnd - boltStart);
-            float boltLength = length(boltEnd - boltStart);
+    Только простое свечение, без молний, блума и альфа-смешивания.
+    glow — канал y профиля качества LOW (RadialProfileC.c).
 
-            float2 toPixel = pixelNDC - boltStart;
-            float alongBolt = dot(toPixel, boltDir);
-            float2 closest = boltStart + boltDir * clamp(alongBolt, 0.0, boltLength);
-            float acrossBolt = length(pixelNDC - closest);
+    Минус эффекты - плюс FPS!
+*/
+static inline float4 lowQualityParticleColor(
+    float3 baseColor,
+    float2 uv,
+    float glow,
+    float brightnessBoost,
+    float time,
+    bool isStorm,
+    bool fastMath
+) {
+    float3 col;
+    if (isStorm) {
+        // Упрощенные цвета бури
+        float electricSeed = dot(uv, float2(12.9898, 78.233)) + time;
+        float hue = hash(electricSeed) * TWO_PI;
+        col = float3(
+            0.3 + 0.7 * effectSin(hue, fastMath),
+            0.4 + 0.6 * effectCos(hue, fastMath),
+            0.8
+        ) * 3.0;
+        col += float3(0.2, 0.4, 0.7) * glow;  // stormCore * STORM_CORE_SOFTNESS
+    } else {
+        col = clamp(baseColor * brightnessBoost, 0.0, 1.0) + glow;
+    }
+    return float4(col, 1.0);
+}
 
-            float core = exp(-acrossBolt / LIGHTNING_BOLT_WIDTH);
+/*
+    ОСНОВНОЙ FRAGMENT ШЕЙДЕР
 
-            float zigzag = sin(alongBolt * LIGHTNING_ZIGZAG_FREQ
-                               + params[0].time * 20.0)
-                           * LIGHTNING_ZIGZAG_AMOUNT;
+    Один шейдер на все уровни качества и состояния: вариант выбирается
+    function constants выше. Поддерживает разные режимы: буря, сбор,
+    обычное состояние.
+*/
+fragment float4 fragmentParticle(
+    VertexOut in [[stage_in]],                    // Данные от vertex шейдера
+    float2 pointCoord [[point_coord]],            // Координаты внутри частицы (0-1)
+    constant SimulationParams * params [[buffer(1)]], // Параметры симуляции
+    constant float4 * radialProfiles [[buffer(2)]]   // Радиальные профили (Lighting.h)
+) {
+    // ============================================================================
+    // ПОДГОТОВКА КООРДИНАТ И ФОРМЫ ЧАСТИЦЫ
+    // ============================================================================
 
-            float zigzagMask = exp(-abs(zigzag) * 25.0);
+    // Преобразование координат: (0,0) центр → (-1,-1) край
+    float2 uv = pointCoord * 2.0 - 1.0;
+    float dist = length(uv);  // Расстояние от центра
 
-            float timeMask = smoothstep(0.0, 0.15, boltProgress) *
-                             smoothstep(1.0, 0.7, boltProgress);
+    float3 baseColor = in.color.rgb;  // linear (см. vertexParticle)
+    const bool isStorm = specializedState == SIMULATION_STATE_LIGHTNING_STORM;
 
-            float boltShape = core * zigzagMask * timeMask;
+    // Свечение, AO, bloom и rim зависят только от dist — читаем из таблицы
+    float4 profile = sampleRadialProfile(radialProfiles, specializedState, dist);
 
-            col += float3(1.0, 1.0, 1.0) * boltShape * LIGHTNING_BOLT_BRIGHTNESS;
-        }
+    if (specializedQuality == LIGHTING_QUALITY_LOW) {
+        return lowQualityParticleColor(baseColor, uv, profile.y, in.brightnessBoost,
+                                       params[0].time, isStorm, specializedFastMath);
+    }
 
-    } else {
-        // ========================================================================
-        // ОБРАБОТКА ЦВЕТОВ ДЛЯ ВСЕХ СОСТОЯНИЙ КРОМЕ STORM
-        // ========================================================================
+    // Pixel-perfect режим: без освещения и эффектов, только исходный цвет.
+    // Это дает максимально точное соответствие исходному изображению.
+    if (specializedPixelPerfect && !isStorm) {
+        return float4(baseColor, 1.0);
+    }
 
-        // КРИТИЧНО: В режиме CHAOTIC просто выводим оригинальный цвет с свечением!
-        if (params[0].state == SIMULATION_STATE_CHAOTIC ||
-            params[0].state == SIMULATION_STATE_COLLECTED) {
-            // Берём оригинальный цвет БЕЗ каких-либо модификаций
-            col = baseColor;
-            
-            // Только добавляем мягкое свечение
-            float glow = pow(1.0 - dist, 2.5) * 0.2;
-            col += float3(glow);
-        } else {
-            // Для других режимов используем полное освещение
-            float localTime = params[0].time * getStateTimeScale(params[0].state);
-            col = calculateParticle2DLighting(
-                baseColor,              // Базовый цвет частицы (linear)
-                in.screenPos,           // Позиция на экране
-                params[0].screenSize,   // Размер экрана для NDC-освещения
-                dist,                   // Расстояние от центра
-                localTime,              // Адаптированное время
-                params[0].state,        // Текущее состояние
-                in.brightnessBoost      // Усиление яркости
-            );
-
-            // Дополнительные акценты для других состояний
-            float stateEnergy = 1.0;
-            float rimStrength = 0.0;
-
-            if (params[0].state == SIMULATION_STATE_IDLE) {
-                stateEnergy = 0.6;
-            }
+    // Круглая форма с мягкими краями (в pixel-perfect — квадрат)
+    float alpha = specializedPixelPerfect
+        ? 1.0
+        : 1.0 - smoothstep(1.0 - PARTICLE_EDGE_SOFTNESS, 1.0, dist);
 
-            if (params[0].state == SIMULATION_STATE_COLLECTING) {
-                rimStrength = 0.25;
-            }
+    // ============================================================================
+    // ВЫБОР ЦВЕТА В ЗАВИСИМОСТИ ОТ СОСТОЯНИЯ
+    // ============================================================================
 
-            if (params[0].state == SIMULATION_STATE_COLLECTED) {
-                stateEnergy = 1.0;
-                rimStrength = 0.45;
-            }
+    float3 col;  // Финальный цвет частицы
 
-            col *= stateEnergy;
+    if (isStorm) {
+        col = stormParticleColor(uv, dist, profile.y, in.screenPos, params[0].screenSize,
+                                 params[0].time, specializedFastMath);
+    } else if (specializedState == SIMULATION_STATE_CHAOTIC ||
+               specializedState == SIMULATION_STATE_COLLECTED) {
+        // КРИТИЧНО: В режиме CHAOTIC просто выводим оригинальный цвет с свечением!
+        col = baseColor + float3(profile.y);
+    } else {
+        // Для других режимов используем полное освещение (блум только в HIGH)
+        col = calculateProfiledParticle2DLighting(
+            baseColor,              // Базовый цвет частицы (linear)
+            in.screenPos,           // Позиция на экране
+            params[0].screenSize,   // Размер экрана для NDC-освещения
+            profile,                // Радиальный профиль состояния
+            specializedState,       // Текущее состояние
+            in.brightnessBoost,     // Усиление яркости
+            specializedQuality == LIGHTING_QUALITY_HIGH
+        );
 
-            if (rimStrength > 0.0) {
-                float rim = pow(1.0 - dist, 2.0);
-                col += float3(1.0, 0.9, 0.7) * rim * rimStrength;
-            }
+        // Дополнительные акценты для других состояний
+        if (specializedState == SIMULATION_STATE_IDLE) {
+            col *= 0.6;
         }
+
+        // Rim (в профиле collecting — 0.25 * (1 - dist)^2, у остальных 0)
+        col += float3(1.0, 0.9, 0.7) * profile.w;
     }
 
     // ============================================================================
@@ -429,7 +491,7 @@ fragment float4 fragmentParticle(
 
     float finalAlpha;
 
-    switch (params[0].state) {
+    switch (specializedState) {
         case SIMULATION_STATE_LIGHTNING_STORM: {
             // Буря: полная непрозрачность с контролем яркости
             finalAlpha = alpha;
@@ -451,13 +513,13 @@ fragment float4 fragmentParticle(
             // Усиливаем альфа для видимости ЗДЕСЬ, в рендеринге
             // Это не искажает исходные данные в PixelCache, только визуальное отображение
             float pixelAlpha = in.color.a;
-            
+
             // Если альфа низкая/средняя, усиливаем её для видимости
             if (pixelAlpha >= 0.1 && pixelAlpha < 0.8) {
                 // Усиливаем альфа: минимум 60%, максимум 100%
                 pixelAlpha = max(0.6, min(pixelAlpha * 2.0, 1.0));
             }
-            
+
             finalAlpha = alpha * pixelAlpha;
             break;
         }
@@ -465,55 +527,4 @@ fragment float4 fragmentParticle(
 
     return float4(col, finalAlpha);
 }
-
-// ============================================================================
-// АЛЬТЕРНАТИВНЫЙ FRAGMENT ШЕЙДЕР - РЕЖИМ ПРОИЗВОДИТЕЛЬНОСТИ
-// ============================================================================
-// Fast-path для будущего переключения качества. Сейчас основной pipeline его не вызывает.
-
-/*
-    УПРОЩЕННАЯ ВЕРСИЯ ДЛЯ МАКСИМАЛЬНОЙ ПРОИЗВОДИТЕЛЬНОСТИ
-
-    Используй эту версию когда нужно быстродействие, а не красота.
-    Замени fragmentParticle на fragmentParticlePerformance в pipeline.
-
-    Минус эффекты - плюс FPS!
-*/
-
-fragment float4 fragmentParticlePerformance(
-    VertexOut in [[stage_in]],
-    float2 pointCoord [[point_coord]],
-    constant SimulationParams * params [[buffer(1)]]
-) {
-    // Простая подготовка координат
-    float2 uv = pointCoord * 2.0 - 1.0;
-    float dist = length(uv);
-
-    // Простая круглая форма
-    // Форма частицы учитывается через dist в освещении ниже
-
-    // МИНИМАЛЬНОЕ ОСВЕЩЕНИЕ
-    float3 col;
-    float3 baseColor = srgbToLinear(in.color.rgb);
-
-    if (params[0].state == SIMULATION_STATE_LIGHTNING_STORM) {
-        // Упрощенные цвета бури
-        float electricSeed = dot(uv, float2(12.9898, 78.233)) + params[0].time;
-        float hue = hash(electricSeed) * TWO_PI;
-        col = float3(
-            0.3 + 0.7 * sin(hue),
-            0.4 + 0.6 * cos(hue),
-            0.8
-        ) * 3.0;
-        float stormCore = pow(max(1.0 - dist, 0.0), 3.0);
-        col += float3(0.2, 0.4, 0.7) * stormCore * STORM_CORE_SOFTNESS;
-    } else {
-        // Только простое свечение
-        float glow = pow(1.0 - dist, 2.5) * GLOW_BASE_INTENSITY;
-        col = clamp(baseColor * in.brightnessBoost, 0.0, 1.0) + glow;
-    }
-
-    float finalAlpha = 1.0;
-    return float4(col, finalAlpha);
-}
 #endif /* Basic_h */
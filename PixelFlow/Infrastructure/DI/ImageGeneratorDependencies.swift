@@ -102,8 +102,11 @@ final class ImageGeneratorDependencies {
         // Менеджер операций
         container.register(OperationManager(logger: logger), for: OperationManagerProtocol.self)
         
-        // Менеджер кэша
-        container.register(DefaultCacheManager(cacheSizeLimit: 100 * 1024 * 1024), for: CacheManagerProtocol.self) // 100 MB
+        // Менеджер кэша (512 MB): частицы квантованы — 4M занимают ~46 MB вместо 366 MB
+        container.register(
+            DefaultCacheManager(cacheSizeLimit: 512 * 1024 * 1024, particleEncoding: .quantized),
+            for: CacheManagerProtocol.self
+        )
         
         // Координатор генерации
         let coordinator = GenerationCoordinatorFactory.makeCoordinator(in: container)
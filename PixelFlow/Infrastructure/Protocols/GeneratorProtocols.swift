@@ -52,6 +52,10 @@ protocol PixelSamplerProtocol {
         screenSize: CGSize
     ) throws -> [Sample]
 
+    /// Декодирует пиксели изображения заранее — конвейер делает это параллельно
+    /// анализу; samplePixels затем берет их из кэша
+    func preparePixelCache(for image: CGImage) throws
+
     /// Стратегия сэмплинга
     var samplingStrategy: SamplingStrategy { get }
 
@@ -70,6 +74,17 @@ protocol ParticleAssemblerProtocol {
         originalImageSize: CGSize
     ) -> [Particle]
 
+    /// Собирает одну порцию — частицы сэмплов range (индексы глобальные,
+    /// результат совпадает с тем же диапазоном полной сборки)
+    func assembleParticleChunk(
+        from samples: [Sample],
+        range: Range<Int>,
+        config: ParticleGenerationConfig,
+        screenSize: CGSize,
+        imageSize: CGSize,
+        originalImageSize: CGSize
+    ) -> [Particle]
+
     // Валидирует частицы
     // func validateParticles(_ particles: [Particle]) -> Bool
 
@@ -85,6 +100,12 @@ protocol CacheManagerProtocol {
     /// Извлекает объект из кэша
     func retrieve<T: Codable>(_ type: T.Type, for key: String) throws -> T?
 
+    /// Сохраняет частицы в бинарном файле (ParticleCacheFileC.h)
+    func cacheParticles(_ particles: [Particle], for key: String) throws
+
+    /// Отображает кэшированные частицы в память без декодирования
+    func mapParticles(for key: String) -> ParticleCacheMapping?
+
     /// Проверяет наличие объекта в кэше
     func contains(key: String) -> Bool
 
@@ -255,12 +276,15 @@ protocol GenerationMetricsProtocol {
 
 /// Протокол для конвейера генерации частиц
 protocol GenerationPipelineProtocol {
-    /// Выполняет полный цикл генерации частиц
+    /// Выполняет полный цикл генерации частиц.
+    /// onChunk — частицы порциями по мере сборки, до возврата полного массива;
+    /// вызывается по порядку на последовательной фоновой очереди, параллельно сборке
     func execute(
         image: CGImage,
         config: ParticleGenerationConfig,
         screenSize: CGSize,
-        progress: @escaping (Float, String) -> Void
+        progress: @escaping (Float, String) -> Void,
+        onChunk: ((ParticleChunk) -> Void)?
     ) async throws -> [Particle]
 
     /// Выполняет отдельный этап генерации
@@ -304,14 +328,25 @@ protocol GenerationStrategyProtocol {
 
 /// Протокол для координатора генерации частиц
 protocol GenerationCoordinatorProtocol {
-    /// Генерирует частицы асинхронно
+    /// Генерирует частицы асинхронно; onChunk — порции по мере сборки (и из кэша)
     func generateParticles(
         from image: CGImage,
         config: ParticleGenerationConfig,
         screenSize: CGSize,
-        progress: @escaping (Float, String) -> Void
+        progress: @escaping (Float, String) -> Void,
+        onChunk: ((ParticleChunk) -> Void)?
     ) async throws -> [Particle]
 
+    /// Пакетная генерация: задания идут через общий пул потоков внахлест (этапы
+    /// разных изображений перекрываются) в пределах бюджета памяти memoryBudgetBytes.
+    /// onResult — по заданию (номер в jobs), в порядке завершения, с потока генерации.
+    /// Не блокирует одиночную генерацию; отмена — отменой вызывающей Task
+    func generateParticles(
+        batch jobs: [GenerationJob],
+        memoryBudgetBytes: Int,
+        onResult: @escaping (Int, Result<[Particle], Error>) -> Void
+    ) async -> BatchGenerationReport
+
     /// Отменяет генерацию
     func cancelGeneration()
 
@@ -349,6 +384,36 @@ enum GenerationStageOutput {
     case cached(Bool)
 }
 
+/// Порция потоковой генерации: частицы [startIndex, startIndex + particles.count)
+/// итогового массива. Приходят по возрастанию startIndex с потока генерации
+struct ParticleChunk {
+    let startIndex: Int
+    let particles: [Particle]
+}
+
+/// Задание пакетной генерации
+struct GenerationJob {
+    let image: CGImage
+    let config: ParticleGenerationConfig
+    let screenSize: CGSize
+}
+
+/// Итог пакетной генерации
+struct BatchGenerationReport {
+    /// Сгенерировано пайплайном
+    let generated: Int
+    /// Взято из кэша (память или диск)
+    let cached: Int
+    let failed: Int
+    let seconds: TimeInterval
+    /// Наибольшая одновременно зарезервированная оценка памяти заданий
+    let peakReservedBytes: Int
+
+    var imagesPerSecond: Double {
+        seconds > 0 ? Double(generated + cached) / seconds : 0
+    }
+}
+
 /// Протокол для валидатора конфигурации
 protocol ConfigurationValidatorProtocol {
     /// Валидирует конфигурацию генерации
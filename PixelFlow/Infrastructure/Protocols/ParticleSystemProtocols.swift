@@ -9,9 +9,14 @@
 import MetalKit
 import CoreGraphics
 
-/// Качество render pipeline в MetalRenderer.
+/// Качество render pipeline в MetalRenderer — уровень освещения
+/// специализированного fragmentParticle (LIGHTING_QUALITY_* в Basic.h).
 enum RenderQuality: Equatable {
+    /// HIGH: полное освещение с bloom
+    case high
+    /// MEDIUM: освещение без bloom
     case standard
+    /// LOW: упрощенное свечение
     case performance
 }
 
@@ -20,8 +25,20 @@ extension QualityPreset {
         switch self {
         case .draft:
             return .performance
-        case .standard, .high, .ultra:
+        case .standard:
             return .standard
+        case .high, .ultra:
+            return .high
+        }
+    }
+
+    /// Аппроксимации sin/cos/exp/pow в эффектах (ошибка sin 7.2e-6, cos 1.3e-5, pow 3.4e-5 абс., exp 4.4e-6 отн. — см. Shaders/shaders.md)
+    var usesFastEffectsMath: Bool {
+        switch self {
+        case .draft, .standard:
+            return true
+        case .high, .ultra:
+            return false
         }
     }
 }
@@ -96,12 +113,15 @@ protocol MetalRendererProtocol: AnyObject, MTKViewDelegate {
     /// Очищает Metal ресурсы
     func cleanup()
 
-    /// Устанавливает буфер частиц извне
-    func setParticleBuffer(_ buffer: MTLBuffer?)
+    /// Устанавливает кольцо буферов частиц хранилища
+    func setParticleRing(_ ring: ParticleBufferRing?)
 
-    /// Обновляет количество частиц
+    /// Обновляет количество частиц (только на паузе рендера)
     func updateParticleCount(_ count: Int)
 
+    /// Меняет количество частиц на границе следующего кадра — безопасно во время рендера
+    func requestParticleCount(_ count: Int)
+
     /// Устройство Metal
     var device: MTLDevice { get }
 
@@ -149,9 +169,24 @@ protocol SimulationEngineProtocol: AnyObject {
     /// Запускает молниеносную бурю
     func startLightningStorm()
 
+    /// Запускает режим роя (частицы расталкивают соседей)
+    func startSwarm()
+
+    /// Точки касаний (действуют в chaotic, lightningStorm и swarm)
+    var attractorField: AttractorField { get }
+
+    /// Добавляет или перемещает точку касания (position — NDC, radius — пиксели drawable)
+    func setAttractor(id: Int, position: SIMD2<Float>, radius: Float, strength: Float)
+
+    /// Убирает точку касания
+    func removeAttractor(id: Int)
+
     /// Обновляет прогресс сбора
     func updateProgress(_ progress: Float)
 
+    /// Очередь команд: ставить с любого потока, применяются в начале кадра
+    var commands: SimulationCommandQueue { get }
+
     /// Обновляет симуляцию с учётом времени
     func update(deltaTime: Float)
 
@@ -200,7 +235,10 @@ protocol PhysicsEngineProtocol: AnyObject {
 
 /// Протокол для хранилища частиц
 protocol ParticleStorageProtocol: AnyObject {
-    /// Буфер частиц
+    /// Кольцо буферов частиц (CPU пишет в свободный слот, GPU — в актуальный)
+    var particleRing: ParticleBufferRing { get }
+
+    /// Актуальный слот кольца частиц
     var particleBuffer: MTLBuffer? { get }
 
     /// Количество частиц
@@ -224,6 +262,15 @@ protocol ParticleStorageProtocol: AnyObject {
     /// Устанавливает высококачественные целевые частицы для сборки изображения
     func setHighQualityTargets(_ particles: [Particle])
 
+    /// Начало потоковой установки HQ-частиц: цели набираются порциями
+    func beginHighQualityStream()
+
+    /// Порция HQ-частиц: сразу пишется в буфер и в набираемые цели. Любой поток
+    func installHighQualityChunk(_ chunk: ParticleChunk)
+
+    /// Конец потока: набранные цели становятся HQ-целями. Возвращает число установленных частиц
+    func finishHighQualityStream() -> Int
+
     /// Применяет высококачественные целевые позиции к текущему буферу частиц
     func applyHighQualityTargetsToBuffer()
 
@@ -257,6 +304,17 @@ protocol ParticleGeneratorProtocol: AnyObject {
     /// Генерирует частицы из изображения
     func generateParticles(from image: CGImage, config: ParticleGenerationConfig, screenSize: CGSize) async throws -> [Particle]
 
+    /// То же, с порциями частиц по мере сборки (onChunk — по порядку, с фоновой очереди генерации)
+    func generateParticles(
+        from image: CGImage,
+        config: ParticleGenerationConfig,
+        screenSize: CGSize,
+        onChunk: @escaping (ParticleChunk) -> Void
+    ) async throws -> [Particle]
+
+    /// Заранее заполняет кэш генерации пакетом заданий; частицы не возвращаются
+    func prewarmCache(jobs: [GenerationJob], memoryBudgetBytes: Int) async -> BatchGenerationReport
+
     // Обновляет размер экрана
     // func updateScreenSize(_ size: CGSize)
 
@@ -0,0 +1,155 @@
+//
+//  AttractorFieldBench.c
+//  PixelFlow
+//
+//  Стоимость поля точек касаний (AttractorFieldC.c): маска тайлов против
+//  наивной проверки всех точек для каждой частицы. Наивный вариант — та же
+//  applyAttractorForcesC с маской, где у каждого тайла выставлены все биты,
+//  поэтому скорости обоих вариантов сверяются бит в бит.
+//  Таблица в ParticleSystem/particlesystem.md (AttractorFieldC) получена им.
+//
+//  Не входит в Xcode-таргет. Сборка на Linux/macOS из корня репозитория:
+//
+//    P=PixelFlow/Engine/ParticleSystem
+//    cc -O2 -std=c11 -I$P/Particles
+//       Tools/AttractorFieldBench/AttractorFieldBench.c
+//       $P/Particles/AttractorFieldC.c -lm -o attractor-field-bench
+//
+//  (одной командной строкой)
+//
+//  Запуск: ./attractor-field-bench [--particles N] [--passes N]
+//
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "AttractorFieldC.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Экран iPhone в пикселях drawable, страйд ParticleC (80 байт)
+#define BENCH_SCREEN_WIDTH 1170.0f
+#define BENCH_SCREEN_HEIGHT 2532.0f
+#define BENCH_STRIDE_FLOATS 20
+#define BENCH_DT (1.0f / 60.0f)
+#define BENCH_TILE_COUNT (ATTRACTOR_TILE_DIM_C * ATTRACTOR_TILE_DIM_C)
+
+typedef struct {
+    int attractors;
+    float radius;   // px
+} BenchCase;
+
+static const BenchCase cases[] = {
+    { 1, 120.0f }, { 4, 120.0f }, { 16, 120.0f },
+    { 1, 360.0f }, { 4, 360.0f }, { 16, 360.0f },
+};
+#define BENCH_CASE_COUNT ((int)(sizeof(cases) / sizeof(cases[0])))
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static float randomUnit(void) {
+    return (float)rand() / (float)RAND_MAX;
+}
+
+/// Лучший проход applyAttractorForcesC в нс/частица; velocities обнуляются перед каждым
+static double timeForces(const float* positions, float* velocities, int count, int passes,
+                         const AttractorPackedC* attractors, const uint16_t* masks, int* touched) {
+    double best = 1e30;
+    for (int pass = 0; pass < passes; pass++) {
+        for (int i = 0; i < count; i++) {
+            velocities[(size_t)i * BENCH_STRIDE_FLOATS] = 0.0f;
+            velocities[(size_t)i * BENCH_STRIDE_FLOATS + 1] = 0.0f;
+        }
+        double start = nowSeconds();
+        *touched = applyAttractorForcesC(positions, velocities, BENCH_STRIDE_FLOATS, count, BENCH_DT,
+                                         attractors, masks, BENCH_SCREEN_WIDTH, BENCH_SCREEN_HEIGHT);
+        double seconds = nowSeconds() - start;
+        if (seconds < best) best = seconds;
+    }
+    return best * 1e9 / (double)count;
+}
+
+int main(int argc, char** argv) {
+    int count = 300000;
+    int passes = 5;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--particles") == 0 && i + 1 < argc) {
+            count = atoi(argv[++i]);
+            if (count < 1) count = 1;
+        } else if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = atoi(argv[++i]);
+            if (passes < 1) passes = 1;
+        }
+    }
+
+    size_t floats = (size_t)count * BENCH_STRIDE_FLOATS;
+    float* particles = calloc(floats, sizeof(float));
+    float* culledVelocities = calloc(floats, sizeof(float));
+    float* naiveVelocities = calloc(floats, sizeof(float));
+    if (!particles || !culledVelocities || !naiveVelocities) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    srand(1);
+    for (int i = 0; i < count; i++) {
+        particles[(size_t)i * BENCH_STRIDE_FLOATS] = randomUnit() * 2.0f - 1.0f;
+        particles[(size_t)i * BENCH_STRIDE_FLOATS + 1] = randomUnit() * 2.0f - 1.0f;
+    }
+
+    printf("%d particles, stride %d bytes, screen %.0fx%.0f, best of %d passes\n",
+           count, (int)(BENCH_STRIDE_FLOATS * sizeof(float)), BENCH_SCREEN_WIDTH, BENCH_SCREEN_HEIGHT, passes);
+    printf("%6s %7s | %8s %12s %12s | %8s\n",
+           "points", "radius", "mask us", "culled ns", "naive ns", "touched");
+
+    for (int c = 0; c < BENCH_CASE_COUNT; c++) {
+        AttractorPackedC attractors[ATTRACTOR_MAX_COUNT_C];
+        srand(100 + c);
+        for (int a = 0; a < cases[c].attractors; a++) {
+            AttractorC attractor = {
+                .x = randomUnit() * 1.6f - 0.8f,
+                .y = randomUnit() * 1.6f - 0.8f,
+                .radius = cases[c].radius,
+                .strength = a == 0 ? 4.0f : -4.0f,
+            };
+            attractors[a] = packAttractorC(attractor);
+        }
+
+        uint16_t masks[BENCH_TILE_COUNT];
+        double maskBest = 1e30;
+        for (int pass = 0; pass < passes * 100; pass++) {
+            double start = nowSeconds();
+            buildAttractorTileMasksC(attractors, cases[c].attractors, BENCH_SCREEN_WIDTH, BENCH_SCREEN_HEIGHT, masks);
+            double seconds = nowSeconds() - start;
+            if (seconds < maskBest) maskBest = seconds;
+        }
+
+        uint16_t allMasks[BENCH_TILE_COUNT];
+        uint16_t allBits = (uint16_t)((1u << cases[c].attractors) - 1u);
+        for (int t = 0; t < BENCH_TILE_COUNT; t++) allMasks[t] = allBits;
+
+        int touched = 0, naiveTouched = 0;
+        double culled = timeForces(particles, culledVelocities, count, passes, attractors, masks, &touched);
+        double naive = timeForces(particles, naiveVelocities, count, passes, attractors, allMasks, &naiveTouched);
+
+        if (memcmp(culledVelocities, naiveVelocities, floats * sizeof(float)) != 0) {
+            fprintf(stderr, "culled and naive velocities differ for %d points, radius %.0f\n",
+                    cases[c].attractors, cases[c].radius);
+            return 1;
+        }
+
+        printf("%6d %4.0f px | %8.2f %12.1f %12.1f | %7.1f%%\n",
+               cases[c].attractors, cases[c].radius, maskBest * 1e6, culled, naive,
+               100.0 * (double)touched / (double)count);
+    }
+
+    free(particles);
+    free(culledVelocities);
+    free(naiveVelocities);
+    return 0;
+}
@@ -0,0 +1,732 @@
+//
+//  BatchGenerate.c
+//  PixelFlow
+//
+//  Пакетная генерация частиц по каталогу изображений (binary PPM, P6) —
+//  C-модель GenerationCoordinator.generateParticles(batch:) для замера
+//  пропускной способности планирования. Swift API инструмент не вызывает
+//  и его не измеряет: ни CoreGraphics-декодирования, ни TaskPool, ни
+//  Swift-этапов, ни проверки кэша. Цифры таблицы в Core/core.md — цифры
+//  этой модели. Каждое изображение — граф TaskGraphC на общем пуле:
+//
+//    decode → { analysis, score } → select → order → assembly → write
+//
+//  Графы разных изображений идут на пуле вперемешку; новое изображение
+//  стартует, когда его оценка памяти помещается в бюджет (--budget) и есть
+//  слот (потоков пула + 1). --sequential — по одному изображению, как
+//  одиночная генерация координатора.
+//
+//  Анализ и сэмплинг — C-упрощение Swift-этапов (ImageAnalyzer, PixelSampler
+//  с importance + uniform): те же проходы по пикселям, без CoreGraphics.
+//  Порядок — progressiveOrderC, сборка — раскладка и формулы ParticleAssembler
+//  (fit, NDC, linear-цвет, скорость), запись — particleCacheWriteC (QUANTIZED).
+//
+//  Не входит в Xcode-таргет. Сборка на Linux/macOS из корня репозитория:
+//
+//    G=PixelFlow/Engine/Generators/ImageParticleGenerator
+//    P=PixelFlow/Engine/ParticleSystem
+//    cc -O2 -std=c11 -pthread -I$G/Core -I$G/Caching -I$G/Sampling/Helpers -I$P/Particles
+//       Tools/BatchGenerate/BatchGenerate.c $G/Core/TaskGraphC.c
+//       $G/Caching/ParticleCacheFileC.c $G/Sampling/Helpers/ProgressiveOrderC.c
+//       $P/Particles/ColorSpaceC.c -lm -o batch-generate
+//
+//  (одной командной строкой)
+//
+//  Запуск: ./batch-generate <dir> [--out DIR] [--particles N] [--screen WxH]
+//          [--threads N] [--budget MB] [--repeat N] [--sequential]
+//  JPEG/PNG переводятся в PPM, например: mogrify -format ppm *.jpg
+//
+
+#define _DEFAULT_SOURCE
+
+#include "TaskGraphC.h"
+#include "ParticleCacheFileC.h"
+#include "ProgressiveOrderC.h"
+#include "PixelSampler.h"
+#include "ColorSpaceC.h"
+#include "SimulationStepC.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+// Параметры ParticleGenerationConfig.standard и ParticleAssembler
+#define CONTRAST_WEIGHT          0.4f
+#define SATURATION_WEIGHT        0.3f
+#define IMPORTANT_SAMPLING_RATIO 0.7f
+#define LOW_CONTRAST             0.1f   // ниже — половина доли importance, остальное равномерно
+#define QUALITY_MULTIPLIER       1.5f   // QualityMultipliers.standard
+#define MAX_SPEED_NDC            0.5f
+#define VELOCITY_BASE            0.1f
+#define CHAOS_FACTOR             0.5f
+
+#define ANALYSIS_MAX_SIDE        2048   // анализ по копии не больше 2048 px, как ImageAnalyzer
+#define SCORE_BINS               1024
+#define SCORE_MAX                (2.0f * CONTRAST_WEIGHT + SATURATION_WEIGHT)
+#define ROW_GRAIN                64     // строк в порции score
+#define PARTICLE_GRAIN           16384  // частиц в порции сборки (GenerationPipeline)
+#define ORDER_SEED               0x5EEDu
+
+#define WRITE_PRIORITY           -1     // запись ниже этапов генерации
+
+enum { STAGE_DECODE, STAGE_ANALYSIS, STAGE_SCORE, STAGE_SELECT, STAGE_ORDER, STAGE_ASSEMBLY, STAGE_WRITE, STAGE_COUNT };
+
+static const char* const stageNames[STAGE_COUNT] = {
+    "decode", "analysis", "score", "select", "order", "assembly", "write"
+};
+
+// MARK: - Job
+
+typedef struct {
+    char path[1024];
+    char outPath[1024];
+    int width;
+    int height;
+    long pixelOffset;        // начало пикселей в файле
+    int64_t reservedBytes;
+
+    int particleTarget;
+    float screenWidth;
+    float screenHeight;
+
+    uint8_t* rgb;            // decode
+    float* score;            // score: важность пикселя
+    float contrast;          // analysis: СКО яркости
+    SampleC* samples;        // select
+    int sampleCount;
+    uint32_t* order;         // order
+    ParticleC* particles;    // assembly
+    uint64_t fileSize;       // write
+
+    TaskGraphC* graph;
+    int32_t status;
+} Job;
+
+/// Учет бюджета и слотов: главный поток ждет, завершения заданий освобождают
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    int64_t budgetBytes;
+    int64_t reservedBytes;
+    int64_t peakReservedBytes;
+    int inFlight;
+    int completed;
+    int failed;
+} Admission;
+
+static Admission admission = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .changed = PTHREAD_COND_INITIALIZER,
+};
+
+static _Atomic uint64_t stageNanoseconds[STAGE_COUNT];
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t nowNanoseconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void addStageTime(int stage, uint64_t start) {
+    atomic_fetch_add_explicit(&stageNanoseconds[stage], nowNanoseconds() - start, memory_order_relaxed);
+}
+
+static void freeJobBuffers(Job* job) {
+    free(job->rgb);
+    free(job->score);
+    free(job->samples);
+    free(job->order);
+    free(job->particles);
+    job->rgb = NULL;
+    job->score = NULL;
+    job->samples = NULL;
+    job->order = NULL;
+    job->particles = NULL;
+}
+
+// MARK: - PPM
+
+static int skipSpaceAndComments(FILE* file) {
+    int c;
+    while ((c = fgetc(file)) != EOF) {
+        if (c == '#') {
+            while ((c = fgetc(file)) != EOF && c != '\n') {}
+        } else if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            ungetc(c, file);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/// Заголовок P6 с maxval 255: размер и смещение пикселей
+static int readPPMHeader(const char* path, int* width, int* height, long* pixelOffset) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return 0;
+    int maxValue = 0;
+    int ok = fgetc(file) == 'P' && fgetc(file) == '6'
+        && skipSpaceAndComments(file) && fscanf(file, "%d", width) == 1
+        && skipSpaceAndComments(file) && fscanf(file, "%d", height) == 1
+        && skipSpaceAndComments(file) && fscanf(file, "%d", &maxValue) == 1
+        && maxValue == 255 && *width > 0 && *height > 0
+        && fgetc(file) != EOF;
+    if (ok) *pixelOffset = ftell(file);
+    fclose(file);
+    return ok;
+}
+
+// MARK: - Stages
+
+static int decodeWork(void* context, uint64_t begin, uint64_t end) {
+    (void)begin; (void)end;
+    Job* job = context;
+    uint64_t start = nowNanoseconds();
+    size_t size = (size_t)job->width * (size_t)job->height * 3;
+
+    job->rgb = malloc(size);
+    job->score = malloc(sizeof(float) * (size_t)job->width * (size_t)job->height);
+    FILE* file = fopen(job->path, "rb");
+    int ok = job->rgb && job->score && file
+        && fseek(file, job->pixelOffset, SEEK_SET) == 0
+        && fread(job->rgb, 1, size, file) == size;
+    if (file) fclose(file);
+    if (!ok) fprintf(stderr, "cannot decode %s\n", job->path);
+
+    addStageTime(STAGE_DECODE, start);
+    return ok;
+}
+
+static inline float lumaAt(const uint8_t* rgb) {
+    return (0.299f * rgb[0] + 0.587f * rgb[1] + 0.114f * rgb[2]) * (1.0f / 255.0f);
+}
+
+/// Глобальная статистика по прореженной копии (как анализ по уменьшенному изображению)
+static int analysisWork(void* context, uint64_t begin, uint64_t end) {
+    (void)begin; (void)end;
+    Job* job = context;
+    uint64_t start = nowNanoseconds();
+
+    int side = job->width > job->height ? job->width : job->height;
+    int step = (side + ANALYSIS_MAX_SIDE - 1) / ANALYSIS_MAX_SIDE;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    uint64_t count = 0;
+    for (int y = 0; y < job->height; y += step) {
+        const uint8_t* row = job->rgb + (size_t)y * (size_t)job->width * 3;
+        for (int x = 0; x < job->width; x += step) {
+            double luma = lumaAt(row + (size_t)x * 3);
+            sum += luma;
+            sumSquares += luma * luma;
+            count++;
+        }
+    }
+    double mean = sum / (double)count;
+    double variance = sumSquares / (double)count - mean * mean;
+    job->contrast = variance > 0.0 ? (float)sqrt(variance) : 0.0f;
+
+    addStageTime(STAGE_ANALYSIS, start);
+    return 1;
+}
+
+/// Важность пикселя: градиент яркости и насыщенность — порции по строкам
+static int scoreWork(void* context, uint64_t begin, uint64_t end) {
+    Job* job = context;
+    uint64_t start = nowNanoseconds();
+    const int width = job->width;
+    const int height = job->height;
+    const size_t stride = (size_t)width * 3;
+
+    for (int y = (int)begin; y < (int)end; y++) {
+        const uint8_t* row = job->rgb + (size_t)y * stride;
+        const uint8_t* up = y > 0 ? row - stride : row;
+        const uint8_t* down = y + 1 < height ? row + stride : row;
+        float* out = job->score + (size_t)y * (size_t)width;
+        for (int x = 0; x < width; x++) {
+            const uint8_t* pixel = row + (size_t)x * 3;
+            const uint8_t* left = x > 0 ? pixel - 3 : pixel;
+            const uint8_t* right = x + 1 < width ? pixel + 3 : pixel;
+            float gradient = fabsf(lumaAt(right) - lumaAt(left)) + fabsf(lumaAt(down + (size_t)x * 3) - lumaAt(up + (size_t)x * 3));
+
+            uint8_t maxValue = pixel[0] > pixel[1] ? pixel[0] : pixel[1];
+            uint8_t minValue = pixel[0] < pixel[1] ? pixel[0] : pixel[1];
+            if (pixel[2] > maxValue) maxValue = pixel[2];
+            if (pixel[2] < minValue) minValue = pixel[2];
+            float saturation = maxValue > 0 ? (float)(maxValue - minValue) / (float)maxValue : 0.0f;
+
+            out[x] = CONTRAST_WEIGHT * gradient + SATURATION_WEIGHT * saturation;
+        }
+    }
+
+    addStageTime(STAGE_SCORE, start);
+    return 1;
+}
+
+static inline void appendSample(Job* job, uint8_t* taken, int x, int y) {
+    size_t index = (size_t)y * (size_t)job->width + (size_t)x;
+    if (taken[index >> 3] & (1u << (index & 7))) return;
+    taken[index >> 3] |= (uint8_t)(1u << (index & 7));
+
+    const uint8_t* pixel = job->rgb + index * 3;
+    job->samples[job->sampleCount++] = (SampleC){
+        .x = x, .y = y,
+        .r = pixel[0] * (1.0f / 255.0f),
+        .g = pixel[1] * (1.0f / 255.0f),
+        .b = pixel[2] * (1.0f / 255.0f),
+        .a = 1.0f,
+    };
+}
+
+/// Доля importance — самые важные пиксели (порог по гистограмме, равномерно
+/// по отобранным), остальное — равномерная сетка. Пиксели больше не нужны
+static int selectWork(void* context, uint64_t begin, uint64_t end) {
+    (void)begin; (void)end;
+    Job* job = context;
+    uint64_t start = nowNanoseconds();
+    const size_t pixelCount = (size_t)job->width * (size_t)job->height;
+    int target = job->particleTarget;
+    if ((size_t)target > pixelCount) target = (int)pixelCount;
+
+    float ratio = job->contrast < LOW_CONTRAST ? IMPORTANT_SAMPLING_RATIO * 0.5f : IMPORTANT_SAMPLING_RATIO;
+    int importantCount = (int)((float)target * ratio);
+
+    job->samples = malloc(sizeof(SampleC) * (size_t)(target > 0 ? target : 1));
+    uint8_t* taken = calloc((pixelCount + 7) / 8, 1);
+    uint64_t* histogram = calloc(SCORE_BINS, sizeof(uint64_t));
+    if (!job->samples || !taken || !histogram) {
+        free(taken);
+        free(histogram);
+        addStageTime(STAGE_SELECT, start);
+        return 0;
+    }
+    job->sampleCount = 0;
+
+    const float binScale = (float)SCORE_BINS / SCORE_MAX;
+    for (size_t i = 0; i < pixelCount; i++) {
+        int bin = (int)(job->score[i] * binScale);
+        histogram[bin < SCORE_BINS ? bin : SCORE_BINS - 1]++;
+    }
+    int thresholdBin = SCORE_BINS - 1;
+    uint64_t candidates = histogram[thresholdBin];
+    while (thresholdBin > 0 && candidates < (uint64_t)importantCount) {
+        candidates += histogram[--thresholdBin];
+    }
+
+    if (importantCount > 0 && candidates > 0) {
+        const float threshold = (float)thresholdBin / binScale;
+        const double step = (double)candidates / (double)importantCount;
+        double next = 0.0;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < pixelCount && job->sampleCount < importantCount; i++) {
+            if (job->score[i] < threshold) continue;
+            if ((double)seen++ < next) continue;
+            next += step;
+            appendSample(job, taken, (int)(i % (size_t)job->width), (int)(i / (size_t)job->width));
+        }
+    }
+
+    int uniformCount = target - job->sampleCount;
+    if (uniformCount > 0) {
+        double aspect = (double)job->width / (double)job->height;
+        int gridHeight = (int)sqrt((double)uniformCount / aspect);
+        if (gridHeight < 1) gridHeight = 1;
+        int gridWidth = (int)ceil((double)uniformCount / (double)gridHeight);
+        for (int gy = 0; gy < gridHeight && job->sampleCount < target; gy++) {
+            int y = (int)(((double)gy + 0.5) * job->height / gridHeight);
+            for (int gx = 0; gx < gridWidth && job->sampleCount < target; gx++) {
+                appendSample(job, taken, (int)(((double)gx + 0.5) * job->width / gridWidth), y);
+            }
+        }
+    }
+
+    free(taken);
+    free(histogram);
+    free(job->rgb);
+    free(job->score);
+    job->rgb = NULL;
+    job->score = NULL;
+
+    addStageTime(STAGE_SELECT, start);
+    return job->sampleCount > 0;
+}
+
+static int orderWork(void* context, uint64_t begin, uint64_t end) {
+    (void)begin; (void)end;
+    Job* job = context;
+    uint64_t start = nowNanoseconds();
+    int count = job->sampleCount;
+
+    int32_t* coordinates = malloc(sizeof(int32_t) * 2 * (size_t)count);
+    job->order = malloc(sizeof(uint32_t) * (size_t)count);
+    int ok = coordinates && job->order;
+    if (ok) {
+        for (int i = 0; i < count; i++) {
+            coordinates[2 * i] = job->samples[i].x;
+            coordinates[2 * i + 1] = job->samples[i].y;
+        }
+        ok = progressiveOrderC(coordinates, count, job->width, job->height, 0, ORDER_SEED, job->order) == 0;
+    }
+    free(coordinates);
+    job->particles = ok ? malloc(sizeof(ParticleC) * (size_t)count) : NULL;
+
+    addStageTime(STAGE_ORDER, start);
+    return ok && job->particles;
+}
+
+static inline uint32_t xorshift32(uint32_t* value) {
+    uint32_t x = *value;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *value = x;
+    return x;
+}
+
+/// Формулы ParticleAssembler: fit по экрану, NDC с инверсией Y, linear-цвет
+static int assemblyWork(void* context, uint64_t begin, uint64_t end) {
+    Job* job = context;
+    uint64_t start = nowNanoseconds();
+    if (end > (uint64_t)job->sampleCount) end = (uint64_t)job->sampleCount;
+
+    const float scaleX = job->screenWidth / (float)job->width;
+    const float scaleY = job->screenHeight / (float)job->height;
+    const float scale = scaleX < scaleY ? scaleX : scaleY;
+    const float offsetX = (job->screenWidth - (float)job->width * scale) * 0.5f;
+    const float offsetY = (job->screenHeight - (float)job->height * scale) * 0.5f;
+    float size = ceilf(scale);
+    if (size < 1.0f) size = 1.0f;
+    size *= QUALITY_MULTIPLIER;
+
+    for (uint64_t k = begin; k < end; k++) {
+        const SampleC* sample = &job->samples[job->order[k]];
+        ParticleC* particle = &job->particles[k];
+        memset(particle, 0, sizeof(*particle));
+
+        float screenX = offsetX + ((float)sample->x + 0.5f) * scale;
+        float screenY = offsetY + ((float)sample->y + 0.5f) * scale;
+        particle->position[0] = screenX / job->screenWidth * 2.0f - 1.0f;
+        particle->position[1] = (1.0f - screenY / job->screenHeight) * 2.0f - 1.0f;
+        memcpy(particle->targetPosition, particle->position, sizeof(particle->position));
+
+        particle->color[0] = srgbToLinearLUTC(sample->r);
+        particle->color[1] = srgbToLinearLUTC(sample->g);
+        particle->color[2] = srgbToLinearLUTC(sample->b);
+        particle->color[3] = sample->a;
+        memcpy(particle->originalColor, particle->color, sizeof(particle->color));
+
+        particle->size = size;
+        particle->baseSize = size;
+
+        uint32_t seed = ((uint32_t)sample->x * 73856093u) ^ ((uint32_t)sample->y * 19349663u) ^ (uint32_t)k;
+        float chaos = CHAOS_FACTOR + (float)(xorshift32(&seed) % 200u) / 1000.0f;
+        float vx = -VELOCITY_BASE + (float)(xorshift32(&seed) % 500u) / 1000.0f;
+        float vy = -VELOCITY_BASE + (float)(xorshift32(&seed) % 500u) / 1000.0f;
+        particle->velocity[0] = vx * MAX_SPEED_NDC * chaos;
+        particle->velocity[1] = vy * MAX_SPEED_NDC * chaos;
+    }
+
+    addStageTime(STAGE_ASSEMBLY, start);
+    return 1;
+}
+
+static int writeWork(void* context, uint64_t begin, uint64_t end) {
+    (void)begin; (void)end;
+    Job* job = context;
+    uint64_t start = nowNanoseconds();
+    int ok = 1;
+    if (job->outPath[0]) {
+        ok = particleCacheWriteC(job->outPath, job->particles, (uint64_t)job->sampleCount,
+                                 PARTICLE_CACHE_ENCODING_QUANTIZED, &job->fileSize) == PARTICLE_CACHE_OK;
+        if (!ok) fprintf(stderr, "cannot write %s\n", job->outPath);
+    }
+    addStageTime(STAGE_WRITE, start);
+    return ok;
+}
+
+// MARK: - Scheduling
+
+static void jobCompleted(int32_t status, void* context) {
+    Job* job = context;
+    job->status = status;
+    freeJobBuffers(job);
+
+    pthread_mutex_lock(&admission.lock);
+    admission.reservedBytes -= job->reservedBytes;
+    admission.inFlight--;
+    admission.completed++;
+    if (status != TASK_GRAPH_OK) admission.failed++;
+    pthread_cond_broadcast(&admission.changed);
+    pthread_mutex_unlock(&admission.lock);
+}
+
+/// Оценка как у координатора: пиксели, промежуточная карта и частицы со сэмплами
+static int64_t estimateJobBytes(const Job* job) {
+    int64_t pixels = (int64_t)job->width * job->height;
+    int64_t particles = job->particleTarget;
+    return pixels * (3 + (int64_t)sizeof(float)) + pixels / 8
+        + particles * (int64_t)(sizeof(SampleC) + sizeof(uint32_t) + sizeof(ParticleC));
+}
+
+static TaskGraphC* buildJobGraph(Job* job) {
+    TaskGraphC* graph = taskGraphCreateC();
+    if (!graph) return NULL;
+    const double pixels = (double)job->width * job->height;
+    const double particles = job->particleTarget;
+    const double analysisPixels = pixels < (double)ANALYSIS_MAX_SIDE * ANALYSIS_MAX_SIDE
+        ? pixels : (double)ANALYSIS_MAX_SIDE * ANALYSIS_MAX_SIDE;
+
+    int32_t decode = taskGraphAddNodeC(graph, decodeWork, job, 1, 0, 0, pixels);
+    int32_t analysis = taskGraphAddNodeC(graph, analysisWork, job, 1, 0, 0, analysisPixels);
+    int32_t score = taskGraphAddNodeC(graph, scoreWork, job, (uint64_t)job->height, ROW_GRAIN, 0, pixels);
+    int32_t select = taskGraphAddNodeC(graph, selectWork, job, 1, 0, 0, pixels);
+    int32_t order = taskGraphAddNodeC(graph, orderWork, job, 1, 0, 0, particles);
+    int32_t assembly = taskGraphAddNodeC(graph, assemblyWork, job, (uint64_t)job->particleTarget, PARTICLE_GRAIN, 0, particles);
+    int32_t write = taskGraphAddNodeC(graph, writeWork, job, 1, 0, WRITE_PRIORITY, particles);
+
+    // Число частиц узнаем только после select: сборка режется по цели, лишние порции пустые
+    int ok = decode >= 0 && analysis >= 0 && score >= 0 && select >= 0 && order >= 0 && assembly >= 0 && write >= 0
+        && taskGraphAddDependencyC(graph, analysis, decode)
+        && taskGraphAddDependencyC(graph, score, decode)
+        && taskGraphAddDependencyC(graph, select, analysis)
+        && taskGraphAddDependencyC(graph, select, score)
+        && taskGraphAddDependencyC(graph, order, select)
+        && taskGraphAddDependencyC(graph, assembly, order)
+        && taskGraphAddDependencyC(graph, write, assembly);
+    if (!ok) {
+        taskGraphDestroyC(graph);
+        return NULL;
+    }
+    return graph;
+}
+
+/// Ждет места в бюджете и слота. Задание дороже бюджета идет одно
+static void admit(Job* job, int maxInFlight) {
+    pthread_mutex_lock(&admission.lock);
+    while (admission.inFlight >= maxInFlight
+           || (admission.inFlight > 0 && admission.reservedBytes + job->reservedBytes > admission.budgetBytes)) {
+        pthread_cond_wait(&admission.changed, &admission.lock);
+    }
+    admission.inFlight++;
+    admission.reservedBytes += job->reservedBytes;
+    if (admission.reservedBytes > admission.peakReservedBytes) {
+        admission.peakReservedBytes = admission.reservedBytes;
+    }
+    pthread_mutex_unlock(&admission.lock);
+}
+
+static void waitForAll(void) {
+    pthread_mutex_lock(&admission.lock);
+    while (admission.inFlight > 0) {
+        pthread_cond_wait(&admission.changed, &admission.lock);
+    }
+    pthread_mutex_unlock(&admission.lock);
+}
+
+// MARK: - Directory
+
+static int hasPPMExtension(const char* name) {
+    size_t length = strlen(name);
+    return length > 4 && strcmp(name + length - 4, ".ppm") == 0;
+}
+
+static int compareJobs(const void* a, const void* b) {
+    return strcmp(((const Job*)a)->path, ((const Job*)b)->path);
+}
+
+/// Задания по *.ppm каталога (по имени); заголовки читаются сразу — для оценки памяти
+static Job* scanDirectory(const char* directory, const char* outDirectory, int* jobCount) {
+    DIR* dir = opendir(directory);
+    if (!dir) return NULL;
+
+    Job* jobs = NULL;
+    int count = 0;
+    int capacity = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (!hasPPMExtension(entry->d_name)) continue;
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            Job* grown = realloc(jobs, sizeof(Job) * (size_t)capacity);
+            if (!grown) break;
+            jobs = grown;
+        }
+        Job* job = &jobs[count];
+        memset(job, 0, sizeof(*job));
+        snprintf(job->path, sizeof(job->path), "%s/%s", directory, entry->d_name);
+        if (!readPPMHeader(job->path, &job->width, &job->height, &job->pixelOffset)) {
+            fprintf(stderr, "skipping %s: not a binary PPM (P6, maxval 255)\n", job->path);
+            continue;
+        }
+        if (outDirectory) {
+            size_t nameLength = strlen(entry->d_name) - 4;
+            snprintf(job->outPath, sizeof(job->outPath), "%s/%.*s.pfpc", outDirectory, (int)nameLength, entry->d_name);
+        }
+        count++;
+    }
+    closedir(dir);
+
+    if (jobs) qsort(jobs, (size_t)count, sizeof(Job), compareJobs);
+    *jobCount = count;
+    return jobs;
+}
+
+// MARK: - Main
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <dir> [--out DIR] [--particles N] [--screen WxH] [--threads N] "
+                        "[--budget MB] [--repeat N] [--sequential]\n", argv[0]);
+        return 2;
+    }
+
+    const char* directory = argv[1];
+    const char* outDirectory = NULL;
+    int particleTarget = 100000;
+    int screenWidth = 1179;
+    int screenHeight = 2556;
+    int threads = 0;
+    int64_t budgetMB = 512;
+    int repeat = 1;
+    int sequential = 0;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outDirectory = argv[++i];
+        } else if (strcmp(argv[i], "--particles") == 0 && i + 1 < argc) {
+            particleTarget = atoi(argv[++i]);
+            if (particleTarget < 1) particleTarget = 1;
+        } else if (strcmp(argv[i], "--screen") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &screenWidth, &screenHeight) != 2 || screenWidth < 1 || screenHeight < 1) {
+                screenWidth = 1179;
+                screenHeight = 2556;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+            if (threads < 0) threads = 0;
+        } else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            budgetMB = atoll(argv[++i]);
+            if (budgetMB < 1) budgetMB = 1;
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+            if (repeat < 1) repeat = 1;
+        } else if (strcmp(argv[i], "--sequential") == 0) {
+            sequential = 1;
+        }
+    }
+
+    if (outDirectory && mkdir(outDirectory, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "cannot create %s\n", outDirectory);
+        return 1;
+    }
+
+    int jobCount = 0;
+    Job* jobs = scanDirectory(directory, outDirectory, &jobCount);
+    if (!jobs || jobCount == 0) {
+        fprintf(stderr, "no PPM images in %s\n", directory);
+        free(jobs);
+        return 1;
+    }
+
+    TaskPoolC* pool = taskPoolCreateC((uint32_t)threads);
+    if (!pool) {
+        fprintf(stderr, "cannot start task pool\n");
+        free(jobs);
+        return 1;
+    }
+    int workers = (int)taskPoolWorkerCountC(pool);
+    int maxInFlight = sequential ? 1 : workers + 1;
+    admission.budgetBytes = budgetMB * 1024 * 1024;
+
+    uint64_t totalPixels = 0;
+    uint64_t totalParticles = 0;
+    uint64_t totalFileBytes = 0;
+    double bestSeconds = 0.0;
+    int status = 0;
+
+    for (int run = 0; run < repeat && status == 0; run++) {
+        admission.completed = 0;
+        admission.failed = 0;
+        admission.peakReservedBytes = 0;
+        for (int s = 0; s < STAGE_COUNT; s++) atomic_store(&stageNanoseconds[s], 0);
+
+        double start = nowSeconds();
+        for (int i = 0; i < jobCount; i++) {
+            Job* job = &jobs[i];
+            job->particleTarget = particleTarget;
+            job->screenWidth = (float)screenWidth;
+            job->screenHeight = (float)screenHeight;
+            job->sampleCount = 0;
+            job->fileSize = 0;
+            job->reservedBytes = estimateJobBytes(job);
+            job->graph = buildJobGraph(job);
+            if (!job->graph) {
+                fprintf(stderr, "out of memory\n");
+                status = 1;
+                break;
+            }
+
+            admit(job, maxInFlight);
+            if (taskGraphStartC(job->graph, pool, NULL, jobCompleted, job) != TASK_GRAPH_OK) {
+                jobCompleted(TASK_GRAPH_ERROR_NOMEM, job);
+            }
+        }
+        waitForAll();
+        double seconds = nowSeconds() - start;
+
+        totalPixels = 0;
+        totalParticles = 0;
+        totalFileBytes = 0;
+        for (int i = 0; i < jobCount; i++) {
+            if (jobs[i].graph) {
+                if (jobs[i].status == TASK_GRAPH_OK) {
+                    totalPixels += (uint64_t)jobs[i].width * (uint64_t)jobs[i].height;
+                    totalParticles += (uint64_t)jobs[i].sampleCount;
+                    totalFileBytes += jobs[i].fileSize;
+                }
+                taskGraphDestroyC(jobs[i].graph);
+                jobs[i].graph = NULL;
+            }
+        }
+        if (admission.failed > 0) status = 1;
+
+        int generated = admission.completed - admission.failed;
+        printf("run %d: %d images (%d failed) in %.3f s — %.2f images/s, %.1f Mpixel/s, peak reserved %.1f MB\n",
+               run + 1, generated, admission.failed, seconds,
+               seconds > 0.0 ? generated / seconds : 0.0,
+               seconds > 0.0 ? (double)totalPixels / seconds / 1e6 : 0.0,
+               (double)admission.peakReservedBytes / (1024.0 * 1024.0));
+        if (run == 0 || seconds < bestSeconds) bestSeconds = seconds;
+    }
+
+    if (status == 0 || admission.completed > 0) {
+        printf("\nimages: %d, workers: %d, in flight: %d, budget: %lld MB, particles: %d, screen: %dx%d\n",
+               jobCount, workers, maxInFlight, (long long)budgetMB, particleTarget, screenWidth, screenHeight);
+        printf("best run: %.3f s — %.2f images/s; particles: %llu, cache files: %.1f MB\n",
+               bestSeconds, bestSeconds > 0.0 ? jobCount / bestSeconds : 0.0,
+               (unsigned long long)totalParticles, (double)totalFileBytes / (1024.0 * 1024.0));
+
+        uint64_t stageTotal = 0;
+        for (int s = 0; s < STAGE_COUNT; s++) stageTotal += atomic_load(&stageNanoseconds[s]);
+        printf("\nlast run, cpu time by stage:\n%-9s %10s %7s\n", "stage", "cpu ms", "share");
+        for (int s = 0; s < STAGE_COUNT; s++) {
+            uint64_t ns = atomic_load(&stageNanoseconds[s]);
+            printf("%-9s %10.1f %6.1f%%\n", stageNames[s], (double)ns / 1e6,
+                   stageTotal ? 100.0 * (double)ns / (double)stageTotal : 0.0);
+        }
+    }
+
+    taskPoolDestroyC(pool);
+    free(jobs);
+    return status;
+}
@@ -0,0 +1,346 @@
+//
+//  BufferRingTest.c
+//  PixelFlow
+//
+//  Проверка кольца слотов частиц (BufferRingC.c) по протоколу
+//  ParticleBufferRing.swift: замок только на захват и публикацию слота,
+//  копия и запись CPU — без замка. Сначала однопоточные проверки учета слотов,
+//  затем нагрузка: render-поток (запись без ожидания, как integrateVelocities,
+//  и beginFrame), поток GPU (compute in-place и render по очереди кадров) и
+//  фоновый писатель с ожиданием (как порции HQ). Слот — массив одинаковых
+//  значений: любая рваная копия или чтение видны как разные значения.
+//
+//  Не входит в Xcode-таргет. Сборка на Linux/macOS из корня репозитория:
+//
+//    P=PixelFlow/Engine/ParticleSystem
+//    cc -O2 -std=c11 -pthread -I$P/Utils Tools/BufferRingTest/BufferRingTest.c
+//       $P/Utils/BufferRingC.c -o buffer-ring-test
+//
+//  (одной командной строкой; для TSan — добавить -fsanitize=thread -g)
+//
+//  Запуск: ./buffer-ring-test [--frames N] [--elements N] [--pace-us N]
+//  --pace-us — пауза render-потока между кадрами (vsync); 0 — кадры подряд.
+//  Код выхода 0 — все проверки прошли.
+//
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "BufferRingC.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RING_SLOTS 3
+#define MAX_FRAMES_IN_FLIGHT (RING_SLOTS - 1)
+
+static int failures = 0;
+
+#define CHECK(condition, message)                                           \
+    do {                                                                    \
+        if (!(condition)) {                                                 \
+            fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, message); \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// MARK: - Single-threaded checks
+
+static void testSlotBookkeeping(void) {
+    BufferRingC ring;
+    bufferRingInitC(&ring, RING_SLOTS);
+    CHECK(ring.latest == 0 && ring.writing == -1, "init: slot 0 is latest, nothing is written");
+
+    // CPU пишет не в latest, публикация переносит latest
+    int32_t slot = bufferRingAcquireC(&ring);
+    CHECK(slot > 0, "acquire skips latest");
+    CHECK(bufferRingAcquireC(&ring) == -1, "second writer is refused");
+    bufferRingPublishC(&ring, slot);
+    CHECK(ring.latest == slot && ring.writing == -1, "publish moves latest");
+
+    // Кадр с compute делает latest нечитаемым до completeWrite
+    int32_t frameSlot = -1, writes = 0;
+    uint64_t serial = bufferRingBeginFrameC(&ring, &frameSlot, &writes);
+    CHECK(frameSlot == slot && writes == 1, "frame runs compute on latest");
+    CHECK(bufferRingIsReadableC(&ring, slot) == 0, "latest unreadable while compute runs");
+    bufferRingCompleteWriteC(&ring, serial);
+    CHECK(bufferRingIsReadableC(&ring, slot) == 1, "latest readable after compute");
+
+    // Слот кадра в полете не выдается писателю
+    int32_t next = bufferRingAcquireC(&ring);
+    CHECK(next >= 0 && next != slot, "acquire skips slot used by frame in flight");
+
+    // Пока CPU держит слот, кадр только читает latest и не трогает его заборы
+    uint64_t writeSerialBefore = ring.writeSerial[ring.latest];
+    uint64_t readSerial = bufferRingBeginFrameC(&ring, &frameSlot, &writes);
+    CHECK(writes == 0, "frame is read-only while CPU holds a slot");
+    CHECK(ring.writeSerial[ring.latest] == writeSerialBefore, "read-only frame keeps latest readable");
+    CHECK(bufferRingIsReadableC(&ring, ring.latest) == 1, "latest stays readable for the CPU copy");
+    bufferRingCancelC(&ring, next);
+    CHECK(ring.writing == -1, "cancel releases the claim");
+
+    bufferRingRetireC(&ring, serial);
+    bufferRingRetireC(&ring, readSerial);
+    CHECK(bufferRingInFlightC(&ring) == 0, "all frames retired");
+
+    // Со maxFramesInFlight кадрами в полете свободный слот есть всегда
+    uint64_t serials[MAX_FRAMES_IN_FLIGHT];
+    for (int f = 0; f < MAX_FRAMES_IN_FLIGHT; f++) {
+        serials[f] = bufferRingBeginFrameC(&ring, NULL, NULL);
+        int32_t s = bufferRingAcquireC(&ring);
+        CHECK(s >= 0, "free slot with frames in flight");
+        bufferRingPublishC(&ring, s);
+    }
+    for (int f = 0; f < MAX_FRAMES_IN_FLIGHT; f++) bufferRingRetireC(&ring, serials[f]);
+}
+
+// MARK: - Stress
+
+typedef struct {
+    uint64_t serial;
+    int32_t slot;
+    int32_t writes;
+} Frame;
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t condition;
+    BufferRingC ring;
+    uint32_t* slots[RING_SLOTS];
+    int elements;
+
+    // Очередь кадров GPU
+    Frame queue[MAX_FRAMES_IN_FLIGHT + 1];
+    int queueHead, queueCount;
+    int inFlight;
+    int stop;
+
+    // Слот, который CPU сейчас читает или пишет без замка; GPU не должен писать их
+    atomic_int cpuSource;
+    atomic_int cpuTarget;
+
+    atomic_long tornReads;
+    atomic_long gpuWritesIntoCpuSlots;
+    atomic_long computeFrames, readOnlyFrames;
+    atomic_long renderWrites, renderSkips, backgroundWrites;
+    double renderClaimMaxSeconds;
+} StressRing;
+
+static int isUniform(const uint32_t* values, int count) {
+    for (int i = 1; i < count; i++) {
+        if (values[i] != values[0]) return 0;
+    }
+    return 1;
+}
+
+/// Захват под замком, как ParticleBufferRing.claimSlot. waiting = 0 — без ожидания
+static int32_t claimSlot(StressRing* s, int waiting, int32_t* source) {
+    pthread_mutex_lock(&s->lock);
+    int32_t slot = bufferRingAcquireC(&s->ring);
+    while (waiting && slot < 0) {
+        pthread_cond_wait(&s->condition, &s->lock);
+        slot = bufferRingAcquireC(&s->ring);
+    }
+    if (slot >= 0) {
+        while (bufferRingIsReadableC(&s->ring, s->ring.latest) == 0) {
+            if (!waiting) {
+                bufferRingCancelC(&s->ring, slot);
+                pthread_cond_broadcast(&s->condition);
+                slot = -1;
+                break;
+            }
+            pthread_cond_wait(&s->condition, &s->lock);
+        }
+    }
+    if (slot >= 0) {
+        *source = s->ring.latest;
+        atomic_store(&s->cpuSource, *source);
+        atomic_store(&s->cpuTarget, slot);
+    }
+    pthread_mutex_unlock(&s->lock);
+    return slot;
+}
+
+/// Копия и изменение без замка, затем публикация под замком
+static void writeAndPublish(StressRing* s, int32_t slot, int32_t source, uint32_t increment) {
+    const uint32_t* from = s->slots[source];
+    uint32_t* to = s->slots[slot];
+    for (int i = 0; i < s->elements; i++) to[i] = from[i] + increment;
+    if (!isUniform(to, s->elements)) atomic_fetch_add(&s->tornReads, 1);
+
+    pthread_mutex_lock(&s->lock);
+    atomic_store(&s->cpuSource, -1);
+    atomic_store(&s->cpuTarget, -1);
+    bufferRingPublishC(&s->ring, slot);
+    pthread_cond_broadcast(&s->condition);
+    pthread_mutex_unlock(&s->lock);
+}
+
+static void* gpuThread(void* arg) {
+    StressRing* s = arg;
+    for (;;) {
+        pthread_mutex_lock(&s->lock);
+        while (s->queueCount == 0 && !s->stop) pthread_cond_wait(&s->condition, &s->lock);
+        if (s->queueCount == 0 && s->stop) {
+            pthread_mutex_unlock(&s->lock);
+            return NULL;
+        }
+        Frame frame = s->queue[s->queueHead];
+        pthread_mutex_unlock(&s->lock);
+
+        // Compute in-place в слоте кадра
+        uint32_t* values = s->slots[frame.slot];
+        if (frame.writes) {
+            if (atomic_load(&s->cpuSource) == frame.slot || atomic_load(&s->cpuTarget) == frame.slot) {
+                atomic_fetch_add(&s->gpuWritesIntoCpuSlots, 1);
+            }
+            for (int i = 0; i < s->elements; i++) values[i] += 1;
+        }
+        pthread_mutex_lock(&s->lock);
+        bufferRingCompleteWriteC(&s->ring, frame.serial);
+        pthread_cond_broadcast(&s->condition);
+        pthread_mutex_unlock(&s->lock);
+
+        // Render читает слот
+        if (!isUniform(values, s->elements)) atomic_fetch_add(&s->tornReads, 1);
+
+        pthread_mutex_lock(&s->lock);
+        bufferRingRetireC(&s->ring, frame.serial);
+        s->queueHead = (s->queueHead + 1) % (MAX_FRAMES_IN_FLIGHT + 1);
+        s->queueCount--;
+        s->inFlight--;
+        pthread_cond_broadcast(&s->condition);
+        pthread_mutex_unlock(&s->lock);
+    }
+}
+
+static void* backgroundWriter(void* arg) {
+    StressRing* s = arg;
+    for (;;) {
+        pthread_mutex_lock(&s->lock);
+        int stop = s->stop;
+        pthread_mutex_unlock(&s->lock);
+        if (stop) return NULL;
+
+        int32_t source = -1;
+        int32_t slot = claimSlot(s, 1, &source);
+        if (slot < 0) continue;
+        writeAndPublish(s, slot, source, 1000);
+        atomic_fetch_add(&s->backgroundWrites, 1);
+
+        struct timespec pause = { 0, 200000 };
+        nanosleep(&pause, NULL);
+    }
+}
+
+static void testStress(int frames, int elements, int paceMicroseconds) {
+    StressRing s;
+    memset(&s, 0, sizeof(s));
+    pthread_mutex_init(&s.lock, NULL);
+    pthread_cond_init(&s.condition, NULL);
+    bufferRingInitC(&s.ring, RING_SLOTS);
+    s.elements = elements;
+    for (int i = 0; i < RING_SLOTS; i++) s.slots[i] = calloc((size_t)elements, sizeof(uint32_t));
+    atomic_init(&s.cpuSource, -1);
+    atomic_init(&s.cpuTarget, -1);
+
+    pthread_t gpu, writer;
+    pthread_create(&gpu, NULL, gpuThread, &s);
+    pthread_create(&writer, NULL, backgroundWriter, &s);
+
+    for (int f = 0; f < frames; f++) {
+        // inFlightSemaphore: не больше maxFramesInFlight кадров
+        pthread_mutex_lock(&s.lock);
+        while (s.inFlight >= MAX_FRAMES_IN_FLIGHT) pthread_cond_wait(&s.condition, &s.lock);
+        pthread_mutex_unlock(&s.lock);
+
+        // Запись render-потока: без ожидания, пропуск при занятом кольце
+        double start = nowSeconds();
+        int32_t source = -1;
+        int32_t slot = claimSlot(&s, 0, &source);
+        double claimSeconds = nowSeconds() - start;
+        if (claimSeconds > s.renderClaimMaxSeconds) s.renderClaimMaxSeconds = claimSeconds;
+        if (slot >= 0) {
+            writeAndPublish(&s, slot, source, 1);
+            atomic_fetch_add(&s.renderWrites, 1);
+        } else {
+            atomic_fetch_add(&s.renderSkips, 1);
+        }
+
+        pthread_mutex_lock(&s.lock);
+        Frame frame;
+        frame.serial = bufferRingBeginFrameC(&s.ring, &frame.slot, &frame.writes);
+        atomic_fetch_add(frame.writes ? &s.computeFrames : &s.readOnlyFrames, 1);
+        int tail = (s.queueHead + s.queueCount) % (MAX_FRAMES_IN_FLIGHT + 1);
+        s.queue[tail] = frame;
+        s.queueCount++;
+        s.inFlight++;
+        pthread_cond_broadcast(&s.condition);
+        pthread_mutex_unlock(&s.lock);
+
+        if (paceMicroseconds > 0) {
+            struct timespec pace = { 0, (long)paceMicroseconds * 1000L };
+            nanosleep(&pace, NULL);
+        }
+    }
+
+    pthread_mutex_lock(&s.lock);
+    s.stop = 1;
+    pthread_cond_broadcast(&s.condition);
+    pthread_mutex_unlock(&s.lock);
+    pthread_join(writer, NULL);
+    pthread_join(gpu, NULL);
+
+    CHECK(atomic_load(&s.tornReads) == 0, "no torn copies or reads");
+    CHECK(atomic_load(&s.gpuWritesIntoCpuSlots) == 0, "compute never writes a slot the CPU copies or writes");
+    CHECK(bufferRingInFlightC(&s.ring) == 0, "all frames retired");
+    CHECK(atomic_load(&s.renderWrites) > 0, "render-thread writes go through");
+
+    printf("stress: %d frames (%ld compute, %ld read-only), render writes %ld, skipped %ld, "
+           "background writes %ld, max render claim %.1f us\n",
+           frames, atomic_load(&s.computeFrames), atomic_load(&s.readOnlyFrames),
+           atomic_load(&s.renderWrites), atomic_load(&s.renderSkips),
+           atomic_load(&s.backgroundWrites), s.renderClaimMaxSeconds * 1e6);
+
+    for (int i = 0; i < RING_SLOTS; i++) free(s.slots[i]);
+    pthread_cond_destroy(&s.condition);
+    pthread_mutex_destroy(&s.lock);
+}
+
+int main(int argc, char** argv) {
+    int frames = 20000;
+    int elements = 4096;
+    int paceMicroseconds = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+            if (frames < 1) frames = 1;
+        } else if (strcmp(argv[i], "--elements") == 0 && i + 1 < argc) {
+            elements = atoi(argv[++i]);
+            if (elements < 1) elements = 1;
+        } else if (strcmp(argv[i], "--pace-us") == 0 && i + 1 < argc) {
+            paceMicroseconds = atoi(argv[++i]);
+            if (paceMicroseconds < 0) paceMicroseconds = 0;
+            if (paceMicroseconds > 999999) paceMicroseconds = 999999;
+        }
+    }
+
+    testSlotBookkeeping();
+    testStress(frames, elements, paceMicroseconds);
+
+    if (failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
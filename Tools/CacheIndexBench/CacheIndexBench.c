@@ -0,0 +1,326 @@
+//
+//  CacheIndexBench.c
+//  PixelFlow
+//
+//  Индекс дискового кэша (CacheIndexC.h) на N записях: put, touch,
+//  вытеснение самой старой записи с put новой и открытие журнала
+//  с воспроизведением. Базовая линия — прежний индекс: перезапись всего
+//  JSON на каждое изменение (печать snprintf и атомарная запись через
+//  временный файл, без JSONEncoder — нижняя оценка) и сортировка записей
+//  по времени доступа при очистке. Ключи и имена файлов — как у
+//  GenerationCoordinator и DefaultCacheManager. После открытия журнала
+//  проверяются число записей, суммарный размер и порядок LRU.
+//  Таблица в ImageParticleGenerator/Caching/caching.md («Журнал индекса»)
+//  получена им.
+//
+//  Не входит в Xcode-таргет. Сборка на Linux/macOS из корня репозитория:
+//
+//    G=PixelFlow/Engine/Generators/ImageParticleGenerator
+//    cc -O2 -std=c11 -I$G/Caching
+//       Tools/CacheIndexBench/CacheIndexBench.c
+//       $G/Caching/CacheIndexC.c -o cache-index-bench
+//
+//  (одной командной строкой)
+//
+//  Запуск: ./cache-index-bench [--entries N] [--journal-records N] [--dir PATH] [--passes N]
+//
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "CacheIndexC.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define KEY_CAPACITY 192
+#define FILE_NAME_CAPACITY 80
+#define JSON_ENTRY_CAPACITY 640
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+static void hex64(char* out, uint64_t seed, int digits) {
+    static const char alphabet[] = "0123456789abcdef";
+    for (int i = 0; i < digits; i++) {
+        if (i % 16 == 0) seed = mix64(seed + (uint64_t)i);
+        out[i] = alphabet[(seed >> (4 * (i % 16))) & 0xF];
+    }
+    out[digits] = '\0';
+}
+
+/// Ключ файла координатора: версия, размер изображения, экран, отпечатки
+/// конфигурации и содержимого
+static void makeKey(char* key, uint64_t id) {
+    char fingerprint[65];
+    char content[65];
+    hex64(fingerprint, id * 2 + 1, 64);
+    hex64(content, id * 3 + 7, 64);
+    snprintf(key, KEY_CAPACITY, "generation_v6-content-2026-10-17_%ux%u_1179x2556_%s_%s",
+             1000u + (unsigned)(id % 3000u), 1000u + (unsigned)(id % 2000u), fingerprint, content);
+}
+
+/// Имя файла менеджера: SHA-256 ключа в hex
+static void makeFileName(char* fileName, uint64_t id) {
+    char digest[65];
+    hex64(digest, id * 2 + 2, 64);
+    snprintf(fileName, FILE_NAME_CAPACITY, "%s.particles", digest);
+}
+
+static int64_t entrySize(uint64_t id) {
+    return (int64_t)(1 << 20) + (int64_t)(mix64(id) % (12u << 20));
+}
+
+// MARK: - Базовая линия: JSON-индекс
+
+typedef struct {
+    char key[KEY_CAPACITY];
+    char fileName[FILE_NAME_CAPACITY];
+    int64_t size;
+    double createdAt;
+    double lastAccessed;
+} JsonEntry;
+
+/// Весь индекс в JSON и атомарная запись (временный файл + rename). Возвращает байты
+static size_t writeJsonIndex(const char* path, const JsonEntry* entries, uint64_t count, char* buffer,
+                             size_t capacity) {
+    size_t length = 0;
+    length += (size_t)snprintf(buffer + length, capacity - length, "{\"entries\":{");
+    for (uint64_t i = 0; i < count; i++) {
+        const JsonEntry* e = &entries[i];
+        length += (size_t)snprintf(buffer + length, capacity - length,
+                                   "%s\"%s\":{\"key\":\"%s\",\"fileName\":\"%s\",\"size\":%lld,"
+                                   "\"createdAt\":%.6f,\"lastAccessed\":%.6f}",
+                                   i ? "," : "", e->key, e->key, e->fileName, (long long)e->size,
+                                   e->createdAt, e->lastAccessed);
+    }
+    length += (size_t)snprintf(buffer + length, capacity - length, "}}");
+
+    char temporary[1040];
+    snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+    FILE* file = fopen(temporary, "wb");
+    if (!file) return 0;
+    size_t written = fwrite(buffer, 1, length, file);
+    fclose(file);
+    if (written != length || rename(temporary, path) != 0) return 0;
+    return length;
+}
+
+static int compareLastAccessed(const void* a, const void* b) {
+    const JsonEntry* x = *(const JsonEntry* const*)a;
+    const JsonEntry* y = *(const JsonEntry* const*)b;
+    return (x->lastAccessed > y->lastAccessed) - (x->lastAccessed < y->lastAccessed);
+}
+
+// MARK: - Проверка порядка
+
+typedef struct {
+    uint64_t visited;
+    double previous;
+    int ordered;
+} OrderCheck;
+
+static int visitInOrder(const CacheIndexEntryC* entry, void* context) {
+    OrderCheck* check = context;
+    if (entry->lastAccessed < check->previous) check->ordered = 0;
+    check->previous = entry->lastAccessed;
+    check->visited++;
+    return 1;
+}
+
+// MARK: - Замеры журнала
+
+typedef struct {
+    double put;
+    double touch;
+    double evictPut;
+    double open;
+    uint64_t openRecords;
+} JournalTimings;
+
+static int measureJournal(const char* path, uint64_t entries, uint64_t journalRecords, JournalTimings* t) {
+    char key[KEY_CAPACITY];
+    char fileName[FILE_NAME_CAPACITY];
+    unlink(path);
+    CacheIndexC* index = cacheIndexOpenC(path);
+    if (!index) return 0;
+
+    double clock = 1000.0;
+    double start = nowSeconds();
+    for (uint64_t id = 0; id < entries; id++) {
+        makeKey(key, id);
+        makeFileName(fileName, id);
+        if (!cacheIndexPutC(index, key, fileName, entrySize(id), clock, clock)) return 0;
+        clock += 1.0;
+    }
+    t->put = (nowSeconds() - start) / (double)entries;
+
+    // Попадания: случайные записи, пачки касаний уходят в журнал сами
+    uint64_t touches = entries;
+    start = nowSeconds();
+    for (uint64_t i = 0; i < touches; i++) {
+        makeKey(key, mix64(i) % entries);
+        if (!cacheIndexTouchC(index, key, clock)) return 0;
+        clock += 1.0;
+    }
+    t->touch = (nowSeconds() - start) / (double)touches;
+
+    // Кэш полон: каждая новая запись вытесняет самую старую
+    uint64_t evictions = entries / 10;
+    start = nowSeconds();
+    for (uint64_t i = 0; i < evictions; i++) {
+        CacheIndexEntryC oldest;
+        if (!cacheIndexOldestC(index, &oldest) || !cacheIndexRemoveC(index, oldest.key)) return 0;
+        uint64_t id = entries + i;
+        makeKey(key, id);
+        makeFileName(fileName, id);
+        if (!cacheIndexPutC(index, key, fileName, entrySize(id), clock, clock)) return 0;
+        clock += 1.0;
+    }
+    t->evictPut = (nowSeconds() - start) / (double)evictions;
+
+    // Журнал до journalRecords записей касаниями (ниже порога сжатия)
+    for (uint64_t i = 0; cacheIndexJournalRecordsC(index) < journalRecords; i++) {
+        makeKey(key, entries / 10 + mix64(i + 7) % (entries - entries / 10));
+        cacheIndexTouchC(index, key, clock);
+        clock += 1.0;
+        if (i > journalRecords * 4) break;
+    }
+    uint64_t count = cacheIndexCountC(index);
+    int64_t totalSize = cacheIndexTotalSizeC(index);
+    cacheIndexCloseC(index);
+
+    start = nowSeconds();
+    index = cacheIndexOpenC(path);
+    t->open = nowSeconds() - start;
+    if (!index) return 0;
+    t->openRecords = cacheIndexJournalRecordsC(index);
+
+    OrderCheck check = { 0, -1.0, 1 };
+    cacheIndexForEachC(index, visitInOrder, &check);
+    int ok = cacheIndexCountC(index) == count && cacheIndexTotalSizeC(index) == totalSize &&
+             check.visited == count && check.ordered;
+    cacheIndexCloseC(index);
+    if (!ok) printf("FAIL: reopened index differs (count, size or LRU order)\n");
+    return ok;
+}
+
+// MARK: - Замеры JSON
+
+static int measureJson(const char* path, uint64_t entries, double* rewrite, double* sortTime, size_t* bytes) {
+    JsonEntry* table = malloc(sizeof(JsonEntry) * (size_t)entries);
+    const JsonEntry** order = malloc(sizeof(JsonEntry*) * (size_t)entries);
+    size_t capacity = (size_t)entries * JSON_ENTRY_CAPACITY;
+    char* buffer = malloc(capacity);
+    if (!table || !order || !buffer) return 0;
+
+    for (uint64_t id = 0; id < entries; id++) {
+        makeKey(table[id].key, id);
+        makeFileName(table[id].fileName, id);
+        table[id].size = entrySize(id);
+        table[id].createdAt = 1000.0 + (double)id;
+        table[id].lastAccessed = 1000.0 + (double)(mix64(id) % entries);
+        order[id] = &table[id];
+    }
+
+    // Каждое изменение (put, touch) переписывало весь файл
+    const int writes = 20;
+    double start = nowSeconds();
+    for (int i = 0; i < writes; i++) {
+        table[i].lastAccessed += 1.0;
+        *bytes = writeJsonIndex(path, table, entries, buffer, capacity);
+        if (*bytes == 0) return 0;
+    }
+    *rewrite = (nowSeconds() - start) / writes;
+
+    // Очистка сортировала все записи по времени доступа
+    start = nowSeconds();
+    qsort(order, (size_t)entries, sizeof(*order), compareLastAccessed);
+    *sortTime = nowSeconds() - start;
+
+    free(table);
+    free(order);
+    free(buffer);
+    unlink(path);
+    return 1;
+}
+
+static void keepBest(double* best, double value) {
+    if (value < *best) *best = value;
+}
+
+int main(int argc, char** argv) {
+    uint64_t entries = 10000;
+    uint64_t journalRecords = 30000;
+    const char* directory = "/tmp";
+    int passes = 3;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--entries") == 0 && i + 1 < argc) {
+            entries = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--journal-records") == 0 && i + 1 < argc) {
+            journalRecords = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc) {
+            directory = argv[++i];
+        } else if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--entries N] [--journal-records N] [--dir PATH] [--passes N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (entries < 10 || passes <= 0) return 2;
+
+    char journalPath[1024];
+    char jsonPath[1024];
+    snprintf(journalPath, sizeof(journalPath), "%s/cache-index-bench.journal", directory);
+    snprintf(jsonPath, sizeof(jsonPath), "%s/cache-index-bench.json", directory);
+
+    JournalTimings best = { 1e30, 1e30, 1e30, 1e30, 0 };
+    double rewrite = 1e30;
+    double sortTime = 1e30;
+    size_t jsonBytes = 0;
+    for (int pass = 0; pass < passes; pass++) {
+        JournalTimings t;
+        if (!measureJournal(journalPath, entries, journalRecords, &t)) return 1;
+        keepBest(&best.put, t.put);
+        keepBest(&best.touch, t.touch);
+        keepBest(&best.evictPut, t.evictPut);
+        keepBest(&best.open, t.open);
+        best.openRecords = t.openRecords;
+
+        double passRewrite, passSort;
+        if (!measureJson(jsonPath, entries, &passRewrite, &passSort, &jsonBytes)) {
+            fprintf(stderr, "JSON baseline failed in %s\n", directory);
+            return 1;
+        }
+        keepBest(&rewrite, passRewrite);
+        keepBest(&sortTime, passSort);
+    }
+    unlink(journalPath);
+
+    printf("%llu entries, best of %d\n", (unsigned long long)entries, passes);
+    printf("%-32s %12s %20s\n", "operation", "journal", "JSON rewrite");
+    printf("%-32s %9.2f us %17.2f ms\n", "put (new entry)", best.put * 1e6, rewrite * 1e3);
+    printf("%-32s %9.2f us %17.2f ms\n", "touch (hit)", best.touch * 1e6, rewrite * 1e3);
+    printf("%-32s %9.2f us %11.2f ms + sort %.2f ms\n", "evict + put", best.evictPut * 1e6,
+           rewrite * 1e3, sortTime * 1e3);
+    printf("open (%llu journal records) %9.2f ms\n", (unsigned long long)best.openRecords, best.open * 1e3);
+    printf("JSON index: %.1f MB\n", (double)jsonBytes / 1e6);
+    printf("reopened index matches\n");
+    return 0;
+}
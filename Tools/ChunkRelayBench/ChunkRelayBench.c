@@ -0,0 +1,452 @@
+//
+//  ChunkRelayBench.c
+//  PixelFlow
+//
+//  Потоковая сборка частиц (GenerationPipeline, ParticleChunkRelay) на TaskGraphC:
+//  было — один узел пула собирает все порции и при полной очереди ждет получателя
+//  на семафоре; стало — каждая порция отдельный узел, а ожидание места идет вне
+//  пула (в Swift — приостановка задачи). Посреди сборки на тот же пул ставятся
+//  независимые узлы (декодирование следующего изображения и т.п.) — их
+//  задержка старта показывает, держит ли сборка поток пула. Графы ждутся через
+//  completion, а не taskGraphWaitC: ожидающий поток не должен сам выполнять узлы.
+//  Получатель — отдельный поток (очередь relay): копия порции в буфер и пауза,
+//  имитирующая ожидание кольцом свободного слота. Пик памяти — порции,
+//  собранные, но еще не обработанные получателем.
+//  Таблица в Generators/ImageParticleGenerator/Core/core.md получена им.
+//
+//  Не входит в Xcode-таргет. Сборка на Linux/macOS из корня репозитория:
+//
+//    G=PixelFlow/Engine/Generators/ImageParticleGenerator
+//    cc -O2 -std=c11 -pthread -I$G/Core
+//       Tools/ChunkRelayBench/ChunkRelayBench.c $G/Core/TaskGraphC.c -lm -o chunk-relay-bench
+//
+//  (одной командной строкой)
+//
+//  Запуск: ./chunk-relay-bench [--particles N] [--threads N] [--sink-us N]
+//          [--jobs N] [--job-us N] [--job-delay-ms N] [--runs N]
+//
+
+#define _DEFAULT_SOURCE
+
+#include "TaskGraphC.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Как GenerationPipeline.Constants: порция 16 384 частицы, очередь на 4 порции
+#define BENCH_CHUNK_PARTICLES 16384
+#define BENCH_QUEUE_CAPACITY 4
+// Страйд Particle (ParticleC) — 80 байт
+#define BENCH_PARTICLE_FLOATS 20
+#define BENCH_MAX_JOBS 64
+
+typedef enum {
+    MODE_BLOCKING,    // было: узел пула ждет место на семафоре
+    MODE_SUSPENDING,  // стало: узел на порцию, ожидание места вне пула
+} RelayMode;
+
+static uint64_t nowNanoseconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void spinMicroseconds(int us) {
+    uint64_t end = nowNanoseconds() + (uint64_t)us * 1000ull;
+    while (nowNanoseconds() < end) {
+    }
+}
+
+// MARK: - Graph completion
+
+/// Ожидание графа без выполнения его узлов на ждущем потоке
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+    int finished;
+} GraphWait;
+
+static void graphFinished(int32_t status, void* context) {
+    (void)status;
+    GraphWait* wait = context;
+    pthread_mutex_lock(&wait->lock);
+    wait->finished = 1;
+    pthread_cond_signal(&wait->done);
+    pthread_mutex_unlock(&wait->lock);
+}
+
+static void runGraph(TaskGraphC* graph, TaskPoolC* pool) {
+    GraphWait wait = { .finished = 0 };
+    pthread_mutex_init(&wait.lock, NULL);
+    pthread_cond_init(&wait.done, NULL);
+    taskGraphStartC(graph, pool, NULL, graphFinished, &wait);
+    pthread_mutex_lock(&wait.lock);
+    while (!wait.finished) pthread_cond_wait(&wait.done, &wait.lock);
+    pthread_mutex_unlock(&wait.lock);
+    pthread_cond_destroy(&wait.done);
+    pthread_mutex_destroy(&wait.lock);
+}
+
+// MARK: - Relay
+
+/// Очередь порций к получателю с местами на BENCH_QUEUE_CAPACITY порций
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    int freeSlots;
+    int head, tail, queued;
+    int chunks[BENCH_QUEUE_CAPACITY];   // номера порций в очереди
+    int finished;                       // все порции отправлены
+    int delivered;
+    uint64_t firstDeliveredAt;
+    // Память: порции собраны, но получатель их еще не обработал
+    int64_t liveBytes;
+    int64_t peakLiveBytes;
+} Relay;
+
+typedef struct {
+    Relay relay;
+    RelayMode mode;
+    float* source;          // «сэмплы»
+    float* particles;       // собранный массив
+    float* ring;            // слот кольца, куда получатель копирует порцию
+    int particleCount;
+    int chunkCount;
+    int sinkMicroseconds;
+    uint64_t startedAt;
+    uint64_t blockedNanoseconds;  // поток пула стоял на ожидании места
+} Stream;
+
+static void relayTakeSlot(Stream* stream) {
+    Relay* relay = &stream->relay;
+    uint64_t start = nowNanoseconds();
+    pthread_mutex_lock(&relay->lock);
+    while (relay->freeSlots == 0) {
+        pthread_cond_wait(&relay->changed, &relay->lock);
+    }
+    relay->freeSlots--;
+    pthread_mutex_unlock(&relay->lock);
+    if (stream->mode == MODE_BLOCKING) {
+        stream->blockedNanoseconds += nowNanoseconds() - start;
+    }
+}
+
+static void relayPush(Relay* relay, int chunk, int64_t bytes) {
+    pthread_mutex_lock(&relay->lock);
+    relay->chunks[relay->tail] = chunk;
+    relay->tail = (relay->tail + 1) % BENCH_QUEUE_CAPACITY;
+    relay->queued++;
+    relay->liveBytes += bytes;
+    if (relay->liveBytes > relay->peakLiveBytes) relay->peakLiveBytes = relay->liveBytes;
+    pthread_cond_broadcast(&relay->changed);
+    pthread_mutex_unlock(&relay->lock);
+}
+
+/// Получатель: копия порции в слот кольца и ожидание «GPU»
+static void* runSink(void* context) {
+    Stream* stream = context;
+    Relay* relay = &stream->relay;
+    for (;;) {
+        pthread_mutex_lock(&relay->lock);
+        while (relay->queued == 0 && !relay->finished) {
+            pthread_cond_wait(&relay->changed, &relay->lock);
+        }
+        if (relay->queued == 0) {
+            pthread_mutex_unlock(&relay->lock);
+            return NULL;
+        }
+        int chunk = relay->chunks[relay->head];
+        relay->head = (relay->head + 1) % BENCH_QUEUE_CAPACITY;
+        relay->queued--;
+        pthread_mutex_unlock(&relay->lock);
+
+        int begin = chunk * BENCH_CHUNK_PARTICLES;
+        int end = begin + BENCH_CHUNK_PARTICLES < stream->particleCount ? begin + BENCH_CHUNK_PARTICLES : stream->particleCount;
+        size_t floats = (size_t)(end - begin) * BENCH_PARTICLE_FLOATS;
+        memcpy(stream->ring + (size_t)begin * BENCH_PARTICLE_FLOATS,
+               stream->particles + (size_t)begin * BENCH_PARTICLE_FLOATS, floats * sizeof(float));
+        if (stream->sinkMicroseconds > 0) usleep((useconds_t)stream->sinkMicroseconds);
+
+        pthread_mutex_lock(&relay->lock);
+        if (relay->delivered++ == 0) relay->firstDeliveredAt = nowNanoseconds();
+        relay->liveBytes -= (int64_t)(floats * sizeof(float));
+        relay->freeSlots++;
+        pthread_cond_broadcast(&relay->changed);
+        pthread_mutex_unlock(&relay->lock);
+    }
+}
+
+// MARK: - Assembly
+
+/// Сборка порции: раскладка, цвет и скорость — несколько операций на частицу,
+/// как createParticle + linearizeParticleColorsC
+static void assembleChunk(Stream* stream, int chunk) {
+    int begin = chunk * BENCH_CHUNK_PARTICLES;
+    int end = begin + BENCH_CHUNK_PARTICLES < stream->particleCount ? begin + BENCH_CHUNK_PARTICLES : stream->particleCount;
+    for (int i = begin; i < end; i++) {
+        const float* sample = stream->source + (size_t)i * 4;
+        float* particle = stream->particles + (size_t)i * BENCH_PARTICLE_FLOATS;
+        particle[0] = sample[0] * 2.0f - 1.0f;
+        particle[1] = 1.0f - sample[1] * 2.0f;
+        particle[2] = 0.0f;
+        for (int c = 0; c < 3; c++) {
+            float srgb = sample[2] * (0.8f + 0.1f * (float)c);
+            particle[4 + c] = srgb <= 0.04045f ? srgb / 12.92f : powf((srgb + 0.055f) / 1.055f, 2.4f);
+        }
+        particle[7] = 1.0f;
+        particle[8] = sinf(sample[3] * 6.2831853f) * 0.01f;
+        particle[9] = cosf(sample[3] * 6.2831853f) * 0.01f;
+        for (int f = 10; f < BENCH_PARTICLE_FLOATS; f++) particle[f] = sample[3];
+    }
+}
+
+static int64_t chunkBytes(const Stream* stream, int chunk) {
+    int begin = chunk * BENCH_CHUNK_PARTICLES;
+    int end = begin + BENCH_CHUNK_PARTICLES < stream->particleCount ? begin + BENCH_CHUNK_PARTICLES : stream->particleCount;
+    return (int64_t)(end - begin) * BENCH_PARTICLE_FLOATS * (int64_t)sizeof(float);
+}
+
+/// Было: весь этап — один узел; место под порцию ждет поток пула
+static int blockingAssemblyWork(void* context, uint64_t begin, uint64_t end) {
+    (void)begin;
+    (void)end;
+    Stream* stream = context;
+    for (int chunk = 0; chunk < stream->chunkCount; chunk++) {
+        assembleChunk(stream, chunk);
+        relayTakeSlot(stream);
+        relayPush(&stream->relay, chunk, chunkBytes(stream, chunk));
+    }
+    return 1;
+}
+
+typedef struct {
+    Stream* stream;
+    int chunk;
+} ChunkJob;
+
+static int chunkAssemblyWork(void* context, uint64_t begin, uint64_t end) {
+    (void)begin;
+    (void)end;
+    ChunkJob* job = context;
+    assembleChunk(job->stream, job->chunk);
+    return 1;
+}
+
+// MARK: - Concurrent jobs
+
+typedef struct {
+    uint64_t submittedAt;
+    uint64_t startedAt;
+    uint64_t finishedAt;
+    int microseconds;
+} PoolJob;
+
+typedef struct {
+    TaskPoolC* pool;
+    PoolJob* jobs;
+    int count;
+    int microseconds;
+    int delayMilliseconds;
+} JobSubmitter;
+
+static int poolJobWork(void* context, uint64_t begin, uint64_t end) {
+    (void)begin;
+    (void)end;
+    PoolJob* job = context;
+    job->startedAt = nowNanoseconds();
+    spinMicroseconds(job->microseconds);
+    job->finishedAt = nowNanoseconds();
+    return 1;
+}
+
+/// Ставит узлы через delay после старта сборки — когда очередь к получателю уже полна
+static void* submitJobs(void* context) {
+    JobSubmitter* submitter = context;
+    usleep((useconds_t)submitter->delayMilliseconds * 1000);
+    TaskGraphC* graph = taskGraphCreateC();
+    uint64_t submittedAt = nowNanoseconds();
+    for (int j = 0; j < submitter->count; j++) {
+        submitter->jobs[j] = (PoolJob){ .submittedAt = submittedAt, .microseconds = submitter->microseconds };
+        taskGraphAddNodeC(graph, poolJobWork, &submitter->jobs[j], 1, 0, 2, (double)submitter->microseconds);
+    }
+    runGraph(graph, submitter->pool);
+    taskGraphDestroyC(graph);
+    return NULL;
+}
+
+// MARK: - Run
+
+typedef struct {
+    double firstChunkMs;
+    double totalMs;
+    double blockedMs;
+    double jobStartMaxMs;
+    double jobsDoneMs;
+    double peakChunkMB;
+} RunResult;
+
+static void runOnce(TaskPoolC* pool, RelayMode mode, Stream* stream, JobSubmitter* submitter,
+                    RunResult* result) {
+    Relay* relay = &stream->relay;
+    pthread_mutex_init(&relay->lock, NULL);
+    pthread_cond_init(&relay->changed, NULL);
+    relay->freeSlots = BENCH_QUEUE_CAPACITY;
+    relay->head = relay->tail = relay->queued = 0;
+    relay->finished = 0;
+    relay->delivered = 0;
+    relay->liveBytes = relay->peakLiveBytes = 0;
+    stream->mode = mode;
+    stream->blockedNanoseconds = 0;
+
+    pthread_t sink;
+    pthread_create(&sink, NULL, runSink, stream);
+    stream->startedAt = nowNanoseconds();
+
+    pthread_t jobThread;
+    pthread_create(&jobThread, NULL, submitJobs, submitter);
+
+    if (mode == MODE_BLOCKING) {
+        TaskGraphC* assembly = taskGraphCreateC();
+        taskGraphAddNodeC(assembly, blockingAssemblyWork, stream, 1, 0, 2, (double)stream->particleCount);
+        runGraph(assembly, pool);
+        taskGraphDestroyC(assembly);
+    } else {
+        // Этот поток — «задача»: ждет место вне пула, порция — отдельный узел
+        for (int chunk = 0; chunk < stream->chunkCount; chunk++) {
+            ChunkJob job = { stream, chunk };
+            TaskGraphC* graph = taskGraphCreateC();
+            taskGraphAddNodeC(graph, chunkAssemblyWork, &job, 1, 0, 2, (double)BENCH_CHUNK_PARTICLES);
+            runGraph(graph, pool);
+            taskGraphDestroyC(graph);
+            relayTakeSlot(stream);
+            relayPush(relay, chunk, chunkBytes(stream, chunk));
+        }
+    }
+
+    pthread_mutex_lock(&relay->lock);
+    relay->finished = 1;
+    pthread_cond_broadcast(&relay->changed);
+    pthread_mutex_unlock(&relay->lock);
+    pthread_join(sink, NULL);
+    uint64_t finishedAt = nowNanoseconds();
+
+    pthread_join(jobThread, NULL);
+
+    const PoolJob* jobs = submitter->jobs;
+    uint64_t jobStartMax = 0, jobsDone = 0;
+    for (int j = 0; j < submitter->count; j++) {
+        if (jobs[j].startedAt - jobs[j].submittedAt > jobStartMax) jobStartMax = jobs[j].startedAt - jobs[j].submittedAt;
+        if (jobs[j].finishedAt - jobs[j].submittedAt > jobsDone) jobsDone = jobs[j].finishedAt - jobs[j].submittedAt;
+    }
+
+    result->firstChunkMs = (double)(relay->firstDeliveredAt - stream->startedAt) * 1e-6;
+    result->totalMs = (double)(finishedAt - stream->startedAt) * 1e-6;
+    result->blockedMs = (double)stream->blockedNanoseconds * 1e-6;
+    result->jobStartMaxMs = (double)jobStartMax * 1e-6;
+    result->jobsDoneMs = (double)jobsDone * 1e-6;
+    result->peakChunkMB = (double)relay->peakLiveBytes / (1024.0 * 1024.0);
+
+    pthread_cond_destroy(&relay->changed);
+    pthread_mutex_destroy(&relay->lock);
+}
+
+// MARK: - Main
+
+int main(int argc, char** argv) {
+    int particles = 1000000;
+    int threads = 1;
+    int sinkMicroseconds = 2000;
+    int jobCount = 8;
+    int jobMicroseconds = 1000;
+    int jobDelayMilliseconds = 20;
+    int runs = 3;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--particles") == 0 && i + 1 < argc) {
+            particles = atoi(argv[++i]);
+            if (particles < 1) particles = 1;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+            if (threads < 1) threads = 1;
+        } else if (strcmp(argv[i], "--sink-us") == 0 && i + 1 < argc) {
+            sinkMicroseconds = atoi(argv[++i]);
+            if (sinkMicroseconds < 0) sinkMicroseconds = 0;
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            jobCount = atoi(argv[++i]);
+            if (jobCount < 0) jobCount = 0;
+            if (jobCount > BENCH_MAX_JOBS) jobCount = BENCH_MAX_JOBS;
+        } else if (strcmp(argv[i], "--job-us") == 0 && i + 1 < argc) {
+            jobMicroseconds = atoi(argv[++i]);
+            if (jobMicroseconds < 0) jobMicroseconds = 0;
+        } else if (strcmp(argv[i], "--job-delay-ms") == 0 && i + 1 < argc) {
+            jobDelayMilliseconds = atoi(argv[++i]);
+            if (jobDelayMilliseconds < 0) jobDelayMilliseconds = 0;
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+            if (runs < 1) runs = 1;
+        }
+    }
+
+    TaskPoolC* pool = taskPoolCreateC((uint32_t)threads);
+    Stream stream = {
+        .source = malloc(sizeof(float) * 4 * (size_t)particles),
+        .particles = malloc(sizeof(float) * BENCH_PARTICLE_FLOATS * (size_t)particles),
+        .ring = malloc(sizeof(float) * BENCH_PARTICLE_FLOATS * (size_t)particles),
+        .particleCount = particles,
+        .chunkCount = (particles + BENCH_CHUNK_PARTICLES - 1) / BENCH_CHUNK_PARTICLES,
+        .sinkMicroseconds = sinkMicroseconds,
+    };
+    if (!pool || !stream.source || !stream.particles || !stream.ring) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    srand(1);
+    for (size_t i = 0; i < (size_t)particles * 4; i++) {
+        stream.source[i] = (float)rand() / (float)RAND_MAX;
+    }
+
+    PoolJob jobs[BENCH_MAX_JOBS];
+    JobSubmitter submitter = {
+        .pool = pool,
+        .jobs = jobs,
+        .count = jobCount,
+        .microseconds = jobMicroseconds,
+        .delayMilliseconds = jobDelayMilliseconds,
+    };
+
+    printf("%d particles in %d chunks of %d, queue %d, sink %d us/chunk, pool %d threads,\n"
+           "%d concurrent jobs x %d us at +%d ms, best of %d runs (by total)\n",
+           particles, stream.chunkCount, BENCH_CHUNK_PARTICLES, BENCH_QUEUE_CAPACITY, sinkMicroseconds,
+           threads, jobCount, jobMicroseconds, jobDelayMilliseconds, runs);
+    printf("%-10s | %9s %9s %11s | %12s %12s | %11s\n", "relay", "first ms", "total ms", "blocked ms",
+           "job start ms", "jobs done ms", "peak MB");
+
+    const RelayMode modes[] = { MODE_BLOCKING, MODE_SUSPENDING };
+    for (int m = 0; m < 2; m++) {
+        RunResult best = { .totalMs = 1e30 };
+        for (int run = 0; run < runs; run++) {
+            RunResult result;
+            runOnce(pool, modes[m], &stream, &submitter, &result);
+            if (memcmp(stream.ring, stream.particles, sizeof(float) * BENCH_PARTICLE_FLOATS * (size_t)particles) != 0) {
+                fprintf(stderr, "sink copy differs from assembled particles\n");
+                return 1;
+            }
+            if (result.totalMs < best.totalMs) best = result;
+        }
+        printf("%-10s | %9.2f %9.1f %11.1f | %12.2f %12.1f | %11.1f\n",
+               modes[m] == MODE_BLOCKING ? "blocking" : "suspending",
+               best.firstChunkMs, best.totalMs, best.blockedMs, best.jobStartMaxMs, best.jobsDoneMs,
+               best.peakChunkMB);
+    }
+
+    taskPoolDestroyC(pool);
+    free(stream.source);
+    free(stream.particles);
+    free(stream.ring);
+    return 0;
+}
@@ -0,0 +1,149 @@
+//
+//  CollectedCounterBench.c
+//  PixelFlow
+//
+//  Конкуренция за счетчик собранных частиц: reduceCollectedCountC
+//  (CollectedCounter.c) на N потоках с разным размером группы. Группа 1 —
+//  atomic на каждую собранную частицу, как было в updateParticles раньше.
+//  Таблица в ParticleSystem/particlesystem.md (счетчик собранных частиц)
+//  получена им.
+//
+//  Не входит в Xcode-таргет. Сборка на Linux/macOS из корня репозитория:
+//
+//    P=PixelFlow/Engine/ParticleSystem
+//    cc -O2 -std=c11 -pthread -I$P/Particles
+//       Tools/CollectedCounterBench/CollectedCounterBench.c
+//       $P/Particles/CollectedCounter.c -o collected-counter-bench
+//
+//  (одной командной строкой)
+//
+//  Запуск: ./collected-counter-bench [--particles N] [--snapped 0..1]
+//          [--threads N,N,...] [--passes N]
+//
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "CollectedCounter.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_THREAD_COUNTS 8
+
+static const int groupSizes[] = { 1, 32, 256, 4096 };
+#define GROUP_SIZE_COUNT ((int)(sizeof(groupSizes) / sizeof(groupSizes[0])))
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+typedef struct {
+    const uint8_t* snapped;
+    int startIndex;
+    int count;
+    int groupSize;
+    uint32_t* counter;
+} Worker;
+
+static void* runWorker(void* context) {
+    Worker* worker = context;
+    reduceCollectedCountC(worker->snapped, worker->startIndex, worker->count, worker->groupSize, worker->counter);
+    return NULL;
+}
+
+/// Лучшее время прохода в нс/частица; counter проверяется против expected
+static double measure(const uint8_t* snapped, int particles, int threads, int groupSize,
+                      int passes, uint32_t expected) {
+    pthread_t handles[64];
+    Worker workers[64];
+    double best = 1e30;
+
+    for (int pass = 0; pass < passes; pass++) {
+        uint32_t counter = 0;
+        int chunk = (particles + threads - 1) / threads;
+
+        double start = nowSeconds();
+        for (int t = 0; t < threads; t++) {
+            int begin = t * chunk;
+            int end = begin + chunk < particles ? begin + chunk : particles;
+            workers[t] = (Worker){ snapped, begin, end > begin ? end - begin : 0, groupSize, &counter };
+            pthread_create(&handles[t], NULL, runWorker, &workers[t]);
+        }
+        for (int t = 0; t < threads; t++) pthread_join(handles[t], NULL);
+        double seconds = nowSeconds() - start;
+
+        if (counter != expected) {
+            fprintf(stderr, "counter mismatch: %u != %u\n", counter, expected);
+            exit(1);
+        }
+        if (seconds < best) best = seconds;
+    }
+    return best * 1e9 / (double)particles;
+}
+
+int main(int argc, char** argv) {
+    int particles = 4 * 1024 * 1024;
+    double snappedFraction = 0.5;
+    int passes = 20;
+    int threadCounts[MAX_THREAD_COUNTS] = { 1, 8 };
+    int threadCountTotal = 2;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--particles") == 0 && i + 1 < argc) {
+            particles = atoi(argv[++i]);
+            if (particles < 1) particles = 1;
+        } else if (strcmp(argv[i], "--snapped") == 0 && i + 1 < argc) {
+            snappedFraction = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = atoi(argv[++i]);
+            if (passes < 1) passes = 1;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threadCountTotal = 0;
+            char* list = argv[++i];
+            for (char* token = strtok(list, ","); token && threadCountTotal < MAX_THREAD_COUNTS;
+                 token = strtok(NULL, ",")) {
+                int value = atoi(token);
+                if (value >= 1 && value <= 64) threadCounts[threadCountTotal++] = value;
+            }
+            if (threadCountTotal == 0) threadCounts[threadCountTotal++] = 1;
+        }
+    }
+
+    uint8_t* snapped = malloc((size_t)particles);
+    if (!snapped) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    srand(1);
+    uint32_t expected = 0;
+    for (int i = 0; i < particles; i++) {
+        snapped[i] = (double)rand() / (double)RAND_MAX < snappedFraction;
+        expected += snapped[i];
+    }
+
+    printf("%d flags, %.0f%% snapped, best of %d passes, ns/particle\n",
+           particles, snappedFraction * 100.0, passes);
+    printf("%-8s", "threads");
+    for (int g = 0; g < GROUP_SIZE_COUNT; g++) {
+        char label[32];
+        snprintf(label, sizeof(label), "group %d", groupSizes[g]);
+        printf(" %15s", label);
+    }
+    printf("\n");
+
+    for (int t = 0; t < threadCountTotal; t++) {
+        printf("%-8d", threadCounts[t]);
+        for (int g = 0; g < GROUP_SIZE_COUNT; g++) {
+            printf(" %15.2f", measure(snapped, particles, threadCounts[t], groupSizes[g], passes, expected));
+        }
+        printf("\n");
+    }
+
+    free(snapped);
+    return 0;
+}
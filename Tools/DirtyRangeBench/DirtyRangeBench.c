@@ -0,0 +1,230 @@
+//
+//  DirtyRangeBench.c
+//  PixelFlow
+//
+//  Частичные записи CPU в кольцо частиц: слот перед записью догоняет latest
+//  либо копией целиком (как до DirtyRangeC), либо только по отрезкам, где он
+//  отстал (dirtyRangeCopyC). Учет слотов — BufferRingC, отметки — как
+//  в ParticleBufferRing.swift: публикация отмечает свой диапазон в остальных
+//  слотах, кадр GPU (compute пишет latest in-place) — весь буфер. GPU
+//  завершает кадр сразу. Таблица в ParticleSystem/particlesystem.md
+//  (DirtyRangeC) получена им; после прогона содержимое latest сверяется
+//  с эталоном.
+//
+//  Не входит в Xcode-таргет. Сборка на Linux/macOS из корня репозитория:
+//
+//    P=PixelFlow/Engine/ParticleSystem
+//    cc -O2 -std=c11 -I$P/Utils
+//       Tools/DirtyRangeBench/DirtyRangeBench.c
+//       $P/Utils/DirtyRangeC.c $P/Utils/BufferRingC.c -o dirty-range-bench
+//
+//  (одной командной строкой)
+//
+//  Запуск: ./dirty-range-bench [--particles N,N,...] [--writes N,N,...]
+//          [--chunk N] [--frames N] [--passes N]
+//
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "BufferRingC.h"
+#include "DirtyRangeC.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SLOT_COUNT 3
+#define PARTICLE_STRIDE 96   // MemoryLayout<Particle>.stride
+#define MAX_LIST 8
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+typedef struct {
+    BufferRingC ring;
+    DirtyRangeSetC stale[SLOT_COUNT];
+    uint8_t* buffers[SLOT_COUNT];
+    uint64_t bufferSize;
+} Ring;
+
+static int ringAllocate(Ring* ring, uint64_t bufferSize) {
+    ring->bufferSize = bufferSize;
+    for (int i = 0; i < SLOT_COUNT; i++) {
+        ring->buffers[i] = malloc((size_t)bufferSize);
+        if (!ring->buffers[i]) return 0;
+    }
+    return 1;
+}
+
+/// Пустое кольцо с нулевыми слотами. Буферы живут между проходами, как MTLBuffer
+/// слотов: страницы уже отображены, и замер не включает их первое касание
+static void ringReset(Ring* ring) {
+    bufferRingInitC(&ring->ring, SLOT_COUNT);
+    for (int i = 0; i < SLOT_COUNT; i++) {
+        memset(ring->buffers[i], 0, (size_t)ring->bufferSize);
+        dirtyRangeInitC(&ring->stale[i], DIRTY_RANGE_CACHE_LINE_C, ring->bufferSize);
+    }
+}
+
+static void ringFree(Ring* ring) {
+    for (int i = 0; i < SLOT_COUNT; i++) free(ring->buffers[i]);
+}
+
+/// markStale(exceptSlot:modifiedRange:); length 0 — весь буфер
+static void markStale(Ring* ring, int32_t latest, uint64_t offset, uint64_t length) {
+    for (int i = 0; i < SLOT_COUNT; i++) {
+        if (i == latest) continue;
+        if (length == 0) {
+            dirtyRangeMarkAllC(&ring->stale[i]);
+        } else {
+            dirtyRangeMarkC(&ring->stale[i], offset, length);
+        }
+    }
+}
+
+/// write(preservingContents: true, modifiedRange:) — копия latest, body, публикация
+static int ringWrite(Ring* ring, int partialCopy, uint64_t offset, uint64_t length, uint8_t value) {
+    int32_t slot = bufferRingAcquireC(&ring->ring);
+    if (slot < 0) return 0;
+    uint8_t* target = ring->buffers[slot];
+    const uint8_t* source = ring->buffers[ring->ring.latest];
+
+    if (partialCopy) {
+        dirtyRangeCopyC(&ring->stale[slot], target, source);
+    } else {
+        memcpy(target, source, (size_t)ring->bufferSize);
+    }
+    memset(target + offset, value, (size_t)length);
+
+    dirtyRangeClearC(&ring->stale[slot]);
+    markStale(ring, slot, offset, length);
+    bufferRingPublishC(&ring->ring, slot);
+    return 1;
+}
+
+/// Кадр GPU: compute пишет latest целиком. Эталон меняется так же, как слот
+static void ringFrame(Ring* ring, uint8_t* reference, uint8_t value) {
+    int32_t slot = 0;
+    int32_t writes = 0;
+    uint64_t serial = bufferRingBeginFrameC(&ring->ring, &slot, &writes);
+    if (writes) {
+        markStale(ring, slot, 0, 0);
+        // Compute меняет первую частицу каждой страницы — весь буфер отличается от прежнего
+        for (uint64_t at = 0; at < ring->bufferSize; at += 16384) {
+            ring->buffers[slot][at] = value;
+            reference[at] = value;
+        }
+    }
+    bufferRingCompleteWriteC(&ring->ring, serial);
+    bufferRingRetireC(&ring->ring, serial);
+}
+
+/// Лучшее время записи в мс; 0 — расхождение с эталоном
+static double measure(Ring* ring, uint8_t* reference, int writesPerFrame, int chunk,
+                      int frames, int passes, int partialCopy) {
+    uint64_t bufferSize = ring->bufferSize;
+    uint64_t chunkBytes = (uint64_t)chunk * PARTICLE_STRIDE;
+    uint64_t chunks = bufferSize / chunkBytes;
+    double best = 1e30;
+
+    for (int pass = 0; pass < passes; pass++) {
+        ringReset(ring);
+        memset(reference, 0, (size_t)bufferSize);
+
+        uint64_t next = 0;
+        int total = 0;
+        double elapsed = 0.0;
+        for (int frame = 0; frame < frames; frame++) {
+            for (int w = 0; w < writesPerFrame; w++) {
+                uint64_t offset = (next++ % chunks) * chunkBytes;
+                uint8_t value = (uint8_t)(1 + (total % 250));
+                double start = nowSeconds();
+                if (!ringWrite(ring, partialCopy, offset, chunkBytes, value)) {
+                    fprintf(stderr, "no free slot\n");
+                    exit(1);
+                }
+                elapsed += nowSeconds() - start;
+                memset(reference + offset, value, (size_t)chunkBytes);
+                total++;
+            }
+            ringFrame(ring, reference, (uint8_t)(frame & 0xFF));
+        }
+
+        if (memcmp(ring->buffers[ring->ring.latest], reference, (size_t)bufferSize) != 0) return 0.0;
+
+        double ms = elapsed * 1e3 / total;
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+static int parseList(char* list, int* out, int capacity) {
+    int n = 0;
+    for (char* token = strtok(list, ","); token && n < capacity; token = strtok(NULL, ",")) {
+        int value = atoi(token);
+        if (value > 0) out[n++] = value;
+    }
+    return n;
+}
+
+int main(int argc, char** argv) {
+    int sizes[MAX_LIST] = { 1 << 20, 4 << 20 };
+    int sizeCount = 2;
+    int writeCounts[MAX_LIST] = { 1, 8, 64 };
+    int writeCountTotal = 3;
+    int chunk = 16384;
+    int frames = 8;
+    int passes = 3;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--particles") == 0 && i + 1 < argc) {
+            sizeCount = parseList(argv[++i], sizes, MAX_LIST);
+        } else if (strcmp(argv[i], "--writes") == 0 && i + 1 < argc) {
+            writeCountTotal = parseList(argv[++i], writeCounts, MAX_LIST);
+        } else if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc) {
+            chunk = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--particles N,...] [--writes N,...] [--chunk N] [--frames N] [--passes N]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (sizeCount <= 0 || writeCountTotal <= 0 || chunk <= 0 || frames <= 0 || passes <= 0) return 2;
+
+    printf("%d slots, writes of %d particles, %d frames, best of %d, ms per write\n",
+           SLOT_COUNT, chunk, frames, passes);
+    printf("%10s %8s %12s %12s\n", "particles", "writes", "full copy", "dirty ranges");
+
+    for (int s = 0; s < sizeCount; s++) {
+        if (sizes[s] < chunk) continue;
+        uint64_t bufferSize = (uint64_t)sizes[s] * PARTICLE_STRIDE;
+        Ring ring;
+        uint8_t* reference = malloc((size_t)bufferSize);
+        if (!reference || !ringAllocate(&ring, bufferSize)) {
+            fprintf(stderr, "out of memory for %d particles\n", sizes[s]);
+            return 1;
+        }
+
+        for (int w = 0; w < writeCountTotal; w++) {
+            double full = measure(&ring, reference, writeCounts[w], chunk, frames, passes, 0);
+            double partial = measure(&ring, reference, writeCounts[w], chunk, frames, passes, 1);
+            if (full == 0.0 || partial == 0.0) {
+                printf("FAIL: latest slot differs from reference (%d particles, %d writes)\n",
+                       sizes[s], writeCounts[w]);
+                return 1;
+            }
+            printf("%10d %8d %12.2f %12.2f\n", sizes[s], writeCounts[w], full, partial);
+        }
+        ringFree(&ring);
+        free(reference);
+    }
+    return 0;
+}
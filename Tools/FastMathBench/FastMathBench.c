@@ -0,0 +1,153 @@
+//
+//  FastMathBench.c
+//  PixelFlow
+//
+//  Точность и скорость FastMathC.h (CPU-двойник Shaders/Core/FastMath.h)
+//  против libm: максимальная ошибка по равномерной сетке и нс/элемент
+//  на массиве. Таблицы в Shaders/shaders.md (раздел FastMath.h) получены им.
+//
+//  Не входит в Xcode-таргет. Сборка на Linux/macOS из корня репозитория:
+//
+//    cc -O2 -march=native -std=c11 -IPixelFlow/Engine/ParticleSystem/Utils
+//       Tools/FastMathBench/FastMathBench.c -lm -o fastmath-bench
+//
+//  (одной командной строкой)
+//
+//  Запуск: ./fastmath-bench [--points N] [--elements N] [--passes N]
+//
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "FastMathC.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// MARK: - Accuracy
+
+typedef float (*UnaryF)(float);
+typedef double (*UnaryD)(double);
+
+/// Максимальная ошибка на сетке [lo, hi]: абсолютная или относительная
+static double maxError(UnaryF approx, UnaryD reference, double lo, double hi, int points, int relative) {
+    double worst = 0.0;
+    for (int i = 0; i < points; i++) {
+        float x = (float)(lo + (hi - lo) * (double)i / (double)(points - 1));
+        double expected = reference((double)x);
+        double error = fabs((double)approx(x) - expected);
+        if (relative && expected != 0.0) error /= fabs(expected);
+        if (error > worst) worst = error;
+    }
+    return worst;
+}
+
+static double log2Reference(double x) { return log2(x); }
+
+static double maxPowError(int points) {
+    // Сетка points узлов: ~sqrt(points) по каждой оси
+    int side = (int)sqrt((double)points);
+    double worst = 0.0;
+    for (int i = 0; i < side; i++) {
+        float x = (float)i / (float)(side - 1);
+        for (int j = 0; j < side; j++) {
+            float y = 0.5f + 3.5f * (float)j / (float)(side - 1);
+            double error = fabs((double)approxPowC(x, y) - pow((double)x, (double)y));
+            if (error > worst) worst = error;
+        }
+    }
+    return worst;
+}
+
+// MARK: - Speed
+
+/// Цикл на каждую функцию, а не указатель: вызов должен инлайниться,
+/// как в шейдере. Сумма не дает компилятору выбросить цикл
+#define DEFINE_TIMER(name, expression)                                              \
+    static double name(const float* input, int count, int passes, float* sink) {   \
+        double best = 1e30;                                                         \
+        for (int pass = 0; pass < passes; pass++) {                                 \
+            double start = nowSeconds();                                            \
+            float sum = 0.0f;                                                       \
+            for (int i = 0; i < count; i++) {                                       \
+                float x = input[i];                                                 \
+                sum += (expression);                                                \
+            }                                                                       \
+            double seconds = nowSeconds() - start;                                  \
+            *sink += sum;                                                           \
+            if (seconds < best) best = seconds;                                     \
+        }                                                                           \
+        return best * 1e9 / (double)count;                                          \
+    }
+
+DEFINE_TIMER(timeSinf, sinf(x))
+DEFINE_TIMER(timeApproxSin, approxSinC(x))
+DEFINE_TIMER(timeCosf, cosf(x))
+DEFINE_TIMER(timeApproxCos, approxCosC(x))
+DEFINE_TIMER(timeExpf, expf(x))
+DEFINE_TIMER(timeApproxExp, approxExpC(x))
+DEFINE_TIMER(timePowf, powf(x, 2.2f))
+DEFINE_TIMER(timeApproxPow, approxPowC(x, 2.2f))
+
+int main(int argc, char** argv) {
+    int points = 200000;
+    int elements = 1000000;
+    int passes = 50;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--points") == 0 && i + 1 < argc) {
+            points = atoi(argv[++i]);
+            if (points < 2) points = 2;
+        } else if (strcmp(argv[i], "--elements") == 0 && i + 1 < argc) {
+            elements = atoi(argv[++i]);
+            if (elements < 1) elements = 1;
+        } else if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = atoi(argv[++i]);
+            if (passes < 1) passes = 1;
+        }
+    }
+
+    printf("accuracy (%d points, against libm double):\n", points);
+    printf("%-11s %-22s %10s\n", "function", "range", "max error");
+    printf("%-11s %-22s %10.1e abs\n", "approxSin", "[-100, 100]", maxError(approxSinC, sin, -100.0, 100.0, points, 0));
+    printf("%-11s %-22s %10.1e abs\n", "approxCos", "[-100, 100]", maxError(approxCosC, cos, -100.0, 100.0, points, 0));
+    printf("%-11s %-22s %10.1e rel\n", "approxExp", "[-20, 20]", maxError(approxExpC, exp, -20.0, 20.0, points, 1));
+    printf("%-11s %-22s %10.1e abs\n", "approxLog2", "(0, 1]", maxError(approxLog2C, log2Reference, 1e-6, 1.0, points, 0));
+    printf("%-11s %-22s %10.1e abs\n", "approxPow", "x [0, 1], y [0.5, 4]", maxPowError(points));
+
+    float* input = malloc(sizeof(float) * (size_t)elements);
+    float* unit = malloc(sizeof(float) * (size_t)elements);
+    if (!input || !unit) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    srand(1);
+    for (int i = 0; i < elements; i++) {
+        input[i] = ((float)rand() / (float)RAND_MAX) * 40.0f - 20.0f;
+        unit[i] = (float)rand() / (float)RAND_MAX;
+    }
+
+    float sink = 0.0f;
+    printf("\nspeed (%d elements, best of %d passes, ns/element):\n", elements, passes);
+    printf("%-6s %6s | %-11s %6s\n", "libm", "ns", "FastMathC", "ns");
+    printf("%-6s %6.2f | %-11s %6.2f\n", "sinf", timeSinf(input, elements, passes, &sink),
+           "approxSinC", timeApproxSin(input, elements, passes, &sink));
+    printf("%-6s %6.2f | %-11s %6.2f\n", "cosf", timeCosf(input, elements, passes, &sink),
+           "approxCosC", timeApproxCos(input, elements, passes, &sink));
+    printf("%-6s %6.2f | %-11s %6.2f\n", "expf", timeExpf(input, elements, passes, &sink),
+           "approxExpC", timeApproxExp(input, elements, passes, &sink));
+    printf("%-6s %6.2f | %-11s %6.2f\n", "powf", timePowf(unit, elements, passes, &sink),
+           "approxPowC", timeApproxPow(unit, elements, passes, &sink));
+    printf("(checksum %g)\n", (double)sink);
+
+    free(input);
+    free(unit);
+    return 0;
+}
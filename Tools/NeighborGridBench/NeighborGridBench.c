@@ -0,0 +1,218 @@
+//
+//  NeighborGridBench.c
+//  PixelFlow
+//
+//  Стоимость сетки соседей (NeighborGridC.c) при разной плотности:
+//  последовательный buildNeighborGridC, параллельный counting sort
+//  (neighborGridCountC → neighborGridScanC → neighborGridScatterC) на N потоках
+//  и applyNeighborForcesC. Параллельная раскладка сверяется с последовательной.
+//  Таблицы в ParticleSystem/particlesystem.md (NeighborGridC) получены им.
+//
+//  Не входит в Xcode-таргет. Сборка на Linux/macOS из корня репозитория:
+//
+//    P=PixelFlow/Engine/ParticleSystem
+//    cc -O2 -std=c11 -pthread -I$P/Particles
+//       Tools/NeighborGridBench/NeighborGridBench.c
+//       $P/Particles/NeighborGridC.c -lm -o neighbor-grid-bench
+//
+//  (одной командной строкой)
+//
+//  Запуск: ./neighbor-grid-bench [--threads N] [--passes N]
+//
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "NeighborGridC.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Радиус 6 px на экране 1170 px → сетка 195×195, как у NeighborInteraction на iPhone
+#define BENCH_SCREEN_WIDTH 1170.0f
+#define BENCH_RADIUS_PIXELS 6.0f
+#define BENCH_MAX_GRID_DIM 512
+#define BENCH_MAX_NEIGHBORS 27
+#define BENCH_MAX_THREADS 64
+
+typedef struct {
+    int particles;
+    int areaDivisor;   // Частицы занимают 1/areaDivisor экрана
+} BenchCase;
+
+static const BenchCase cases[] = {
+    { 10000, 1 }, { 100000, 1 }, { 300000, 1 }, { 1000000, 1 },
+    { 100000, 4 }, { 1000000, 4 }, { 100000, 16 }, { 1000000, 16 },
+};
+#define BENCH_CASE_COUNT ((int)(sizeof(cases) / sizeof(cases[0])))
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// MARK: - Parallel build
+
+typedef enum {
+    BUILD_STAGE_COUNT,
+    BUILD_STAGE_SCATTER,
+} BuildStage;
+
+typedef struct {
+    const NeighborGridBuildC* build;
+    BuildStage stage;
+    int worker;
+} BuildJob;
+
+static void* buildWorker(void* arg) {
+    BuildJob* job = arg;
+    if (job->stage == BUILD_STAGE_COUNT) {
+        neighborGridCountC(job->build, job->worker);
+    } else {
+        neighborGridScatterC(job->build, job->worker);
+    }
+    return NULL;
+}
+
+/// Стадия на всех воркерах: нулевой на текущем потоке, как в TraceReplay
+static void runBuildStage(const NeighborGridBuildC* build, BuildStage stage) {
+    pthread_t handles[BENCH_MAX_THREADS];
+    BuildJob jobs[BENCH_MAX_THREADS];
+    for (int t = 0; t < build->workerCount; t++) {
+        jobs[t] = (BuildJob){ .build = build, .stage = stage, .worker = t };
+        if (t > 0) pthread_create(&handles[t], NULL, buildWorker, &jobs[t]);
+    }
+    buildWorker(&jobs[0]);
+    for (int t = 1; t < build->workerCount; t++) {
+        pthread_join(handles[t], NULL);
+    }
+}
+
+static void buildParallel(const NeighborGridBuildC* build) {
+    runBuildStage(build, BUILD_STAGE_COUNT);
+    neighborGridScanC(build);
+    runBuildStage(build, BUILD_STAGE_SCATTER);
+}
+
+// MARK: - Main
+
+int main(int argc, char** argv) {
+    int threads = 8;
+    int passes = 5;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+            if (threads < 1) threads = 1;
+            if (threads > BENCH_MAX_THREADS) threads = BENCH_MAX_THREADS;
+        } else if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = atoi(argv[++i]);
+            if (passes < 1) passes = 1;
+        }
+    }
+
+    float radius = 2.0f * BENCH_RADIUS_PIXELS / BENCH_SCREEN_WIDTH;
+    NeighborGridDimsC dims = neighborGridDimsC(radius, BENCH_MAX_GRID_DIM);
+    NeighborForceParamsC forceParams = {
+        .radius = radius,
+        .separationStrength = 1.0f,
+        .cohesionStrength = 0.2f,
+        .maxNeighbors = BENCH_MAX_NEIGHBORS,
+    };
+
+    int maxParticles = 0;
+    for (int c = 0; c < BENCH_CASE_COUNT; c++) {
+        if (cases[c].particles > maxParticles) maxParticles = cases[c].particles;
+    }
+    size_t n = (size_t)maxParticles;
+    size_t cells = (size_t)dims.cellCount;
+    float* positions = malloc(sizeof(float) * 2 * n);
+    uint32_t* cellStarts = malloc(sizeof(uint32_t) * (cells + 1));
+    uint32_t* cellCursors = malloc(sizeof(uint32_t) * cells);
+    uint32_t* workerCursors = malloc(sizeof(uint32_t) * cells * (size_t)threads);
+    uint32_t* particleCells = malloc(sizeof(uint32_t) * n);
+    uint32_t* sortedIndices = malloc(sizeof(uint32_t) * n);
+    uint32_t* parallelIndices = malloc(sizeof(uint32_t) * n);
+    float* sortedPositions = malloc(sizeof(float) * 2 * n);
+    float* forces = malloc(sizeof(float) * 2 * n);
+    if (!positions || !cellStarts || !cellCursors || !workerCursors || !particleCells ||
+        !sortedIndices || !parallelIndices || !sortedPositions || !forces) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    printf("grid %dx%d, radius %.0f px of %.0f, max %d neighbors, %d threads, best of %d passes, ns/particle\n",
+           dims.gridDim, dims.gridDim, BENCH_RADIUS_PIXELS, BENCH_SCREEN_WIDTH, BENCH_MAX_NEIGHBORS,
+           threads, passes);
+    printf("%9s %6s | %8s %10s | %8s %10s %14s\n",
+           "particles", "area", "build 1", "build N", "forces", "total ms", "avg neighbors");
+
+    for (int c = 0; c < BENCH_CASE_COUNT; c++) {
+        int count = cases[c].particles;
+        // Квадрат со стороной 2/sqrt(divisor) в центре экрана
+        float side = 2.0f / sqrtf((float)cases[c].areaDivisor);
+        srand(1);
+        for (int i = 0; i < count; i++) {
+            positions[2 * i] = ((float)rand() / (float)RAND_MAX - 0.5f) * side;
+            positions[2 * i + 1] = ((float)rand() / (float)RAND_MAX - 0.5f) * side;
+        }
+
+        NeighborGridBuildC build = {
+            .positions = positions,
+            .strideFloats = 2,
+            .count = count,
+            .dims = dims,
+            .workerCount = threads,
+            .cellStarts = cellStarts,
+            .workerCursors = workerCursors,
+            .particleCells = particleCells,
+            .sortedIndices = parallelIndices,
+            .sortedPositions = sortedPositions,
+        };
+
+        double serialBest = 1e30, parallelBest = 1e30, forcesBest = 1e30;
+        long pairs = 0;
+        for (int pass = 0; pass < passes; pass++) {
+            double start = nowSeconds();
+            buildParallel(&build);
+            double seconds = nowSeconds() - start;
+            if (seconds < parallelBest) parallelBest = seconds;
+
+            start = nowSeconds();
+            buildNeighborGridC(positions, 2, count, dims, cellStarts, cellCursors,
+                               particleCells, sortedIndices, sortedPositions);
+            seconds = nowSeconds() - start;
+            if (seconds < serialBest) serialBest = seconds;
+
+            start = nowSeconds();
+            pairs = applyNeighborForcesC(dims, forceParams, cellStarts, sortedIndices, sortedPositions,
+                                         0, count, forces);
+            seconds = nowSeconds() - start;
+            if (seconds < forcesBest) forcesBest = seconds;
+        }
+
+        if (memcmp(parallelIndices, sortedIndices, sizeof(uint32_t) * (size_t)count) != 0) {
+            fprintf(stderr, "parallel build differs from serial for %d particles\n", count);
+            return 1;
+        }
+
+        printf("%9d %4s%-2d | %8.1f %10.1f | %8.1f %10.2f %14.1f\n",
+               count, "1/", cases[c].areaDivisor,
+               serialBest * 1e9 / count, parallelBest * 1e9 / count, forcesBest * 1e9 / count,
+               (serialBest + forcesBest) * 1000.0, (double)pairs / (double)count);
+    }
+
+    free(positions);
+    free(cellStarts);
+    free(cellCursors);
+    free(workerCursors);
+    free(particleCells);
+    free(sortedIndices);
+    free(parallelIndices);
+    free(sortedPositions);
+    free(forces);
+    return 0;
+}
@@ -0,0 +1,350 @@
+//
+//  ParticleCacheBench.c
+//  PixelFlow
+//
+//  Бинарный кэш частиц (ParticleCacheFileC.h): запись, mmap + заголовок,
+//  контрольная сумма и декодирование в RAW и QUANTIZED, декодирование
+//  префикса и ошибка квантования. Частицы — как у сборщика: позиции из
+//  пикселей экрана, targetPosition = position, цвета — 8-битные коды sRGB,
+//  size/life/idleChaoticMotion постоянны. Затем проверяет, что битый
+//  payload, обрезанный файл, чужой magic и префикс длиннее файла отвергаются.
+//  Таблицы в ImageParticleGenerator/Caching/caching.md («Бинарный кэш частиц»,
+//  «Квантованная кодировка») получены им.
+//
+//  Не входит в Xcode-таргет. Сборка на Linux/macOS из корня репозитория:
+//
+//    P=PixelFlow/Engine/ParticleSystem
+//    G=PixelFlow/Engine/Generators/ImageParticleGenerator
+//    cc -O2 -std=c11 -I$G/Caching -I$P/Particles
+//       Tools/ParticleCacheBench/ParticleCacheBench.c
+//       $G/Caching/ParticleCacheFileC.c $P/Particles/ColorSpaceC.c
+//       -lm -o particle-cache-bench
+//
+//  (одной командной строкой)
+//
+//  Запуск: ./particle-cache-bench [--particles N,N,...] [--dir PATH]
+//          [--screen WxH] [--passes N] [--text]
+//  --text добавляет нижнюю оценку JSON (печать %.9g и разбор strtof) для
+//  первого размера — на 1M частиц это еще несколько секунд.
+//
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ParticleCacheFileC.h"
+#include "ColorSpaceC.h"
+#include "SimulationStepC.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_SIZES 8
+#define PREFIX_FRACTION 4   // префикс — четверть частиц
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t nextRandom(uint32_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+/// Частицы сборщика: пиксель экрана → NDC, скорость до 0.01, цвет из 8-битных кодов
+static void makeParticles(ParticleC* particles, uint64_t count, int width, int height) {
+    uint32_t state = 0x2545F491u;
+    memset(particles, 0, sizeof(ParticleC) * (size_t)count);
+    for (uint64_t i = 0; i < count; i++) {
+        ParticleC* p = &particles[i];
+        float x = (float)(nextRandom(&state) % (uint32_t)width) + 0.5f;
+        float y = (float)(nextRandom(&state) % (uint32_t)height) + 0.5f;
+        p->position[0] = x / (float)width * 2.0f - 1.0f;
+        p->position[1] = 1.0f - y / (float)height * 2.0f;
+        p->velocity[0] = ((float)(nextRandom(&state) % 20001u) - 10000.0f) * 1e-6f;
+        p->velocity[1] = ((float)(nextRandom(&state) % 20001u) - 10000.0f) * 1e-6f;
+        uint32_t rgb = nextRandom(&state);
+        for (int c = 0; c < 3; c++) p->color[c] = srgb8ToLinearC((uint8_t)(rgb >> (8 * c)));
+        p->color[3] = 1.0f;
+        memcpy(p->targetPosition, p->position, sizeof(p->position));
+        memcpy(p->originalColor, p->color, sizeof(p->color));
+        p->size = p->baseSize = 2.0f;
+        p->life = 1.0f;
+    }
+}
+
+static uint64_t fileSizeAt(const char* path) {
+    struct stat info;
+    return stat(path, &info) == 0 ? (uint64_t)info.st_size : 0;
+}
+
+typedef struct {
+    double write;
+    double mapHeader;
+    double mapChecksum;
+    double decode;
+    double decodePrefix;
+    uint64_t fileSize;
+    uint32_t encoding;
+} Timings;
+
+static void keepBest(double* best, double value) {
+    if (value < *best) *best = value;
+}
+
+/// Наибольшая ошибка полей после декодирования
+static void maxErrors(const ParticleC* a, const ParticleC* b, uint64_t count,
+                      float* position, float* velocity, float* color) {
+    *position = *velocity = *color = 0.0f;
+    for (uint64_t i = 0; i < count; i++) {
+        for (int axis = 0; axis < 2; axis++) {
+            *position = fmaxf(*position, fabsf(a[i].position[axis] - b[i].position[axis]));
+            *velocity = fmaxf(*velocity, fabsf(a[i].velocity[axis] - b[i].velocity[axis]));
+        }
+        for (int c = 0; c < 4; c++) *color = fmaxf(*color, fabsf(a[i].color[c] - b[i].color[c]));
+    }
+}
+
+static int measure(const char* path, const ParticleC* particles, uint64_t count, uint32_t encoding,
+                   int passes, ParticleC* decoded, Timings* t) {
+    *t = (Timings){ 1e30, 1e30, 1e30, 1e30, 1e30, 0, 0 };
+    const uint64_t prefix = count / PREFIX_FRACTION;
+
+    for (int pass = 0; pass < passes; pass++) {
+        double start = nowSeconds();
+        if (particleCacheWriteC(path, particles, count, encoding, &t->fileSize) != PARTICLE_CACHE_OK) {
+            fprintf(stderr, "write failed: %s\n", path);
+            return 0;
+        }
+        keepBest(&t->write, nowSeconds() - start);
+
+        // Page cache теплый: файл только что записан
+        ParticleCacheMappingC mapping;
+        start = nowSeconds();
+        if (particleCacheMapC(path, 0, &mapping) != PARTICLE_CACHE_OK) return 0;
+        keepBest(&t->mapHeader, nowSeconds() - start);
+        particleCacheUnmapC(&mapping);
+
+        start = nowSeconds();
+        if (particleCacheMapC(path, 1, &mapping) != PARTICLE_CACHE_OK) return 0;
+        keepBest(&t->mapChecksum, nowSeconds() - start);
+        t->encoding = mapping.header.encoding;
+
+        start = nowSeconds();
+        if (particleCacheDecodeC(&mapping, prefix, decoded) != PARTICLE_CACHE_OK) return 0;
+        keepBest(&t->decodePrefix, nowSeconds() - start);
+
+        start = nowSeconds();
+        if (particleCacheDecodeC(&mapping, count, decoded) != PARTICLE_CACHE_OK) return 0;
+        keepBest(&t->decode, nowSeconds() - start);
+        particleCacheUnmapC(&mapping);
+    }
+    return 1;
+}
+
+/// Нижняя оценка JSON: только печать и разбор чисел, без промежуточных объектов
+static void measureText(const char* path, const ParticleC* particles, uint64_t count) {
+    FILE* file = fopen(path, "w");
+    if (!file) return;
+    double start = nowSeconds();
+    for (uint64_t i = 0; i < count; i++) {
+        const float* fields = (const float*)&particles[i];
+        for (int k = 0; k < 23; k++) fprintf(file, "%.9g,", fields[k]);
+        fprintf(file, "%u\n", particles[i].idleChaoticMotion);
+    }
+    fclose(file);
+    double printSeconds = nowSeconds() - start;
+    uint64_t size = fileSizeAt(path);
+
+    file = fopen(path, "r");
+    if (!file) return;
+    char* text = malloc((size_t)size + 1);
+    if (!text || fread(text, 1, (size_t)size, file) != size) {
+        fclose(file);
+        free(text);
+        return;
+    }
+    fclose(file);
+    text[size] = '\0';
+
+    start = nowSeconds();
+    double sum = 0.0;
+    for (char* cursor = text; *cursor; ) {
+        char* end;
+        sum += strtof(cursor, &end);
+        if (end == cursor) end++;
+        cursor = (*end == ',' || *end == '\n') ? end + 1 : end;
+    }
+    double parseSeconds = nowSeconds() - start;
+    free(text);
+    unlink(path);
+    printf("  text: %.0f MB, print %.1f s, parse %.1f s (checksum %.3g)\n",
+           (double)size / 1e6, printSeconds, parseSeconds, sum);
+}
+
+static int expectStatus(const char* name, int status, int expected) {
+    if (status == expected) {
+        printf("  %-28s rejected (%d)\n", name, status);
+        return 1;
+    }
+    printf("  FAIL: %-22s status %d, expected %d\n", name, status, expected);
+    return 0;
+}
+
+static int copyFile(const char* from, const char* to, uint64_t length) {
+    FILE* in = fopen(from, "rb");
+    FILE* out = fopen(to, "wb");
+    int ok = in && out;
+    char chunk[65536];
+    while (ok && length > 0) {
+        size_t want = length < sizeof(chunk) ? (size_t)length : sizeof(chunk);
+        size_t got = fread(chunk, 1, want, in);
+        ok = got == want && fwrite(chunk, 1, got, out) == got;
+        length -= got;
+    }
+    if (in) fclose(in);
+    if (out) fclose(out);
+    return ok;
+}
+
+static int patchByte(const char* path, uint64_t offset, uint8_t mask) {
+    FILE* file = fopen(path, "r+b");
+    if (!file) return 0;
+    int byte = (fseek(file, (long)offset, SEEK_SET) == 0) ? fgetc(file) : EOF;
+    int ok = byte != EOF && fseek(file, (long)offset, SEEK_SET) == 0 && fputc(byte ^ mask, file) != EOF;
+    fclose(file);
+    return ok;
+}
+
+/// Битые файлы отвергаются при отображении, а не читаются со сдвигом или мусором
+static int checkRejections(const char* path, const char* scratch, uint64_t count, ParticleC* decoded) {
+    ParticleCacheMappingC mapping;
+    uint64_t size = fileSizeAt(path);
+    int ok = 1;
+
+    ok &= copyFile(path, scratch, size) && patchByte(scratch, PARTICLE_CACHE_PAGE_SIZE + 1000, 0x40);
+    ok &= expectStatus("corrupt payload", particleCacheMapC(scratch, 1, &mapping), PARTICLE_CACHE_ERROR_CHECKSUM);
+
+    ok &= copyFile(path, scratch, size / 2);
+    ok &= expectStatus("truncated file", particleCacheMapC(scratch, 0, &mapping), PARTICLE_CACHE_ERROR_FORMAT);
+
+    ok &= copyFile(path, scratch, 40);
+    ok &= expectStatus("header only", particleCacheMapC(scratch, 0, &mapping), PARTICLE_CACHE_ERROR_FORMAT);
+
+    ok &= copyFile(path, scratch, size) && patchByte(scratch, 0, 0x01);
+    ok &= expectStatus("foreign magic", particleCacheMapC(scratch, 0, &mapping), PARTICLE_CACHE_ERROR_FORMAT);
+
+    if (particleCacheMapC(path, 1, &mapping) != PARTICLE_CACHE_OK) {
+        printf("  FAIL: intact file does not map\n");
+        return 0;
+    }
+    ok &= expectStatus("prefix beyond count", particleCacheDecodeC(&mapping, count + 1, decoded),
+                       PARTICLE_CACHE_ERROR_FORMAT);
+    particleCacheUnmapC(&mapping);
+
+    unlink(scratch);
+    return ok;
+}
+
+static int parseList(char* list, int* out, int capacity) {
+    int n = 0;
+    for (char* token = strtok(list, ","); token && n < capacity; token = strtok(NULL, ",")) {
+        int value = atoi(token);
+        if (value > 0) out[n++] = value;
+    }
+    return n;
+}
+
+int main(int argc, char** argv) {
+    int sizes[MAX_SIZES] = { 1000000, 4000000 };
+    int sizeCount = 2;
+    const char* directory = "/tmp";
+    int width = 1179;
+    int height = 2556;
+    int passes = 3;
+    int text = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--particles") == 0 && i + 1 < argc) {
+            sizeCount = parseList(argv[++i], sizes, MAX_SIZES);
+        } else if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc) {
+            directory = argv[++i];
+        } else if (strcmp(argv[i], "--screen") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &width, &height) != 2) return 2;
+        } else if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--text") == 0) {
+            text = 1;
+        } else {
+            fprintf(stderr, "usage: %s [--particles N,...] [--dir PATH] [--screen WxH] [--passes N] [--text]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (sizeCount <= 0 || passes <= 0 || width <= 0 || height <= 0) return 2;
+
+    char path[1024];
+    char scratch[1024];
+    snprintf(path, sizeof(path), "%s/particle-cache-bench.particles", directory);
+    snprintf(scratch, sizeof(scratch), "%s/particle-cache-bench-broken.particles", directory);
+
+    printf("screen %dx%d, prefix 1/%d, best of %d, ms\n", width, height, PREFIX_FRACTION, passes);
+    printf("%9s %-10s %9s %9s %11s %11s %9s %9s %9s\n", "particles", "encoding", "file MB",
+           "write", "map+header", "map+check", "decode", "prefix", "GB/s");
+
+    int ok = 1;
+    for (int s = 0; s < sizeCount; s++) {
+        uint64_t count = (uint64_t)sizes[s];
+        ParticleC* particles = malloc(sizeof(ParticleC) * (size_t)count);
+        ParticleC* decoded = malloc(sizeof(ParticleC) * (size_t)count);
+        if (!particles || !decoded) {
+            fprintf(stderr, "out of memory for %d particles\n", sizes[s]);
+            return 1;
+        }
+        makeParticles(particles, count, width, height);
+
+        const uint32_t encodings[2] = { PARTICLE_CACHE_ENCODING_RAW, PARTICLE_CACHE_ENCODING_QUANTIZED };
+        for (int e = 0; e < 2; e++) {
+            Timings t;
+            if (!measure(path, particles, count, encodings[e], passes, decoded, &t)) {
+                printf("FAIL: round trip %s\n", e ? "quantized" : "raw");
+                return 1;
+            }
+            // Скорость декодирования — по выходу (96 байт на частицу)
+            double rate = (double)count * sizeof(ParticleC) / t.decode / 1e9;
+            printf("%9d %-10s %9.1f %9.2f %11.3f %11.2f %9.2f %9.2f %9.1f\n", sizes[s],
+                   t.encoding == PARTICLE_CACHE_ENCODING_QUANTIZED ? "quantized" : "raw",
+                   (double)t.fileSize / (1024.0 * 1024.0), t.write * 1e3, t.mapHeader * 1e3,
+                   t.mapChecksum * 1e3, t.decode * 1e3, t.decodePrefix * 1e3, rate);
+
+            float position, velocity, color;
+            maxErrors(particles, decoded, count, &position, &velocity, &color);
+            if (t.encoding == PARTICLE_CACHE_ENCODING_RAW) {
+                if (memcmp(particles, decoded, sizeof(ParticleC) * (size_t)count) != 0) {
+                    printf("FAIL: raw round trip is not exact\n");
+                    ok = 0;
+                }
+            } else {
+                printf("  error: position %.2g NDC (%.3g px), velocity %.2g, color %.2g\n", position,
+                       position * 0.5f * (float)width, velocity, color);
+            }
+            if (e == 1 && s == 0) ok &= checkRejections(path, scratch, count, decoded);
+        }
+
+        if (text && s == 0) measureText(path, particles, count);
+        free(particles);
+        free(decoded);
+    }
+
+    unlink(path);
+    if (!ok) return 1;
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,248 @@
+//
+//  ShardedLRUBench.c
+//  PixelFlow
+//
+//  Пропускная способность кэша в памяти (ShardedLRUCacheC.h, MemoryCache)
+//  на N потоках: 1 шард (одна блокировка, как общий замок) против 16.
+//  Смесь 15/16 get и 1/16 put по ключам с перекосом; значения —
+//  выделенные блоки со счетчиком ссылок (как retain/release Swift-объектов),
+//  промах get выделяет новое значение и кладет его в кэш. Время включает
+//  выделение и освобождение значений. После прогона сверяется, что все
+//  значения освобождены ровно один раз. Таблица в ImageParticleGenerator/
+//  Caching/caching.md (MemoryCache) получена им.
+//
+//  Не входит в Xcode-таргет. Сборка на Linux/macOS из корня репозитория:
+//
+//    G=PixelFlow/Engine/Generators/ImageParticleGenerator
+//    cc -O2 -std=c11 -pthread -I$G/Caching
+//       Tools/ShardedLRUBench/ShardedLRUBench.c
+//       $G/Caching/ShardedLRUCacheC.c -o sharded-lru-bench
+//
+//  (одной командной строкой)
+//
+//  Запуск: ./sharded-lru-bench [--ops N] [--keys N] [--capacity-mb N]
+//          [--threads N,N,...] [--passes N]
+//
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ShardedLRUCacheC.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_THREAD_COUNTS 8
+#define MAX_THREADS 64
+#define VALUE_MIN_BYTES 256u
+#define VALUE_SPREAD_BYTES 4096u
+#define PUT_EVERY 16   // 1 из 16 операций — put
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// MARK: - Значения со счетчиком ссылок
+
+typedef struct {
+    atomic_int references;
+    uint32_t size;
+    uint64_t key;
+} Value;
+
+static atomic_llong liveValues;
+
+static Value* makeValue(uint64_t key, uint32_t size) {
+    Value* value = malloc(size);
+    if (!value) return NULL;
+    atomic_init(&value->references, 1);
+    value->size = size;
+    value->key = key;
+    atomic_fetch_add_explicit(&liveValues, 1, memory_order_relaxed);
+    return value;
+}
+
+static void retainValue(void* pointer) {
+    atomic_fetch_add_explicit(&((Value*)pointer)->references, 1, memory_order_relaxed);
+}
+
+static void releaseValue(void* pointer) {
+    Value* value = pointer;
+    if (atomic_fetch_sub_explicit(&value->references, 1, memory_order_acq_rel) == 1) {
+        atomic_fetch_sub_explicit(&liveValues, 1, memory_order_relaxed);
+        free(value);
+    }
+}
+
+// MARK: - Нагрузка
+
+static uint64_t nextRandom(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+/// Ключ с перекосом: u³ — малые номера заметно чаще; хеш как у hashValue
+static uint64_t skewedKey(uint64_t* state, uint64_t keys) {
+    double u = (double)(nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+    uint64_t rank = (uint64_t)(u * u * u * (double)keys);
+    return mix64(rank + 1);
+}
+
+static uint32_t valueSize(uint64_t key) {
+    return VALUE_MIN_BYTES + (uint32_t)(key % VALUE_SPREAD_BYTES);
+}
+
+typedef struct {
+    ShardedLRUCacheC* cache;
+    uint64_t operations;
+    uint64_t keys;
+    uint64_t seed;
+    uint64_t corrupt;
+    pthread_barrier_t* start;
+} Worker;
+
+static void* runWorker(void* context) {
+    Worker* worker = context;
+    uint64_t state = worker->seed;
+    pthread_barrier_wait(worker->start);
+
+    for (uint64_t i = 0; i < worker->operations; i++) {
+        uint64_t key = skewedKey(&state, worker->keys);
+        if (i % PUT_EVERY == PUT_EVERY - 1) {
+            Value* value = makeValue(key, valueSize(key));
+            if (value) shardedLRUPutC(worker->cache, key, value, value->size);
+            continue;
+        }
+        Value* value = shardedLRUGetC(worker->cache, key);
+        if (value) {
+            if (value->key != key) worker->corrupt++;
+            releaseValue(value);
+        } else {
+            // Промах: значение строится заново и кладется в кэш
+            value = makeValue(key, valueSize(key));
+            if (value) shardedLRUPutC(worker->cache, key, value, value->size);
+        }
+    }
+    return NULL;
+}
+
+typedef struct {
+    double seconds;
+    double hitRate;
+    uint64_t corrupt;
+} RunResult;
+
+static int run(uint32_t shards, int threads, uint64_t operations, uint64_t keys, int64_t capacity,
+               RunResult* result) {
+    ShardedLRUCallbacksC callbacks = { retainValue, releaseValue };
+    ShardedLRUCacheC* cache = shardedLRUCreateC(shards, capacity, callbacks);
+    if (!cache) return 0;
+
+    pthread_t handles[MAX_THREADS];
+    Worker workers[MAX_THREADS];
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, (unsigned)threads + 1);
+
+    for (int t = 0; t < threads; t++) {
+        workers[t] = (Worker){ cache, operations / (uint64_t)threads, keys, 0x9E3779B97F4A7C15ull * (uint64_t)(t + 1), 0, &start };
+        pthread_create(&handles[t], NULL, runWorker, &workers[t]);
+    }
+    double begin = nowSeconds();
+    pthread_barrier_wait(&start);
+    for (int t = 0; t < threads; t++) pthread_join(handles[t], NULL);
+    result->seconds = nowSeconds() - begin;
+    pthread_barrier_destroy(&start);
+
+    ShardedLRUStatsC stats;
+    shardedLRUStatsC(cache, &stats);
+    uint64_t lookups = stats.hits + stats.misses;
+    result->hitRate = lookups ? (double)stats.hits / (double)lookups : 0.0;
+    result->corrupt = 0;
+    for (int t = 0; t < threads; t++) result->corrupt += workers[t].corrupt;
+
+    shardedLRUDestroyC(cache);
+    return atomic_load(&liveValues) == 0;
+}
+
+int main(int argc, char** argv) {
+    uint64_t operations = 8u << 20;
+    uint64_t keys = 100000;
+    int64_t capacity = 128ll << 20;
+    int threadCounts[MAX_THREAD_COUNTS] = { 1, 2, 4, 8 };
+    int threadCountTotal = 4;
+    int passes = 3;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            operations = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--keys") == 0 && i + 1 < argc) {
+            keys = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--capacity-mb") == 0 && i + 1 < argc) {
+            capacity = atoll(argv[++i]) << 20;
+        } else if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threadCountTotal = 0;
+            char* list = argv[++i];
+            for (char* token = strtok(list, ","); token && threadCountTotal < MAX_THREAD_COUNTS;
+                 token = strtok(NULL, ",")) {
+                int value = atoi(token);
+                if (value >= 1 && value <= MAX_THREADS) threadCounts[threadCountTotal++] = value;
+            }
+        } else {
+            fprintf(stderr, "usage: %s [--ops N] [--keys N] [--capacity-mb N] [--threads N,...] [--passes N]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (operations == 0 || keys == 0 || capacity <= 0 || passes <= 0 || threadCountTotal == 0) return 2;
+
+    printf("%llu ops (%d/%d get), %llu keys, %lld MB, best of %d\n", (unsigned long long)operations,
+           PUT_EVERY - 1, PUT_EVERY, (unsigned long long)keys, (long long)(capacity >> 20), passes);
+    printf("%-8s %22s %22s %8s\n", "threads", "1 shard", "16 shards", "hits");
+
+    const uint32_t shardCounts[2] = { 1, SHARDED_LRU_DEFAULT_SHARDS };
+    for (int c = 0; c < threadCountTotal; c++) {
+        double best[2] = { 1e30, 1e30 };
+        double hitRate = 0.0;
+        for (int s = 0; s < 2; s++) {
+            for (int pass = 0; pass < passes; pass++) {
+                RunResult result;
+                if (!run(shardCounts[s], threadCounts[c], operations, keys, capacity, &result)) {
+                    printf("FAIL: values leaked or over-released (%lld live)\n", (long long)atomic_load(&liveValues));
+                    return 1;
+                }
+                if (result.corrupt) {
+                    printf("FAIL: %llu gets returned a value of another key\n", (unsigned long long)result.corrupt);
+                    return 1;
+                }
+                if (result.seconds < best[s]) best[s] = result.seconds;
+                hitRate = result.hitRate;
+            }
+        }
+        printf("%-8d", threadCounts[c]);
+        for (int s = 0; s < 2; s++) {
+            double mops = (double)operations / best[s] / 1e6;
+            printf(" %9.1f Mops/s (%3.0f ns)", mops, best[s] * 1e9 / (double)operations);
+        }
+        printf(" %7.0f%%\n", hitRate * 100.0);
+    }
+    printf("all values released exactly once\n");
+    return 0;
+}
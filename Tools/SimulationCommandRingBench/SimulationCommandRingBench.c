@@ -0,0 +1,238 @@
+//
+//  SimulationCommandRingBench.c
+//  PixelFlow
+//
+//  Стресс-тест и замер задержки очереди команд (SimulationCommandRingC.c):
+//  N производителей ставят команды, один потребитель разбирает их пачками,
+//  как SimulationEngine.update. Проверяется, что ни одна команда не потеряна
+//  и команды каждого производителя приходят в порядке постановки.
+//  Базовая линия — то же кольцо под pthread_mutex (и push, и разбор).
+//  Таблица в ParticleSystem/particlesystem.md (очередь команд) получена им.
+//
+//  Не входит в Xcode-таргет. Сборка на Linux/macOS из корня репозитория:
+//
+//    P=PixelFlow/Engine/ParticleSystem
+//    cc -O2 -std=c11 -pthread -I$P/Particles
+//       Tools/SimulationCommandRingBench/SimulationCommandRingBench.c
+//       $P/Particles/SimulationCommandRingC.c -o command-ring-bench
+//
+//  (одной командной строкой)
+//
+//  Запуск: ./command-ring-bench [--producers N] [--commands N] [--runs N]
+//
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "SimulationCommandRingC.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Как SimulationCommandQueue: кольцо на 256 команд, разбор пачкой до 256
+#define BENCH_RING_CAPACITY 256
+#define BENCH_DRAIN_BATCH 256
+#define BENCH_MAX_PRODUCERS 64
+
+static uint64_t nowNanoseconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// MARK: - Queue under test
+
+typedef struct {
+    SimulationCommandRingC* ring;
+    int locked;              // 1 — базовая линия под mutex
+    pthread_mutex_t mutex;
+} BenchQueue;
+
+static int benchPush(BenchQueue* queue, const SimulationCommandC* command) {
+    if (!queue->locked) return simulationCommandRingPushC(queue->ring, command);
+    pthread_mutex_lock(&queue->mutex);
+    int pushed = simulationCommandRingPushC(queue->ring, command);
+    pthread_mutex_unlock(&queue->mutex);
+    return pushed;
+}
+
+static uint32_t benchDrain(BenchQueue* queue, SimulationCommandC* commands) {
+    if (!queue->locked) return simulationCommandRingDrainC(queue->ring, commands, BENCH_DRAIN_BATCH);
+    pthread_mutex_lock(&queue->mutex);
+    uint32_t count = simulationCommandRingDrainC(queue->ring, commands, BENCH_DRAIN_BATCH);
+    pthread_mutex_unlock(&queue->mutex);
+    return count;
+}
+
+// MARK: - Producers
+
+typedef struct {
+    BenchQueue* queue;
+    int producer;
+    int commands;
+    uint64_t retries;  // Повторы при полной очереди
+} Producer;
+
+static void* runProducer(void* context) {
+    Producer* producer = context;
+    for (int seq = 0; seq < producer->commands; seq++) {
+        SimulationCommandC command = {
+            .type = SIMULATION_COMMAND_SET_ATTRACTOR_C,
+            .id = producer->producer,
+            .values = { (float)seq, 0.0f, 0.0f, 0.0f },
+        };
+        command.timestamp = nowNanoseconds();
+        // Полная очередь отклоняет команду; тест ставит ее заново, чтобы проверить
+        // доставку каждой — в приложении отклоненная команда теряется
+        while (!benchPush(producer->queue, &command)) {
+            producer->retries++;
+            sched_yield();
+            command.timestamp = nowNanoseconds();
+        }
+    }
+    return NULL;
+}
+
+// MARK: - Run
+
+typedef struct {
+    double p50Us;
+    double p99Us;
+    double maxDrainUs;
+    uint64_t retries;
+} RunResult;
+
+static int compareLatency(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/// Один прогон; 0 — потеря или нарушение порядка (сообщение в stderr)
+static int runOnce(int locked, int producers, int commands, uint64_t* latencies, RunResult* result) {
+    BenchQueue queue = { .ring = simulationCommandRingCreateC(BENCH_RING_CAPACITY), .locked = locked };
+    if (!queue.ring) {
+        fprintf(stderr, "out of memory\n");
+        return 0;
+    }
+    pthread_mutex_init(&queue.mutex, NULL);
+
+    pthread_t handles[BENCH_MAX_PRODUCERS];
+    Producer workers[BENCH_MAX_PRODUCERS];
+    int nextSequence[BENCH_MAX_PRODUCERS] = { 0 };
+    for (int p = 0; p < producers; p++) {
+        workers[p] = (Producer){ .queue = &queue, .producer = p, .commands = commands };
+        pthread_create(&handles[p], NULL, runProducer, &workers[p]);
+    }
+
+    // Потребитель — этот поток: разбирает пачками, пока не получит все
+    SimulationCommandC batch[BENCH_DRAIN_BATCH];
+    size_t expected = (size_t)producers * (size_t)commands;
+    size_t received = 0;
+    uint64_t maxDrain = 0;
+    int ok = 1;
+    while (received < expected && ok) {
+        uint64_t start = nowNanoseconds();
+        uint32_t count = benchDrain(&queue, batch);
+        uint64_t end = nowNanoseconds();
+        if (count == 0) {
+            sched_yield();
+            continue;
+        }
+        if (end - start > maxDrain) maxDrain = end - start;
+
+        for (uint32_t i = 0; i < count; i++) {
+            int producer = batch[i].id;
+            int seq = (int)batch[i].values[0];
+            if (producer < 0 || producer >= producers || seq != nextSequence[producer]) {
+                fprintf(stderr, "%s: producer %d sent %d, expected %d\n", locked ? "mutex" : "ring",
+                        producer, seq, producer >= 0 && producer < producers ? nextSequence[producer] : -1);
+                ok = 0;
+                break;
+            }
+            nextSequence[producer]++;
+            latencies[received++] = end - batch[i].timestamp;
+        }
+    }
+
+    for (int p = 0; p < producers; p++) {
+        pthread_join(handles[p], NULL);
+    }
+    uint64_t retries = 0;
+    for (int p = 0; p < producers; p++) retries += workers[p].retries;
+
+    SimulationCommandC leftover;
+    if (ok && simulationCommandRingPopC(queue.ring, &leftover)) {
+        fprintf(stderr, "%s: extra command after %zu\n", locked ? "mutex" : "ring", expected);
+        ok = 0;
+    }
+    if (ok && simulationCommandRingDroppedC(queue.ring) != retries) {
+        fprintf(stderr, "%s: dropped %llu, producers saw %llu\n", locked ? "mutex" : "ring",
+                (unsigned long long)simulationCommandRingDroppedC(queue.ring), (unsigned long long)retries);
+        ok = 0;
+    }
+
+    pthread_mutex_destroy(&queue.mutex);
+    simulationCommandRingDestroyC(queue.ring);
+    if (!ok) return 0;
+
+    qsort(latencies, expected, sizeof(uint64_t), compareLatency);
+    result->p50Us = (double)latencies[expected / 2] * 1e-3;
+    result->p99Us = (double)latencies[expected * 99 / 100] * 1e-3;
+    result->maxDrainUs = (double)maxDrain * 1e-3;
+    result->retries = retries;
+    return 1;
+}
+
+// MARK: - Main
+
+int main(int argc, char** argv) {
+    int producers = 4;
+    int commands = 200000;
+    int runs = 3;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--producers") == 0 && i + 1 < argc) {
+            producers = atoi(argv[++i]);
+            if (producers < 1) producers = 1;
+            if (producers > BENCH_MAX_PRODUCERS) producers = BENCH_MAX_PRODUCERS;
+        } else if (strcmp(argv[i], "--commands") == 0 && i + 1 < argc) {
+            commands = atoi(argv[++i]);
+            if (commands < 1) commands = 1;
+            // Номер команды передается во float без потерь до 2^24
+            if (commands > (1 << 24)) commands = 1 << 24;
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+            if (runs < 1) runs = 1;
+        }
+    }
+
+    uint64_t* latencies = malloc(sizeof(uint64_t) * (size_t)producers * (size_t)commands);
+    if (!latencies) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    printf("%d producers x %d commands, ring %d, drain batch %d, best of %d runs (by p99)\n",
+           producers, commands, BENCH_RING_CAPACITY, BENCH_DRAIN_BATCH, runs);
+    printf("%-6s | %8s %8s %14s | %10s\n", "queue", "p50 us", "p99 us", "max drain us", "full");
+
+    for (int locked = 0; locked <= 1; locked++) {
+        RunResult best = { .p99Us = 1e30 };
+        for (int run = 0; run < runs; run++) {
+            RunResult result;
+            if (!runOnce(locked, producers, commands, latencies, &result)) {
+                free(latencies);
+                return 1;
+            }
+            if (result.p99Us < best.p99Us) best = result;
+        }
+        printf("%-6s | %8.1f %8.1f %14.1f | %10llu\n", locked ? "mutex" : "ring",
+               best.p50Us, best.p99Us, best.maxDrainUs, (unsigned long long)best.retries);
+    }
+    printf("no loss, per-producer order preserved\n");
+
+    free(latencies);
+    return 0;
+}
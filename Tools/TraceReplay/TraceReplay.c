@@ -0,0 +1,473 @@
+//
+//  TraceReplay.c
+//  PixelFlow
+//
+//  Headless-воспроизведение трассы сессии (SimulationTraceC.h) через
+//  CPU-бэкенд updateParticles (SimulationStepC.c). Кадры идут подряд без
+//  ожидания — отчет показывает пропускную способность и распределение
+//  времени кадра по состояниям, а также реальные кадры с устройства.
+//  С --render итоговый кадр рисуется CPU-растеризатором (PointSpriteRasterC.h),
+//  в отчет добавляется ошибка радиального профиля состояния (RadialProfileC.h).
+//
+//  Не входит в Xcode-таргет. Сборка на Linux/macOS из корня репозитория:
+//
+//    P=PixelFlow/Engine/ParticleSystem
+//    cc -O2 -std=c11 -pthread -I$P/Particles Tools/TraceReplay/TraceReplay.c
+//       $P/Particles/SimulationStepC.c $P/Particles/SimulationTraceC.c
+//       $P/Particles/AttractorFieldC.c $P/Particles/NeighborGridC.c
+//       $P/Particles/ParticleSeeds.c $P/Rendering/PointSpriteRasterC.c
+//       $P/Rendering/RadialProfileC.c -lm -o trace-replay
+//
+//  (одной командной строкой)
+//
+//  Запуск: ./trace-replay session.pftr [--repeat N]
+//          [--render frame.qoi|frame.ppm] [--size WxH] [--threads N] [--passes N]
+//          [--quality low|medium|high]
+//  Трасса записывается на устройстве при PIXELFLOW_TRACE_PATH в окружении схемы.
+//
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "AttractorFieldC.h"
+#include "NeighborGridC.h"
+#include "ParticleSeeds.h"
+#include "SimulationStepC.h"
+#include "SimulationTraceC.h"
+#include "../Rendering/PointSpriteRasterC.h"
+#include "../Rendering/RadialProfileC.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// MARK: - Per-state statistics
+
+typedef struct {
+    uint32_t frames;
+    uint64_t particles;
+    double seconds;
+    double* frameMs;         // время шага на CPU
+    double* deviceMs;        // frameSeconds из трассы
+    uint32_t capacity;
+} StateStats;
+
+static const char* const stateNames[SIMULATION_STATE_COUNT_C] = {
+    "idle", "chaotic", "collecting", "collected", "storm", "swarm"
+};
+
+static int appendFrame(StateStats* stats, double frameMs, double deviceMs, uint32_t particles) {
+    if (stats->frames == stats->capacity) {
+        uint32_t capacity = stats->capacity ? stats->capacity * 2 : 256;
+        double* frameMsGrown = realloc(stats->frameMs, sizeof(double) * capacity);
+        if (!frameMsGrown) return 0;
+        stats->frameMs = frameMsGrown;
+        double* deviceMsGrown = realloc(stats->deviceMs, sizeof(double) * capacity);
+        if (!deviceMsGrown) return 0;
+        stats->deviceMs = deviceMsGrown;
+        stats->capacity = capacity;
+    }
+    stats->frameMs[stats->frames] = frameMs;
+    stats->deviceMs[stats->frames] = deviceMs;
+    stats->frames++;
+    stats->particles += particles;
+    stats->seconds += frameMs / 1000.0;
+    return 1;
+}
+
+static int compareDouble(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/// Перцентиль по отсортированному массиву (nearest-rank)
+static double percentile(const double* sorted, uint32_t count, double p) {
+    if (count == 0) return 0.0;
+    uint32_t rank = (uint32_t)(p * (double)(count - 1) + 0.5);
+    return sorted[rank];
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/// FNV-1a по буферу частиц — одинаковая трасса дает одинаковый итог
+static uint64_t checksum(const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    uint64_t hash = 1469598103934665603ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// MARK: - Replay
+
+typedef struct {
+    ParticleC* particles;
+    ParticleSeedsC* seeds;
+    uint32_t particleCount;
+
+    // Сетка соседей (swarm)
+    uint32_t* cellStarts;
+    uint32_t* cellCursors;
+    uint32_t cellCapacity;
+    uint32_t* particleCells;
+    uint32_t* sortedIndices;
+    float* sortedPositions;
+    float* neighborForces;
+
+    uint16_t attractorMasks[ATTRACTOR_TILE_DIM_C * ATTRACTOR_TILE_DIM_C];
+} ReplayBuffers;
+
+static int ensureCells(ReplayBuffers* buffers, uint32_t cellCount) {
+    if (cellCount <= buffers->cellCapacity) return 1;
+    uint32_t* starts = realloc(buffers->cellStarts, sizeof(uint32_t) * (cellCount + 1));
+    if (!starts) return 0;
+    buffers->cellStarts = starts;
+    uint32_t* cursors = realloc(buffers->cellCursors, sizeof(uint32_t) * cellCount);
+    if (!cursors) return 0;
+    buffers->cellCursors = cursors;
+    buffers->cellCapacity = cellCount;
+    return 1;
+}
+
+/// Один кадр: те же стадии, что и в MetalRenderer.encodeCompute
+static int replayFrame(ReplayBuffers* buffers, SimulationParamsC* params) {
+    if (params->particleCount > buffers->particleCount) {
+        params->particleCount = buffers->particleCount;
+    }
+    int count = (int)params->particleCount;
+
+    SimulationStepInputsC inputs = { .seeds = buffers->seeds };
+
+    if (params->state == SIMULATION_STATE_SWARM_C && count > 0) {
+        NeighborGridDimsC dims = {
+            .cellSize = params->neighborGrid[0],
+            .invCellSize = params->neighborGrid[1],
+            .gridDim = (int)params->neighborGrid[2],
+            .cellCount = (int)params->neighborGrid[3],
+        };
+        NeighborForceParamsC forces = {
+            .radius = params->neighborForces[0],
+            .separationStrength = params->neighborForces[1],
+            .cohesionStrength = params->neighborForces[2],
+            .maxNeighbors = (int)params->neighborForces[3],
+        };
+        if (dims.cellCount > 0 && ensureCells(buffers, (uint32_t)dims.cellCount)) {
+            buildNeighborGridC(buffers->particles[0].position, (int)(sizeof(ParticleC) / sizeof(float)), count, dims,
+                               buffers->cellStarts, buffers->cellCursors, buffers->particleCells,
+                               buffers->sortedIndices, buffers->sortedPositions);
+            applyNeighborForcesC(dims, forces, buffers->cellStarts, buffers->sortedIndices,
+                                 buffers->sortedPositions, 0, count, buffers->neighborForces);
+            inputs.neighborForces = buffers->neighborForces;
+        }
+    }
+
+    if (params->attractorCount > 0) {
+        buildAttractorTileMasksC(params->attractors, (int)params->attractorCount,
+                                 params->screenSize[0], params->screenSize[1], buffers->attractorMasks);
+        inputs.attractorTileMasks = buffers->attractorMasks;
+    }
+
+    simulationStepC(buffers->particles, params, inputs, 0, count);
+    return count;
+}
+
+static void printReport(StateStats* stats, uint32_t transitions) {
+    printf("\n%-11s %7s %11s %8s %8s %8s %8s %8s | %10s %10s\n",
+           "state", "frames", "Mparticle/s", "mean ms", "p50", "p90", "p99", "max",
+           "device p50", "device p99");
+
+    for (int s = 0; s < SIMULATION_STATE_COUNT_C; s++) {
+        StateStats* st = &stats[s];
+        if (st->frames == 0) continue;
+
+        qsort(st->frameMs, st->frames, sizeof(double), compareDouble);
+        qsort(st->deviceMs, st->frames, sizeof(double), compareDouble);
+
+        double throughput = st->seconds > 0.0 ? (double)st->particles / st->seconds / 1e6 : 0.0;
+        printf("%-11s %7u %11.2f %8.3f %8.3f %8.3f %8.3f %8.3f | %10.2f %10.2f\n",
+               stateNames[s], st->frames, throughput,
+               st->seconds * 1000.0 / (double)st->frames,
+               percentile(st->frameMs, st->frames, 0.50),
+               percentile(st->frameMs, st->frames, 0.90),
+               percentile(st->frameMs, st->frames, 0.99),
+               st->frameMs[st->frames - 1],
+               percentile(st->deviceMs, st->frames, 0.50),
+               percentile(st->deviceMs, st->frames, 0.99));
+    }
+    printf("state transitions: %u\n", transitions);
+}
+
+// MARK: - Render
+
+typedef enum {
+    RENDER_STAGE_BIN,
+    RENDER_STAGE_SCATTER,
+    RENDER_STAGE_TILES,
+} RenderStage;
+
+#define RENDER_TILE_BATCH 4
+
+typedef struct {
+    PointSpriteRasterC* raster;
+    RenderStage stage;
+    int worker;
+    atomic_int* nextTile;
+} RenderJob;
+
+static void* renderWorker(void* arg) {
+    RenderJob* job = arg;
+    switch (job->stage) {
+        case RENDER_STAGE_BIN:
+            pointSpriteRasterBinC(job->raster, job->worker);
+            break;
+        case RENDER_STAGE_SCATTER:
+            pointSpriteRasterScatterC(job->raster, job->worker);
+            break;
+        case RENDER_STAGE_TILES: {
+            // Тайлы бури и плотных областей дороже — раздаем пачками по мере готовности
+            int tileCount = pointSpriteRasterTileCountC(job->raster);
+            for (;;) {
+                int first = atomic_fetch_add(job->nextTile, RENDER_TILE_BATCH);
+                if (first >= tileCount) break;
+                pointSpriteRasterTilesC(job->raster, first, RENDER_TILE_BATCH);
+            }
+            break;
+        }
+    }
+    return NULL;
+}
+
+/// Стадия на всех потоках; возвращает время в мс
+static double runRenderStage(PointSpriteRasterC* raster, RenderStage stage, int threads) {
+    pthread_t handles[64];
+    RenderJob jobs[64];
+    atomic_int nextTile = 0;
+
+    double start = nowSeconds();
+    for (int t = 0; t < threads; t++) {
+        jobs[t] = (RenderJob){ .raster = raster, .stage = stage, .worker = t, .nextTile = &nextTile };
+        if (t > 0) pthread_create(&handles[t], NULL, renderWorker, &jobs[t]);
+    }
+    renderWorker(&jobs[0]);
+    for (int t = 1; t < threads; t++) {
+        pthread_join(handles[t], NULL);
+    }
+    return (nowSeconds() - start) * 1000.0;
+}
+
+static int hasSuffix(const char* s, const char* suffix) {
+    size_t n = strlen(s);
+    size_t m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+static int renderFrame(const ReplayBuffers* buffers, const SimulationParamsC* params,
+                       const char* outPath, int width, int height, int threads, int passes,
+                       int quality) {
+    if (width <= 0 || height <= 0) {
+        width = (int)params->screenSize[0];
+        height = (int)params->screenSize[1];
+    }
+    PointSpriteRasterC* raster = pointSpriteRasterCreateC(width, height, threads);
+    if (!raster) {
+        fprintf(stderr, "cannot create %dx%d raster\n", width, height);
+        return 1;
+    }
+    pointSpriteRasterSetQualityC(raster, quality);
+
+    uint32_t count = params->particleCount < buffers->particleCount ? params->particleCount : buffers->particleCount;
+    double stageMs[3] = { 0.0, 0.0, 0.0 };
+    double totalMs = 0.0;
+    int status = 0;
+
+    for (int pass = 0; pass < passes && status == 0; pass++) {
+        double start = nowSeconds();
+        if (!pointSpriteRasterBeginC(raster, buffers->particles, buffers->seeds, count, params)) {
+            status = 1;
+            break;
+        }
+        stageMs[0] += runRenderStage(raster, RENDER_STAGE_BIN, threads);
+        if (!pointSpriteRasterPrepareScatterC(raster)) {
+            status = 1;
+            break;
+        }
+        stageMs[1] += runRenderStage(raster, RENDER_STAGE_SCATTER, threads);
+        stageMs[2] += runRenderStage(raster, RENDER_STAGE_TILES, threads);
+        totalMs += (nowSeconds() - start) * 1000.0;
+    }
+
+    if (status != 0) {
+        fprintf(stderr, "out of memory while rendering\n");
+    } else {
+        const uint8_t* pixels = pointSpriteRasterPixelsC(raster);
+        int written = hasSuffix(outPath, ".ppm")
+            ? pointSpriteWritePPMC(outPath, pixels, width, height)
+            : pointSpriteWriteQOIC(outPath, pixels, width, height);
+        if (!written) {
+            fprintf(stderr, "cannot write %s\n", outPath);
+            status = 1;
+        }
+
+        double frameMs = totalMs / (double)passes;
+        printf("\nrender: %s %dx%d, state %u, quality %d, %u sprites, %llu sprite-tiles, %d threads, %d passes\n",
+               outPath, width, height, params->state, quality, count,
+               (unsigned long long)pointSpriteRasterBinnedCountC(raster), threads, passes);
+        printf("frame %.3f ms (bin %.3f, scatter %.3f, tiles %.3f), %.2f Msprite/s\n",
+               frameMs, stageMs[0] / passes, stageMs[1] / passes, stageMs[2] / passes,
+               frameMs > 0.0 ? (double)count / (frameMs / 1000.0) / 1e6 : 0.0);
+
+        // Таблица против аналитики; 1/255 — шаг 8-битной цели
+        RadialProfileSampleC profile[RADIAL_PROFILE_SIZE_C];
+        bakeRadialProfileC(profile, params->state, quality);
+        float maxError = radialProfileMaxErrorC(profile, params->state, quality, 4096);
+        printf("radial profile: %d entries, max error %.2e (%.4f of 1/255)\n",
+               RADIAL_PROFILE_SIZE_C, maxError, maxError * 255.0f);
+    }
+
+    pointSpriteRasterDestroyC(raster);
+    return status;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <trace.pftr> [--repeat N] [--render out.qoi|out.ppm] "
+                        "[--size WxH] [--threads N] [--passes N] [--quality low|medium|high]\n", argv[0]);
+        return 2;
+    }
+
+    const char* path = argv[1];
+    int repeat = 1;
+    const char* renderPath = NULL;
+    int renderWidth = 0;
+    int renderHeight = 0;
+    int renderThreads = 4;
+    int renderPasses = 5;
+    int renderQuality = LIGHTING_QUALITY_HIGH_C;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+            if (repeat < 1) repeat = 1;
+        } else if (strcmp(argv[i], "--render") == 0 && i + 1 < argc) {
+            renderPath = argv[++i];
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &renderWidth, &renderHeight) != 2) {
+                renderWidth = renderHeight = 0;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            renderThreads = atoi(argv[++i]);
+            if (renderThreads < 1) renderThreads = 1;
+            if (renderThreads > 64) renderThreads = 64;
+        } else if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            renderPasses = atoi(argv[++i]);
+            if (renderPasses < 1) renderPasses = 1;
+        } else if (strcmp(argv[i], "--quality") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (strcmp(name, "low") == 0) renderQuality = LIGHTING_QUALITY_LOW_C;
+            else if (strcmp(name, "medium") == 0) renderQuality = LIGHTING_QUALITY_MEDIUM_C;
+            else renderQuality = LIGHTING_QUALITY_HIGH_C;
+        }
+    }
+
+    StateStats stats[SIMULATION_STATE_COUNT_C];
+    memset(stats, 0, sizeof(stats));
+    uint32_t transitions = 0;
+    uint64_t lastChecksum = 0;
+    int status = 0;
+    int renderStatus = 0;
+
+    for (int run = 0; run < repeat && status == 0; run++) {
+        SimulationTraceReaderC* reader = simulationTraceOpenReaderC(path);
+        if (!reader) {
+            fprintf(stderr, "cannot open trace: %s\n", path);
+            return 1;
+        }
+
+        ReplayBuffers buffers;
+        memset(&buffers, 0, sizeof(buffers));
+        buffers.particleCount = simulationTraceParticleCountC(reader);
+        size_t n = buffers.particleCount ? buffers.particleCount : 1;
+        buffers.particles = malloc(sizeof(ParticleC) * n);
+        buffers.seeds = malloc(sizeof(ParticleSeedsC) * n);
+        buffers.particleCells = malloc(sizeof(uint32_t) * n);
+        buffers.sortedIndices = malloc(sizeof(uint32_t) * n);
+        buffers.sortedPositions = malloc(sizeof(float) * 2 * n);
+        buffers.neighborForces = malloc(sizeof(float) * 2 * n);
+
+        if (!buffers.particles || !buffers.seeds || !buffers.particleCells ||
+            !buffers.sortedIndices || !buffers.sortedPositions || !buffers.neighborForces ||
+            !simulationTraceReadParticlesC(reader, buffers.particles)) {
+            fprintf(stderr, "cannot read particle buffer\n");
+            status = 1;
+        } else {
+            bakeParticleSeedsC(buffers.seeds, 0, (int)buffers.particleCount);
+        }
+
+        SimulationParamsC params;
+        memset(&params, 0, sizeof(params));
+        SimulationTraceEventC event;
+        int result;
+
+        while (status == 0 && (result = simulationTraceNextC(reader, &event, &params)) != 0) {
+            if (result < 0) {
+                fprintf(stderr, "corrupted record after frame %u\n", event.frameIndex);
+                status = 1;
+                break;
+            }
+
+            if (event.tag == SIMULATION_TRACE_TAG_STATE) {
+                if (run == 0) transitions++;
+                continue;
+            }
+
+            double start = nowSeconds();
+            int stepped = replayFrame(&buffers, &params);
+            double frameMs = (nowSeconds() - start) * 1000.0;
+
+            uint32_t state = params.state < SIMULATION_STATE_COUNT_C ? params.state : SIMULATION_STATE_IDLE_C;
+            if (!appendFrame(&stats[state], frameMs, (double)event.frameSeconds * 1000.0, (uint32_t)stepped)) {
+                fprintf(stderr, "out of memory\n");
+                status = 1;
+            }
+        }
+
+        if (status == 0) {
+            lastChecksum = checksum(buffers.particles, sizeof(ParticleC) * buffers.particleCount);
+        }
+        if (status == 0 && renderPath && run == repeat - 1) {
+            renderStatus = renderFrame(&buffers, &params, renderPath, renderWidth, renderHeight,
+                                       renderThreads, renderPasses, renderQuality);
+        }
+
+        free(buffers.particles);
+        free(buffers.seeds);
+        free(buffers.cellStarts);
+        free(buffers.cellCursors);
+        free(buffers.particleCells);
+        free(buffers.sortedIndices);
+        free(buffers.sortedPositions);
+        free(buffers.neighborForces);
+        simulationTraceCloseReaderC(reader);
+    }
+
+    if (status == 0) {
+        printf("trace: %s, runs: %d, final buffer checksum: %016llx\n",
+               path, repeat, (unsigned long long)lastChecksum);
+        printReport(stats, transitions);
+    }
+    if (status == 0) status = renderStatus;
+
+    for (int s = 0; s < SIMULATION_STATE_COUNT_C; s++) {
+        free(stats[s].frameMs);
+        free(stats[s].deviceMs);
+    }
+    return status;
+}
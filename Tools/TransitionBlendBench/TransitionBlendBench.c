@@ -0,0 +1,235 @@
+//
+//  TransitionBlendBench.c
+//  PixelFlow
+//
+//  Шаг перехода к HQ-целям: transitionBlendC (TransitionBlendC.c) против
+//  прежней схемы — копия latest в слот и скалярный lerp по полям, как
+//  в ParticleStorage.interpolateParticle. Таблица в ParticleSystem/
+//  particlesystem.md (TransitionBlendC) получена им; заодно считается,
+//  за сколько кадров переход сходится к целям ровно.
+//
+//  Не входит в Xcode-таргет. Сборка на Linux/macOS из корня репозитория:
+//
+//    P=PixelFlow/Engine/ParticleSystem
+//    cc -O2 -std=c11 -I$P/Particles
+//       Tools/TransitionBlendBench/TransitionBlendBench.c
+//       $P/Particles/TransitionBlendC.c $P/Particles/PreviewIntegratorC.c
+//       -lm -o transition-blend-bench
+//
+//  (одной командной строкой)
+//
+//  Запуск: ./transition-blend-bench [--particles N,N,...] [--factor F] [--passes N]
+//
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "TransitionBlendC.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_SIZES 8
+#define TRANSITION_STAGGER 0.3f
+#define CONVERGENCE_FRAME_LIMIT 10000
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t nextRandom(uint32_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static float randomUnit(uint32_t* state) {
+    return (float)(nextRandom(state) >> 8) * (1.0f / 16777216.0f);
+}
+
+static void fillVec(float* v, int lanes, uint32_t* state) {
+    for (int k = 0; k < lanes; k++) v[k] = randomUnit(state) * 2.0f - 1.0f;
+}
+
+/// Превью и цели; у половины частиц цвет совпадает с целью (как у перехода превью → HQ)
+static void makeParticles(ParticleC* source, ParticleC* targets, int count) {
+    uint32_t state = 0x9E3779B9u;
+    memset(source, 0, sizeof(ParticleC) * (size_t)count);
+    memset(targets, 0, sizeof(ParticleC) * (size_t)count);
+    for (int i = 0; i < count; i++) {
+        ParticleC* p = &source[i];
+        ParticleC* t = &targets[i];
+        fillVec(p->position, 3, &state);
+        fillVec(p->velocity, 3, &state);
+        fillVec(p->targetPosition, 3, &state);
+        fillVec(p->color, 4, &state);
+        fillVec(p->originalColor, 4, &state);
+        p->size = p->baseSize = 1.0f + randomUnit(&state) * 4.0f;
+        p->life = randomUnit(&state);
+        p->idleChaoticMotion = 1;
+
+        *t = *p;
+        fillVec(t->position, 3, &state);
+        fillVec(t->targetPosition, 3, &state);
+        t->velocity[0] = t->velocity[1] = t->velocity[2] = 0.0f;
+        t->size = t->baseSize = 1.0f + randomUnit(&state) * 4.0f;
+        t->idleChaoticMotion = 0;
+        if (i % 2) {
+            fillVec(t->color, 4, &state);
+            fillVec(t->originalColor, 4, &state);
+        }
+    }
+}
+
+static inline void lerpLanes(float* current, const float* target, int lanes, float f) {
+    for (int k = 0; k < lanes; k++) current[k] += (target[k] - current[k]) * f;
+}
+
+/// Прежний шаг: слот копируется из latest, затем поля смешиваются по одному
+static void scalarBlend(const ParticleC* latest, const ParticleC* targets, ParticleC* slot,
+                        int count, float f) {
+    memcpy(slot, latest, sizeof(ParticleC) * (size_t)count);
+    for (int i = 0; i < count; i++) {
+        ParticleC current = slot[i];
+        const ParticleC* t = &targets[i];
+        lerpLanes(current.position, t->position, 3, f);
+        lerpLanes(current.velocity, t->velocity, 3, f);
+        lerpLanes(current.targetPosition, t->targetPosition, 3, f);
+        lerpLanes(current.color, t->color, 4, f);
+        lerpLanes(current.originalColor, t->originalColor, 4, f);
+        current.size += (t->size - current.size) * f;
+        current.baseSize += (t->baseSize - current.baseSize) * f;
+        current.life += (t->life - current.life) * f;
+        if (f >= TRANSITION_IDLE_SWITCH_C) current.idleChaoticMotion = t->idleChaoticMotion;
+        slot[i] = current;
+    }
+}
+
+typedef enum {
+    VARIANT_SCALAR,
+    VARIANT_FUSED,
+    VARIANT_FUSED_STAGGERED,
+    VARIANT_SETTLED
+} Variant;
+
+/// Лучшее время шага в мс. Каждый проход начинает с тех же latest/целей
+static double measure(Variant variant, const ParticleC* source, const ParticleC* targets,
+                      ParticleC* slot, int count, float f, int passes) {
+    double best = 1e30;
+    for (int pass = 0; pass < passes; pass++) {
+        double start = nowSeconds();
+        switch (variant) {
+        case VARIANT_SCALAR:
+            scalarBlend(source, targets, slot, count, f);
+            break;
+        case VARIANT_FUSED:
+            transitionBlendC(source, targets, slot, 0, count, f, TRANSITION_STAGGER, 0.0f);
+            break;
+        case VARIANT_FUSED_STAGGERED:
+            // Середина окна старта — примерно половина частиц еще ждет
+            transitionBlendC(source, targets, slot, 0, count, f,
+                             TRANSITION_STAGGER * 0.5f, TRANSITION_STAGGER);
+            break;
+        case VARIANT_SETTLED:
+            transitionBlendC(targets, targets, slot, 0, count, f, TRANSITION_STAGGER, 0.0f);
+            break;
+        }
+        double ms = (nowSeconds() - start) * 1e3;
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+/// Кадров до полного совпадения с целями (шаг на месте); -1 — не сошелся
+static int framesToConverge(const ParticleC* source, const ParticleC* targets, int count, float f) {
+    ParticleC* state = malloc(sizeof(ParticleC) * (size_t)count);
+    if (!state) return -1;
+    memcpy(state, source, sizeof(ParticleC) * (size_t)count);
+
+    int frames = -1;
+    for (int frame = 1; frame <= CONVERGENCE_FRAME_LIMIT; frame++) {
+        if (transitionBlendC(state, targets, state, 0, count, f, 1e9f, 0.0f) == 0) {
+            frames = frame;
+            break;
+        }
+    }
+    if (frames > 0 && memcmp(state, targets, sizeof(ParticleC) * (size_t)count) != 0) frames = -1;
+    free(state);
+    return frames;
+}
+
+/// Список через запятую (argv правится на месте, как в CollectedCounterBench)
+static int parseList(char* list, int* out, int capacity) {
+    int n = 0;
+    for (char* token = strtok(list, ","); token && n < capacity; token = strtok(NULL, ",")) {
+        int value = atoi(token);
+        if (value > 0) out[n++] = value;
+    }
+    return n;
+}
+
+int main(int argc, char** argv) {
+    int sizes[MAX_SIZES] = { 1 << 20, 4 << 20 };
+    int sizeCount = 2;
+    float factor = 0.033f;
+    int passes = 8;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--particles") == 0 && i + 1 < argc) {
+            sizeCount = parseList(argv[++i], sizes, MAX_SIZES);
+        } else if (strcmp(argv[i], "--factor") == 0 && i + 1 < argc) {
+            factor = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--particles N,N,...] [--factor F] [--passes N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (sizeCount <= 0 || passes <= 0 || factor <= 0.0f) return 2;
+
+    printf("f = %.3f, best of %d, ms per frame\n", factor, passes);
+    printf("%10s %14s %10s %14s %10s\n", "particles", "copy+scalar", "fused", "fused/stagger", "settled");
+
+    for (int s = 0; s < sizeCount; s++) {
+        int count = sizes[s];
+        ParticleC* source = malloc(sizeof(ParticleC) * (size_t)count);
+        ParticleC* targets = malloc(sizeof(ParticleC) * (size_t)count);
+        ParticleC* slot = malloc(sizeof(ParticleC) * (size_t)count);
+        if (!source || !targets || !slot) {
+            fprintf(stderr, "out of memory for %d particles\n", count);
+            return 1;
+        }
+        makeParticles(source, targets, count);
+
+        double scalar = measure(VARIANT_SCALAR, source, targets, slot, count, factor, passes);
+        double fused = measure(VARIANT_FUSED, source, targets, slot, count, factor, passes);
+        double staggered = measure(VARIANT_FUSED_STAGGERED, source, targets, slot, count, factor, passes);
+        double settled = measure(VARIANT_SETTLED, source, targets, slot, count, factor, passes);
+        printf("%10d %14.1f %10.1f %14.1f %10.1f\n", count, scalar, fused, staggered, settled);
+
+        free(source);
+        free(targets);
+        free(slot);
+    }
+
+    // Сходимость проверяется на малом наборе — число кадров от размера не зависит
+    int probeCount = 1 << 14;
+    ParticleC* source = malloc(sizeof(ParticleC) * (size_t)probeCount);
+    ParticleC* targets = malloc(sizeof(ParticleC) * (size_t)probeCount);
+    if (!source || !targets) return 1;
+    makeParticles(source, targets, probeCount);
+    int frames = framesToConverge(source, targets, probeCount, factor);
+    free(source);
+    free(targets);
+    if (frames < 0) {
+        printf("FAIL: transition did not converge exactly within %d frames\n", CONVERGENCE_FRAME_LIMIT);
+        return 1;
+    }
+    printf("converged exactly to targets in %d frames\n", frames);
+    return 0;
+}